@@ -0,0 +1,58 @@
+/*
+ * Times single-phase lookups with the BICUBIC&HEOS and TTSE&HEOS backends for water at random state points
+ * spread over the whole table, which is the case in which the memory layout of the tables matters most.
+ *
+ * Build against the static library, for instance from the root of the repository:
+ *     g++ -O2 -Iinclude -Iexternals/Eigen dev/TTSE/bicubic_lookup_benchmark.cpp build/libCoolProp.a -ldl -o bicubic_lookup_benchmark
+ */
+#include "AbstractState.h"
+#include "crossplatform_shared_ptr.h"
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+
+using namespace CoolProp;
+
+static void time_backend(const std::string &backend, std::size_t N, std::size_t repeats)
+{
+    shared_ptr<AbstractState> AS(AbstractState::factory(backend, "Water"));
+
+    // Random single-phase states in the range 1 bar < p < 100 bar and 280 K < T < 980 K
+    std::vector<double> p(N), T(N), h(N);
+    srand(1);
+    for (std::size_t i = 0; i < N; ++i){
+        p[i] = 1e5*pow(10.0, 2.0*rand()/RAND_MAX);
+        T[i] = 280 + 700.0*rand()/RAND_MAX;
+        AS->update(PT_INPUTS, p[i], T[i]);
+        h[i] = AS->hmolar();
+    }
+
+    double summer = 0;
+    clock_t t1 = clock();
+    for (std::size_t k = 0; k < repeats; ++k){
+        for (std::size_t i = 0; i < N; ++i){
+            AS->update(HmolarP_INPUTS, h[i], p[i]);
+            summer += AS->T() + AS->rhomolar();
+        }
+    }
+    clock_t t2 = clock();
+    for (std::size_t k = 0; k < repeats; ++k){
+        for (std::size_t i = 0; i < N; ++i){
+            AS->update(PT_INPUTS, p[i], T[i]);
+            summer += AS->hmolar() + AS->smolar();
+        }
+    }
+    clock_t t3 = clock();
+    double Ncalls = static_cast<double>(N*repeats);
+    std::cout << backend << ": HmolarP " << (t2-t1)/static_cast<double>(CLOCKS_PER_SEC)/Ncalls*1e9 << " ns/call, "
+              << "PT " << (t3-t2)/static_cast<double>(CLOCKS_PER_SEC)/Ncalls*1e9 << " ns/call (checksum " << summer << ")" << std::endl;
+}
+
+int main()
+{
+    time_backend("BICUBIC&HEOS", 100000, 20);
+    time_backend("TTSE&HEOS", 100000, 20);
+    return 0;
+}
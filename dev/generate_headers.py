@@ -106,6 +106,45 @@ def TO_CPP(root_dir, hashes):
             print(os.path.join(root_dir,'include',outfile)+ ' written to file')
         else:
             print(outfile + ' is up to date')
+    
+    fluid_index_to_file(root_dir, hashes)
+    
+def fluid_index_to_file(root_dir, hashes):
+    """
+    Write the index of the fluids in all_fluids_JSON: the name, the CAS number, the aliases and the position of the 
+    JSON object of each fluid within the string.  With it, the fluid library can be indexed without parsing any JSON, 
+    and each fluid is only parsed the first time that it is used
+    """
+    text = open(os.path.join(root_dir,'dev','all_fluids.json'),'r').read()
+    master = json.loads(text)
+    
+    entries = []
+    # The fluids are written one after the other by json.dumps, separated by ', '
+    offset = 1
+    for fluid in master:
+        fluid_text = json.dumps(fluid)
+        if text[offset:offset+len(fluid_text)] != fluid_text:
+            raise ValueError('unable to find the JSON object of fluid %s in all_fluids.json' % fluid['NAME'])
+        entries.append('{{{name:s}, {CAS:s}, {aliases:s}, {offset:d}, {length:d}}}'.format(name = json.dumps(fluid['NAME']),
+                                                                                     CAS = json.dumps(fluid['CAS']),
+                                                                                     aliases = json.dumps('|'.join(fluid['ALIASES'])),
+                                                                                     offset = offset,
+                                                                                     length = len(fluid_text)))
+        offset += len(fluid_text) + len(', ')
+    
+    body = ',\n'.join(entries)
+    outfile = os.path.join(root_dir,'include','all_fluids_index.h')
+    if not os.path.isfile(outfile) or 'all_fluids_index' not in hashes or hashes['all_fluids_index'] != get_hash(body.encode('ascii')):
+        output  = '// File generated by the script dev/generate_headers.py on '+ str(datetime.now()) + '\n\n'
+        output += '// The name, CAS number, aliases (separated by |) and position in all_fluids_JSON of the JSON object of each fluid\n'
+        output += 'const CoolProp::FluidIndexEntry all_fluids_index[] = {\n' + body + '\n};\n'
+        f = open(outfile, 'w')
+        f.write(output)
+        f.close()
+        hashes['all_fluids_index'] = get_hash(body.encode('ascii'))
+        print(outfile + ' written to file')
+    else:
+        print('all_fluids_index.h is up to date')
             
 def version_to_file(root_dir):
     
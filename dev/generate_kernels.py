@@ -0,0 +1,414 @@
+"""
+Generate C++ kernels for the generalized exponential terms of the residual Helmholtz energy of
+some of the fluids, with the coefficients and exponents of each fluid compiled in.  Each kernel
+does what ResidualHelmholtzGeneralizedExponential::all() does for that fluid, but
+
+ * the loop over the terms is unrolled and the coefficients are constants,
+ * integer powers of delta and tau (and powers with exponents that are multiples of 1/8) are
+   built from multiplications (and square roots), each power once, rather than with exp and log,
+ * exp(u) is calculated once for all the terms that have the same u
+
+Usage:
+    python generate_kernels.py path/to/GeneratedHelmholtzKernels.cpp Water R134a ...
+
+The fluids are looked up by name in dev/fluids; the kernels are used when CoolProp is built with
+COOLPROP_GENERATED_KERNELS (see the option of the same name in CMakeLists.txt), and only if they
+agree with the generic evaluation when the fluid is loaded.
+"""
+from __future__ import division, print_function
+from fractions import Fraction
+import glob
+import json
+import os
+import re
+import sys
+
+repo_root_path = os.path.normpath(os.path.join(os.path.abspath(__file__), '..', '..'))
+
+# The greatest denominator of fractional exponents that are built with square roots
+max_root_denominator = 8
+
+header = """// This file was generated by dev/generate_kernels.py; do not edit it by hand
+#include "Helmholtz.h"
+#include <cmath>
+
+#if defined(__GNUC__)
+    #define GENERATED_INLINE inline __attribute__((always_inline))
+#else
+    #define GENERATED_INLINE inline
+#endif
+
+namespace CoolProp{
+
+namespace {
+
+/// Indices of the sums, in the order of the derivatives in HelmholtzDerivatives
+enum { SUM_A, SUM_D, SUM_T, SUM_DD, SUM_DT, SUM_TT, SUM_DDD, SUM_DDT, SUM_DTT, SUM_TTT, SUM_DDDD, SUM_DDDT, SUM_DDTT, SUM_DTTT, SUM_TTTT, NUMBER_OF_SUMS };
+
+/** Add the contributions of the term n*delta^d*tau^t*exp(u) (ndteu) to the sums, as in ResidualHelmholtzGeneralizedExponential::all_reference()
+ *
+ * The derivatives of u with respect to delta of orders greater than delta_order are zero, and are left out of the
+ * calculation altogether (a multiplication by zero cannot be folded away by the compiler), and likewise for tau.
+ */
+template<int max_order, int delta_order, int tau_order>
+GENERATED_INLINE void add_term(double *s, const double ndteu, const double d, const double t, const double tau, const double delta,
+                               const double du_ddelta, const double d2u_ddelta2, const double d3u_ddelta3, const double d4u_ddelta4,
+                               const double du_dtau, const double d2u_dtau2, const double d3u_dtau3, const double d4u_dtau4)
+{
+    s[SUM_A] += ndteu;
+    if (max_order < 1){ return; }
+    const double B_delta = (delta_order >= 1) ? delta*du_ddelta + d : d;
+    const double B_tau = (tau_order >= 1) ? tau*du_dtau + t : t;
+    s[SUM_D] += ndteu*B_delta;
+    s[SUM_T] += ndteu*B_tau;
+    if (max_order < 2){ return; }
+    const double dB_delta_ddelta = (delta_order >= 2) ? delta*d2u_ddelta2 + du_ddelta : du_ddelta;
+    const double B_delta2 = (delta_order >= 1) ? delta*dB_delta_ddelta + (B_delta - 1)*B_delta : (B_delta - 1)*B_delta;
+    const double dB_tau_dtau = (tau_order >= 2) ? tau*d2u_dtau2 + du_dtau : du_dtau;
+    const double B_tau2 = (tau_order >= 1) ? tau*dB_tau_dtau + (B_tau - 1)*B_tau : (B_tau - 1)*B_tau;
+    s[SUM_DD] += ndteu*B_delta2;
+    s[SUM_DT] += ndteu*B_delta*B_tau;
+    s[SUM_TT] += ndteu*B_tau2;
+    if (max_order < 3){ return; }
+    const double d2B_delta_ddelta2 = (delta_order >= 3) ? delta*d3u_ddelta3 + 2*d2u_ddelta2 : 2*d2u_ddelta2;
+    const double dB_delta2_ddelta = (delta_order >= 2) ? delta*d2B_delta_ddelta2 + 2*B_delta*dB_delta_ddelta : 2*B_delta*dB_delta_ddelta;
+    const double B_delta3 = (delta_order >= 1) ? delta*dB_delta2_ddelta + (B_delta - 2)*B_delta2 : (B_delta - 2)*B_delta2;
+    const double d2B_tau_dtau2 = (tau_order >= 3) ? tau*d3u_dtau3 + 2*d2u_dtau2 : 2*d2u_dtau2;
+    const double dB_tau2_dtau = (tau_order >= 2) ? tau*d2B_tau_dtau2 + 2*B_tau*dB_tau_dtau : 2*B_tau*dB_tau_dtau;
+    const double B_tau3 = (tau_order >= 1) ? tau*dB_tau2_dtau + (B_tau - 2)*B_tau2 : (B_tau - 2)*B_tau2;
+    s[SUM_DDD] += ndteu*B_delta3;
+    s[SUM_DDT] += ndteu*B_delta2*B_tau;
+    s[SUM_DTT] += ndteu*B_delta*B_tau2;
+    s[SUM_TTT] += ndteu*B_tau3;
+    if (max_order < 4){ return; }
+    double dB_delta3_ddelta = 3*delta*dB_delta_ddelta*dB_delta_ddelta + 3*B_delta*(B_delta - 1)*dB_delta_ddelta;
+    if (delta_order >= 2){ dB_delta3_ddelta += 3*delta*B_delta*d2B_delta_ddelta2; }
+    if (delta_order >= 3){ dB_delta3_ddelta += delta*delta*((delta_order >= 4) ? delta*d4u_ddelta4 + 3*d3u_ddelta3 : 3*d3u_ddelta3); }
+    const double B_delta4 = (delta_order >= 1) ? delta*dB_delta3_ddelta + (B_delta - 3)*B_delta3 : (B_delta - 3)*B_delta3;
+    double dB_tau3_dtau = 3*tau*dB_tau_dtau*dB_tau_dtau + 3*B_tau*(B_tau - 1)*dB_tau_dtau;
+    if (tau_order >= 2){ dB_tau3_dtau += 3*tau*B_tau*d2B_tau_dtau2; }
+    if (tau_order >= 3){ dB_tau3_dtau += tau*tau*((tau_order >= 4) ? tau*d4u_dtau4 + 3*d3u_dtau3 : 3*d3u_dtau3); }
+    const double B_tau4 = (tau_order >= 1) ? tau*dB_tau3_dtau + (B_tau - 3)*B_tau3 : (B_tau - 3)*B_tau3;
+    s[SUM_DDDD] += ndteu*B_delta4;
+    s[SUM_DDDT] += ndteu*B_delta3*B_tau;
+    s[SUM_DDTT] += ndteu*B_delta2*B_tau2;
+    s[SUM_DTTT] += ndteu*B_delta*B_tau3;
+    s[SUM_TTTT] += ndteu*B_tau4;
+}
+
+/// Add the sums, scaled to give the derivatives with respect to delta and tau, to derivs
+template<int max_order>
+GENERATED_INLINE void add_sums(const double *s, const double one_over_tau, const double one_over_delta, HelmholtzDerivatives &derivs)
+{
+    derivs.alphar                 += s[SUM_A];
+    if (max_order < 1){ return; }
+    derivs.dalphar_ddelta         += s[SUM_D]*one_over_delta;
+    derivs.dalphar_dtau           += s[SUM_T]*one_over_tau;
+    if (max_order < 2){ return; }
+    derivs.d2alphar_ddelta2       += s[SUM_DD]*POW2(one_over_delta);
+    derivs.d2alphar_dtau2         += s[SUM_TT]*POW2(one_over_tau);
+    derivs.d2alphar_ddelta_dtau   += s[SUM_DT]*one_over_delta*one_over_tau;
+    if (max_order < 3){ return; }
+    derivs.d3alphar_ddelta3       += s[SUM_DDD]*POW3(one_over_delta);
+    derivs.d3alphar_dtau3         += s[SUM_TTT]*POW3(one_over_tau);
+    derivs.d3alphar_ddelta2_dtau  += s[SUM_DDT]*POW2(one_over_delta)*one_over_tau;
+    derivs.d3alphar_ddelta_dtau2  += s[SUM_DTT]*one_over_delta*POW2(one_over_tau);
+    if (max_order < 4){ return; }
+    derivs.d4alphar_ddelta4       += s[SUM_DDDD]*POW4(one_over_delta);
+    derivs.d4alphar_dtau4         += s[SUM_TTTT]*POW4(one_over_tau);
+    derivs.d4alphar_ddelta3_dtau  += s[SUM_DDDT]*POW3(one_over_delta)*one_over_tau;
+    derivs.d4alphar_ddelta2_dtau2 += s[SUM_DDTT]*POW2(one_over_delta)*POW2(one_over_tau);
+    derivs.d4alphar_ddelta_dtau3  += s[SUM_DTTT]*one_over_delta*POW3(one_over_tau);
+}
+"""
+
+footer = """
+} /* namespace */
+
+GeneratedHelmholtzKernel get_generated_helmholtz_kernel(const std::string &fluid_name)
+{
+{registry}    return NULL;
+}
+
+} /* namespace CoolProp */
+"""
+
+def literal(x):
+    """ The shortest C++ literal that gives back the double x """
+    s = repr(float(x))
+    if s in ('inf', '-inf', 'nan'):
+        raise ValueError('cannot write %s as a literal' % s)
+    # In parentheses if negative, so that it can go anywhere in an expression
+    return '(%s)' % s if s.startswith('-') else s
+
+def valid(x):
+    """ The same test as ValidNumber() in CoolPropTools.h """
+    return x == x and abs(x) != float('inf')
+
+class Powers(object):
+    """
+    The powers of one variable (tau or delta) that the terms need.  Powers with exponents that are multiples
+    of 1/q, with q a power of two no greater than max_root_denominator, are the product of an integer power
+    of the variable and an integer power of its q-th root, which is found with square roots; both integer
+    powers are built from squares.  Any other power is exp(e*log(x)).
+    """
+    def __init__(self, variable):
+        self.variable = variable
+        self.exponents = set()
+
+    def add(self, e):
+        self.exponents.add(float(e))
+
+    def chain(self, name, comment, needed):
+        """ Code for the powers 2, 3, ... of name(1) that are needed, from its squares and their products """
+        code = []
+        if not needed:
+            return code
+        computed = set([1])
+        k = 2
+        while k <= max(needed):
+            code.append('const double %s = %s*%s; // %s' % (name(k), name(k//2), name(k//2), comment(k)))
+            computed.add(k)
+            k *= 2
+        for a in sorted(set(needed) - computed):
+            bits = [1 << b for b in range(a.bit_length()) if a & (1 << b)]
+            code.append('const double %s = %s; // %s' % (name(a), '*'.join(name(b) for b in reversed(bits)), comment(a)))
+        return code
+
+    def setup(self):
+        x = self.variable
+        fractions = dict((e, Fraction(e)) for e in self.exponents if Fraction(e).denominator <= max_root_denominator)
+        q = max([1] + [f.denominator for f in fractions.values()])
+        self.code = []
+        self.names = {}
+
+        # Integer powers of the variable, and of its q-th root
+        integer_parts = dict((e, int(abs(f)*q)//q) for e, f in fractions.items())
+        root_parts = dict((e, int(abs(f)*q) % q) for e, f in fractions.items())
+        power_name = lambda k: x if k == 1 else '%s_%d' % (x, k)
+        root_name = lambda k: '%s_r%d' % (x, k)
+        self.code += self.chain(power_name, lambda k: '%s^%d' % (x, k), [k for k in integer_parts.values() if k > 1])
+        if q > 1:
+            root = x
+            for i in range({2: 1, 4: 2, 8: 3}[q]):
+                root = 'sqrt(%s)' % root
+            self.code.append('const double %s = %s; // %s^(1/%d)' % (root_name(1), root, x, q))
+            self.code += self.chain(root_name, lambda k: '%s^(%s)' % (x, Fraction(k, q)), [k for k in root_parts.values() if k > 1])
+        for e, f in sorted(fractions.items()):
+            factors = []
+            if integer_parts[e] > 0:
+                factors.append(power_name(integer_parts[e]))
+            if root_parts[e] > 0:
+                factors.append(root_name(root_parts[e]))
+            if not factors:
+                self.names[e] = '1.0'
+            elif f > 0:
+                self.names[e] = '*'.join(factors)
+            else:
+                self.names[e] = '%s_m%s' % (x, str(-f).replace('/', '_'))
+                self.code.append('const double %s = 1/(%s); // %s^(%s)' % (self.names[e], '*'.join(factors), x, f))
+
+        # Any other powers
+        others = sorted(e for e in self.exponents if e not in fractions)
+        if others:
+            self.code.append('const double log_%s = log(%s);' % (x, x))
+        for i, e in enumerate(others):
+            self.names[e] = '%s_pow%d' % (x, i)
+            self.code.append('const double %s = exp(%s*log_%s); // %s^%s' % (self.names[e], literal(e), x, x, literal(e)))
+
+    def __getitem__(self, e):
+        return self.names[float(e)]
+
+def terms_of(fluid):
+    """
+    The generalized exponential terms of the first equation of state of the fluid, as they are converted in
+    the add_* functions of ResidualHelmholtzGeneralizedExponential, dropping the parts of u that pack() drops
+    """
+    terms = []
+    for contribution in fluid['EOS'][0]['alphar']:
+        type = contribution['type']
+        if type in ('ResidualHelmholtzNonAnalytic', 'ResidualHelmholtzAssociating'):
+            # Evaluated by their own classes
+            continue
+        N = len(contribution['n'])
+        for i in range(N):
+            get = lambda key: float(contribution[key][i])
+            term = dict(n=get('n'), d=get('d'), t=get('t'), delta_part=None, tau_part=None, gaussian=None)
+            if type == 'ResidualHelmholtzPower':
+                l = get('l')
+                term['delta_part'] = (1.0, l)
+            elif type == 'ResidualHelmholtzExponential':
+                term['delta_part'] = (get('g'), get('l'))
+            elif type == 'ResidualHelmholtzLemmon2005':
+                term['delta_part'] = (1.0, get('l'))
+                m = get('m')
+                if abs(m) > 0:
+                    term['tau_part'] = (1.0, m)
+            elif type == 'ResidualHelmholtzGaussian':
+                eta, epsilon, beta, gamma = get('eta'), get('epsilon'), get('beta'), get('gamma')
+                eta_in_u = valid(eta) and eta != 0
+                beta_in_u = valid(beta) and beta != 0
+                if eta_in_u or beta_in_u:
+                    term['gaussian'] = (eta if eta_in_u else 0.0, epsilon if eta_in_u else 0.0, beta if beta_in_u else 0.0, gamma if beta_in_u else 0.0)
+            else:
+                raise ValueError('Residual Helmholtz term of type %s is not supported' % type)
+            if term['delta_part'] is not None:
+                c, l = term['delta_part']
+                if not (valid(l) and int(l) > 0):
+                    term['delta_part'] = None
+                else:
+                    # delta^l is calculated as pow(delta, (int)l), and l itself is used for the derivatives
+                    term['delta_part'] = (c, l, int(l))
+            terms.append(term)
+    return terms
+
+def generate_kernel(name, fluid):
+    """ The code of the kernel for one fluid """
+    identifier = 'fluid_' + re.sub('[^0-9a-zA-Z_]', '_', name)
+    terms = terms_of(fluid)
+
+    tau_powers = Powers('tau')
+    delta_powers = Powers('delta')
+    for term in terms:
+        tau_powers.add(term['t'])
+        delta_powers.add(term['d'])
+        if term['delta_part'] is not None:
+            delta_powers.add(term['delta_part'][2])
+        if term['tau_part'] is not None:
+            tau_powers.add(term['tau_part'][1])
+    tau_powers.setup()
+    delta_powers.setup()
+
+    lines = []
+    lines.append('// Powers of tau and delta')
+    lines += tau_powers.code + delta_powers.code
+
+    # The parts of u that are shared between terms: -c*delta^l and -omega*tau^m, with their derivatives
+    delta_parts, tau_parts, exps = {}, {}, {}
+    def u_part(parts, part, variable, powers):
+        if part not in parts:
+            coefficient, exponent, power = part[0], part[1], part[-1]
+            p = '%s%d' % (variable[0], len(parts))
+            lines.append('// u = -%s*%s^%s' % (literal(coefficient), variable, literal(exponent)))
+            value = powers[power] if coefficient == 1 else '%s*%s' % (literal(coefficient), powers[power])
+            lines.append('const double u_%s = -%s;' % (p, value))
+            # The derivatives, up to the first one that is zero (if l or m is an integer, those after the l-th or m-th are)
+            previous, names = 'u_%s' % p, []
+            for order in range(1, 5):
+                factor = exponent - (order - 1)
+                if factor == 0:
+                    break
+                name = 'd%su_%s' % ('' if order == 1 else order, p)
+                if factor == 1:
+                    lines.append('const double %s = %s*one_over_%s;' % (name, previous, variable))
+                else:
+                    lines.append('const double %s = %s*%s*one_over_%s;' % (name, literal(factor), previous, variable))
+                names.append(name)
+                previous = name
+            parts[part] = (p, names)
+        return parts[part]
+
+    lines.append('double s[NUMBER_OF_SUMS] = {0};')
+    for i, term in enumerate(terms):
+        # u, and its derivatives of orders 1 to 4 with respect to delta and tau, as sums of parts
+        u, du_ddelta, du_dtau, code = [], [[] for order in range(4)], [[] for order in range(4)], []
+        if term['delta_part'] is not None:
+            p, names = u_part(delta_parts, term['delta_part'], 'delta', delta_powers)
+            u.append('u_%s' % p)
+            for order, derivative in enumerate(names):
+                du_ddelta[order].append(derivative)
+        if term['tau_part'] is not None:
+            p, names = u_part(tau_parts, term['tau_part'], 'tau', tau_powers)
+            u.append('u_%s' % p)
+            for order, derivative in enumerate(names):
+                du_dtau[order].append(derivative)
+        if term['gaussian'] is not None:
+            eta, epsilon, beta, gamma = term['gaussian']
+            if eta != 0:
+                code.append('const double x_delta = delta - %s;' % literal(epsilon))
+                u.append('-%s*x_delta*x_delta' % literal(eta))
+                du_ddelta[0].append('-2*%s*x_delta' % literal(eta)); du_ddelta[1].append('-2*%s' % literal(eta))
+            if beta != 0:
+                code.append('const double x_tau = tau - %s;' % literal(gamma))
+                u.append('-%s*x_tau*x_tau' % literal(beta))
+                du_dtau[0].append('-2*%s*x_tau' % literal(beta)); du_dtau[1].append('-2*%s' % literal(beta))
+        # The highest derivatives of u that are not zero, so that add_term() can leave out the others
+        delta_order = max([0] + [order + 1 for order in range(4) if du_ddelta[order]])
+        tau_order = max([0] + [order + 1 for order in range(4) if du_dtau[order]])
+        du_ddelta = [' + '.join(parts) if parts else '0.0' for parts in du_ddelta]
+        du_dtau = [' + '.join(parts) if parts else '0.0' for parts in du_dtau]
+        factors = [literal(term['n'])]
+        for power in (tau_powers[term['t']], delta_powers[term['d']]):
+            if power != '1.0':
+                factors.append(power)
+        if u:
+            key = ' + '.join(u)
+            if term['gaussian'] is not None:
+                code.append('const double exp_u = exp(%s);' % key)
+                factors.append('exp_u')
+            else:
+                if key not in exps:
+                    exps[key] = 'exp_u%d' % len(exps)
+                    lines.append('const double %s = exp(%s);' % (exps[key], key))
+                factors.append(exps[key])
+        lines.append('{ // Term %d' % i)
+        for c in code:
+            lines.append('    ' + c)
+        lines.append('    add_term<max_order, %d, %d>(s, %s, %s, %s, tau, delta, %s, %s);' % (delta_order, tau_order, '*'.join(factors), literal(term['d']), literal(term['t']), ', '.join(du_ddelta), ', '.join(du_dtau)))
+        lines.append('}')
+    lines.append('add_sums<max_order>(s, one_over_tau, one_over_delta, derivs);')
+
+    out = []
+    out.append('')
+    out.append('/// The %d generalized exponential terms of %s' % (len(terms), name))
+    out.append('template<int max_order>')
+    out.append('void %s_terms(const double tau, const double delta, HelmholtzDerivatives &derivs)' % identifier)
+    out.append('{')
+    out.append('    const double one_over_tau = 1/tau, one_over_delta = 1/delta;')
+    out += ['    ' + l for l in lines]
+    out.append('}')
+    out.append('void %s_kernel(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs, const int max_order)' % identifier)
+    out.append('{')
+    out.append('    if (max_order < 1){ %s_terms<0>(tau, delta, derivs); }' % identifier)
+    out.append('    else if (max_order < 2){ %s_terms<1>(tau, delta, derivs); }' % identifier)
+    out.append('    else if (max_order < 3){ %s_terms<2>(tau, delta, derivs); }' % identifier)
+    out.append('    else if (max_order < 4){ %s_terms<3>(tau, delta, derivs); }' % identifier)
+    out.append('    else{ %s_terms<4>(tau, delta, derivs); }' % identifier)
+    out.append('}')
+    return identifier, '\n'.join(out) + '\n'
+
+def load_fluids():
+    fluids = {}
+    for path in glob.glob(os.path.join(repo_root_path, 'dev', 'fluids', '*.json')):
+        with open(path, 'r') as fp:
+            fluid = json.load(fp)
+        fluids[fluid['NAME']] = fluid
+    return fluids
+
+def generate(output, names):
+    fluids = load_fluids()
+    code = header
+    registry = ''
+    for name in names:
+        if name not in fluids:
+            raise ValueError('There is no fluid named %s in dev/fluids' % name)
+        identifier, kernel = generate_kernel(name, fluids[name])
+        code += kernel
+        registry += '    if (fluid_name == "%s"){ return %s_kernel; }\n' % (name, identifier)
+    code += footer.replace('{registry}', registry)
+
+    # Only write the file if it has changed, so that it is not compiled again for nothing
+    if os.path.exists(output):
+        with open(output, 'r') as fp:
+            if fp.read() == code:
+                print('%s is up to date' % output)
+                return
+    with open(output, 'w') as fp:
+        fp.write(code)
+    print('Generated kernels for %s in %s' % (', '.join(names), output))
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+    generate(sys.argv[1], sys.argv[2:])
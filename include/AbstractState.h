@@ -400,6 +400,16 @@ public:
      */
     static AbstractState * factory(const std::string &backend, const std::vector<std::string> &fluid_names);
 
+    /**
+     * @brief Make a new-allocated copy of this state, including its composition and current thermodynamic state
+     *
+     * None of the set-up done by factory() (fluid lookup, mixture parameters, loading of tables, ...) is repeated, which makes this
+     * the cheap way to generate a pool of states for multiple threads.  The copy can be updated independently of this state.
+     *
+     * Very Important!! : Use a smart pointer to manage the pointer returned.
+     */
+    virtual AbstractState * clone(){ throw NotImplementedError("clone is not implemented for this backend"); };
+
     /// Set the internal variable T without a flash call (expert use only!)
     void set_T(CoolPropDbl T){ _T = T; }
 
@@ -458,6 +468,25 @@ public:
     /// Some or all of the guesses will be used - this is backend dependent
     virtual void update_with_guesses(CoolProp::input_pairs input_pair, double Value1, double Value2, const GuessesStructure &guesses){ throw NotImplementedError("update_with_guesses is not implemented for this backend"); };
 
+    /**
+     * @brief Update the state for each of a set of state points, and evaluate a set of keyed outputs at each point
+     *
+     * This is equivalent to calling update() followed by keyed_output() for each of the outputs at each of the
+     * state points, but backends can re-implement this function to provide a specialized loop.  If the update
+     * or an output fails at a state point, the corresponding entries are set to _HUGE and the next point is
+     * calculated.
+     *
+     * @param input_pair Integer key from CoolProp::input_pairs to the two inputs that will be passed to the function
+     * @param Value1 Array of first input values (of length N)
+     * @param Value2 Array of second input values (of length N)
+     * @param N The number of state points
+     * @param outputs Array of keys from CoolProp::parameters for the outputs (of length Nout)
+     * @param Nout The number of outputs
+     * @param out Array for the outputs (of length N*Nout); the j-th output at the i-th state point is stored in out[i*Nout+j]
+     * @param first_error If not NULL, set to the error message of the first update or output that failed, or left as it is if none failed
+     */
+    virtual void update_many(CoolProp::input_pairs input_pair, const double *Value1, const double *Value2, std::size_t N, const parameters *outputs, std::size_t Nout, double *out, std::string *first_error = NULL);
+
     /// A function that says whether the backend instance can be instantiated in the high-level interface
     /// In general this should be true, except for some other backends (especially the tabular backends)
     /// To disable use in high-level interface, implement this function and return false
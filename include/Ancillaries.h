@@ -25,8 +25,7 @@ class SurfaceTensionCorrelation
 {
 public:
     std::vector<CoolPropDbl> a, ///< the leading coefficients a_i
-                             n, ///< the powers n_i
-                             s; ///< a summation buffer
+                             n; ///< the powers n_i
     CoolPropDbl Tc; ///< critical temperature in K
     std::size_t N; ///< number of a_i, n_i pairs
     std::string BibTeX; ///< The BiBTeX key for the surface tension curve in use
@@ -41,18 +40,19 @@ public:
         BibTeX = cpjson::get_string(json_code,"BibTeX");
 
         this->N = n.size();
-        s = n;
     };
     /// Actually evaluate the surface tension equation
     CoolPropDbl evaluate(CoolPropDbl T)
     {
         if (a.empty()){ throw NotImplementedError(format("surface tension curve not provided"));}
         CoolPropDbl THETA = 1-T/Tc;
+        // Summed without a member buffer, since the correlation is shared by all the states that use the fluid
+        double summer = 0;
         for (std::size_t i = 0; i < N; ++i)
         {
-            s[i] = a[i]*pow(THETA, n[i]);
+            summer += a[i]*pow(THETA, n[i]);
         }
-        return std::accumulate(s.begin(), s.end(), 0.0);
+        return summer;
     }
 };
 /**
@@ -84,7 +84,7 @@ class SaturationAncillaryFunction
 private:
     Eigen::MatrixXd num_coeffs, ///< Coefficients for numerator in rational polynomial 
                     den_coeffs; ///< Coefficients for denominator in rational polynomial
-    std::vector<double> n, t, s; // For TYPE_NOT_EXPONENTIAL & TYPE_EXPONENTIAL
+    std::vector<double> n, t; // For TYPE_NOT_EXPONENTIAL & TYPE_EXPONENTIAL
     union{
         CoolPropDbl max_abs_error; ///< For TYPE_RATIONAL_POLYNOMIAL
         struct{                    // For TYPE_NOT_EXPONENTIAL & TYPE_EXPONENTIAL
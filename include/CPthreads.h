@@ -0,0 +1,213 @@
+#ifndef CPTHREADS_H
+#define CPTHREADS_H
+
+#include "PlatformDetermination.h"
+
+#if defined(__ISWINDOWS__)
+    // Keep the min and max macros and the rarely used parts of the Windows API out of every file that includes this header
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+namespace CoolProp{
+
+/** \brief A mutex that works with any compiler, whether or not it supports C++11
+ *
+ * On Windows this is a slim reader/writer lock (used only in exclusive mode), elsewhere it is a pthreads mutex;
+ * lock it with a ScopedLock rather than by hand so that it is released when an exception is thrown.
+ */
+class Mutex{
+private:
+    #if defined(__ISWINDOWS__)
+        SRWLOCK handle;
+    #else
+        pthread_mutex_t handle;
+    #endif
+    Mutex(const Mutex &);
+    Mutex & operator=(const Mutex &);
+    friend class ConditionVariable;
+public:
+    #if defined(__ISWINDOWS__)
+        Mutex(){ InitializeSRWLock(&handle); };
+        ~Mutex(){};
+        void lock(){ AcquireSRWLockExclusive(&handle); };
+        void unlock(){ ReleaseSRWLockExclusive(&handle); };
+    #else
+        Mutex(){ pthread_mutex_init(&handle, NULL); };
+        ~Mutex(){ pthread_mutex_destroy(&handle); };
+        void lock(){ pthread_mutex_lock(&handle); };
+        void unlock(){ pthread_mutex_unlock(&handle); };
+    #endif
+};
+
+/// Holds a Mutex locked for as long as it is in scope
+class ScopedLock{
+private:
+    Mutex &mutex;
+    ScopedLock(const ScopedLock &);
+    ScopedLock & operator=(const ScopedLock &);
+public:
+    explicit ScopedLock(Mutex &mutex) : mutex(mutex) { mutex.lock(); };
+    ~ScopedLock(){ mutex.unlock(); };
+};
+
+/** \brief A condition variable that is used together with a Mutex
+ *
+ * As for any condition variable, wait() can return spuriously, so it must be called in a loop that checks the condition.
+ */
+class ConditionVariable{
+private:
+    #if defined(__ISWINDOWS__)
+        CONDITION_VARIABLE handle;
+    #else
+        pthread_cond_t handle;
+    #endif
+    ConditionVariable(const ConditionVariable &);
+    ConditionVariable & operator=(const ConditionVariable &);
+public:
+    #if defined(__ISWINDOWS__)
+        ConditionVariable(){ InitializeConditionVariable(&handle); };
+        ~ConditionVariable(){};
+        /// Release the mutex (which must be locked by this thread), wait to be notified, and lock the mutex again
+        void wait(Mutex &mutex){ SleepConditionVariableSRW(&handle, &(mutex.handle), INFINITE, 0); };
+        void notify_all(){ WakeAllConditionVariable(&handle); };
+    #else
+        ConditionVariable(){ pthread_cond_init(&handle, NULL); };
+        ~ConditionVariable(){ pthread_cond_destroy(&handle); };
+        /// Release the mutex (which must be locked by this thread), wait to be notified, and lock the mutex again
+        void wait(Mutex &mutex){ pthread_cond_wait(&handle, &(mutex.handle)); };
+        void notify_all(){ pthread_cond_broadcast(&handle); };
+    #endif
+};
+
+/** \brief A value of which each thread has its own copy
+ *
+ * The copy for a thread is default-constructed the first time that thread calls get(), and is destroyed when the
+ * thread exits.  The thread-local storage slot itself is never released, so that a ThreadLocal with static storage
+ * duration can still be used while other static objects are being destroyed.
+ */
+template<class T> class ThreadLocal{
+private:
+    #if defined(__ISWINDOWS__)
+        DWORD key;
+        static void WINAPI destroy(void *value){ delete static_cast<T *>(value); };
+    #else
+        pthread_key_t key;
+        static void destroy(void *value){ delete static_cast<T *>(value); };
+    #endif
+    ThreadLocal(const ThreadLocal &);
+    ThreadLocal & operator=(const ThreadLocal &);
+public:
+    #if defined(__ISWINDOWS__)
+        ThreadLocal(){ key = FlsAlloc(&destroy); };
+        T & get(){
+            T *value = static_cast<T *>(FlsGetValue(key));
+            if (value == NULL){ value = new T(); FlsSetValue(key, value); }
+            return *value;
+        };
+    #else
+        ThreadLocal(){ pthread_key_create(&key, &destroy); };
+        T & get(){
+            T *value = static_cast<T *>(pthread_getspecific(key));
+            if (value == NULL){ value = new T(); pthread_setspecific(key, value); }
+            return *value;
+        };
+    #endif
+};
+
+/** \brief An int that can be read and written from several threads at once
+ *
+ * Reads and writes are atomic but impose no ordering on other memory operations, so this is meant for settings
+ * like the debug level, not for synchronizing threads.
+ */
+class AtomicInt{
+private:
+    #if defined(__ISWINDOWS__)
+        volatile LONG value;
+    #else
+        volatile int value;
+    #endif
+    AtomicInt(const AtomicInt &);
+    AtomicInt & operator=(const AtomicInt &);
+public:
+    explicit AtomicInt(int value) : value(value) {};
+    #if defined(__ISWINDOWS__)
+        int load() const { return static_cast<int>(InterlockedCompareExchange(const_cast<volatile LONG *>(&value), 0, 0)); };
+        void store(int v){ InterlockedExchange(&value, static_cast<LONG>(v)); };
+    #elif defined(__GNUC__)
+        int load() const { return __atomic_load_n(&value, __ATOMIC_RELAXED); };
+        void store(int v){ __atomic_store_n(&value, v, __ATOMIC_RELAXED); };
+    #else
+        int load() const { return value; };
+        void store(int v){ value = v; };
+    #endif
+};
+
+/** \brief Runs a function exactly once, however many threads ask for it at the same time
+ *
+ * The threads that call call() while the function is running wait until it has returned.  If the function throws, the
+ * exception is passed on to the caller and the function is run again by the next call.  The function must not call
+ * call() on the same Once.
+ */
+class Once{
+private:
+    Mutex mutex;
+    #if defined(__ISWINDOWS__)
+        volatile LONG done;
+        bool is_done(){ return InterlockedCompareExchange(&done, 0, 0) != 0; };
+        void set_done(){ InterlockedExchange(&done, 1); };
+    #elif defined(__GNUC__)
+        volatile int done;
+        bool is_done(){ return __atomic_load_n(&done, __ATOMIC_ACQUIRE) != 0; };
+        void set_done(){ __atomic_store_n(&done, 1, __ATOMIC_RELEASE); };
+    #else
+        volatile int done;
+        bool is_done(){ return false; }; // Without atomics the mutex is always taken
+        void set_done(){ done = 1; };
+    #endif
+    Once(const Once &);
+    Once & operator=(const Once &);
+public:
+    Once() : done(0) {};
+    void call(void (*function)(void *), void *argument){
+        if (is_done()){ return; }
+        ScopedLock lock(mutex);
+        if (done){ return; }
+        function(argument);
+        set_done();
+    };
+    void call(void (*function)()){
+        if (is_done()){ return; }
+        ScopedLock lock(mutex);
+        if (done){ return; }
+        function();
+        set_done();
+    };
+};
+
+/** \brief An object that is default-constructed the first time that get() is called, from whichever thread that is
+ *
+ * Like ThreadLocal, the object is never destroyed, so that it can still be used while other static objects are being destroyed.
+ */
+template<class T> class LazyInstance{
+private:
+    Once once;
+    T *instance;
+    static void construct(void *self){ static_cast<LazyInstance *>(self)->instance = new T(); };
+    LazyInstance(const LazyInstance &);
+    LazyInstance & operator=(const LazyInstance &);
+public:
+    LazyInstance() : instance(NULL) {};
+    T & get(){ once.call(&construct, this); return *instance; };
+};
+
+} /* namespace CoolProp */
+
+#endif
@@ -23,6 +23,7 @@
     X(CRITICAL_WITHIN_1UK, "CRITICAL_WITHIN_1UK", true, "If true, any temperature within 1 uK of the critical temperature will be considered to be AT the critical point") \
     X(CRITICAL_SPLINES_ENABLED, "CRITICAL_SPLINES_ENABLED", true, "If true, the critical splines will be used in the near-vicinity of the critical point") \
     X(SAVE_RAW_TABLES, "SAVE_RAW_TABLES", false, "If true, the raw, uncompressed tables will also be written to file") \
+    X(MEMORY_MAPPED_TABLES, "MEMORY_MAPPED_TABLES", true, "If true, the tables are also written in an uncompressed binary layout that is memory-mapped (rather than decompressed and unpacked) when the tables are loaded") \
     X(ALTERNATIVE_TABLES_DIRECTORY, "ALTERNATIVE_TABLES_DIRECTORY", "", "If provided, this path will be the root directory for the tabular data.  Otherwise, ${HOME}/.CoolProp/Tables is used") \
     X(ALTERNATIVE_REFPROP_PATH, "ALTERNATIVE_REFPROP_PATH", "", "An alternative path to be provided to the directory that contains REFPROP's fluids and mixtures directories.  If provided, the SETPATH function will be called with this directory prior to calling any REFPROP functions.") \
     X(ALTERNATIVE_REFPROP_HMX_BNC_PATH, "ALTERNATIVE_REFPROP_HMX_BNC_PATH", "", "An alternative path to the HMX.BNC file.  If provided, it will be passed into REFPROP's SETUP or SETMIX routines") \
@@ -30,6 +31,16 @@
     X(MAXIMUM_TABLE_DIRECTORY_SIZE_IN_GB, "MAXIMUM_TABLE_DIRECTORY_SIZE_IN_GB", 1.0, "The maximum allowed size of the directory that is used to store tabular data") \
     X(DONT_CHECK_PROPERTY_LIMITS, "DONT_CHECK_PROPERTY_LIMITS", false, "If true, when possible, CoolProp will skip checking whether values are inside the property limits") \
 	X(HENRYS_LAW_TO_GENERATE_VLE_GUESSES, "HENRYS_LAW_TO_GENERATE_VLE_GUESSES", false, "If true, when doing water-based mixture dewpoint calculations, use Henry's Law to generate guesses for liquid-phase composition") \
+    X(PROPSSIMULTI_NUMBER_OF_THREADS, "PROPSSIMULTI_NUMBER_OF_THREADS", 1.0, "The number of threads used by PropsSImulti to evaluate the state points; 1 is serial, 0 uses all available threads.  Only used if CoolProp is built with OpenMP") \
+    X(HAPROPSSIMULTI_NUMBER_OF_THREADS, "HAPROPSSIMULTI_NUMBER_OF_THREADS", 1.0, "The number of threads used by HAPropsSImulti to evaluate the state points; 1 is serial, 0 uses all available threads.  Only used if CoolProp is built with OpenMP") \
+    X(HAPROPSSI_TABULAR, "HAPROPSSI_TABULAR", false, "If true, HAPropsSI and HAPropsSImulti interpolate in tables of the humid air properties, which are built once for the limits given by the HUMID_AIR_TABLE_* keys and cached with the other tables.  Points outside the tables, or in cells that are not accurate enough, are calculated in full") \
+    X(HUMID_AIR_TABLE_TMIN, "HUMID_AIR_TABLE_TMIN", 243.15, "The lowest dry-bulb temperature in the humid air tables, in K") \
+    X(HUMID_AIR_TABLE_TMAX, "HUMID_AIR_TABLE_TMAX", 333.15, "The highest dry-bulb temperature in the humid air tables, in K") \
+    X(HUMID_AIR_TABLE_WMAX, "HUMID_AIR_TABLE_WMAX", 0.05, "The highest humidity ratio in the humid air tables, in kg water/kg dry air; the tables start at dry air") \
+    X(HUMID_AIR_TABLE_PMIN, "HUMID_AIR_TABLE_PMIN", 101325.0, "The lowest pressure in the humid air tables, in Pa") \
+    X(HUMID_AIR_TABLE_PMAX, "HUMID_AIR_TABLE_PMAX", 101325.0, "The highest pressure in the humid air tables, in Pa; if it is equal to HUMID_AIR_TABLE_PMIN, the tables are only used at that pressure") \
+    X(HUMID_AIR_TABLE_TOLERANCE, "HUMID_AIR_TABLE_TOLERANCE", 1e-4, "The largest estimated relative error of a cell of the humid air tables that is used; read when the tables are first loaded") \
+    X(TABLE_BUILD_NUMBER_OF_THREADS, "TABLE_BUILD_NUMBER_OF_THREADS", 0.0, "The number of threads used to build the tables for the tabular backends; 1 is serial, 0 uses all available threads.  Only used if CoolProp is built with OpenMP") \
 
  // Use preprocessor to create the Enum
  enum configuration_keys{
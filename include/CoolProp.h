@@ -61,10 +61,10 @@ You might want to start by looking at CoolProp.h
     /// @param level The level of the verbosity for the debugging output (0-10) 0: no debgging output
     void set_debug_level(int level);
 
-    /// Set the global error string 
+    /// Set the error string of the calling thread
     /// @param error The error string to use
     void set_error_string(const std::string &error);
-    /// An internal function to set the global warning string
+    /// An internal function to set the warning string of the calling thread
     /// @param warning The string to set as the warning string
     void set_warning_string(const std::string &warning);
     
@@ -80,6 +80,7 @@ You might want to start by looking at CoolProp.h
 
     /// Get a globally-defined string
     /// @param ParamName A string, one of "version", "errstring", "warnstring", "gitrevision", "FluidsList", "fluids_list", "parameter_list","predefined_mixtures"
+    /// \note "errstring" and "warnstring" are kept per thread; they return (and clear) the last error or warning raised on the calling thread
     /// @returns str The string, or an error message if not valid input
     std::string get_global_param_string(const std::string &ParamName);
 
@@ -156,6 +157,17 @@ You might want to start by looking at CoolProp.h
     /// \note Returns empty string if there was an error; use get_global_param_string("errstring") to retrieve the error
     std::string PhaseSI(const std::string &Name1, double Prop1, const std::string &Name2, double Prop2, const std::string &FluidName);
     
+    /**
+     * @brief Load the fluid libraries and set up the given fluids ahead of time, so that the first real call does not have to
+     * 
+     * Each fluid string is given as to PropsSI ("Water", "HEOS::R32[0.5]&R125[0.5]", "INCOMP::MEG-20%", "BICUBIC&HEOS::R245fa", ...);
+     * a state is made for each of them, which parses the fluids and, for the tabular backends, loads or builds the tables.
+     * The libraries are only ever loaded once, so this may be called from any thread, and more than once.
+     * @param fluids The fluid strings
+     * \note Throws ValueError if a state cannot be made for one of the fluids
+     */
+    void warm_up(const std::vector<std::string> &fluids);
+
     /**
      * @brief Extract the backend from a string - something like "HEOS::Water" would split to "HEOS" and "Water".  If no backend is specified, the backend will be set to "?"
      * @param fluid_string The input string
@@ -387,8 +387,9 @@
         T dL3_dx = (1/(x-x0) + 1/(x-x1) + 1/(x-x2) )*L3;
         return dL0_dx*f0 + dL1_dx*f1 + dL2_dx*f2 + dL3_dx*f3;
     };
-    template<class T1, class T2> T2 CubicInterp(const std::vector<T1> &x, const std::vector<T1> &y, std::size_t i0, std::size_t i1, std::size_t i2, std::size_t i3, T2 val)
+    template<class Vector, class T2> T2 CubicInterp(const Vector &x, const Vector &y, std::size_t i0, std::size_t i1, std::size_t i2, std::size_t i3, T2 val)
     {
+        typedef typename Vector::value_type T1;
         return CubicInterp(x[i0],x[i1],x[i2],x[i3],y[i0],y[i1],y[i2],y[i3],static_cast<T1>(val));
     };
 
@@ -566,11 +567,11 @@ template <typename T> std::vector<T> logspace(T xmin, T xmax, std::size_t n) {
  * @brief Use bisection to find the inputs that bisect the value you want, the trick
  * here is that this function is allowed to have "holes" where parts of the the array are 
  * also filled with invalid numbers for which ValidNumber(x) is false
- * @param vec The vector to be bisected
+ * @param vec The vector to be bisected (any container with size() and operator[])
  * @param val The value to be found
  * @param i The index to the left of the final point; i and i+1 bound the value
  */
-template <typename T> void bisect_vector(const std::vector<T> &vec, T val, std::size_t &i)
+template <typename Vector, typename T> void bisect_vector(const Vector &vec, T val, std::size_t &i)
 {
     T rL, rM, rR;
     std::size_t N = vec.size(), L = 0, R = N-1, M = (L+R)/2;
@@ -634,15 +635,15 @@ template <typename T> void bisect_vector(const std::vector<T> &vec, T val, std::
  * @brief Use bisection to find the inputs that bisect the value you want, the trick
  * here is that this function is allowed to have "holes" where parts of the the array are 
  * also filled with invalid numbers for which ValidNumber(x) is false
- * @param matrix The vector to be bisected
+ * @param mat The matrix to be bisected (any container with size() and mat[i][j] indexing)
  * @param j The index of the matric in the off-grain dimension
  * @param val The value to be found
  * @param i The index to the left of the final point; i and i+1 bound the value
  */
-template <typename T> void bisect_segmented_vector_slice(const std::vector<std::vector<T> > &mat, std::size_t j, T val, std::size_t &i)
+template <typename Matrix, typename T> void bisect_segmented_vector_slice(const Matrix &mat, std::size_t j, T val, std::size_t &i)
 {
     T rL, rM, rR;
-    std::size_t N = mat[j].size(), L = 0, R = N-1, M = (L+R)/2;
+    std::size_t N = mat.size(), L = 0, R = N-1, M = (L+R)/2;
     // Move the right limits in until they are good
     while (!ValidNumber(mat[R][j])){
         if (R == 1){ throw CoolProp::ValueError("All the values in bisection vector are invalid"); }
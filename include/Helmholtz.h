@@ -159,10 +159,73 @@ struct HelmholtzDerivatives
         #undef X
         return _new;
     }
+    /// True if each of the derivatives is within rtol*|other| + atol of the one in other
+    bool is_close(const HelmholtzDerivatives &other, CoolPropDbl rtol, CoolPropDbl atol) const
+    {
+        #define X(name)  if (!(std::abs(name - other.name) <= rtol*std::abs(other.name) + atol)){ return false; }
+            LIST_OF_DERIVATIVE_VARIABLES
+        #undef X
+        return true;
+    }
     HelmholtzDerivatives(){reset(0.0);};
 };
+
+/** \brief The derivatives of the Helmholtz energy at a number of points, stored structure-of-arrays
+ *
+ * Element i of each of the vectors is the corresponding member of the HelmholtzDerivatives at point i.
+ */
+struct HelmholtzDerivativesArrays
+{
+    #define X(name)  std::vector<CoolPropDbl> name;
+        LIST_OF_DERIVATIVE_VARIABLES
+    #undef X
+
+    HelmholtzDerivativesArrays(){};
+    explicit HelmholtzDerivativesArrays(std::size_t N){ resize(N); };
+    /// Set the number of points, and set all the derivatives at all of them to zero
+    void resize(std::size_t N){
+        #define X(name)  name.assign(N, 0.0);
+            LIST_OF_DERIVATIVE_VARIABLES
+        #undef X
+    }
+    std::size_t size() const { return alphar.size(); };
+    /// The derivatives at point i
+    HelmholtzDerivatives get(std::size_t i) const
+    {
+        HelmholtzDerivatives derivs;
+        #define X(name)  derivs.name = name[i];
+            LIST_OF_DERIVATIVE_VARIABLES
+        #undef X
+        return derivs;
+    }
+    /// Add derivs*factor to the derivatives at point i
+    void add(std::size_t i, const HelmholtzDerivatives &derivs, CoolPropDbl factor = 1.0)
+    {
+        #define X(name)  name[i] += derivs.name*factor;
+            LIST_OF_DERIVATIVE_VARIABLES
+        #undef X
+    }
+    /// Add other*factor to the derivatives at all the points; other must have the same number of points
+    void add(const HelmholtzDerivativesArrays &other, CoolPropDbl factor = 1.0)
+    {
+        for (std::size_t i = 0; i < other.size(); ++i){
+            #define X(name)  name[i] += other.name[i]*factor;
+                LIST_OF_DERIVATIVE_VARIABLES
+            #undef X
+        }
+    }
+};
 #undef LIST_OF_DERIVATIVE_VARIABLES
 
+/** \brief A kernel for the generalized exponential terms of one fluid, generated ahead of time by dev/generate_kernels.py
+ *
+ * It adds the contributions of the terms to derivs, just as ResidualHelmholtzGeneralizedExponential::all() does.
+ */
+typedef void (*GeneratedHelmholtzKernel)(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs, const int max_order);
+
+/// The kernel generated for the fluid with this name, or NULL if there is none; only defined if the library is built with COOLPROP_GENERATED_KERNELS
+GeneratedHelmholtzKernel get_generated_helmholtz_kernel(const std::string &fluid_name);
+
 struct ResidualHelmholtzGeneralizedExponentialElement
 {
     /// These variables are for the n*delta^d_i*tau^t_i part
@@ -182,6 +245,30 @@ struct ResidualHelmholtzGeneralizedExponentialElement
         l_int = 0; m_int = 0;
     }
 };
+/** \brief The terms of one family of a ResidualHelmholtzGeneralizedExponential, stored structure-of-arrays
+ *
+ * The terms are grouped by which parts of u they have, so that each family can be evaluated by a loop without any
+ * branches.  The arrays are padded with terms that contribute nothing (n = 0) to a multiple of
+ * ResidualHelmholtzGeneralizedExponential::block_size, so that the terms can always be evaluated a whole block at a time.
+ */
+struct ResidualHelmholtzGeneralizedExponentialFamily
+{
+    enum family_type{
+        FAMILY_POWER,       ///< u = 0
+        FAMILY_EXPONENTIAL, ///< u = -c*delta^l
+        FAMILY_GAUSSIAN,    ///< u = -eta1*(delta-epsilon1)-eta2*(delta-epsilon2)^2-beta1*(tau-gamma1)-beta2*(tau-gamma2)^2
+        FAMILY_GENERAL      ///< Any other combination of the parts of u
+    };
+    family_type type;
+    /// The coefficients of the terms; parts of u that a term does not have are zero
+    std::vector<double> n, d, t, c, l_int, l_double, omega, m, eta1, epsilon1, eta2, epsilon2, beta1, gamma1, beta2, gamma2;
+
+    explicit ResidualHelmholtzGeneralizedExponentialFamily(family_type type) : type(type) {};
+    std::size_t size() const { return n.size(); };
+    /// Add a term, the parts of u that are not in this family being left out
+    void push_back(const ResidualHelmholtzGeneralizedExponentialElement &el, bool delta_l, bool tau_m, bool eta1_in_u, bool eta2_in_u, bool beta1_in_u, bool beta2_in_u);
+};
+
 /** \brief A generalized residual helmholtz energy container that can deal with a wide range of terms which can be converted to this general form
  * 
  * \f$ \alpha^r=\sum_i n_i \delta^{d_i} \tau^{t_i}\exp(u_i) \f$
@@ -196,20 +283,19 @@ public:
     bool delta_li_in_u, tau_mi_in_u, eta1_in_u, eta2_in_u, beta1_in_u, beta2_in_u, finished;
     std::vector<CoolPropDbl> s;
     std::size_t N;
+    /// The kernel generated for these terms that all() at a single point uses in their place, or NULL if there is none (see set_kernel())
+    GeneratedHelmholtzKernel kernel;
     
-    // These variables are for the exp(u) part
-    // u is given by -c*delta^l_i-omega*tau^m_i-eta1*(delta-epsilon1)-eta2*(delta-epsilon2)^2-beta1*(tau-gamma1)-beta2*(tau-gamma2)^2
-    std::vector<double> n,d,t,c, l_double, omega, m_double, eta1, epsilon1, eta2, epsilon2, beta1, gamma1, beta2, gamma2;
-    // If l_i or m_i are integers, we will store them as integers in order to call pow(double, int) rather than pow(double, double)
-    std::vector<int> l_int, m_int;
-    
-    Eigen::ArrayXd uE, du_ddeltaE, du_dtauE, d2u_ddelta2E, d2u_dtau2E, d3u_ddelta3E, d3u_dtau3E;
-        
+    /// The number of terms (or, for many points, of points) that all() evaluates at a time; the terms of each family are padded to a multiple of this
+    enum { block_size = 8 };
+
     std::vector<ResidualHelmholtzGeneralizedExponentialElement> elements;
+    /// The elements, regrouped by family by pack()
+    std::vector<ResidualHelmholtzGeneralizedExponentialFamily> families;
     // Default Constructor
     ResidualHelmholtzGeneralizedExponential()
         : delta_li_in_u(false),tau_mi_in_u(false),eta1_in_u(false),
-          eta2_in_u(false),beta1_in_u(false),beta2_in_u(false),finished(false), N(0) {};
+          eta2_in_u(false),beta1_in_u(false),beta2_in_u(false),finished(false), N(0), kernel(NULL) {};
     /** \brief Add and convert an old-style power (polynomial) term to generalized form
 	 * 
 	 * Term of the format
@@ -233,6 +319,7 @@ public:
             elements.push_back(el);
         }
         delta_li_in_u = true;
+        pack();
     };
 	/** \brief Add and convert an old-style exponential term to generalized form
 	 * 
@@ -255,6 +342,7 @@ public:
             elements.push_back(el);
         }
         delta_li_in_u = true;
+        pack();
     }
 	/** \brief Add and convert an old-style Gaussian term to generalized form
 	 * 
@@ -284,6 +372,7 @@ public:
         }
         eta2_in_u = true;
         beta2_in_u = true;
+        pack();
     };
 	/** \brief Add and convert an old-style Gaussian term from GERG 2008 natural gas model to generalized form
 	 * 
@@ -312,6 +401,7 @@ public:
         }
         eta2_in_u = true;
         eta1_in_u = true;
+        pack();
     };
 	/** \brief Add and convert a term from Lemmon and Jacobsen (2005) used for R125
 	 * 
@@ -340,64 +430,52 @@ public:
         }
         delta_li_in_u = true;
         tau_mi_in_u = true;
+        pack();
     };
     
+    /// Called once all the terms have been added
     void finish(){
-        n.resize(elements.size()); d.resize(elements.size());
-        t.resize(elements.size()); c.resize(elements.size());
-		omega.resize(elements.size());
-        l_double.resize(elements.size()); l_int.resize(elements.size());
-		m_double.resize(elements.size()); m_int.resize(elements.size());
-        epsilon2.resize(elements.size()); eta2.resize(elements.size());
-        gamma2.resize(elements.size()); beta2.resize(elements.size());
-        
-        for (std::size_t i = 0; i < elements.size(); ++i){
-            n[i] = elements[i].n;
-            d[i] = elements[i].d;
-            t[i] = elements[i].t;
-            c[i] = elements[i].c;
-			omega[i] = elements[i].omega;
-            l_double[i] = elements[i].l_double;
-            l_int[i] = elements[i].l_int;
-			m_double[i] = elements[i].m_double;
-            m_int[i] = elements[i].m_int;
-            epsilon2[i] = elements[i].epsilon2;
-            eta2[i] = elements[i].eta2;
-            gamma2[i] = elements[i].gamma2;
-            beta2[i] = elements[i].beta2;
-        }
-        uE.resize(elements.size());
-        du_ddeltaE.resize(elements.size());
-        du_dtauE.resize(elements.size());
-        d2u_ddelta2E.resize(elements.size());
-        d2u_dtau2E.resize(elements.size());
-        d3u_ddelta3E.resize(elements.size());
-        d3u_dtau3E.resize(elements.size());
-        
+        pack();
         finished = true;
     };
+    /// Regroup the elements into families; called each time terms are added, which also drops the kernel, if any
+    void pack();
+    /** \brief Use a kernel generated ahead of time for these terms in all(), in place of the generic evaluation
+     *
+     * The kernel is first checked against the generic evaluation at a few points, and is only used if they agree, so that
+     * a kernel generated from other coefficients can never be used by mistake.  Passing NULL goes back to the generic evaluation.
+     * \return True if the kernel is used
+     */
+    bool set_kernel(GeneratedHelmholtzKernel kernel);
 
     void to_json(rapidjson::Value &el, rapidjson::Document &doc);
     
-    CoolPropDbl base(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.alphar;};
-    CoolPropDbl dDelta(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.dalphar_ddelta;};
-    CoolPropDbl dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.dalphar_dtau;};
-    CoolPropDbl dDelta2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d2alphar_ddelta2;};
-    CoolPropDbl dDelta_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d2alphar_ddelta_dtau;};
-    CoolPropDbl dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d2alphar_dtau2;};
-    CoolPropDbl dDelta3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d3alphar_ddelta3;};
-    CoolPropDbl dDelta2_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d3alphar_ddelta2_dtau;};
-    CoolPropDbl dDelta_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d3alphar_ddelta_dtau2;};
-    CoolPropDbl dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d3alphar_dtau3;};
-
-    CoolPropDbl dDelta4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d4alphar_ddelta4;};
-    CoolPropDbl dDelta3_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d4alphar_ddelta3_dtau;};
-    CoolPropDbl dDelta2_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d4alphar_ddelta2_dtau2;};
-    CoolPropDbl dDelta_dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d4alphar_ddelta_dtau3;};
-    CoolPropDbl dTau4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d4alphar_dtau4;};
+    CoolPropDbl base(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 0); return deriv.alphar;};
+    CoolPropDbl dDelta(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 1); return deriv.dalphar_ddelta;};
+    CoolPropDbl dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 1); return deriv.dalphar_dtau;};
+    CoolPropDbl dDelta2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 2); return deriv.d2alphar_ddelta2;};
+    CoolPropDbl dDelta_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 2); return deriv.d2alphar_ddelta_dtau;};
+    CoolPropDbl dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 2); return deriv.d2alphar_dtau2;};
+    CoolPropDbl dDelta3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 3); return deriv.d3alphar_ddelta3;};
+    CoolPropDbl dDelta2_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 3); return deriv.d3alphar_ddelta2_dtau;};
+    CoolPropDbl dDelta_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 3); return deriv.d3alphar_ddelta_dtau2;};
+    CoolPropDbl dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 3); return deriv.d3alphar_dtau3;};
+
+    CoolPropDbl dDelta4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 4); return deriv.d4alphar_ddelta4;};
+    CoolPropDbl dDelta3_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 4); return deriv.d4alphar_ddelta3_dtau;};
+    CoolPropDbl dDelta2_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 4); return deriv.d4alphar_ddelta2_dtau2;};
+    CoolPropDbl dDelta_dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 4); return deriv.d4alphar_ddelta_dtau3;};
+    CoolPropDbl dTau4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 4); return deriv.d4alphar_dtau4;};
     
-    void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw();
-    //void allEigen(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw();
+    /// Add the contributions of this term to derivs; only the derivatives up to max_order (0 to 4) are calculated, the others are left unchanged
+    void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs, const int max_order = 4) throw();
+    /** \brief Add the contributions of this term at each of the points (tau[i], delta[i]) to derivs, which must already have as many points as tau
+     *
+     * The points are evaluated block_size at a time, with each term loaded and set up once per block.
+     */
+    void all(const std::vector<CoolPropDbl> &tau, const std::vector<CoolPropDbl> &delta, HelmholtzDerivativesArrays &derivs, const int max_order = 4);
+    /// The same as all(), but evaluated one element at a time; this is the reference that the vectorized evaluation in all() is tested against
+    void all_reference(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs, const int max_order = 4) throw();
 };
 
 struct ResidualHelmholtzNonAnalyticElement
@@ -444,23 +522,23 @@ public:
 
     void to_json(rapidjson::Value &el, rapidjson::Document &doc);
 
-    CoolPropDbl base(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.alphar;};
-    CoolPropDbl dDelta(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.dalphar_ddelta;};
-    CoolPropDbl dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.dalphar_dtau;};
-    CoolPropDbl dDelta2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d2alphar_ddelta2;};
-    CoolPropDbl dDelta_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d2alphar_ddelta_dtau;}
-    CoolPropDbl dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d2alphar_dtau2;};
-    CoolPropDbl dDelta3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d3alphar_ddelta3;};
-    CoolPropDbl dDelta2_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d3alphar_ddelta2_dtau;};
-    CoolPropDbl dDelta_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d3alphar_ddelta_dtau2;};
-    CoolPropDbl dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d3alphar_dtau3;};
-    CoolPropDbl dTau4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_dtau4;};
-    CoolPropDbl dDelta_dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_ddelta_dtau3;};
-    CoolPropDbl dDelta2_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_ddelta2_dtau2;};
-    CoolPropDbl dDelta3_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_ddelta3_dtau;};
-    CoolPropDbl dDelta4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_ddelta4;};
+    CoolPropDbl base(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 0); return deriv.alphar;};
+    CoolPropDbl dDelta(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 1); return deriv.dalphar_ddelta;};
+    CoolPropDbl dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 1); return deriv.dalphar_dtau;};
+    CoolPropDbl dDelta2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 2); return deriv.d2alphar_ddelta2;};
+    CoolPropDbl dDelta_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 2); return deriv.d2alphar_ddelta_dtau;}
+    CoolPropDbl dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 2); return deriv.d2alphar_dtau2;};
+    CoolPropDbl dDelta3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 3); return deriv.d3alphar_ddelta3;};
+    CoolPropDbl dDelta2_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 3); return deriv.d3alphar_ddelta2_dtau;};
+    CoolPropDbl dDelta_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 3); return deriv.d3alphar_ddelta_dtau2;};
+    CoolPropDbl dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 3); return deriv.d3alphar_dtau3;};
+    CoolPropDbl dTau4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_dtau4;};
+    CoolPropDbl dDelta_dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_ddelta_dtau3;};
+    CoolPropDbl dDelta2_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_ddelta2_dtau2;};
+    CoolPropDbl dDelta3_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_ddelta3_dtau;};
+    CoolPropDbl dDelta4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_ddelta4;};
     
-    void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw();
+    void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs, const int max_order = 4) throw();
 };
 
 class ResidualHelmholtzSRK : public BaseHelmholtzTerm{
@@ -490,23 +568,23 @@ public:
 
     void to_json(rapidjson::Value &el, rapidjson::Document &doc);
 
-    CoolPropDbl base(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.alphar; };
-    CoolPropDbl dDelta(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.dalphar_ddelta; };
-    CoolPropDbl dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.dalphar_dtau; };
-    CoolPropDbl dDelta2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d2alphar_ddelta2; };
-    CoolPropDbl dDelta_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d2alphar_ddelta_dtau; }
-    CoolPropDbl dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d2alphar_dtau2; };
-    CoolPropDbl dDelta3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d3alphar_ddelta3; };
-    CoolPropDbl dDelta2_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d3alphar_ddelta2_dtau; };
-    CoolPropDbl dDelta_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d3alphar_ddelta_dtau2; };
-    CoolPropDbl dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d3alphar_dtau3; };
-    CoolPropDbl dTau4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_dtau4; };
-    CoolPropDbl dDelta_dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_ddelta_dtau3; };
-    CoolPropDbl dDelta2_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_ddelta2_dtau2; };
-    CoolPropDbl dDelta3_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_ddelta3_dtau; };
-    CoolPropDbl dDelta4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_ddelta4; };
-
-    void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw();
+    CoolPropDbl base(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 0); return deriv.alphar; };
+    CoolPropDbl dDelta(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 1); return deriv.dalphar_ddelta; };
+    CoolPropDbl dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 1); return deriv.dalphar_dtau; };
+    CoolPropDbl dDelta2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 2); return deriv.d2alphar_ddelta2; };
+    CoolPropDbl dDelta_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 2); return deriv.d2alphar_ddelta_dtau; }
+    CoolPropDbl dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 2); return deriv.d2alphar_dtau2; };
+    CoolPropDbl dDelta3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 3); return deriv.d3alphar_ddelta3; };
+    CoolPropDbl dDelta2_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 3); return deriv.d3alphar_ddelta2_dtau; };
+    CoolPropDbl dDelta_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 3); return deriv.d3alphar_ddelta_dtau2; };
+    CoolPropDbl dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 3); return deriv.d3alphar_dtau3; };
+    CoolPropDbl dTau4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_dtau4; };
+    CoolPropDbl dDelta_dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_ddelta_dtau3; };
+    CoolPropDbl dDelta2_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_ddelta2_dtau2; };
+    CoolPropDbl dDelta3_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_ddelta3_dtau; };
+    CoolPropDbl dDelta4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_ddelta4; };
+
+    void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs, const int max_order = 4) throw();
 };
 
 /// The generalized Lee-Kesler formulation of Xiang & Deiters: doi:10.1016/j.ces.2007.11.029
@@ -530,23 +608,23 @@ public:
         const CoolPropDbl R
         );
 
-    CoolPropDbl base(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.alphar; };
-    CoolPropDbl dDelta(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.dalphar_ddelta; };
-    CoolPropDbl dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.dalphar_dtau; };
-    CoolPropDbl dDelta2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d2alphar_ddelta2; };
-    CoolPropDbl dDelta_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d2alphar_ddelta_dtau; }
-    CoolPropDbl dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d2alphar_dtau2; };
-    CoolPropDbl dDelta3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d3alphar_ddelta3; };
-    CoolPropDbl dDelta2_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d3alphar_ddelta2_dtau; };
-    CoolPropDbl dDelta_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d3alphar_ddelta_dtau2; };
-    CoolPropDbl dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d3alphar_dtau3; };
-    CoolPropDbl dTau4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_dtau4; };
-    CoolPropDbl dDelta_dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_ddelta_dtau3; };
-    CoolPropDbl dDelta2_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_ddelta2_dtau2; };
-    CoolPropDbl dDelta3_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_ddelta3_dtau; };
-    CoolPropDbl dDelta4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv); return deriv.d4alphar_ddelta4; };
-
-    void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw();
+    CoolPropDbl base(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 0); return deriv.alphar; };
+    CoolPropDbl dDelta(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 1); return deriv.dalphar_ddelta; };
+    CoolPropDbl dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 1); return deriv.dalphar_dtau; };
+    CoolPropDbl dDelta2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 2); return deriv.d2alphar_ddelta2; };
+    CoolPropDbl dDelta_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 2); return deriv.d2alphar_ddelta_dtau; }
+    CoolPropDbl dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 2); return deriv.d2alphar_dtau2; };
+    CoolPropDbl dDelta3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 3); return deriv.d3alphar_ddelta3; };
+    CoolPropDbl dDelta2_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 3); return deriv.d3alphar_ddelta2_dtau; };
+    CoolPropDbl dDelta_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 3); return deriv.d3alphar_ddelta_dtau2; };
+    CoolPropDbl dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 3); return deriv.d3alphar_dtau3; };
+    CoolPropDbl dTau4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_dtau4; };
+    CoolPropDbl dDelta_dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_ddelta_dtau3; };
+    CoolPropDbl dDelta2_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_ddelta2_dtau2; };
+    CoolPropDbl dDelta3_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_ddelta3_dtau; };
+    CoolPropDbl dDelta4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){ HelmholtzDerivatives deriv; all(tau, delta, deriv, 4); return deriv.d4alphar_ddelta4; };
+
+    void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs, const int max_order = 4) throw();
 };
 
 class ResidualHelmholtzSAFTAssociating : public BaseHelmholtzTerm{
@@ -604,16 +682,16 @@ public:
 
     void to_json(rapidjson::Value &el, rapidjson::Document &doc);
 
-    CoolPropDbl base(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.alphar;};
-    CoolPropDbl dDelta(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.dalphar_ddelta;};
-    CoolPropDbl dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.dalphar_dtau;};
-    CoolPropDbl dDelta2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d2alphar_ddelta2;};
-    CoolPropDbl dDelta_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d2alphar_ddelta_dtau;};
-    CoolPropDbl dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d2alphar_dtau2;};
-    CoolPropDbl dDelta3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d3alphar_ddelta3;};
-    CoolPropDbl dDelta2_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d3alphar_ddelta2_dtau;};
-    CoolPropDbl dDelta_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d3alphar_ddelta_dtau2;};
-    CoolPropDbl dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv); return deriv.d3alphar_dtau3;};
+    CoolPropDbl base(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 0); return deriv.alphar;};
+    CoolPropDbl dDelta(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 1); return deriv.dalphar_ddelta;};
+    CoolPropDbl dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 1); return deriv.dalphar_dtau;};
+    CoolPropDbl dDelta2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 2); return deriv.d2alphar_ddelta2;};
+    CoolPropDbl dDelta_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 2); return deriv.d2alphar_ddelta_dtau;};
+    CoolPropDbl dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 2); return deriv.d2alphar_dtau2;};
+    CoolPropDbl dDelta3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 3); return deriv.d3alphar_ddelta3;};
+    CoolPropDbl dDelta2_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 3); return deriv.d3alphar_ddelta2_dtau;};
+    CoolPropDbl dDelta_dTau2(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 3); return deriv.d3alphar_ddelta_dtau2;};
+    CoolPropDbl dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){HelmholtzDerivatives deriv; all(tau,delta,deriv, 3); return deriv.d3alphar_dtau3;};
 
     CoolPropDbl dTau4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){return 1e99;};
     CoolPropDbl dDelta_dTau3(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){return 1e99;};
@@ -621,14 +699,16 @@ public:
     CoolPropDbl dDelta3_dTau(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){return 1e99;};
     CoolPropDbl dDelta4(const CoolPropDbl &tau, const CoolPropDbl &delta) throw(){return 1e99;};
     
-    void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &deriv) const throw();
+    void all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &deriv, const int max_order = 4) const throw();
 };
 
+/// The residual Helmholtz energy of a pure fluid
+/**
+The container holds only the coefficients of the contributions, and does not cache
+any values, so that one instance can be shared between all the states that use the fluid
+*/
 class ResidualHelmholtzContainer
 {
-private:
-    CachedElement _base, _dDelta, _dTau, _dDelta2, _dTau2, _dDelta_dTau, _dDelta3, _dDelta2_dTau, _dDelta_dTau2, _dTau3;
-    CachedElement _dDelta4, _dDelta3_dTau, _dDelta2_dTau2, _dDelta_dTau3, _dTau4;
 public:
     ResidualHelmholtzNonAnalytic NonAnalytic;
     ResidualHelmholtzSAFTAssociating SAFT;
@@ -643,100 +723,51 @@ public:
         SRK = ResidualHelmholtzSRK();
         XiangDeiters = ResidualHelmholtzXiangDeiters();
     }
-    void clear(){
-        _base.clear();
-        _dDelta.clear(); _dTau.clear();
-        _dDelta2.clear(); _dTau2.clear(); _dDelta_dTau.clear();
-        _dDelta3.clear(); _dTau3.clear(); _dDelta2_dTau.clear(); _dDelta_dTau2.clear();
-        _dDelta4.clear(); _dDelta3_dTau.clear(); _dDelta2_dTau2.clear(); _dDelta_dTau3.clear(); _dTau4.clear();
-    }
-    HelmholtzDerivatives all(const CoolPropDbl tau, const CoolPropDbl delta, bool cache_values = false)
+    /// Calculate the residual Helmholtz energy and its derivatives up to max_order (0 to 4); the higher-order derivatives are left at zero
+    HelmholtzDerivatives all(const CoolPropDbl tau, const CoolPropDbl delta, const int max_order = 4)
     {
         HelmholtzDerivatives derivs; // zeros out the elements
-        GenExp.all(tau, delta, derivs);
-        NonAnalytic.all(tau, delta, derivs);
-        SAFT.all(tau, delta, derivs);
-        SRK.all(tau, delta, derivs);
-        XiangDeiters.all(tau, delta, derivs);
-        if (cache_values){
-            _base = derivs.alphar;
-            _dDelta = derivs.dalphar_ddelta;
-            _dTau = derivs.dalphar_dtau;
-            _dDelta2 = derivs.d2alphar_ddelta2;
-            _dTau2 = derivs.d2alphar_dtau2;
-            _dDelta_dTau = derivs.d2alphar_ddelta_dtau;
-            _dDelta3 = derivs.d3alphar_ddelta3;
-            _dTau3 = derivs.d3alphar_dtau3;
-            _dDelta2_dTau = derivs.d3alphar_ddelta2_dtau;
-            _dDelta_dTau2 = derivs.d3alphar_ddelta_dtau2;
-        }
+        GenExp.all(tau, delta, derivs, max_order);
+        NonAnalytic.all(tau, delta, derivs, max_order);
+        SAFT.all(tau, delta, derivs, max_order);
+        SRK.all(tau, delta, derivs, max_order);
+        XiangDeiters.all(tau, delta, derivs, max_order);
         return derivs;
     };
-    CoolPropDbl base(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) {
-        if (!_base || dont_use_cache)
-            return all(tau, delta).alphar;
-        else
-            return _base;
-    };
-    CoolPropDbl dDelta(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) {
-        if (!_dDelta || dont_use_cache)
-            return all(tau, delta).dalphar_ddelta;
-        else
-            return _dDelta;
-    };
-    CoolPropDbl dTau(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) {
-        if (!_dTau || dont_use_cache)
-            return all(tau, delta).dalphar_dtau;
-        else
-            return _dTau;
-    };
-    CoolPropDbl dDelta2(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) {
-        if (!_dDelta2 || dont_use_cache)
-            return all(tau, delta).d2alphar_ddelta2; 
-        else
-            return _dDelta2;
-    };
-    CoolPropDbl dDelta_dTau(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) {
-        if (!_dDelta_dTau || dont_use_cache)
-            return all(tau, delta).d2alphar_ddelta_dtau;
-        else
-            return _dDelta_dTau;
-    };
-    CoolPropDbl dTau2(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) {
-        if (!_dTau2 || dont_use_cache)
-            return all(tau, delta).d2alphar_dtau2;
-        else
-            return _dTau2;
-    };
-    CoolPropDbl dDelta3(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) {
-        if (!_dDelta3 || dont_use_cache)
-            return all(tau, delta).d3alphar_ddelta3;
-        else
-            return _dDelta3;
-    };
-    CoolPropDbl dDelta2_dTau(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) {
-        if (!_dDelta2_dTau || dont_use_cache)
-            return all(tau, delta).d3alphar_ddelta2_dtau;
-        else
-            return _dDelta2_dTau;
-    };
-    CoolPropDbl dDelta_dTau2(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) {
-        if (!_dDelta_dTau2 || dont_use_cache)
-            return all(tau, delta).d3alphar_ddelta_dtau2;
-        else
-            return _dDelta_dTau2;
-    };
-    CoolPropDbl dTau3(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) {
-        if (!_dTau3 || dont_use_cache)
-            return all(tau, delta).d3alphar_dtau3;
-        else
-            return _dTau3;
+    /** \brief Calculate the residual Helmholtz energy and its derivatives up to max_order at each of the points (tau[i], delta[i])
+     *
+     * derivs is resized to the number of points.  The generalized exponential terms, which are the bulk of most equations of state,
+     * are evaluated for a block of points at a time; any other terms are evaluated one point at a time.
+     */
+    void all(const std::vector<CoolPropDbl> &tau, const std::vector<CoolPropDbl> &delta, HelmholtzDerivativesArrays &derivs, const int max_order = 4)
+    {
+        derivs.resize(tau.size()); // zeros out the elements
+        GenExp.all(tau, delta, derivs, max_order);
+        if (NonAnalytic.N == 0 && SAFT.disabled && !SRK.enabled && !XiangDeiters.enabled){ return; }
+        for (std::size_t i = 0; i < tau.size(); ++i){
+            HelmholtzDerivatives point;
+            NonAnalytic.all(tau[i], delta[i], point, max_order);
+            SAFT.all(tau[i], delta[i], point, max_order);
+            SRK.all(tau[i], delta[i], point, max_order);
+            XiangDeiters.all(tau[i], delta[i], point, max_order);
+            derivs.add(i, point);
+        }
     };
-    CoolPropDbl dDelta4(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) { return all(tau, delta).d4alphar_ddelta4; };
-    CoolPropDbl dDelta3_dTau(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) { return all(tau, delta).d4alphar_ddelta3_dtau; };
-    CoolPropDbl dDelta2_dTau2(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) { return all(tau, delta).d4alphar_ddelta2_dtau2; };
-    CoolPropDbl dDelta_dTau3(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) { return all(tau, delta).d4alphar_ddelta_dtau3; };
-    CoolPropDbl dTau4(CoolPropDbl tau, CoolPropDbl delta, const bool dont_use_cache = false) { return all(tau, delta).d4alphar_dtau4; };
+    CoolPropDbl base(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta, 0).alphar; };
+    CoolPropDbl dDelta(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta, 1).dalphar_ddelta; };
+    CoolPropDbl dTau(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta, 1).dalphar_dtau; };
+    CoolPropDbl dDelta2(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta, 2).d2alphar_ddelta2; };
+    CoolPropDbl dDelta_dTau(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta, 2).d2alphar_ddelta_dtau; };
+    CoolPropDbl dTau2(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta, 2).d2alphar_dtau2; };
+    CoolPropDbl dDelta3(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta, 3).d3alphar_ddelta3; };
+    CoolPropDbl dDelta2_dTau(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta, 3).d3alphar_ddelta2_dtau; };
+    CoolPropDbl dDelta_dTau2(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta, 3).d3alphar_ddelta_dtau2; };
+    CoolPropDbl dTau3(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta, 3).d3alphar_dtau3; };
+    CoolPropDbl dDelta4(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta).d4alphar_ddelta4; };
+    CoolPropDbl dDelta3_dTau(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta).d4alphar_ddelta3_dtau; };
+    CoolPropDbl dDelta2_dTau2(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta).d4alphar_ddelta2_dtau2; };
+    CoolPropDbl dDelta_dTau3(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta).d4alphar_ddelta_dtau3; };
+    CoolPropDbl dTau4(CoolPropDbl tau, CoolPropDbl delta) { return all(tau, delta).d4alphar_dtau4; };
 };
 
 // #############################################################################
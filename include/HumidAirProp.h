@@ -4,14 +4,63 @@
 #define HUMAIR_H
 
 #include "CoolPropTools.h"
+#include "crossplatform_shared_ptr.h"
+
+namespace CoolProp{
+    class AbstractState;
+    class HelmholtzEOSBackend;
+}
 
 namespace HumidAir
 {
+/** \brief A humid air calculation context that owns the water and air states that it uses
+ *
+ * The water and air states are modified by every call, so a HumidAirState must only be used by one thread at a
+ * time; give each thread its own HumidAirState to carry out humid air calculations in parallel.  The free functions
+ * (HAPropsSI, HAProps_Aux, ...) use a HumidAirState that belongs to the calling thread and is created the first time
+ * that thread needs it.
+ */
+class HumidAirState
+{
+public:
+    shared_ptr<CoolProp::HelmholtzEOSBackend> Water, Air; ///< The states of pure water and of pseudo-pure air
+    shared_ptr<CoolProp::AbstractState> WaterIF97; ///< The IF97 state of water, used for the isothermal compressibility of liquid water
+
+    HumidAirState();
+
+    /// The same as \ref HAPropsSI, but carried out with the states of this context
+    double HAPropsSI(const std::string &OutputName, const std::string &Input1Name, double Input1, const std::string &Input2Name, double Input2, const std::string &Input3Name, double Input3);
+    /// The same as \ref HAProps_Aux, but carried out with the states of this context
+    double HAProps_Aux(const char* OutputName, double T, double p, double W, char *units);
+    /// The same as \ref HAPropsSImulti, but carried out serially with the states of this context
+    std::vector<std::vector<double> > HAPropsSImulti(const std::vector<std::string> &Outputs, const std::string &Input1Name, const std::vector<double> &Input1, const std::string &Input2Name, const std::vector<double> &Input2, const std::string &Input3Name, const std::vector<double> &Input3);
+private:
+    HumidAirState(const HumidAirState &);
+    HumidAirState & operator=(const HumidAirState &);
+};
+
 /* \brief Standard I/O function using base SI units exclusively
  * 
  */
 double HAPropsSI(const std::string &OutputName, const std::string &Input1Name, double Input1, const std::string &Input2Name, double Input2, const std::string &Input3Name, double Input3);
 
+/** \brief Evaluate several outputs at each of an array of state points using base SI units exclusively
+ *
+ * Each state point is solved for its dry-bulb temperature and water mole fraction only once, and all the outputs
+ * are then calculated from the solved state.  The state points are evaluated in parallel with the number of threads
+ * given by the configuration key HAPROPSSIMULTI_NUMBER_OF_THREADS (only if built with OpenMP).
+ *
+ * @param Outputs The names of the outputs
+ * @param Input1Name The name of the first input
+ * @param Input1 The values of the first input
+ * @param Input2Name The name of the second input
+ * @param Input2 The values of the second input
+ * @param Input3Name The name of the third input
+ * @param Input3 The values of the third input
+ * @returns A matrix with one row per state point and one column per output; an output that cannot be calculated is _HUGE.  If the inputs are invalid, the matrix is empty and the error string is set
+ */
+std::vector<std::vector<double> > HAPropsSImulti(const std::vector<std::string> &Outputs, const std::string &Input1Name, const std::vector<double> &Input1, const std::string &Input2Name, const std::vector<double> &Input2, const std::string &Input3Name, const std::vector<double> &Input3);
+
 /* \brief Standard I/O function using mixed kSI units
  * 
  * \warning DEPRECATED!! Use \ref HAPropsSI
@@ -42,6 +42,73 @@ struct IncompressibleData {
     };
 };
 
+/// A 2D polynomial in temperature and composition with the composition fixed
+/** The concentration axis is summed out once, which leaves a polynomial in (T-Tbase)
+ *  that is evaluated with Horner's scheme without any allocations. The derivative and
+ *  the integrals of p and p/T in temperature are only available for the plain
+ *  polynomial form, see has_derivatives().
+ */
+class IncompressiblePolynomialT {
+protected:
+    IncompressibleData::IncompressibleTypeEnum type;
+    double Tbase;
+    std::vector<double> coeffs;  ///< coeffs[i] multiplies (T-Tbase)^i
+    std::vector<double> dcoeffs; ///< The coefficients of dp/dT in (T-Tbase)
+    std::vector<double> icoeffs; ///< The coefficients of the integral of p dT in (T-Tbase)
+    std::vector<double> fcoeffs; ///< The coefficients of the integral of p/T dT in T, apart from the logarithmic term
+    double flog;                 ///< The coefficient of log(T) in the integral of p/T dT
+
+    static double horner(const std::vector<double> &c, double x){
+        double result = 0;
+        for (std::size_t i = c.size(); i-- > 0; ){ result = result*x + c[i]; }
+        return result;
+    };
+
+public:
+    IncompressiblePolynomialT() : type(IncompressibleData::INCOMPRESSIBLE_NOT_SET), Tbase(0), flog(0) {};
+
+    /// Collapse the coefficients at composition x, other function types leave the polynomial unset
+    void set(const IncompressibleData &data, double x, double Tbase, double xbase);
+    bool is_set() const {return type!=IncompressibleData::INCOMPRESSIBLE_NOT_SET;};
+    bool has_derivatives() const {return type==IncompressibleData::INCOMPRESSIBLE_POLYNOMIAL;};
+
+    /// The value of the property, exponentiated for INCOMPRESSIBLE_EXPPOLYNOMIAL
+    double value(double T) const {
+        double result = horner(coeffs, T-Tbase);
+        return (type==IncompressibleData::INCOMPRESSIBLE_EXPPOLYNOMIAL) ? exp(result) : result;
+    };
+    double derivative(double T) const {return horner(dcoeffs, T-Tbase);};
+    /// Same as Polynomial2DFrac::integral along the temperature axis
+    double integral(double T) const {return horner(icoeffs, T-Tbase);};
+    /// Same as Polynomial2DFrac::integral along the temperature axis with a first exponent of -1
+    double integral_over_T(double T) const {return flog*log(T) + horner(fcoeffs, T);};
+};
+
+/// An approximation of T as a function of a property that is strictly monotonic in T
+/** Cubic Hermite interpolation of T(y) between nodes that are evenly spaced in T, using
+ *  dT/dy = 1/(dy/dT) at the nodes. It is only meant as the initial guess for Newton's method.
+ */
+class IncompressibleInverseT {
+protected:
+    std::vector<double> T, y, dTdy;
+public:
+    void clear(){T.clear(); y.clear(); dTdy.clear();};
+    /// Set the nodes, the approximation is left empty if y is not strictly monotonic in T
+    void set(const std::vector<double> &T, const std::vector<double> &y, const std::vector<double> &dydT);
+    bool is_set() const {return !T.empty();};
+    /// The temperature at y, clamped to the range of the nodes
+    double T_at(double y) const;
+};
+
+/// The temperature polynomials of the properties of a fluid at one composition
+struct IncompressibleFixedComposition {
+    double x; ///< The composition the polynomials were collapsed at
+    IncompressiblePolynomialT density, specific_heat, viscosity, conductivity;
+    /// Inverses of the density and of the integrals of the specific heat, used to start the flash routines
+    IncompressibleInverseT T_of_density, T_of_enthalpy, T_of_entropy;
+    IncompressibleFixedComposition() : x(_HUGE) {};
+};
+
 /// A property provider for incompressible solutions and pure fluids
 /**
 This fluid instance is populated using an entry from a JSON file
@@ -177,13 +244,16 @@ public:
     /// A function to test the density coefficients for 1D or 2D
     bool is_pure();
 
+    /// Collapse the polynomial properties onto the temperature axis at composition x
+    void collapse(double x, IncompressibleFixedComposition &fixed) const;
+
 
 protected:
     /// Base functions that handle the custom function types
-    double baseExponential(IncompressibleData data, double y, double ybase);
-    double baseLogexponential(IncompressibleData data, double y, double ybase);
-    double baseExponentialOffset(IncompressibleData data, double y);
-    double basePolyOffset(IncompressibleData data, double y, double z=0.0);
+    double baseExponential(const IncompressibleData &data, double y, double ybase);
+    double baseLogexponential(const IncompressibleData &data, double y, double ybase);
+    double baseExponentialOffset(const IncompressibleData &data, double y);
+    double basePolyOffset(const IncompressibleData &data, double y, double z=0.0);
 
 public:
 
@@ -11,6 +11,7 @@
 #include "float.h"
 
 #include "Eigen/Core"
+#include "Eigen/LU"
 
 /// A wrapper around std::vector
 /** This wrapper makes the standard vector multi-dimensional.
@@ -737,6 +738,80 @@ template<class T> std::vector<T>               linsolve(std::vector<std::vector<
     return B[0];
 };
 
+/** \brief Preallocated storage for repeatedly solving the square linear system \f$ \mathbf{J}\mathbf{v} = \mathbf{b} \f$
+ *
+ * The matrix, the right-hand side, the solution and the LU factorization are Eigen matrices with a maximum
+ * size of MaxN x MaxN, so that for a fixed MaxN they are stored inside this object, and for MaxN = Eigen::Dynamic
+ * they are allocated by resize().  Either way, solve() does not allocate anything.  The matrices are not aligned, so
+ * that classes holding a LinearSystem can be allocated with plain new.
+ */
+template<class T, int MaxN> class LinearSystem{
+public:
+    typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor | Eigen::DontAlign, MaxN, MaxN> MatrixType;
+    typedef Eigen::Matrix<T, Eigen::Dynamic, 1, Eigen::ColMajor | Eigen::DontAlign, MaxN, 1> VectorType;
+    MatrixType J;
+    VectorType b, v;
+    Eigen::PartialPivLU<MatrixType> LU;
+    /// Resize to N equations; all the entries are set to zero
+    void resize(std::size_t N){
+        J.setZero(N, N); b.setZero(N); v.setZero(N);
+        LU = Eigen::PartialPivLU<MatrixType>(N);
+    };
+    void solve(){
+        LU.compute(J);
+        v = LU.solve(b);
+    };
+};
+
+/** \brief The Jacobian matrix, residual vector and step of a multi-dimensional Newton-Raphson solver
+ *
+ * The workspace is sized once with resize(), after which the solver fills in the Jacobian matrix with J(i,j) and
+ * the negative of the residual vector with rhs(i) at each iteration, and calls solve() to obtain the step.  No heap
+ * allocation takes place in the iterations.  Systems of up to Nfixed equations (the VLE systems of mixtures with a
+ * handful of components) are solved with fixed-size Eigen matrices, larger ones with dynamically sized matrices.
+ */
+template<class T> class NewtonRaphsonWorkspace{
+public:
+    enum {Nfixed = 8};
+private:
+    LinearSystem<T, Nfixed> fixed;
+    LinearSystem<T, Eigen::Dynamic> dynamic;
+    std::size_t N;
+    bool is_fixed() const { return N <= static_cast<std::size_t>(Nfixed); };
+public:
+    NewtonRaphsonWorkspace() : N(0) {};
+    /// Resize to N equations in N unknowns; all the entries are set to zero
+    void resize(std::size_t N){
+        this->N = N;
+        if (is_fixed()){ fixed.resize(N); dynamic.resize(0); }
+        else{ dynamic.resize(N); }
+    };
+    std::size_t size() const { return N; };
+    /// The entry in row i and column j of the Jacobian matrix
+    T & operator()(std::size_t i, std::size_t j){ return is_fixed() ? fixed.J(i, j) : dynamic.J(i, j); };
+    const T & operator()(std::size_t i, std::size_t j) const { return is_fixed() ? fixed.J(i, j) : dynamic.J(i, j); };
+    /// The i-th entry of the right-hand side, the negative of the residual vector
+    T & rhs(std::size_t i){ return is_fixed() ? fixed.b(i) : dynamic.b(i); };
+    /// The i-th entry of the step found by the last call to solve()
+    const T & step(std::size_t i) const { return is_fixed() ? fixed.v(i) : dynamic.v(i); };
+    /// Solve for the step, using an LU decomposition with partial pivoting
+    void solve(){
+        if (is_fixed()){ fixed.solve(); } else{ dynamic.solve(); }
+    };
+    /// Copy the step out into a std::vector (for diagnostic purposes)
+    std::vector<T> step() const {
+        std::vector<T> out(N);
+        for (std::size_t i = 0; i < N; ++i){ out[i] = step(i); }
+        return out;
+    };
+    /// Copy column j of the Jacobian matrix out into a std::vector (for diagnostic purposes)
+    std::vector<T> col(std::size_t j) const {
+        std::vector<T> out(N);
+        for (std::size_t i = 0; i < N; ++i){ out[i] = (*this)(i, j); }
+        return out;
+    };
+};
+
 
 
 template<class T> std::vector<T> get_row(std::vector< std::vector<T> > const& in, size_t row) { return in[row]; };
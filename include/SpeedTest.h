@@ -7,6 +7,9 @@ namespace CoolProp{
 
 void compare_REFPROP_and_CoolProp(const std::string &fluid, int inputs, double val1, double val2, std::size_t N, double d1 = 0, double d2 = 0);
 
+/// Time the generalized exponential terms of the residual Helmholtz energy of a fluid with the kernel generated for it (see dev/generate_kernels.py) and with the generic evaluation
+void compare_generated_and_generic_kernels(const std::string &fluid, std::size_t N);
+
 } /* namespace CoolProp */
 
 #endif
\ No newline at end of file
@@ -16,5 +16,8 @@ Eigen::MatrixXd makeMatrix(const std::vector<double> &coefficients);
 CoolProp::IncompressibleFluid incompressibleFluidObject();
 //IncompressibleBackend incompressibleBackendObject();
 
+/// The number of heap allocations made so far by the calling thread through the global operator new
+std::size_t heap_allocations();
+
 } // namespace CoolPropTesting
 #endif // ENABLE_CATCH
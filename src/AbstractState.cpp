@@ -160,6 +160,11 @@ bool AbstractState::clear() {
     this->_d3alphar_dDelta_dTau2.clear();
     this->_d3alphar_dDelta2_dTau.clear();
     this->_d3alphar_dDelta3.clear();
+    this->_d4alphar_dTau4.clear();
+    this->_d4alphar_dDelta_dTau3.clear();
+    this->_d4alphar_dDelta2_dTau2.clear();
+    this->_d4alphar_dDelta3_dTau.clear();
+    this->_d4alphar_dDelta4.clear();
 
     this->_dalphar_dDelta_lim.clear();
     this->_d2alphar_dDelta2_lim.clear();
@@ -224,6 +229,43 @@ void AbstractState::mass_to_molar_inputs(CoolProp::input_pairs &input_pair, Cool
         return;
     }
 }
+void AbstractState::update_many(CoolProp::input_pairs input_pair, const double *Value1, const double *Value2, std::size_t N, const parameters *outputs, std::size_t Nout, double *out, std::string *first_error)
+{
+    // Classify the outputs once; trivial outputs do not depend on the state and are only evaluated once
+    std::vector<bool> trivial(Nout, false);
+    std::vector<double> trivial_values(Nout, _HUGE);
+    for (std::size_t j = 0; j < Nout; ++j){
+        try{
+            if (is_trivial_parameter(outputs[j])){
+                trivial[j] = true;
+                trivial_values[j] = trivial_keyed_output(outputs[j]);
+            }
+        }
+        catch(std::exception &){ trivial[j] = true; trivial_values[j] = _HUGE; }
+    }
+    for (std::size_t i = 0; i < N; ++i){
+        double *row = out + i*Nout;
+        try{
+            update(input_pair, Value1[i], Value2[i]);
+        }
+        catch(std::exception &e){
+            if (get_debug_level() > 0){ std::cout << format("AbstractState::update_many: update failed at point %d: %s", static_cast<int>(i), e.what()) << std::endl; }
+            for (std::size_t j = 0; j < Nout; ++j){ row[j] = _HUGE; }
+            if (first_error != NULL && first_error->empty()){ *first_error = e.what(); }
+            continue;
+        }
+        for (std::size_t j = 0; j < Nout; ++j){
+            if (trivial[j]){ row[j] = trivial_values[j]; continue; }
+            try{
+                row[j] = keyed_output(outputs[j]);
+            }
+            catch(std::exception &e){
+                row[j] = _HUGE;
+                if (first_error != NULL && first_error->empty()){ *first_error = e.what(); }
+            }
+        }
+    }
+}
 double AbstractState::trivial_keyed_output(parameters key)
 {
     if (get_debug_level()>=50) std::cout << format("AbstractState: keyed_output called for %s ",get_parameter_information(key,"short").c_str()) << std::endl;
@@ -783,6 +825,65 @@ TEST_CASE("Check AbstractState","[AbstractState]")
     }
 }
 
+TEST_CASE("Check update_many against update","[update_many]")
+{
+    shared_ptr<CoolProp::AbstractState> Water(CoolProp::AbstractState::factory("HEOS", "Water"));
+    double p[] = {101325, 101325, 1e6, -1};
+    double T[] = {300, 500, 400, 300};
+    CoolProp::parameters outputs[] = {CoolProp::iDmass, CoolProp::iHmass, CoolProp::imolar_mass, CoolProp::iCpmass};
+    std::vector<double> out(4*4);
+    std::string first_error;
+    Water->update_many(CoolProp::PT_INPUTS, p, T, 4, outputs, 4, &(out[0]), &first_error);
+    for (std::size_t i = 0; i < 3; ++i){
+        Water->update(CoolProp::PT_INPUTS, p[i], T[i]);
+        for (std::size_t j = 0; j < 4; ++j){
+            CAPTURE(i); CAPTURE(j);
+            CHECK(std::abs(out[i*4+j]/Water->keyed_output(outputs[j]) - 1) < 1e-14);
+        }
+    }
+    // The invalid state point is filled with _HUGE
+    for (std::size_t j = 0; j < 4; ++j){
+        CHECK(out[3*4+j] == _HUGE);
+    }
+    // ... and its error is passed back
+    CHECK(!first_error.empty());
+}
+
+TEST_CASE("Check clone against the original state","[clone]")
+{
+    std::vector<std::pair<std::string, std::string> > states;
+    states.push_back(std::pair<std::string, std::string>("HEOS", "Water"));
+    states.push_back(std::pair<std::string, std::string>("HEOS", "R32&R125"));
+    states.push_back(std::pair<std::string, std::string>("INCOMP", "DEB"));
+    states.push_back(std::pair<std::string, std::string>("IF97", "Water"));
+    #if !defined(NO_TABULAR_BACKENDS)
+    // The tables are shared, but the cached cell indices and the underlying state must not be
+    states.push_back(std::pair<std::string, std::string>("TTSE&HEOS", "Water"));
+    states.push_back(std::pair<std::string, std::string>("BICUBIC&HEOS", "Water"));
+    #endif
+    for (std::size_t i = 0; i < states.size(); ++i)
+    {
+        CAPTURE(states[i].first); CAPTURE(states[i].second);
+        shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory(states[i].first, states[i].second));
+        if (states[i].second.find("&") != std::string::npos){
+            std::vector<double> z(2, 0.5); AS->set_mole_fractions(z);
+        }
+        AS->update(CoolProp::PT_INPUTS, 1e6, 300);
+        double rho = AS->rhomass(), h = AS->hmass();
+        shared_ptr<CoolProp::AbstractState> AS2(AS->clone());
+        CHECK(AS2->backend_name() == AS->backend_name());
+        // The current state is copied along
+        CHECK(AS2->rhomass() == rho);
+        // ... and the copy is independent of the original
+        AS2->update(CoolProp::PT_INPUTS, 2e6, 320);
+        CHECK(AS->rhomass() == rho);
+        CHECK(AS->hmass() == h);
+        AS->update(CoolProp::PT_INPUTS, 2e6, 320);
+        CHECK(std::abs(AS2->hmass()/AS->hmass() - 1) < 1e-14);
+        CHECK(std::abs(AS2->cpmass()/AS->cpmass() - 1) < 1e-14);
+    }
+}
+
 TEST_CASE("Check derivatives in first_partial_deriv","[derivs_in_first_partial_deriv]")
 {
     shared_ptr<CoolProp::AbstractState> Water(CoolProp::AbstractState::factory("HEOS", "Water"));
@@ -61,7 +61,7 @@ void CoolProp::AbstractCubicBackend::get_critical_point_starting_values(double &
 
 CoolPropDbl CoolProp::AbstractCubicBackend::calc_alphar_deriv_nocache(const int nTau, const int nDelta, const std::vector<CoolPropDbl> & mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta){
     bool cache_values = true;
-    HelmholtzDerivatives derivs = residual_helmholtz->all(*this, get_mole_fractions_ref(), cache_values);
+    HelmholtzDerivatives derivs = residual_helmholtz->all(*this, get_mole_fractions_ref(), cache_values, nTau + nDelta);
     switch (nTau){
         case 0:
         {
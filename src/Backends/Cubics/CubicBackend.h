@@ -38,6 +38,9 @@ public:
 
 	/// Get a reference to the shared pointer managing the generalized cubic class
 	shared_ptr<AbstractCubic> &get_cubic(){ return cubic; };
+
+	/// The residual Helmholtz term holds a pointer back to this class, so it cannot be copied
+	AbstractCubicBackend * clone(){ throw NotImplementedError("clone is not implemented for the cubic backends"); };
 	
     bool using_mole_fractions(void){return true;};
     bool using_mass_fractions(void){return false;}; 
@@ -127,28 +130,45 @@ class CubicResidualHelmholtz : public ResidualHelmholtz
 
 protected:
 	AbstractCubicBackend *ACB;
-public:
-	CubicResidualHelmholtz(){ ACB = NULL; };
-	CubicResidualHelmholtz(AbstractCubicBackend * ACB) : ACB(ACB) {};
 
-    /// All the derivatives of the residual Helmholtz energy w.r.t. tau and delta that do not involve composition derivative
-    virtual HelmholtzDerivatives all(HelmholtzEOSMixtureBackend &HEOS, const std::vector<CoolPropDbl> &mole_fractions, bool cache_values = false)
-    {
+	/// The derivatives of the residual Helmholtz energy w.r.t. tau and delta up to max_order at the given point
+	HelmholtzDerivatives all(double tau, double delta, const std::vector<double> &z, const int max_order)
+	{
 		HelmholtzDerivatives a;
-		std::vector<double> z = std::vector<double>(mole_fractions.begin(), mole_fractions.end());
         shared_ptr<AbstractCubic> &cubic = ACB->get_cubic();
-		double tau = HEOS.tau(), delta = HEOS.delta();
 		a.alphar = cubic->alphar(tau, delta, z, 0, 0);
+        if (max_order < 1){ return a; }
 		a.dalphar_dtau = cubic->alphar(tau, delta, z, 1, 0);
 		a.dalphar_ddelta = cubic->alphar(tau, delta, z, 0, 1);
+        if (max_order < 2){ return a; }
         a.d2alphar_dtau2 = cubic->alphar(tau, delta, z, 2, 0);
         a.d2alphar_ddelta_dtau = cubic->alphar(tau, delta, z, 1, 1);
         a.d2alphar_ddelta2 = cubic->alphar(tau, delta, z, 0, 2);
+        if (max_order < 3){ return a; }
         a.d3alphar_dtau3 = cubic->alphar(tau, delta, z, 3, 0);
         a.d3alphar_ddelta_dtau2 = cubic->alphar(tau, delta, z, 2, 1);
         a.d3alphar_ddelta2_dtau = cubic->alphar(tau, delta, z, 1, 2);
         a.d3alphar_ddelta3 = cubic->alphar(tau, delta, z, 0, 3);
         return a;
+	}
+public:
+	CubicResidualHelmholtz(){ ACB = NULL; };
+	CubicResidualHelmholtz(AbstractCubicBackend * ACB) : ACB(ACB) {};
+
+    /// All the derivatives of the residual Helmholtz energy w.r.t. tau and delta up to max_order that do not involve composition derivative
+    virtual HelmholtzDerivatives all(HelmholtzEOSMixtureBackend &HEOS, const std::vector<CoolPropDbl> &mole_fractions, bool cache_values = false, const int max_order = 4)
+    {
+		std::vector<double> z = std::vector<double>(mole_fractions.begin(), mole_fractions.end());
+		return all(HEOS.tau(), HEOS.delta(), z, max_order);
+    }
+    /// All the derivatives of the residual Helmholtz energy w.r.t. tau and delta up to max_order at each of the points (tau[i], delta[i])
+    virtual void all(HelmholtzEOSMixtureBackend &HEOS, const std::vector<CoolPropDbl> &mole_fractions, const std::vector<CoolPropDbl> &tau, const std::vector<CoolPropDbl> &delta, HelmholtzDerivativesArrays &derivs, const int max_order = 4)
+    {
+		std::vector<double> z = std::vector<double>(mole_fractions.begin(), mole_fractions.end());
+		derivs.resize(tau.size());
+		for (std::size_t i = 0; i < tau.size(); ++i){
+			derivs.add(i, all(tau[i], delta[i], z, max_order));
+		}
     }
     virtual CoolPropDbl dalphar_dxi(HelmholtzEOSMixtureBackend &HEOS, std::size_t i, x_N_dependency_flag xN_flag){
         return ACB->get_cubic()->d_alphar_dxi(HEOS.tau(), HEOS.delta(), HEOS.get_mole_fractions_doubleref(), 0, 0, i, xN_flag==XN_INDEPENDENT);
@@ -25,6 +25,9 @@ public:
     ResidualHelmholtzGeneralizedExponential phi;
     HelmholtzDerivatives derivs;
 
+    /// Make a new-allocated copy of this departure function
+    virtual DepartureFunction *copy(){ return new DepartureFunction(*this); };
+
     void update(double tau, double delta){
         derivs.reset(0.0);
         phi.all(tau, delta, derivs);
@@ -90,6 +93,7 @@ public:
         }
     };
     ~GERG2008DepartureFunction(){};
+    GERG2008DepartureFunction *copy(){ return new GERG2008DepartureFunction(*this); };
 };
 
 /** \brief A polynomial/exponential departure function
@@ -114,12 +118,16 @@ public:
                                      phi.add_Power(_n, _d, _t, _l);
                                  };
     ~ExponentialDepartureFunction(){};
+    ExponentialDepartureFunction *copy(){ return new ExponentialDepartureFunction(*this); };
 };
 
 typedef shared_ptr<DepartureFunction> DepartureFunctionPointer;
 
 class ExcessTerm
 {
+protected:
+    std::vector<CoolPropDbl> weights_x; ///< The mole fractions that the cached weights belong to
+    STLMatrix xixjF; ///< The cached weights \f$x_ix_jF_{ij}\f$ for i < j
 public:
     std::size_t N;
     std::vector<std::vector<DepartureFunctionPointer> > DepartureFunctionMatrix;
@@ -135,14 +143,46 @@ public:
         for (std::size_t i = 0; i < N; ++i){
             DepartureFunctionMatrix[i].resize(N);
         }
+        // F is about to be (re)set, so the weights have to be recalculated
+        weights_x.clear();
+    };
+    /** \brief The weights \f$x_ix_jF_{ij}\f$ (for i < j) of the departure functions in the sums over the binary pairs
+     *
+     * They only depend on the composition, so they are cached and only recalculated when x changes
+     */
+    const STLMatrix & weights(const std::vector<CoolPropDbl> &x){
+        if (x.size() != weights_x.size() || !std::equal(x.begin(), x.end(), weights_x.begin())){
+            weights_x = x;
+            xixjF.resize(N, std::vector<CoolPropDbl>(N, 0));
+            for (std::size_t i = 0; i < N; i++){
+                for (std::size_t j = i + 1; j < N; j++){
+                    xixjF[i][j] = x[i]*x[j]*F[i][j];
+                }
+            }
+        }
+        return xixjF;
     };
-    /// Update the internal cached derivatives in each departure function
+    /// Copy this term; the departure functions cache their derivatives, so each copy gets its own
+    ExcessTerm copy(){
+        ExcessTerm _copy = *this;
+        for (std::size_t i = 0; i < N; ++i){
+            for (std::size_t j = 0; j < N; ++j){
+                if (DepartureFunctionMatrix[i][j].get() != NULL){
+                    _copy.DepartureFunctionMatrix[i][j].reset(DepartureFunctionMatrix[i][j]->copy());
+                }
+            }
+        }
+        return _copy;
+    };
+    /// Update the internal cached derivatives in each departure function; those with \f$F_{ij} = 0\f$ never contribute, so they are skipped
     void update(double tau, double delta){
         for (std::size_t i = 0; i < N; i++){
             for (std::size_t j = i + 1; j < N; j++){
+                if (F[i][j] == 0){ continue; }
                 DepartureFunctionMatrix[i][j]->update(tau, delta);
             }
             for (std::size_t j = 0; j < i; j++){
+                if (F[i][j] == 0){ continue; }
                 DepartureFunctionMatrix[i][j]->update(tau, delta);
             }
         }
@@ -157,25 +197,36 @@ public:
         if (N == 0){ return derivs; }
 
         update(tau, delta);
-        
-        derivs.alphar = alphar(mole_fractions);
-        derivs.dalphar_ddelta = dalphar_dDelta(mole_fractions);
-        derivs.dalphar_dtau = dalphar_dTau(mole_fractions);
 
-        derivs.d2alphar_ddelta2 = d2alphar_dDelta2(mole_fractions);
-        derivs.d2alphar_ddelta_dtau = d2alphar_dDelta_dTau(mole_fractions);
-        derivs.d2alphar_dtau2 = d2alphar_dTau2(mole_fractions);
+        // All the sums share the weights, so they are done in one pass over the binary pairs
+        const STLMatrix &w = weights(mole_fractions);
+        for (std::size_t i = 0; i < N-1; i++)
+        {
+            for (std::size_t j = i + 1; j < N; j++)
+            {
+                if (F[i][j] == 0){ continue; }
+                const double wij = w[i][j];
+                const HelmholtzDerivatives &dep = DepartureFunctionMatrix[i][j]->derivs;
+                derivs.alphar += wij*dep.alphar;
+                derivs.dalphar_ddelta += wij*dep.dalphar_ddelta;
+                derivs.dalphar_dtau += wij*dep.dalphar_dtau;
+
+                derivs.d2alphar_ddelta2 += wij*dep.d2alphar_ddelta2;
+                derivs.d2alphar_ddelta_dtau += wij*dep.d2alphar_ddelta_dtau;
+                derivs.d2alphar_dtau2 += wij*dep.d2alphar_dtau2;
 
-        derivs.d3alphar_ddelta3 = d3alphar_dDelta3(mole_fractions);
-        derivs.d3alphar_ddelta2_dtau = d3alphar_dDelta2_dTau(mole_fractions);
-        derivs.d3alphar_ddelta_dtau2 = d3alphar_dDelta_dTau2(mole_fractions);
-        derivs.d3alphar_dtau3 = d3alphar_dTau3(mole_fractions);
+                derivs.d3alphar_ddelta3 += wij*dep.d3alphar_ddelta3;
+                derivs.d3alphar_ddelta2_dtau += wij*dep.d3alphar_ddelta2_dtau;
+                derivs.d3alphar_ddelta_dtau2 += wij*dep.d3alphar_ddelta_dtau2;
+                derivs.d3alphar_dtau3 += wij*dep.d3alphar_dtau3;
 
-        derivs.d4alphar_ddelta4 = d4alphar_dDelta4(mole_fractions);
-        derivs.d4alphar_ddelta3_dtau = d4alphar_dDelta3_dTau(mole_fractions);
-        derivs.d4alphar_ddelta2_dtau2 = d4alphar_dDelta2_dTau2(mole_fractions);
-        derivs.d4alphar_ddelta_dtau3 = d4alphar_dDelta_dTau3(mole_fractions);
-        derivs.d4alphar_dtau4 = d4alphar_dTau4(mole_fractions);
+                derivs.d4alphar_ddelta4 += wij*dep.d4alphar_ddelta4;
+                derivs.d4alphar_ddelta3_dtau += wij*dep.d4alphar_ddelta3_dtau;
+                derivs.d4alphar_ddelta2_dtau2 += wij*dep.d4alphar_ddelta2_dtau2;
+                derivs.d4alphar_ddelta_dtau3 += wij*dep.d4alphar_ddelta_dtau3;
+                derivs.d4alphar_dtau4 += wij*dep.d4alphar_dtau4;
+            }
+        }
         return derivs;
     }
 
@@ -183,12 +234,13 @@ public:
     {
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+        const STLMatrix &w = weights(x);
         double summer = 0;
         for (std::size_t i = 0; i < N-1; i++)
         {
             for (std::size_t j = i + 1; j < N; j++)
             {
-                summer += x[i]*x[j]*F[i][j]*DepartureFunctionMatrix[i][j]->alphar();
+                summer += w[i][j]*DepartureFunctionMatrix[i][j]->alphar();
             }
         }
         return summer;
@@ -197,12 +249,13 @@ public:
     {
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+        const STLMatrix &w = weights(x);
         double summer = 0;
         for (std::size_t i = 0; i < N-1; i++)
         {
             for (std::size_t j = i + 1; j < N; j++)
             {
-                summer += x[i]*x[j]*F[i][j]*DepartureFunctionMatrix[i][j]->dalphar_dDelta();
+                summer += w[i][j]*DepartureFunctionMatrix[i][j]->dalphar_dDelta();
             }
         }
         return summer;
@@ -211,12 +264,13 @@ public:
     {
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+        const STLMatrix &w = weights(x);
         double summer = 0;
         for (std::size_t i = 0; i < N-1; i++)
         {
             for (std::size_t j = i + 1; j < N; j++)
             {
-                summer += x[i]*x[j]*F[i][j]*DepartureFunctionMatrix[i][j]->d2alphar_dDelta2();
+                summer += w[i][j]*DepartureFunctionMatrix[i][j]->d2alphar_dDelta2();
             }
         }
         return summer;
@@ -225,12 +279,13 @@ public:
     {
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+        const STLMatrix &w = weights(x);
         double summer = 0;
         for (std::size_t i = 0; i < N-1; i++)
         {
             for (std::size_t j = i + 1; j < N; j++)
             {
-                summer += x[i]*x[j]*F[i][j]*DepartureFunctionMatrix[i][j]->d2alphar_dDelta_dTau();
+                summer += w[i][j]*DepartureFunctionMatrix[i][j]->d2alphar_dDelta_dTau();
             }
         }
         return summer;
@@ -239,12 +294,13 @@ public:
     {
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+        const STLMatrix &w = weights(x);
         double summer = 0;
         for (std::size_t i = 0; i < N-1; i++)
         {
             for (std::size_t j = i + 1; j < N; j++)
             {
-                summer += x[i]*x[j]*F[i][j]*DepartureFunctionMatrix[i][j]->dalphar_dTau();
+                summer += w[i][j]*DepartureFunctionMatrix[i][j]->dalphar_dTau();
             }
         }
         return summer;
@@ -253,12 +309,13 @@ public:
     {
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+        const STLMatrix &w = weights(x);
         double summer = 0;
         for (std::size_t i = 0; i < N-1; i++)
         {
             for (std::size_t j = i + 1; j < N; j++)
             {
-                summer += x[i]*x[j]*F[i][j]*DepartureFunctionMatrix[i][j]->d2alphar_dTau2();
+                summer += w[i][j]*DepartureFunctionMatrix[i][j]->d2alphar_dTau2();
             }
         }
         return summer;
@@ -267,12 +324,13 @@ public:
 	{
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+		const STLMatrix &w = weights(x);
 		double summer = 0;
 		for (std::size_t i = 0; i < N - 1; i++)
 		{
 			for (std::size_t j = i + 1; j < N; j++)
 			{
-				summer += x[i] * x[j] * F[i][j] * DepartureFunctionMatrix[i][j]->d3alphar_dTau3();
+				summer += w[i][j]*DepartureFunctionMatrix[i][j]->d3alphar_dTau3();
 			}
 		}
 		return summer;
@@ -281,12 +339,13 @@ public:
 	{
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+		const STLMatrix &w = weights(x);
 		double summer = 0;
 		for (std::size_t i = 0; i < N - 1; i++)
 		{
 			for (std::size_t j = i + 1; j < N; j++)
 			{
-				summer += x[i] * x[j] * F[i][j] * DepartureFunctionMatrix[i][j]->d3alphar_dDelta_dTau2();
+				summer += w[i][j]*DepartureFunctionMatrix[i][j]->d3alphar_dDelta_dTau2();
 			}
 		}
 		return summer;
@@ -295,12 +354,13 @@ public:
 	{
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+		const STLMatrix &w = weights(x);
 		double summer = 0;
 		for (std::size_t i = 0; i < N - 1; i++)
 		{
 			for (std::size_t j = i + 1; j < N; j++)
 			{
-				summer += x[i] * x[j] * F[i][j] * DepartureFunctionMatrix[i][j]->d3alphar_dDelta2_dTau();
+				summer += w[i][j]*DepartureFunctionMatrix[i][j]->d3alphar_dDelta2_dTau();
 			}
 		}
 		return summer;
@@ -309,12 +369,13 @@ public:
 	{
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+		const STLMatrix &w = weights(x);
 		double summer = 0;
 		for (std::size_t i = 0; i < N - 1; i++)
 		{
 			for (std::size_t j = i + 1; j < N; j++)
 			{
-				summer += x[i] * x[j] * F[i][j] * DepartureFunctionMatrix[i][j]->d3alphar_dDelta3();
+				summer += w[i][j]*DepartureFunctionMatrix[i][j]->d3alphar_dDelta3();
 			}
 		}
 		return summer;
@@ -323,12 +384,13 @@ public:
     {
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+        const STLMatrix &w = weights(x);
         double summer = 0;
         for (std::size_t i = 0; i < N - 1; i++)
         {
             for (std::size_t j = i + 1; j < N; j++)
             {
-                summer += x[i] * x[j] * F[i][j] * DepartureFunctionMatrix[i][j]->d4alphar_dTau4();
+                summer += w[i][j]*DepartureFunctionMatrix[i][j]->d4alphar_dTau4();
             }
         }
         return summer;
@@ -337,12 +399,13 @@ public:
     {
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+        const STLMatrix &w = weights(x);
         double summer = 0;
         for (std::size_t i = 0; i < N - 1; i++)
         {
             for (std::size_t j = i + 1; j < N; j++)
             {
-                summer += x[i] * x[j] * F[i][j] * DepartureFunctionMatrix[i][j]->d4alphar_dDelta_dTau3();
+                summer += w[i][j]*DepartureFunctionMatrix[i][j]->d4alphar_dDelta_dTau3();
             }
         }
         return summer;
@@ -351,12 +414,13 @@ public:
     {
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+        const STLMatrix &w = weights(x);
         double summer = 0;
         for (std::size_t i = 0; i < N - 1; i++)
         {
             for (std::size_t j = i + 1; j < N; j++)
             {
-                summer += x[i] * x[j] * F[i][j] * DepartureFunctionMatrix[i][j]->d4alphar_dDelta2_dTau2();
+                summer += w[i][j]*DepartureFunctionMatrix[i][j]->d4alphar_dDelta2_dTau2();
             }
         }
         return summer;
@@ -365,12 +429,13 @@ public:
     {
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+        const STLMatrix &w = weights(x);
         double summer = 0;
         for (std::size_t i = 0; i < N - 1; i++)
         {
             for (std::size_t j = i + 1; j < N; j++)
             {
-                summer += x[i] * x[j] * F[i][j] * DepartureFunctionMatrix[i][j]->d4alphar_dDelta3_dTau();
+                summer += w[i][j]*DepartureFunctionMatrix[i][j]->d4alphar_dDelta3_dTau();
             }
         }
         return summer;
@@ -379,12 +444,13 @@ public:
     {
         // If Excess term is not being used, return zero
         if (N==0){ return 0; }
+        const STLMatrix &w = weights(x);
         double summer = 0;
         for (std::size_t i = 0; i < N - 1; i++)
         {
             for (std::size_t j = i + 1; j < N; j++)
             {
-                summer += x[i] * x[j] * F[i][j] * DepartureFunctionMatrix[i][j]->d4alphar_dDelta4();
+                summer += w[i][j]*DepartureFunctionMatrix[i][j]->d4alphar_dDelta4();
             }
         }
         return summer;
@@ -304,8 +304,8 @@ void FlashRoutines::HQ_flash(HelmholtzEOSMixtureBackend &HEOS, CoolPropDbl Tgues
     if (Tguess < 0){
         options.use_guesses = true;
         options.T = Tguess;
-        CoolProp::SaturationAncillaryFunction &rhoL = HEOS.get_components()[0].ancillaries.rhoL;
-        CoolProp::SaturationAncillaryFunction &rhoV = HEOS.get_components()[0].ancillaries.rhoV;
+        CoolProp::SaturationAncillaryFunction &rhoL = HEOS.get_components()[0]->ancillaries.rhoL;
+        CoolProp::SaturationAncillaryFunction &rhoV = HEOS.get_components()[0]->ancillaries.rhoV;
         options.rhoL = rhoL.evaluate(Tguess);
         options.rhoV = rhoV.evaluate(Tguess);
     }
@@ -382,7 +382,7 @@ void FlashRoutines::QT_flash(HelmholtzEOSMixtureBackend &HEOS)
         Tmin_sat = std::max(Tmin_satL, Tmin_satV) - 1e-13;
         
         // Get a reference to keep the code a bit cleaner
-        const CriticalRegionSplines &splines = HEOS.components[0].EOS().critical_region_splines;
+        const CriticalRegionSplines &splines = HEOS.components[0]->EOS().critical_region_splines;
         
         // If exactly(ish) at the critical temperature, liquid and vapor have the critial density
         if ((get_config_bool(CRITICAL_WITHIN_1UK) && std::abs(T-Tmax_sat)< 1e-6) || std::abs(T-Tmax_sat)< 1e-12){
@@ -403,7 +403,7 @@ void FlashRoutines::QT_flash(HelmholtzEOSMixtureBackend &HEOS)
             HEOS._p = 0.5*HEOS.SatV->p() + 0.5*HEOS.SatL->p();
             HEOS._rhomolar = 1/(HEOS._Q/HEOS.SatV->rhomolar() + (1 - HEOS._Q)/HEOS.SatL->rhomolar());
         }
-        else if (!(HEOS.components[0].EOS().pseudo_pure))
+        else if (!(HEOS.components[0]->EOS().pseudo_pure))
         {
             // Set some imput options
             SaturationSolvers::saturation_T_pure_Akasaka_options options(false);
@@ -418,14 +418,14 @@ void FlashRoutines::QT_flash(HelmholtzEOSMixtureBackend &HEOS)
             // Pseudo-pure fluid
             CoolPropDbl rhoLanc = _HUGE, rhoVanc = _HUGE, rhoLsat = _HUGE, rhoVsat = _HUGE;
             if (std::abs(HEOS._Q) < DBL_EPSILON){
-                HEOS._p = HEOS.components[0].ancillaries.pL.evaluate(HEOS._T); // These ancillaries are used explicitly
-                rhoLanc = HEOS.components[0].ancillaries.rhoL.evaluate(HEOS._T);
+                HEOS._p = HEOS.components[0]->ancillaries.pL.evaluate(HEOS._T); // These ancillaries are used explicitly
+                rhoLanc = HEOS.components[0]->ancillaries.rhoL.evaluate(HEOS._T);
                 HEOS.SatL->update_TP_guessrho(HEOS._T, HEOS._p, rhoLanc);
                 HEOS._rhomolar = HEOS.SatL->rhomolar();
             }
             else if (std::abs(HEOS._Q - 1) < DBL_EPSILON){
-                HEOS._p = HEOS.components[0].ancillaries.pV.evaluate(HEOS._T); // These ancillaries are used explicitly
-                rhoVanc = HEOS.components[0].ancillaries.rhoV.evaluate(HEOS._T);
+                HEOS._p = HEOS.components[0]->ancillaries.pV.evaluate(HEOS._T); // These ancillaries are used explicitly
+                rhoVanc = HEOS.components[0]->ancillaries.rhoV.evaluate(HEOS._T);
                 HEOS.SatV->update_TP_guessrho(HEOS._T, HEOS._p, rhoVanc);
                 HEOS._rhomolar = HEOS.SatV->rhomolar();
             }
@@ -513,14 +513,14 @@ void FlashRoutines::PQ_flash(HelmholtzEOSMixtureBackend &HEOS)
 {
     if (HEOS.is_pure_or_pseudopure)
     {
-        if (HEOS.components[0].EOS().pseudo_pure){
+        if (HEOS.components[0]->EOS().pseudo_pure){
             // It is a pseudo-pure mixture
             
-            HEOS._TLanc = HEOS.components[0].ancillaries.pL.invert(HEOS._p);
-            HEOS._TVanc = HEOS.components[0].ancillaries.pV.invert(HEOS._p);
+            HEOS._TLanc = HEOS.components[0]->ancillaries.pL.invert(HEOS._p);
+            HEOS._TVanc = HEOS.components[0]->ancillaries.pV.invert(HEOS._p);
             // Get guesses for the ancillaries for density
-            CoolPropDbl rhoL = HEOS.components[0].ancillaries.rhoL.evaluate(HEOS._TLanc);
-            CoolPropDbl rhoV = HEOS.components[0].ancillaries.rhoV.evaluate(HEOS._TVanc);
+            CoolPropDbl rhoL = HEOS.components[0]->ancillaries.rhoL.evaluate(HEOS._TLanc);
+            CoolPropDbl rhoV = HEOS.components[0]->ancillaries.rhoV.evaluate(HEOS._TVanc);
             // Solve for the density
             HEOS.SatL->update_TP_guessrho(HEOS._TLanc, HEOS._p, rhoL);
             HEOS.SatV->update_TP_guessrho(HEOS._TVanc, HEOS._p, rhoV);
@@ -621,7 +621,7 @@ void FlashRoutines::PQ_flash(HelmholtzEOSMixtureBackend &HEOS)
 			std::vector<CoolPropDbl> K = HEOS.K;
 
 			if (get_config_bool(HENRYS_LAW_TO_GENERATE_VLE_GUESSES) && std::abs(HEOS._Q-1) < 1e-10){
-				const std::vector<CoolPropFluid> & components = HEOS.get_components();
+				const std::vector<shared_ptr<CoolPropFluid> > &components = HEOS.get_components();
 				std::size_t iWater = 0;
 				double p1star = PropsSI("P", "T", Tguess, "Q", 1, "Water");
 				const std::vector<CoolPropDbl> y = HEOS.mole_fractions;
@@ -629,18 +629,18 @@ void FlashRoutines::PQ_flash(HelmholtzEOSMixtureBackend &HEOS)
 				for (std::size_t i = 0; i < components.size(); ++i){
 
 					// Reference to EOS
-					const EquationOfState &EOS = components[i].EOSVector[0];
+					const EquationOfState &EOS = components[i]->EOSVector[0];
 
 					CoolPropDbl Tc = EOS.reduce.T;
 					CoolPropDbl pc = EOS.reduce.p;
 					CoolPropDbl acentric = EOS.acentric;
 
-					if (components[i].CAS == "7732-18-5"){
+					if (components[i]->CAS == "7732-18-5"){
 						iWater = i; continue;
 					}
 					else{
 						double A, B, C, Tmin, Tmax;
-						get_Henrys_coeffs_FP(components[i].CAS, A, B, C, Tmin, Tmax);
+						get_Henrys_coeffs_FP(components[i]->CAS, A, B, C, Tmin, Tmax);
 						double T_R = Tguess / 647.096, tau = 1-T_R;
 						double k_H = p1star*exp(A / T_R + B*pow(tau, 0.355) / T_R + C*pow(T_R, -0.41)*exp(tau));
 						x[i] = y[i]*HEOS._p/k_H;
@@ -1005,7 +1005,7 @@ void FlashRoutines::HSU_D_flash(HelmholtzEOSMixtureBackend &HEOS, parameters oth
 
     if (HEOS.is_pure_or_pseudopure)
     {
-        CoolPropFluid &component = HEOS.components[0];
+        CoolPropFluid &component = *HEOS.components[0];
 
         shared_ptr<HelmholtzEOSMixtureBackend> Sat;
         CoolPropDbl rhoLtriple = component.triple_liquid.rhomolar;
@@ -1520,7 +1520,7 @@ void FlashRoutines::solver_for_rho_given_T_oneof_HSU(HelmholtzEOSMixtureBackend
     if (HEOS._T > HEOS._crit.T)
     {
         CoolPropDbl yc, ymin, y;
-        CoolPropDbl rhoc = HEOS.components[0].crit.rhomolar;
+        CoolPropDbl rhoc = HEOS.components[0]->crit.rhomolar;
         CoolPropDbl rhomin = 1e-10;
         
         // Determine limits for the other variable
@@ -1593,7 +1593,7 @@ void FlashRoutines::solver_for_rho_given_T_oneof_HSU(HelmholtzEOSMixtureBackend
     else if (HEOS._phase == iphase_liquid)
     {
         CoolPropDbl ymelt, yL, y;
-        CoolPropDbl rhomelt = HEOS.components[0].triple_liquid.rhomolar;
+        CoolPropDbl rhomelt = HEOS.components[0]->triple_liquid.rhomolar;
         CoolPropDbl rhoL = static_cast<double>(HEOS._rhoLanc);
         
         switch(other)
@@ -37,7 +37,6 @@ SaturationAncillaryFunction::SaturationAncillaryFunction(rapidjson::Value &json_
             this->type = TYPE_EXPONENTIAL;
         n = cpjson::get_double_array(json_code["n"]);
         N = n.size();
-        s = n;
         t = cpjson::get_double_array(json_code["t"]);
         Tmin = cpjson::get_double(json_code,"Tmin");
         Tmax = cpjson::get_double(json_code,"Tmax");
@@ -63,11 +62,12 @@ double SaturationAncillaryFunction::evaluate(double T)
     {
         double THETA = 1-T/T_r;
 
+        // Summed without a member buffer, since the ancillary is shared by all the states that use the fluid
+        double summer = 0;
         for (std::size_t i = 0; i < N; ++i)
         {
-            s[i] = n[i]*pow(THETA, t[i]);
+            summer += n[i]*pow(THETA, t[i]);
         }
-        double summer = std::accumulate(s.begin(), s.end(), 0.0);
 
         if (type == TYPE_NOT_EXPONENTIAL)
         {
@@ -10,25 +10,45 @@
 #include <map>
 #include <algorithm>
 #include "Configuration.h"
+#include "CPthreads.h"
 
 namespace CoolProp{
 
 // Forward declaration of the necessary debug function to avoid including the whole header
 extern int get_debug_level();
 
+/// An entry of the index of the fluids in a JSON string, as generated by dev/generate_headers.py for all_fluids_JSON
+struct FluidIndexEntry{
+    const char *name, *CAS;
+    const char *aliases; ///< The aliases, separated by |
+    std::size_t offset, length; ///< The position of the JSON object of the fluid in the string
+};
+
 /// A container for the fluid parameters for the CoolProp fluids
 /**
-This container holds copies of all of the fluid instances for the fluids that are loaded in CoolProp.
+This container holds all of the fluid instances for the fluids that are loaded in CoolProp.
 New fluids can be added by passing in a rapidjson::Value instance to the add_one function, or
-a rapidjson array of fluids to the add_many function.
+a rapidjson array of fluids to the add_many function.  Fluids can also be added with add_unparsed,
+in which case only their names are indexed and the JSON object of the fluid is parsed the first
+time that the fluid is retrieved.
+
+The fluid instances are shared with the states that use them, so a fluid must never be modified
+once it has been added; to change a fluid, replace it with a modified copy.
 */
 class JSONFluidLibrary
 {
     /// Map from CAS code to JSON instance.  For pseudo-pure fluids, use name in place of CAS code since no CASE number is defined for mixtures
-    std::map<std::size_t, CoolPropFluid> fluid_map;
+    std::map<std::size_t, shared_ptr<CoolPropFluid> > fluid_map;
     std::vector<std::string> name_vector;
     std::map<std::string, std::size_t> string_to_index_map;
     bool _is_empty;
+    /// The position in its JSON string of each fluid that has been added with add_unparsed but not yet parsed
+    struct UnparsedFluid{
+        const std::string *source;
+        std::size_t offset, length;
+    };
+    std::map<std::size_t, UnparsedFluid> unparsed_map;
+    Mutex parse_mutex; ///< Held while a fluid is looked up in fluid_map and parsed if needed
 protected:
 
     /// Parse the contributions to the residual Helmholtz energy
@@ -1100,6 +1120,29 @@ protected:
         fluid.ancillaries.surface_tension = SurfaceTensionCorrelation(surface_tension);
     };
 
+    /// Parse a fluid that was added with add_unparsed and move it to fluid_map; parse_mutex must be held
+    shared_ptr<CoolPropFluid> parse_unparsed(std::size_t key, const UnparsedFluid &unparsed)
+    {
+        const std::string &name = name_vector[key];
+        if (unparsed.offset + unparsed.length > unparsed.source->size()){
+            throw ValueError(format("Unable to load fluid [%s] due to error: its JSON object is outside of the JSON string", name.c_str()));
+        }
+        rapidjson::Document dd;
+        std::string fluid_string = unparsed.source->substr(unparsed.offset, unparsed.length);
+        dd.Parse<0>(fluid_string.c_str());
+        if (dd.HasParseError() || !dd.IsObject()){
+            throw ValueError(format("Unable to load fluid [%s] due to error: its JSON object could not be parsed", name.c_str()));
+        }
+        shared_ptr<CoolPropFluid> fluid(new CoolPropFluid());
+        parse_one(dd, *fluid);
+        if (fluid->name != name){
+            throw ValueError(format("Unable to load fluid [%s] due to error: the index points at fluid [%s]", name.c_str(), fluid->name.c_str()));
+        }
+        fluid_map[key] = fluid;
+        unparsed_map.erase(key);
+        return fluid;
+    };
+
     /// Validate the fluid file that was just constructed
     void validate(CoolPropFluid & fluid)
     {
@@ -1128,16 +1171,49 @@ public:
         _is_empty = false;
 
         // Get the next index for this fluid
-        std::size_t index = fluid_map.size();
+        std::size_t index = name_vector.size();
 
         // Add index->fluid mapping
-        fluid_map[index] = CoolPropFluid();
+        fluid_map[index].reset(new CoolPropFluid());
 
         // Create an instance of the fluid
-        CoolPropFluid &fluid = fluid_map[index];
+        CoolPropFluid &fluid = *fluid_map[index];
+
+        // Fluid name
+        name_vector.push_back(fluid_json["NAME"].GetString());
+
+        parse_one(fluid_json, fluid);
 
+        // If the fluid is ok...
+        add_to_index(fluid.name, fluid.CAS, fluid.aliases, index);
+    };
+    /** \brief Add a fluid without parsing it; only its names are indexed
+     *
+     * The JSON object of the fluid is taken from source, which must stay alive and unchanged for the lifetime of the library,
+     * and is parsed the first time that the fluid is retrieved
+     */
+    void add_unparsed(const FluidIndexEntry &entry, const std::string &source)
+    {
+        _is_empty = false;
+
+        // Get the next index for this fluid
+        std::size_t index = name_vector.size();
+        name_vector.push_back(entry.name);
+
+        UnparsedFluid &unparsed = unparsed_map[index];
+        unparsed.source = &source;
+        unparsed.offset = entry.offset;
+        unparsed.length = entry.length;
+
+        std::vector<std::string> aliases = strsplit(entry.aliases, '|');
+        aliases.erase(std::remove(aliases.begin(), aliases.end(), std::string()), aliases.end());
+        add_to_index(entry.name, entry.CAS, aliases, index);
+    };
+    /// Fill in fluid from its JSON object
+    void parse_one(rapidjson::Value &fluid_json, CoolPropFluid &fluid)
+    {
         // Fluid name
-        fluid.name = fluid_json["NAME"].GetString(); name_vector.push_back(fluid.name);
+        fluid.name = fluid_json["NAME"].GetString();
 
         try{
             // CAS number
@@ -1155,7 +1231,7 @@ public:
             parse_states(fluid_json["STATES"], fluid);
 
             if (get_debug_level() > 5){
-                std::cout << format("Loading fluid %s with CAS %s; %d fluids loaded\n", fluid.name.c_str(), fluid.CAS.c_str(), index);
+                std::cout << format("Loading fluid %s with CAS %s; %d fluids loaded\n", fluid.name.c_str(), fluid.CAS.c_str(), fluid_map.size());
             }
 
             // Aliases
@@ -1164,6 +1240,14 @@ public:
             // EOS
             parse_EOS_listing(fluid_json["EOS"], fluid);
 
+            #if defined(COOLPROP_GENERATED_KERNELS)
+            // Use the kernel generated ahead of time for the residual Helmholtz energy of this fluid, if there is one
+            GeneratedHelmholtzKernel kernel = get_generated_helmholtz_kernel(fluid.name);
+            if (kernel != NULL && !fluid.EOS().alphar.GenExp.set_kernel(kernel) && get_debug_level() > 0){
+                std::cout << format("The generated kernel for fluid [%s] does not agree with its equation of state; it is not used\n", fluid.name.c_str());
+            }
+            #endif
+
             // Validate the fluid
             validate(fluid);
 
@@ -1209,23 +1293,6 @@ public:
                 parse_transport(fluid_json["TRANSPORT"], fluid);
             }
 
-            // If the fluid is ok...
-
-            // Add CAS->index mapping
-            string_to_index_map[fluid.CAS] = index;
-
-            // Add name->index mapping
-            string_to_index_map[fluid.name] = index;
-
-            // Add the aliases
-            for (std::size_t i = 0; i < fluid.aliases.size(); ++i)
-            {
-                string_to_index_map[fluid.aliases[i]] = index;
-                
-                // Add uppercase alias for EES compatibility
-                string_to_index_map[upper(fluid.aliases[i])] = index;
-            }
-
             if (get_debug_level() > 5){ std::cout << format("Loaded.\n"); }
 
         }
@@ -1233,11 +1300,29 @@ public:
             throw ValueError(format("Unable to load fluid [%s] due to error: %s",fluid.name.c_str(),e.what()));
         }
     };
+    /// Map the CAS number, the name and the aliases of a fluid to its index
+    void add_to_index(const std::string &name, const std::string &CAS, const std::vector<std::string> &aliases, std::size_t index)
+    {
+        // Add CAS->index mapping
+        string_to_index_map[CAS] = index;
+
+        // Add name->index mapping
+        string_to_index_map[name] = index;
+
+        // Add the aliases
+        for (std::size_t i = 0; i < aliases.size(); ++i)
+        {
+            string_to_index_map[aliases[i]] = index;
+            
+            // Add uppercase alias for EES compatibility
+            string_to_index_map[upper(aliases[i])] = index;
+        }
+    };
     /// Get a CoolPropFluid instance stored in this library
     /**
     @param key Either a CAS number or the name (CAS number should be preferred)
     */
-    CoolPropFluid get(const std::string &key)
+    shared_ptr<CoolPropFluid> get(const std::string &key)
     {
         // Try to find it
         std::map<std::string, std::size_t>::const_iterator it = string_to_index_map.find(key);
@@ -1250,7 +1335,9 @@ public:
                 std::string used_name = strsplit(key, '-')[0];
                 it = string_to_index_map.find(used_name);
                 if (it != string_to_index_map.end()){
-                    CoolPropFluid fluid = get(it->second);
+                    // A modified copy of the fluid; the one in the library is left untouched
+                    shared_ptr<CoolPropFluid> pfluid(new CoolPropFluid(*get(it->second)));
+                    CoolPropFluid &fluid = *pfluid;
                     // Remove all the residual contributions to the Helmholtz energy
                     fluid.EOSVector[0].alphar.empty_the_EOS();
                     // Get the parameters for the cubic EOS
@@ -1261,7 +1348,7 @@ public:
                     CoolPropDbl R = 8.3144598; // fluid.EOSVector[0].R_u;
                     // Set the SRK contribution
                     fluid.EOSVector[0].alphar.SRK = ResidualHelmholtzSRK(Tc, pc, rhomolarc, acentric, R);
-                    return fluid;
+                    return pfluid;
                 }
             }
             throw ValueError(format("key [%s] was not found in string_to_index_map in JSONFluidLibrary", key.c_str()));
@@ -1272,17 +1359,28 @@ public:
     /**
     @param key The index of the fluid in the map
     */
-    CoolPropFluid get(std::size_t key)
+    shared_ptr<CoolPropFluid> get(std::size_t key)
     {
+        ScopedLock lock(parse_mutex);
         // Try to find it
-        std::map<std::size_t, CoolPropFluid>::iterator it = fluid_map.find(key);
+        std::map<std::size_t, shared_ptr<CoolPropFluid> >::iterator it = fluid_map.find(key);
         // If it is found
         if (it != fluid_map.end()){
             return it->second;
         }
-        else{
-            throw ValueError(format("key [%d] was not found in JSONFluidLibrary",key));
+        // If it has not been parsed yet, parse it now
+        std::map<std::size_t, UnparsedFluid>::iterator it2 = unparsed_map.find(key);
+        if (it2 != unparsed_map.end()){
+            return parse_unparsed(key, it2->second);
         }
+        throw ValueError(format("key [%d] was not found in JSONFluidLibrary",key));
+    };
+    /// Replace the fluid with the given index, which must be in the library, by another fluid
+    void replace(std::size_t key, const shared_ptr<CoolPropFluid> &fluid)
+    {
+        ScopedLock lock(parse_mutex);
+        fluid_map[key] = fluid;
+        unparsed_map.erase(key);
     };
     void set_fluid_enthalpy_entropy_offset(const std::string &fluid, double delta_a1, double delta_a2, const std::string &ref);
     /// Return a comma-separated list of fluid names
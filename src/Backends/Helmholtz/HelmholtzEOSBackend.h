@@ -29,11 +29,12 @@ inline std::string vecstring_to_string(const std::vector<std::string> &a) {
 class HelmholtzEOSBackend : public HelmholtzEOSMixtureBackend  {
 public:
     HelmholtzEOSBackend(){};
-    HelmholtzEOSBackend(CoolPropFluid Fluid){set_components(std::vector<CoolPropFluid>(1,Fluid));};
+    HelmholtzEOSBackend(const CoolPropFluid &Fluid){set_components(std::vector<shared_ptr<CoolPropFluid> >(1, shared_ptr<CoolPropFluid>(new CoolPropFluid(Fluid))));};
+    HelmholtzEOSBackend(const shared_ptr<CoolPropFluid> &Fluid){set_components(std::vector<shared_ptr<CoolPropFluid> >(1, Fluid));};
     HelmholtzEOSBackend(const std::string &name) : HelmholtzEOSMixtureBackend() {
         Dictionary dict;
         std::vector<double> mole_fractions;
-        std::vector<CoolPropFluid> components;
+        std::vector<shared_ptr<CoolPropFluid> > components;
         CoolProp::JSONFluidLibrary &library = get_library();
         if (is_predefined_mixture(name, dict)){
             std::vector<std::string> fluids = dict.get_string_vector("fluids");
@@ -57,6 +58,11 @@ public:
         if (get_debug_level() > 0){ std::cout << "successfully set up state" << std::endl; }
     };
     virtual ~HelmholtzEOSBackend(){};
+    HelmholtzEOSBackend * clone(){
+        HelmholtzEOSBackend *ptr = new HelmholtzEOSBackend(*this);
+        ptr->make_independent();
+        return ptr;
+    };
     std::string backend_name(void){return "HelmholtzEOSBackend";}
 };
 
@@ -35,7 +35,6 @@
 #include "MixtureParameters.h"
 #include <stdlib.h>
 
-static int deriv_counter = 0;
 
 namespace CoolProp {
 
@@ -43,12 +42,15 @@ HelmholtzEOSMixtureBackend::HelmholtzEOSMixtureBackend(){
     imposed_phase_index = iphase_not_imposed;
     is_pure_or_pseudopure = false;
     N = 0;
+    component_alphar_cached = false;
+    component_alphar_order = 0;
+    alphar_min_order = 0;
     _phase = iphase_unknown;
     // Reset the residual Helmholtz energy class
     residual_helmholtz.reset(new ResidualHelmholtz());
 }
 HelmholtzEOSMixtureBackend::HelmholtzEOSMixtureBackend(const std::vector<std::string> &component_names, bool generate_SatL_and_SatV) {
-    std::vector<CoolPropFluid> components(component_names.size());
+    std::vector<shared_ptr<CoolPropFluid> > components(component_names.size());
     for (unsigned int i = 0; i < components.size(); ++i){
         components[i] = get_library().get(component_names[i]);
     }
@@ -62,7 +64,7 @@ HelmholtzEOSMixtureBackend::HelmholtzEOSMixtureBackend(const std::vector<std::st
     // Set the phase to default unknown value
     _phase = iphase_unknown;
 }
-HelmholtzEOSMixtureBackend::HelmholtzEOSMixtureBackend(const std::vector<CoolPropFluid> &components, bool generate_SatL_and_SatV) {
+HelmholtzEOSMixtureBackend::HelmholtzEOSMixtureBackend(const std::vector<shared_ptr<CoolPropFluid> > &components, bool generate_SatL_and_SatV) {
 
     // Reset the residual Helmholtz energy class
     residual_helmholtz.reset(new ResidualHelmholtz());
@@ -73,11 +75,15 @@ HelmholtzEOSMixtureBackend::HelmholtzEOSMixtureBackend(const std::vector<CoolPro
     // Set the phase to default unknown value
     _phase = iphase_unknown;
 }
-void HelmholtzEOSMixtureBackend::set_components(const std::vector<CoolPropFluid> &components, bool generate_SatL_and_SatV) {
+void HelmholtzEOSMixtureBackend::set_components(const std::vector<shared_ptr<CoolPropFluid> > &components, bool generate_SatL_and_SatV) {
 
-    // Copy the components
+    // Share the components; only the pointers are copied
     this->components = components;
     this->N = components.size();
+    this->component_alphar.resize(N);
+    this->component_alphar_cached = false;
+    this->component_alphar_order = 0;
+    this->alphar_min_order = 0;
     
     is_pure_or_pseudopure = (components.size() == 1);
     if (is_pure_or_pseudopure){
@@ -90,6 +96,11 @@ void HelmholtzEOSMixtureBackend::set_components(const std::vector<CoolPropFluid>
 
     imposed_phase_index = iphase_not_imposed;
 
+    // The transport sub-states belong to the old components
+    viscosity_ECS_reference = ECSReferenceState();
+    conductivity_ECS_reference = ECSReferenceState();
+    transport_component_states.clear();
+
     // Top-level class can hold copies of the base saturation classes,
     // saturation classes cannot hold copies of the saturation classes
     if (generate_SatL_and_SatV)
@@ -100,6 +111,32 @@ void HelmholtzEOSMixtureBackend::set_components(const std::vector<CoolPropFluid>
         SatV->specify_phase(iphase_gas);
     }
 }
+HelmholtzEOSMixtureBackend * HelmholtzEOSMixtureBackend::clone(){
+    HelmholtzEOSMixtureBackend *ptr = new HelmholtzEOSMixtureBackend(*this);
+    ptr->make_independent();
+    return ptr;
+}
+void HelmholtzEOSMixtureBackend::make_independent(){
+    // The departure functions in the excess term cache their derivatives, so they cannot be shared
+    if (residual_helmholtz.get() != NULL){
+        residual_helmholtz.reset(residual_helmholtz->copy());
+    }
+    // Nor can the reducing function, which caches its composition derivatives
+    if (Reducing.get() != NULL){
+        Reducing.reset(Reducing->copy());
+    }
+    if (SatL.get() != NULL){
+        SatL.reset(SatL->clone());
+    }
+    if (SatV.get() != NULL){
+        SatV.reset(SatV->clone());
+    }
+    // Will be regenerated on demand
+    TPD_state.reset();
+    viscosity_ECS_reference.state.reset();
+    conductivity_ECS_reference.state.reset();
+    transport_component_states.clear();
+}
 void HelmholtzEOSMixtureBackend::set_mole_fractions(const std::vector<CoolPropDbl> &mole_fractions)
 {
     if (mole_fractions.size() != N)
@@ -116,8 +153,8 @@ void HelmholtzEOSMixtureBackend::set_mole_fractions(const std::vector<CoolPropDb
     if (this->SatV.get() != NULL){
         this->SatV->resize(N);
     }
-    // Also store the mole fractions as doubles
-    this->mole_fractions_double = std::vector<double>(mole_fractions.begin(), mole_fractions.end());
+    // Also store the mole fractions as doubles, in place so that no memory is allocated once the size is right
+    this->mole_fractions_double.assign(mole_fractions.begin(), mole_fractions.end());
 };
 void HelmholtzEOSMixtureBackend::resize(std::size_t N)
 {
@@ -152,7 +189,7 @@ void HelmholtzEOSMixtureBackend::recalculate_singlephase_phase()
 }
 std::string HelmholtzEOSMixtureBackend::fluid_param_string(const std::string &ParamName)
 {
-    CoolProp::CoolPropFluid cpfluid = get_components()[0];
+    const CoolProp::CoolPropFluid &cpfluid = *get_components()[0];
     if (!ParamName.compare("aliases")){
         return strjoin(cpfluid.aliases, ", ");
     }
@@ -218,7 +255,7 @@ std::string HelmholtzEOSMixtureBackend::get_binary_interaction_string(const std:
 void HelmholtzEOSMixtureBackend::calc_change_EOS(const std::size_t i, const std::string &EOS_name){
 
     if (i < components.size()){
-        CoolPropFluid &fluid = components[i];
+        CoolPropFluid &fluid = get_mutable_component(i);
         EquationOfState &EOS = fluid.EOSVector[0];
 
         if (EOS_name == "SRK"){
@@ -255,9 +292,31 @@ void HelmholtzEOSMixtureBackend::calc_change_EOS(const std::size_t i, const std:
     }
     // Now do the same thing to the saturated liquid and vapor instances if possible
     if (SatL.get() != NULL && SatV.get() != NULL){
-        SatL->change_EOS(i, EOS_name);
-        SatV->change_EOS(i, EOS_name);
+        SatL->components[i] = components[i];
+        SatV->components[i] = components[i];
+        SatL->component_alphar_cached = false;
+        SatV->component_alphar_cached = false;
+    }
+}
+CoolPropFluid &HelmholtzEOSMixtureBackend::get_mutable_component(std::size_t i){
+    if (i >= components.size()){ throw ValueError(format("Index [%d] is invalid", i)); }
+    // Copy-on-write; the component might be shared with the library and other states
+    components[i].reset(new CoolPropFluid(*components[i]));
+    component_alphar_cached = false;
+    return *components[i];
+}
+const HelmholtzDerivatives &HelmholtzEOSMixtureBackend::get_component_alphar(std::size_t i, int max_order){
+    CoolPropDbl tau = this->tau(), delta = this->delta();
+    if (!component_alphar_cached || tau != component_alphar_tau || delta != component_alphar_delta || component_alphar_order < max_order){
+        for (std::size_t j = 0; j < components.size(); ++j){
+            component_alphar[j] = components[j]->EOS().alphar.all(tau, delta, max_order);
+        }
+        component_alphar_tau = tau;
+        component_alphar_delta = delta;
+        component_alphar_order = max_order;
+        component_alphar_cached = true;
     }
+    return component_alphar[i];
 }
 void HelmholtzEOSMixtureBackend::calc_phase_envelope(const std::string &type)
 {
@@ -275,7 +334,7 @@ void HelmholtzEOSMixtureBackend::set_mixture_parameters()
 }
 void HelmholtzEOSMixtureBackend::update_states(void)
 {
-    CoolPropFluid &component = components[0];
+    CoolPropFluid &component = get_mutable_component(0);
     EquationOfState &EOS = component.EOSVector[0];
     
     // Clear the state class
@@ -299,25 +358,25 @@ const CoolProp::SimpleState & HelmholtzEOSMixtureBackend::calc_state(const std::
     if (is_pure_or_pseudopure)
     {
         if (!state.compare("hs_anchor")){
-            return components[0].EOS().hs_anchor;
+            return components[0]->EOS().hs_anchor;
         }
         else if (!state.compare("max_sat_T")){
-            return components[0].EOS().max_sat_T;
+            return components[0]->EOS().max_sat_T;
         }
         else if (!state.compare("max_sat_p")){
-            return components[0].EOS().max_sat_p;
+            return components[0]->EOS().max_sat_p;
         }
         else if (!state.compare("reducing")){
-            return components[0].EOS().reduce;
+            return components[0]->EOS().reduce;
         }
         else if (!state.compare("critical")){
-            return components[0].crit;
+            return components[0]->crit;
         }
         else if (!state.compare("triple_liquid")){
-            return components[0].triple_liquid;
+            return components[0]->triple_liquid;
         }
         else if (!state.compare("triple_vapor")){
-            return components[0].triple_vapor;
+            return components[0]->triple_vapor;
         }
         else{
             throw ValueError(format("This state [%s] is invalid to calc_state",state.c_str()));
@@ -335,7 +394,7 @@ const CoolProp::SimpleState & HelmholtzEOSMixtureBackend::calc_state(const std::
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_acentric_factor(void)
 {
     if (is_pure_or_pseudopure){
-        return components[0].EOS().acentric;
+        return components[0]->EOS().acentric;
     }
     else{
         throw ValueError("acentric factor cannot be calculated for mixtures");
@@ -344,7 +403,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_acentric_factor(void)
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_gas_constant(void)
 {
     if (is_pure_or_pseudopure){
-        return components[0].gas_constant();
+        return components[0]->gas_constant();
     }
     else{
         if (get_config_bool(NORMALIZE_GAS_CONSTANTS)){
@@ -355,7 +414,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_gas_constant(void)
             double summer = 0;
             for (unsigned int i = 0; i < components.size(); ++i)
             {
-                summer += mole_fractions[i]*components[i].gas_constant();
+                summer += mole_fractions[i]*components[i]->gas_constant();
             }
             return summer;
         }
@@ -366,7 +425,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_molar_mass(void)
     double summer = 0;
     for (unsigned int i = 0; i < components.size(); ++i)
     {
-        summer += mole_fractions[i]*components[i].molar_mass();
+        summer += mole_fractions[i]*components[i]->molar_mass();
     }
     return summer;
 }
@@ -379,9 +438,9 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_saturation_ancillary(parameters par
             switch (Q)
             {
                 case 0:
-                    return components[0].ancillaries.pL.evaluate(value);
+                    return components[0]->ancillaries.pL.evaluate(value);
                 case 1:
-                    return components[0].ancillaries.pV.evaluate(value);
+                    return components[0]->ancillaries.pV.evaluate(value);
             }
         }
         else if (param == iT && given == iP){
@@ -389,9 +448,9 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_saturation_ancillary(parameters par
             switch (Q)
             {
                 case 0:
-                    return components[0].ancillaries.pL.invert(value);
+                    return components[0]->ancillaries.pL.invert(value);
                 case 1:
-                    return components[0].ancillaries.pV.invert(value);
+                    return components[0]->ancillaries.pV.invert(value);
             }
         }
         else if (param == iDmolar && given == iT){
@@ -399,9 +458,9 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_saturation_ancillary(parameters par
             switch (Q)
             {
                 case 0:
-                    return components[0].ancillaries.rhoL.evaluate(value);
+                    return components[0]->ancillaries.rhoL.evaluate(value);
                 case 1:
-                    return components[0].ancillaries.rhoV.evaluate(value);
+                    return components[0]->ancillaries.rhoV.evaluate(value);
             }
         }
         else if (param == iT && given == iDmolar){
@@ -409,13 +468,13 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_saturation_ancillary(parameters par
             switch (Q)
             {
                 case 0:
-                    return components[0].ancillaries.rhoL.invert(value);
+                    return components[0]->ancillaries.rhoL.invert(value);
                 case 1:
-                    return components[0].ancillaries.rhoV.invert(value);
+                    return components[0]->ancillaries.rhoV.invert(value);
             }
         }
 		else if (param == isurface_tension && given == iT){
-			return components[0].ancillaries.surface_tension.evaluate(value);
+			return components[0]->ancillaries.surface_tension.evaluate(value);
 		}
         else{
             throw ValueError(format("calc of %s given %s is invalid in calc_saturation_ancillary", 
@@ -435,7 +494,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_melting_line(int param, int given,
 {
     if (is_pure_or_pseudopure)
     {
-        return components[0].ancillaries.melting_line.evaluate(param, given, value);
+        return components[0]->ancillaries.melting_line.evaluate(param, given, value);
     }
     else
     {
@@ -445,7 +504,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_melting_line(int param, int given,
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_surface_tension(void)
 {
     if (is_pure_or_pseudopure){
-		return components[0].ancillaries.surface_tension.evaluate(T());
+		return components[0]->ancillaries.surface_tension.evaluate(T());
     }
     else{
         throw NotImplementedError(format("surface tension not implemented for mixtures"));
@@ -456,7 +515,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_viscosity_dilute(void)
     if (is_pure_or_pseudopure)
     {
         CoolPropDbl eta_dilute;
-        switch(components[0].transport.viscosity_dilute.type)
+        switch(components[0]->transport.viscosity_dilute.type)
         {
         case ViscosityDiluteVariables::VISCOSITY_DILUTE_KINETIC_THEORY:
             eta_dilute = TransportRoutines::viscosity_dilute_kinetic_theory(*this); break;
@@ -473,7 +532,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_viscosity_dilute(void)
         case ViscosityDiluteVariables::VISCOSITY_DILUTE_CYCLOHEXANE:
             eta_dilute = TransportRoutines::viscosity_dilute_cyclohexane(*this); break;
         default:
-            throw ValueError(format("dilute viscosity type [%d] is invalid for fluid %s", components[0].transport.viscosity_dilute.type, name().c_str()));
+            throw ValueError(format("dilute viscosity type [%d] is invalid for fluid %s", components[0]->transport.viscosity_dilute.type, name().c_str()));
         }
         return eta_dilute;
     }
@@ -491,7 +550,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_viscosity_background()
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_viscosity_background(CoolPropDbl eta_dilute, CoolPropDbl &initial_density, CoolPropDbl &residual)
 {
     
-    switch(components[0].transport.viscosity_initial.type){        
+    switch(components[0]->transport.viscosity_initial.type){        
         case ViscosityInitialDensityVariables::VISCOSITY_INITIAL_DENSITY_RAINWATER_FRIEND:
         {
             CoolPropDbl B_eta_initial = TransportRoutines::viscosity_initial_density_dependence_Rainwater_Friend(*this);
@@ -511,7 +570,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_viscosity_background(CoolPropDbl et
     }
 
     // Higher order terms
-    switch(components[0].transport.viscosity_higher_order.type)
+    switch(components[0]->transport.viscosity_higher_order.type)
     {
     case ViscosityHigherOrderVariables::VISCOSITY_HIGHER_ORDER_BATSCHINKI_HILDEBRAND:
         residual = TransportRoutines::viscosity_higher_order_modified_Batschinski_Hildebrand(*this); break;
@@ -530,12 +589,29 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_viscosity_background(CoolPropDbl et
     case ViscosityHigherOrderVariables::VISCOSITY_HIGHER_ORDER_BENZENE:
         residual = TransportRoutines::viscosity_benzene_higher_order_hardcoded(*this); break;
     default:
-        throw ValueError(format("higher order viscosity type [%d] is invalid for fluid %s", components[0].transport.viscosity_dilute.type, name().c_str()));
+        throw ValueError(format("higher order viscosity type [%d] is invalid for fluid %s", components[0]->transport.viscosity_dilute.type, name().c_str()));
     }
 
     return initial_density + residual;
 }
 
+HelmholtzEOSMixtureBackend &HelmholtzEOSMixtureBackend::get_ECS_reference(ECSReferenceState &reference, const std::string &fluid_name){
+    if (reference.state.get() == NULL){
+        std::vector<std::string> names(1, fluid_name);
+        reference.state.reset(new HelmholtzEOSMixtureBackend(names));
+        reference.T0 = -1; reference.rhomolar0 = -1;
+    }
+    return *reference.state;
+}
+HelmholtzEOSMixtureBackend &HelmholtzEOSMixtureBackend::get_transport_component_state(std::size_t i){
+    if (transport_component_states.size() != N){
+        transport_component_states.resize(N);
+    }
+    if (transport_component_states[i].get() == NULL){
+        transport_component_states[i].reset(new HelmholtzEOSBackend(components[i]));
+    }
+    return *transport_component_states[i];
+}
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_viscosity(void)
 {
     if (is_pure_or_pseudopure)
@@ -549,9 +625,9 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_viscosity(void)
         set_warning_string("Mixture model for viscosity is highly approximate");
         CoolPropDbl summer = 0;
         for (std::size_t i = 0; i < mole_fractions.size(); ++i){
-            shared_ptr<HelmholtzEOSBackend> HEOS(new HelmholtzEOSBackend(components[i]));
-            HEOS->update(DmolarT_INPUTS, _rhomolar, _T);
-            summer += mole_fractions[i]*log(HEOS->viscosity());
+            HelmholtzEOSMixtureBackend &HEOS = get_transport_component_state(i);
+            HEOS.update(DmolarT_INPUTS, _rhomolar, _T);
+            summer += mole_fractions[i]*log(HEOS.viscosity());
         }
         return exp(summer);
     }
@@ -563,7 +639,7 @@ void HelmholtzEOSMixtureBackend::calc_viscosity_contributions(CoolPropDbl &dilut
         dilute = 0; initial_density = 0; residual = 0; critical = 0;
 
         // Get a reference for code cleanness
-        CoolPropFluid &component = components[0];
+        CoolPropFluid &component = *components[0];
         
         if (!component.transport.viscosity_model_provided){
             throw ValueError(format("Viscosity model is not available for this fluid"));
@@ -572,13 +648,10 @@ void HelmholtzEOSMixtureBackend::calc_viscosity_contributions(CoolPropDbl &dilut
         // Check if using ECS
         if (component.transport.viscosity_using_ECS)
         {
-            // Get reference fluid name
-            std::string fluid_name  = component.transport.viscosity_ecs.reference_fluid;
-            std::vector<std::string> names(1, fluid_name);
-            // Get a managed pointer to the reference fluid for ECS
-            shared_ptr<HelmholtzEOSMixtureBackend> ref_fluid(new HelmholtzEOSMixtureBackend(names));
-            // Get the viscosity using ECS and stick in the critical value
-            critical = TransportRoutines::viscosity_ECS(*this, *ref_fluid);
+            // Get the reference fluid for ECS, which is kept between calls
+            HelmholtzEOSMixtureBackend &ref_fluid = get_ECS_reference(viscosity_ECS_reference, component.transport.viscosity_ecs.reference_fluid);
+            // Get the viscosity using ECS, starting from the last conformal state, and stick in the critical value
+            critical = TransportRoutines::viscosity_ECS(*this, ref_fluid, viscosity_ECS_reference.T0, viscosity_ECS_reference.rhomolar0);
             return;
         }
 
@@ -637,7 +710,7 @@ void HelmholtzEOSMixtureBackend::calc_conductivity_contributions(CoolPropDbl &di
         dilute = 0; initial_density = 0; residual = 0; critical = 0;
         
         // Get a reference for code cleanness
-        CoolPropFluid &component = components[0];
+        CoolPropFluid &component = *components[0];
         
         if (!component.transport.conductivity_model_provided){
             throw ValueError(format("Thermal conductivity model is not available for this fluid"));
@@ -646,13 +719,10 @@ void HelmholtzEOSMixtureBackend::calc_conductivity_contributions(CoolPropDbl &di
         // Check if using ECS
         if (component.transport.conductivity_using_ECS)
         {
-            // Get reference fluid name
-            std::string fluid_name  = component.transport.conductivity_ecs.reference_fluid;
-            std::vector<std::string> name(1, fluid_name);
-            // Get a managed pointer to the reference fluid for ECS
-            shared_ptr<HelmholtzEOSMixtureBackend> ref_fluid(new HelmholtzEOSMixtureBackend(name));
-            // Get the viscosity using ECS and store in initial_density (not normally used);
-            initial_density = TransportRoutines::conductivity_ECS(*this, *ref_fluid); // Warning: not actually initial_density
+            // Get the reference fluid for ECS, which is kept between calls
+            HelmholtzEOSMixtureBackend &ref_fluid = get_ECS_reference(conductivity_ECS_reference, component.transport.conductivity_ecs.reference_fluid);
+            // Get the conductivity using ECS, starting from the last conformal state, and store in initial_density (not normally used);
+            initial_density = TransportRoutines::conductivity_ECS(*this, ref_fluid, conductivity_ECS_reference.T0, conductivity_ECS_reference.rhomolar0); // Warning: not actually initial_density
             return;
         }
         
@@ -673,7 +743,7 @@ void HelmholtzEOSMixtureBackend::calc_conductivity_contributions(CoolPropDbl &di
                 case CoolProp::TransportPropertyData::CONDUCTIVITY_HARDCODED_METHANE:
                     initial_density = TransportRoutines::conductivity_hardcoded_methane(*this); break;
                 default:
-                    throw ValueError(format("hardcoded conductivity type [%d] is invalid for fluid %s", components[0].transport.hardcoded_conductivity, name().c_str()));
+                    throw ValueError(format("hardcoded conductivity type [%d] is invalid for fluid %s", components[0]->transport.hardcoded_conductivity, name().c_str()));
             }
             return;
         }
@@ -696,7 +766,7 @@ void HelmholtzEOSMixtureBackend::calc_conductivity_contributions(CoolPropDbl &di
             case ConductivityDiluteVariables::CONDUCTIVITY_DILUTE_NONE:
                 dilute = 0.0; break;
             default:
-                throw ValueError(format("dilute conductivity type [%d] is invalid for fluid %s", components[0].transport.conductivity_dilute.type, name().c_str()));
+                throw ValueError(format("dilute conductivity type [%d] is invalid for fluid %s", components[0]->transport.conductivity_dilute.type, name().c_str()));
         }
         
         // Residual part
@@ -716,7 +786,7 @@ void HelmholtzEOSMixtureBackend::calc_conductivity_contributions(CoolPropDbl &di
             case ConductivityCriticalVariables::CONDUCTIVITY_CRITICAL_CARBONDIOXIDE_SCALABRIN_JPCRD_2006:
                 critical = TransportRoutines::conductivity_critical_hardcoded_CO2_ScalabrinJPCRD2006(*this); break;
             default:
-                throw ValueError(format("critical conductivity type [%d] is invalid for fluid %s", components[0].transport.viscosity_dilute.type, name().c_str()));
+                throw ValueError(format("critical conductivity type [%d] is invalid for fluid %s", components[0]->transport.viscosity_dilute.type, name().c_str()));
         }
     }
     else{
@@ -728,14 +798,14 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_conductivity_background(void)
 {
     // Residual part
     CoolPropDbl lambda_residual = _HUGE;
-    switch(components[0].transport.conductivity_residual.type)
+    switch(components[0]->transport.conductivity_residual.type)
     {
     case ConductivityResidualVariables::CONDUCTIVITY_RESIDUAL_POLYNOMIAL:
         lambda_residual = TransportRoutines::conductivity_residual_polynomial(*this); break;
     case ConductivityResidualVariables::CONDUCTIVITY_RESIDUAL_POLYNOMIAL_AND_EXPONENTIAL:
         lambda_residual = TransportRoutines::conductivity_residual_polynomial_and_exponential(*this); break;
     default:
-        throw ValueError(format("residual conductivity type [%d] is invalid for fluid %s", components[0].transport.conductivity_residual.type, name().c_str()));
+        throw ValueError(format("residual conductivity type [%d] is invalid for fluid %s", components[0]->transport.conductivity_residual.type, name().c_str()));
     }
     return lambda_residual;
 }
@@ -752,9 +822,9 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_conductivity(void)
         set_warning_string("Mixture model for conductivity is highly approximate");
         CoolPropDbl summer = 0;
         for (std::size_t i = 0; i < mole_fractions.size(); ++i){
-            shared_ptr<HelmholtzEOSBackend> HEOS(new HelmholtzEOSBackend(components[i]));
-            HEOS->update(DmolarT_INPUTS, _rhomolar, _T);
-            summer += mole_fractions[i]*HEOS->conductivity();
+            HelmholtzEOSMixtureBackend &HEOS = get_transport_component_state(i);
+            HEOS.update(DmolarT_INPUTS, _rhomolar, _T);
+            summer += mole_fractions[i]*HEOS.conductivity();
         }
         return summer;
     }
@@ -788,7 +858,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_Ttriple(void)
 {
     double summer = 0;
     for (unsigned int i = 0; i < components.size(); ++i){
-        summer += mole_fractions[i]*components[i].EOS().Ttriple;
+        summer += mole_fractions[i]*components[i]->EOS().Ttriple;
     }
     return summer;
 }
@@ -796,7 +866,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_p_triple(void)
 {
     double summer = 0;
     for (unsigned int i = 0; i < components.size(); ++i){
-        summer += mole_fractions[i]*components[i].EOS().ptriple;
+        summer += mole_fractions[i]*components[i]->EOS().ptriple;
     }
     return summer;
 }
@@ -806,7 +876,7 @@ std::string HelmholtzEOSMixtureBackend::calc_name(void)
         throw ValueError(format("calc_name is only valid for pure and pseudo-pure fluids, %d components", components.size()));
     }
     else{
-        return components[0].name; 
+        return components[0]->name; 
     }
 }
 void HelmholtzEOSMixtureBackend::calc_ideal_curve(const std::string &type, std::vector<double> &T, std::vector<double> &p){
@@ -835,7 +905,7 @@ std::vector<std::string> HelmholtzEOSMixtureBackend::calc_fluid_names(void)
 	std::vector<std::string> out;
 	for (std::size_t i = 0; i < components.size(); ++i)
 	{
-        out.push_back(components[i].name);
+        out.push_back(components[i]->name);
     }
 	return out;
 }
@@ -845,7 +915,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_ODP(void)
         throw ValueError(format("For now, calc_ODP is only valid for pure and pseudo-pure fluids, %d components", components.size()));
     }
     else{
-        CoolPropDbl v = components[0].environment.ODP;
+        CoolPropDbl v = components[0]->environment.ODP;
         if (!ValidNumber(v) || v < 0){ throw ValueError(format("ODP value is not specified or invalid")); }
         return v;
     }
@@ -856,7 +926,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_GWP20(void)
         throw ValueError(format("For now, calc_GWP20 is only valid for pure and pseudo-pure fluids, %d components", components.size()));
     }
     else{
-        CoolPropDbl v = components[0].environment.GWP20;
+        CoolPropDbl v = components[0]->environment.GWP20;
         if (!ValidNumber(v) || v < 0){ throw ValueError(format("GWP20 value is not specified or invalid"));}
         return v;
     }
@@ -867,7 +937,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_GWP100(void)
         throw ValueError(format("For now, calc_GWP100 is only valid for pure and pseudo-pure fluids, %d components", components.size()));
     }
     else{
-        CoolPropDbl v = components[0].environment.GWP100;
+        CoolPropDbl v = components[0]->environment.GWP100;
         if (!ValidNumber(v) || v < 0){ throw ValueError(format("GWP100 value is not specified or invalid")); }
         return v;
     }
@@ -878,7 +948,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_GWP500(void)
         throw ValueError(format("For now, calc_GWP500 is only valid for pure and pseudo-pure fluids, %d components", components.size()));
     }
     else{
-        CoolPropDbl v = components[0].environment.GWP500;
+        CoolPropDbl v = components[0]->environment.GWP500;
         if (!ValidNumber(v) || v < 0){ throw ValueError(format("GWP500 value is not specified or invalid")); }
         return v;
     }
@@ -896,7 +966,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_T_critical(void)
         }
     }
     else{
-        return components[0].crit.T;
+        return components[0]->crit.T;
     }
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_p_critical(void)
@@ -912,7 +982,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_p_critical(void)
         }
     }
     else{
-        return components[0].crit.p;
+        return components[0]->crit.p;
     }
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_rhomolar_critical(void)
@@ -928,16 +998,16 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_rhomolar_critical(void)
         }
     }
     else{
-        return components[0].crit.rhomolar;
+        return components[0]->crit.rhomolar;
     }
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_pmax_sat(void)
 {
     if (is_pure_or_pseudopure)
     {
-        if (components[0].EOS().pseudo_pure)
+        if (components[0]->EOS().pseudo_pure)
         {
-            return components[0].EOS().max_sat_p.p;
+            return components[0]->EOS().max_sat_p.p;
         }
         else{
             return p_critical();
@@ -951,9 +1021,9 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_Tmax_sat(void)
 {
     if (is_pure_or_pseudopure)
     {
-        if (components[0].EOS().pseudo_pure)
+        if (components[0]->EOS().pseudo_pure)
         {
-            double Tmax_sat = components[0].EOS().max_sat_T.T;
+            double Tmax_sat = components[0]->EOS().max_sat_T.T;
             if (!ValidNumber(Tmax_sat)){
                 return T_critical();
             }
@@ -974,8 +1044,8 @@ void HelmholtzEOSMixtureBackend::calc_Tmin_sat(CoolPropDbl &Tmin_satL, CoolPropD
 {
     if (is_pure_or_pseudopure)
     {
-        Tmin_satL = components[0].EOS().sat_min_liquid.T;
-        Tmin_satV = components[0].EOS().sat_min_vapor.T;
+        Tmin_satL = components[0]->EOS().sat_min_liquid.T;
+        Tmin_satV = components[0]->EOS().sat_min_vapor.T;
         return;
     }
     else{
@@ -987,8 +1057,8 @@ void HelmholtzEOSMixtureBackend::calc_pmin_sat(CoolPropDbl &pmin_satL, CoolPropD
 {
     if (is_pure_or_pseudopure)
     {
-        pmin_satL = components[0].EOS().sat_min_liquid.p;
-        pmin_satV = components[0].EOS().sat_min_vapor.p;
+        pmin_satL = components[0]->EOS().sat_min_liquid.p;
+        pmin_satV = components[0]->EOS().sat_min_vapor.p;
         return;
     }
     else{
@@ -1004,7 +1074,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_Tmax(void)
     double summer = 0;
     for (unsigned int i = 0; i < components.size(); ++i)
     {
-        summer += mole_fractions[i]*components[i].EOS().limits.Tmax;
+        summer += mole_fractions[i]*components[i]->EOS().limits.Tmax;
     }
     return summer;
 }
@@ -1013,7 +1083,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_Tmin(void)
     double summer = 0;
     for (unsigned int i = 0; i < components.size(); ++i)
     {
-        summer += mole_fractions[i]*components[i].EOS().limits.Tmin;
+        summer += mole_fractions[i]*components[i]->EOS().limits.Tmin;
     }
     return summer;
 }
@@ -1022,7 +1092,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_pmax(void)
     double summer = 0;
     for (unsigned int i = 0; i < components.size(); ++i)
     {
-        summer += mole_fractions[i]*components[i].EOS().limits.pmax;
+        summer += mole_fractions[i]*components[i]->EOS().limits.pmax;
     }
     return summer;
 }
@@ -1182,7 +1252,7 @@ const std::vector<CoolPropDbl> HelmholtzEOSMixtureBackend::calc_mass_fractions()
     std::vector<CoolPropDbl> &mole_fractions = get_mole_fractions_ref();
     std::vector<CoolPropDbl> mass_fractions(mole_fractions.size());
     for (std::size_t i = 0; i < mole_fractions.size(); ++i){
-        mass_fractions[i] = (components[i].molar_mass())*(mole_fractions[i])/mm;
+        mass_fractions[i] = (components[i]->molar_mass())*(mole_fractions[i])/mm;
     }
     return mass_fractions;
 }
@@ -1258,7 +1328,7 @@ void HelmholtzEOSMixtureBackend::p_phase_determination_pure_or_pseudopure(int ot
     saturation_called = false;
     
     // Reference declaration to save indexing
-    CoolPropFluid &component = components[0];
+    CoolPropFluid &component = *components[0];
     
     // Maximum saturation temperature - Equal to critical pressure for pure fluids
     CoolPropDbl psat_max = calc_pmax_sat();
@@ -1321,13 +1391,13 @@ void HelmholtzEOSMixtureBackend::p_phase_determination_pure_or_pseudopure(int ot
         }
     }
     // Check between triple point pressure and psat_max
-    else if (_p >= components[0].EOS().ptriple*0.9999 && _p <= psat_max)
+    else if (_p >= components[0]->EOS().ptriple*0.9999 && _p <= psat_max)
     {
         // First try the ancillaries, use them to determine the state if you can
         
         // Calculate dew and bubble temps from the ancillaries (everything needs them)
-        _TLanc = components[0].ancillaries.pL.invert(_p);
-        _TVanc = components[0].ancillaries.pV.invert(_p);
+        _TLanc = components[0]->ancillaries.pL.invert(_p);
+        _TVanc = components[0]->ancillaries.pV.invert(_p);
         
         bool definitely_two_phase = false;
         
@@ -1508,7 +1578,7 @@ void HelmholtzEOSMixtureBackend::p_phase_determination_pure_or_pseudopure(int ot
         _rhomolar = 1/(_Q/HEOS.SatV->rhomolar() + (1-_Q)/HEOS.SatL->rhomolar());
         return;
     }
-    else if (_p < components[0].EOS().ptriple*0.9999)
+    else if (_p < components[0]->EOS().ptriple*0.9999)
     {
         if (other == iT){
             if (_T > std::max(Tmin(), Ttriple())){
@@ -1519,7 +1589,7 @@ void HelmholtzEOSMixtureBackend::p_phase_determination_pure_or_pseudopure(int ot
                     _phase = iphase_gas;
                 }
                 else{
-                    throw NotImplementedError(format("For now, we don't support p [%g Pa] below ptriple [%g Pa] when T [%g] is less than Tmin [%g]",_p, components[0].EOS().ptriple, _T, std::max(Tmin(), Ttriple())) );
+                    throw NotImplementedError(format("For now, we don't support p [%g Pa] below ptriple [%g Pa] when T [%g] is less than Tmin [%g]",_p, components[0]->EOS().ptriple, _T, std::max(Tmin(), Ttriple())) );
                 }
             }
         }
@@ -1550,7 +1620,7 @@ void HelmholtzEOSMixtureBackend::calc_ssat_max(void)
     {
         shared_ptr<CoolProp::HelmholtzEOSMixtureBackend> HEOS_copy(new CoolProp::HelmholtzEOSMixtureBackend(get_components()));
         Residual resid(*HEOS_copy);
-        const CoolProp::SimpleState &tripleV = HEOS_copy->get_components()[0].triple_vapor;
+        const CoolProp::SimpleState &tripleV = HEOS_copy->get_components()[0]->triple_vapor;
         double v1 = resid.call(hsat_max.T);
         double v2 = resid.call(tripleV.T);
         // If there is a sign change, there is a maxima, otherwise there is no local maxima/minima
@@ -1633,8 +1703,8 @@ void HelmholtzEOSMixtureBackend::T_phase_determination_pure_or_pseudopure(int ot
         {
             case iP:
             {
-                _pLanc = components[0].ancillaries.pL.evaluate(_T);
-                _pVanc = components[0].ancillaries.pV.evaluate(_T);
+                _pLanc = components[0]->ancillaries.pL.evaluate(_T);
+                _pVanc = components[0]->ancillaries.pV.evaluate(_T);
                 CoolPropDbl p_vap = 0.98*static_cast<double>(_pVanc);
                 CoolPropDbl p_liq = 1.02*static_cast<double>(_pLanc);
 
@@ -1664,8 +1734,8 @@ void HelmholtzEOSMixtureBackend::T_phase_determination_pure_or_pseudopure(int ot
             default:
             {
                 // Always calculate the densities using the ancillaries
-                _rhoVanc = components[0].ancillaries.rhoV.evaluate(_T);
-                _rhoLanc = components[0].ancillaries.rhoL.evaluate(_T);
+                _rhoVanc = components[0]->ancillaries.rhoV.evaluate(_T);
+                _rhoLanc = components[0]->ancillaries.rhoL.evaluate(_T);
                 CoolPropDbl rho_vap = 0.95*static_cast<double>(_rhoVanc);
                 CoolPropDbl rho_liq = 1.05*static_cast<double>(_rhoLanc);
                 switch (other)
@@ -1687,7 +1757,7 @@ void HelmholtzEOSMixtureBackend::T_phase_determination_pure_or_pseudopure(int ot
                                 _phase = iphase_liquid; // Needed for direct update call
                                 _Q = -1000; // Needed for direct update call
                                 update_DmolarT_direct(value, _T);
-                                CoolPropDbl pL = components[0].ancillaries.pL.evaluate(_T);
+                                CoolPropDbl pL = components[0]->ancillaries.pL.evaluate(_T);
                                 if (Qanc < 0.01 && _p > pL*1.05 && first_partial_deriv(iP, iDmolar, iT) > 0 && second_partial_deriv(iP, iDmolar, iT, iDmolar, iT) > 0){
                                     _phase = iphase_liquid; _Q = -1000; return;
                                 }
@@ -1806,7 +1876,7 @@ void HelmholtzEOSMixtureBackend::T_phase_determination_pure_or_pseudopure(int ot
         _rhomolar = 1/(_Q/HEOS.SatV->rhomolar() + (1-_Q)/HEOS.SatL->rhomolar());
         return;
     }
-    else if (_T > _crit.T && _T > components[0].EOS().Ttriple)
+    else if (_T > _crit.T && _T > components[0]->EOS().Ttriple)
     {
         _Q = 1e9;
         switch (other)
@@ -1864,7 +1934,7 @@ void HelmholtzEOSMixtureBackend::T_phase_determination_pure_or_pseudopure(int ot
     }
     else
     {
-        throw ValueError(format("For now, we don't support T [%g K] below Ttriple [%g K]", _T, components[0].EOS().Ttriple));
+        throw ValueError(format("For now, we don't support T [%g K] below Ttriple [%g K]", _T, components[0]->EOS().Ttriple));
     }
 }
 void get_dT_drho(HelmholtzEOSMixtureBackend *HEOS, parameters index, CoolPropDbl &dT, CoolPropDbl &drho)
@@ -1969,9 +2039,17 @@ CoolPropDbl HelmholtzEOSMixtureBackend::solver_rho_Tp(CoolPropDbl T, CoolPropDbl
         HelmholtzEOSMixtureBackend *HEOS;
         CoolPropDbl T, p, delta, rhor, tau, R_u;
 
+        int alphar_min_order;
+
         solver_TP_resid(HelmholtzEOSMixtureBackend *HEOS, CoolPropDbl T, CoolPropDbl p)
         : HEOS(HEOS),T(T),p(p),delta(_HUGE),rhor(HEOS->get_reducing_state().rhomolar),
-          tau(HEOS->get_reducing_state().T/T),R_u(HEOS->gas_constant()){}
+          tau(HEOS->get_reducing_state().T/T),R_u(HEOS->gas_constant()){
+            // Halley's method needs d3alphar_dDelta3 at every step, so calculate the derivatives up to
+            // third order in one go while solving rather than the lower ones first and then all of them again
+            alphar_min_order = HEOS->alphar_min_order;
+            HEOS->alphar_min_order = std::max(alphar_min_order, 3);
+        }
+        ~solver_TP_resid(){ HEOS->alphar_min_order = alphar_min_order; }
         double call(double rhomolar){
             delta = rhomolar/rhor; // needed for derivative
             HEOS->update_DmolarT_direct(rhomolar, T);
@@ -2015,7 +2093,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::solver_rho_Tp(CoolPropDbl T, CoolPropDbl
         else if (phase == iphase_liquid)
         {
             double rhomolar;
-            CoolPropDbl _rhoLancval = static_cast<CoolPropDbl>(components[0].ancillaries.rhoL.evaluate(T));
+            CoolPropDbl _rhoLancval = static_cast<CoolPropDbl>(components[0]->ancillaries.rhoL.evaluate(T));
             try{
                 // First we try with Halley's method starting at saturated liquid
                 rhomolar = Halley(resid, _rhoLancval, 1e-16, 100, errstring);
@@ -2029,7 +2107,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::solver_rho_Tp(CoolPropDbl T, CoolPropDbl
         }
         else if (phase == iphase_supercritical_liquid){
             
-            CoolPropDbl rhoLancval = static_cast<CoolPropDbl>(components[0].ancillaries.rhoL.evaluate(T));
+            CoolPropDbl rhoLancval = static_cast<CoolPropDbl>(components[0]->ancillaries.rhoL.evaluate(T));
             
             // Next we try with a Brent method bounded solver since the function is 1-1
             double rhomolar = Brent(resid, rhoLancval*0.99, rhomolar_critical()*4, DBL_EPSILON,1e-8,100,errstring);
@@ -2083,7 +2161,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::solver_rho_Tp_SRK(CoolPropDbl T, CoolPro
 
     for (std::size_t i = 0; i < components.size(); ++i)
     {
-        CoolPropDbl Tci = components[i].EOS().reduce.T, pci = components[i].EOS().reduce.p, acentric_i = components[i].EOS().acentric;
+        CoolPropDbl Tci = components[i]->EOS().reduce.T, pci = components[i]->EOS().reduce.p, acentric_i = components[i]->EOS().acentric;
         CoolPropDbl m_i = 0.480+1.574*acentric_i-0.176*pow(acentric_i, 2);
         CoolPropDbl b_i = 0.08664*R_u*Tci/pci;
         b += mole_fractions[i]*b_i;
@@ -2092,7 +2170,7 @@ CoolPropDbl HelmholtzEOSMixtureBackend::solver_rho_Tp_SRK(CoolPropDbl T, CoolPro
 
         for (std::size_t j = 0; j < components.size(); ++j)
         {
-            CoolPropDbl Tcj = components[j].EOS().reduce.T, pcj = components[j].EOS().reduce.p, acentric_j = components[j].EOS().acentric;
+            CoolPropDbl Tcj = components[j]->EOS().reduce.T, pcj = components[j]->EOS().reduce.p, acentric_j = components[j]->EOS().acentric;
             CoolPropDbl m_j = 0.480+1.574*acentric_j-0.176*pow(acentric_j, 2);
 
             CoolPropDbl a_j = 0.42747*pow(R_u*Tcj,2)/pcj*pow(1+m_j*(1-sqrt(T/Tcj)),2);
@@ -2436,7 +2514,7 @@ SimpleState HelmholtzEOSMixtureBackend::calc_reducing_state_nocache(const std::v
 {
     SimpleState reducing;
     if (is_pure_or_pseudopure){
-        reducing = components[0].EOS().reduce;
+        reducing = components[0]->EOS().reduce;
     }
     else{
         reducing.T = Reducing->Tr(mole_fractions);
@@ -2450,21 +2528,24 @@ void HelmholtzEOSMixtureBackend::calc_reducing_state(void)
     _reducing = calc_reducing_state_nocache(mole_fractions);
     _crit = _reducing;
 }
-void HelmholtzEOSMixtureBackend::calc_all_alphar_deriv_cache(const std::vector<CoolPropDbl> &mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta)
+void HelmholtzEOSMixtureBackend::calc_all_alphar_deriv_cache(const std::vector<CoolPropDbl> &mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta, const int max_order)
 {
-    deriv_counter++;
     bool cache_values = true;
-    HelmholtzDerivatives derivs = residual_helmholtz->all(*this, get_mole_fractions_ref(), cache_values);
+    const int order = std::max(max_order, alphar_min_order);
+    HelmholtzDerivatives derivs = residual_helmholtz->all(*this, get_mole_fractions_ref(), cache_values, order);
+    // Only the derivatives that were calculated are cached; the others are calculated if and when they are needed
     _alphar = derivs.alphar;
     _dalphar_dDelta = derivs.dalphar_ddelta;
     _dalphar_dTau = derivs.dalphar_dtau;
     _d2alphar_dDelta2 = derivs.d2alphar_ddelta2;
     _d2alphar_dDelta_dTau = derivs.d2alphar_ddelta_dtau;
     _d2alphar_dTau2 = derivs.d2alphar_dtau2;
+    if (order < 3){ return; }
     _d3alphar_dDelta3 = derivs.d3alphar_ddelta3;
     _d3alphar_dDelta2_dTau = derivs.d3alphar_ddelta2_dtau;
     _d3alphar_dDelta_dTau2 = derivs.d3alphar_ddelta_dtau2;
     _d3alphar_dTau3 = derivs.d3alphar_dtau3;
+    if (order < 4){ return; }
     _d4alphar_dDelta4 = derivs.d4alphar_ddelta4;
     _d4alphar_dDelta3_dTau = derivs.d4alphar_ddelta3_dtau;
     _d4alphar_dDelta2_dTau2 = derivs.d4alphar_ddelta2_dtau2;
@@ -2472,40 +2553,46 @@ void HelmholtzEOSMixtureBackend::calc_all_alphar_deriv_cache(const std::vector<C
     _d4alphar_dTau4 = derivs.d4alphar_dtau4;
 }
 
+void HelmholtzEOSMixtureBackend::calc_all_alphar_deriv_multi(const std::vector<CoolPropDbl> &mole_fractions, const std::vector<CoolPropDbl> &tau, const std::vector<CoolPropDbl> &delta, HelmholtzDerivativesArrays &derivs, const int max_order)
+{
+    if (tau.size() != delta.size()){ throw ValueError(format("Lengths of tau [%d] and delta [%d] are not the same", tau.size(), delta.size())); }
+    if (mole_fractions.size() != components.size()){ throw ValueError(format("Length of mole_fractions [%d] is not the number of components [%d]", mole_fractions.size(), components.size())); }
+    residual_helmholtz->all(*this, mole_fractions, tau, delta, derivs, max_order);
+}
+
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_alphar_deriv_nocache(const int nTau, const int nDelta, const std::vector<CoolPropDbl> &mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta)
 {
     if (is_pure_or_pseudopure)
     {
-        bool dont_use_cache = true;
         if (nTau == 0 && nDelta == 0){
-            return components[0].EOS().alphar.base(tau, delta, dont_use_cache);
+            return components[0]->EOS().alphar.base(tau, delta);
         }
         else if (nTau == 0 && nDelta == 1){
-            return components[0].EOS().alphar.dDelta(tau, delta, dont_use_cache);
+            return components[0]->EOS().alphar.dDelta(tau, delta);
         }
         else if (nTau == 1 && nDelta == 0){
-            return components[0].EOS().alphar.dTau(tau, delta, dont_use_cache);
+            return components[0]->EOS().alphar.dTau(tau, delta);
         }
         else if (nTau == 0 && nDelta == 2){
-            return components[0].EOS().alphar.dDelta2(tau, delta, dont_use_cache);
+            return components[0]->EOS().alphar.dDelta2(tau, delta);
         }
         else if (nTau == 1 && nDelta == 1){
-            return components[0].EOS().alphar.dDelta_dTau(tau, delta, dont_use_cache);
+            return components[0]->EOS().alphar.dDelta_dTau(tau, delta);
         }
         else if (nTau == 2 && nDelta == 0){
-            return components[0].EOS().alphar.dTau2(tau, delta, dont_use_cache);
+            return components[0]->EOS().alphar.dTau2(tau, delta);
         }
         else if (nTau == 0 && nDelta == 3){
-            return components[0].EOS().alphar.dDelta3(tau, delta, dont_use_cache);
+            return components[0]->EOS().alphar.dDelta3(tau, delta);
         }
         else if (nTau == 1 && nDelta == 2){
-            return components[0].EOS().alphar.dDelta2_dTau(tau, delta, dont_use_cache);
+            return components[0]->EOS().alphar.dDelta2_dTau(tau, delta);
         }
         else if (nTau == 2 && nDelta == 1){
-            return components[0].EOS().alphar.dDelta_dTau2(tau, delta, dont_use_cache);
+            return components[0]->EOS().alphar.dDelta_dTau2(tau, delta);
         }
         else if (nTau == 3 && nDelta == 0){
-            return components[0].EOS().alphar.dTau3(tau, delta, dont_use_cache);
+            return components[0]->EOS().alphar.dTau3(tau, delta);
         }
         else
         {
@@ -2517,43 +2604,43 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_alphar_deriv_nocache(const int nTau
         std::size_t N = mole_fractions.size();
         CoolPropDbl summer = 0;
         if (nTau == 0 && nDelta == 0){
-            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i].EOS().baser(tau, delta); }
+            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i]->EOS().baser(tau, delta); }
             return summer + residual_helmholtz->Excess.alphar(mole_fractions);
         }
         else if (nTau == 0 && nDelta == 1){
-            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i].EOS().dalphar_dDelta(tau, delta); }
+            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i]->EOS().dalphar_dDelta(tau, delta); }
             return summer + residual_helmholtz->Excess.dalphar_dDelta(mole_fractions);
         }
         else if (nTau == 1 && nDelta == 0){
-            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i].EOS().dalphar_dTau(tau, delta); }
+            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i]->EOS().dalphar_dTau(tau, delta); }
             return summer + residual_helmholtz->Excess.dalphar_dTau(mole_fractions);
         }
         else if (nTau == 0 && nDelta == 2){
-            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i].EOS().d2alphar_dDelta2(tau, delta); }
+            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i]->EOS().d2alphar_dDelta2(tau, delta); }
             return summer + residual_helmholtz->Excess.d2alphar_dDelta2(mole_fractions);
         }
         else if (nTau == 1 && nDelta == 1){
-            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i].EOS().d2alphar_dDelta_dTau(tau, delta); }
+            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i]->EOS().d2alphar_dDelta_dTau(tau, delta); }
             return summer + residual_helmholtz->Excess.d2alphar_dDelta_dTau(mole_fractions);
         }
         else if (nTau == 2 && nDelta == 0){
-            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i].EOS().d2alphar_dTau2(tau, delta); }
+            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i]->EOS().d2alphar_dTau2(tau, delta); }
             return summer + residual_helmholtz->Excess.d2alphar_dTau2(mole_fractions);
         }
         /*else if (nTau == 0 && nDelta == 3){
-            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i].EOS().d3alphar_dDelta3(tau, delta); }
+            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i]->EOS().d3alphar_dDelta3(tau, delta); }
             return summer + pExcess.d3alphar_dDelta3(tau, delta);
         }
         else if (nTau == 1 && nDelta == 2){
-            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i].EOS().d3alphar_dDelta2_dTau(tau, delta); }
+            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i]->EOS().d3alphar_dDelta2_dTau(tau, delta); }
             return summer + pExcess.d3alphar_dDelta2_dTau(tau, delta);
         }
         else if (nTau == 2 && nDelta == 1){
-            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i].EOS().d3alphar_dDelta_dTau2(tau, delta); }
+            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i]->EOS().d3alphar_dDelta_dTau2(tau, delta); }
             return summer + pExcess.d3alphar_dDelta_dTau2(tau, delta);
         }
         else if (nTau == 3 && nDelta == 0){
-            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i].EOS().d3alphar_dTau3(tau, delta); }
+            for (unsigned int i = 0; i < N; ++i){ summer += mole_fractions[i]*components[i]->EOS().d3alphar_dTau3(tau, delta); }
             return summer + pExcess.d3alphar_dTau3(tau, delta);
         }*/
         else
@@ -2569,34 +2656,34 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_alpha0_deriv_nocache(const int nTau
     if (is_pure_or_pseudopure)
     {
         if (nTau == 0 && nDelta == 0){
-			val = components[0].EOS().base0(tau, delta);
+			val = components[0]->EOS().base0(tau, delta);
         }
         else if (nTau == 0 && nDelta == 1){
-            val = components[0].EOS().dalpha0_dDelta(tau, delta);
+            val = components[0]->EOS().dalpha0_dDelta(tau, delta);
         }
         else if (nTau == 1 && nDelta == 0){
-            val = components[0].EOS().dalpha0_dTau(tau, delta);
+            val = components[0]->EOS().dalpha0_dTau(tau, delta);
         }
         else if (nTau == 0 && nDelta == 2){
-            val = components[0].EOS().d2alpha0_dDelta2(tau, delta);
+            val = components[0]->EOS().d2alpha0_dDelta2(tau, delta);
         }
         else if (nTau == 1 && nDelta == 1){
-            val = components[0].EOS().d2alpha0_dDelta_dTau(tau, delta);
+            val = components[0]->EOS().d2alpha0_dDelta_dTau(tau, delta);
         }
         else if (nTau == 2 && nDelta == 0){
-            val = components[0].EOS().d2alpha0_dTau2(tau, delta);
+            val = components[0]->EOS().d2alpha0_dTau2(tau, delta);
         }
         else if (nTau == 0 && nDelta == 3){
-            val = components[0].EOS().d3alpha0_dDelta3(tau, delta);
+            val = components[0]->EOS().d3alpha0_dDelta3(tau, delta);
         }
         else if (nTau == 1 && nDelta == 2){
-            val = components[0].EOS().d3alpha0_dDelta2_dTau(tau, delta);
+            val = components[0]->EOS().d3alpha0_dDelta2_dTau(tau, delta);
         }
         else if (nTau == 2 && nDelta == 1){
-            val = components[0].EOS().d3alpha0_dDelta_dTau2(tau, delta);
+            val = components[0]->EOS().d3alpha0_dDelta_dTau2(tau, delta);
         }
         else if (nTau == 3 && nDelta == 0){
-            val = components[0].EOS().d3alpha0_dTau3(tau, delta);
+            val = components[0]->EOS().d3alpha0_dTau3(tau, delta);
         }
         else
         {
@@ -2616,28 +2703,28 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_alpha0_deriv_nocache(const int nTau
         CoolPropDbl summer = 0;
         CoolPropDbl tau_i, delta_i, rho_ci, T_ci;
         for (unsigned int i = 0; i < N; ++i){
-            rho_ci = components[i].EOS().reduce.rhomolar;
-            T_ci = components[i].EOS().reduce.T;
+            rho_ci = components[i]->EOS().reduce.rhomolar;
+            T_ci = components[i]->EOS().reduce.T;
             tau_i = T_ci*tau/Tr;
             delta_i = delta*rhor/rho_ci;
 
             if (nTau == 0 && nDelta == 0){
-                summer += mole_fractions[i]*(components[i].EOS().base0(tau_i, delta_i)+log(mole_fractions[i]));
+                summer += mole_fractions[i]*(components[i]->EOS().base0(tau_i, delta_i)+log(mole_fractions[i]));
             }
             else if (nTau == 0 && nDelta == 1){
-                summer += mole_fractions[i]*rhor/rho_ci*components[i].EOS().dalpha0_dDelta(tau_i, delta_i);
+                summer += mole_fractions[i]*rhor/rho_ci*components[i]->EOS().dalpha0_dDelta(tau_i, delta_i);
             }
             else if (nTau == 1 && nDelta == 0){
-                summer += mole_fractions[i]*T_ci/Tr*components[i].EOS().dalpha0_dTau(tau_i, delta_i);
+                summer += mole_fractions[i]*T_ci/Tr*components[i]->EOS().dalpha0_dTau(tau_i, delta_i);
             }
             else if (nTau == 0 && nDelta == 2){
-                summer += mole_fractions[i]*pow(rhor/rho_ci,2)*components[i].EOS().d2alpha0_dDelta2(tau_i, delta_i);
+                summer += mole_fractions[i]*pow(rhor/rho_ci,2)*components[i]->EOS().d2alpha0_dDelta2(tau_i, delta_i);
             }
             else if (nTau == 1 && nDelta == 1){
-                summer += mole_fractions[i]*rhor/rho_ci*T_ci/Tr*components[i].EOS().d2alpha0_dDelta_dTau(tau_i, delta_i);
+                summer += mole_fractions[i]*rhor/rho_ci*T_ci/Tr*components[i]->EOS().d2alpha0_dDelta_dTau(tau_i, delta_i);
             }
             else if (nTau == 2 && nDelta == 0){
-                summer += mole_fractions[i]*pow(T_ci/Tr,2)*components[i].EOS().d2alpha0_dTau2(tau_i, delta_i);
+                summer += mole_fractions[i]*pow(T_ci/Tr,2)*components[i]->EOS().d2alpha0_dTau2(tau_i, delta_i);
             }
             else
             {
@@ -2649,78 +2736,78 @@ CoolPropDbl HelmholtzEOSMixtureBackend::calc_alpha0_deriv_nocache(const int nTau
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_alphar(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 2);
     return static_cast<CoolPropDbl>(_alphar);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_dalphar_dDelta(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 2);
     return static_cast<CoolPropDbl>(_dalphar_dDelta);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_dalphar_dTau(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 2);
     return static_cast<CoolPropDbl>(_dalphar_dTau);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_d2alphar_dTau2(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 2);
     return static_cast<CoolPropDbl>(_d2alphar_dTau2);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_d2alphar_dDelta_dTau(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 2);
     return static_cast<CoolPropDbl>(_d2alphar_dDelta_dTau);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_d2alphar_dDelta2(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 2);
     return static_cast<CoolPropDbl>(_d2alphar_dDelta2);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_d3alphar_dDelta3(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 3);
     return static_cast<CoolPropDbl>(_d3alphar_dDelta3);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_d3alphar_dDelta2_dTau(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 3);
     return static_cast<CoolPropDbl>(_d3alphar_dDelta2_dTau);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_d3alphar_dDelta_dTau2(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 3);
     return static_cast<CoolPropDbl>(_d3alphar_dDelta_dTau2);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_d3alphar_dTau3(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 3);
     return static_cast<CoolPropDbl>(_d3alphar_dTau3);
 }
 
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_d4alphar_dDelta4(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 4);
     return static_cast<CoolPropDbl>(_d4alphar_dDelta4);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_d4alphar_dDelta3_dTau(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 4);
     return static_cast<CoolPropDbl>(_d4alphar_dDelta3_dTau);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_d4alphar_dDelta2_dTau2(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 4);
     return static_cast<CoolPropDbl>(_d4alphar_dDelta2_dTau2);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_d4alphar_dDelta_dTau3(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 4);
     return static_cast<CoolPropDbl>(_d4alphar_dDelta_dTau3);
 }
 CoolPropDbl HelmholtzEOSMixtureBackend::calc_d4alphar_dTau4(void)
 {
-    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta);
+    calc_all_alphar_deriv_cache(mole_fractions, _tau, _delta, 4);
     return static_cast<CoolPropDbl>(_d4alphar_dTau4);
 }
 
@@ -23,8 +23,24 @@ private:
     void pre_update(CoolProp::input_pairs &input_pair, CoolPropDbl &value1, CoolPropDbl &value2 );
     void post_update();
 	shared_ptr<HelmholtzEOSMixtureBackend> TPD_state;
+
+    /// The state of the reference fluid for one of the ECS transport models, kept for the lifetime of this state
+    struct ECSReferenceState{
+        shared_ptr<HelmholtzEOSMixtureBackend> state; ///< Created on first use
+        CoolPropDbl T0, rhomolar0; ///< The last conformal state, used as the starting point of the next solution; negative if there is none
+        ECSReferenceState() : T0(-1), rhomolar0(-1) {};
+    };
+    ECSReferenceState viscosity_ECS_reference, conductivity_ECS_reference;
+    /// The pure component states used by the (approximate) mixture transport models, created on first use
+    std::vector<shared_ptr<HelmholtzEOSMixtureBackend> > transport_component_states;
+    /// Get the state of the reference fluid, making it if it does not exist yet
+    HelmholtzEOSMixtureBackend &get_ECS_reference(ECSReferenceState &reference, const std::string &fluid_name);
+    /// Get the state of the i-th pure component for the mixture transport models, making it if it does not exist yet
+    HelmholtzEOSMixtureBackend &get_transport_component_state(std::size_t i);
 protected:
-    std::vector<CoolPropFluid> components; ///< The components that are in use
+    /// Replace the members that a copy-constructed state would otherwise share with its source by copies of its own
+    void make_independent();
+    std::vector<shared_ptr<CoolPropFluid> > components; ///< The components that are in use; shared between all the states that use the same fluids, so they must not be modified in place
     phases imposed_phase_index;
     bool is_pure_or_pseudopure; ///< A flag for whether the substance is a pure or pseudo-pure fluid (true) or a mixture (false)
     std::vector<CoolPropDbl> mole_fractions; ///< The bulk mole fractions of the mixture
@@ -34,12 +50,24 @@ protected:
 
     SimpleState _crit;
     std::size_t N; ///< Number of components
+
+    /// The residual Helmholtz energy derivatives of each component at the current state.  These are cached here
+    /// rather than in the components since the components are shared between states
+    std::vector<HelmholtzDerivatives> component_alphar;
+    CoolPropDbl component_alphar_tau, component_alphar_delta;
+    bool component_alphar_cached;
+    int component_alphar_order; ///< The highest order of the derivatives in component_alphar
+    /// Whenever the cached derivatives of the residual Helmholtz energy are calculated, they are calculated at least up to this order;
+    /// raised by solvers that are known to need higher derivatives at every step
+    int alphar_min_order;
     
 public:
     HelmholtzEOSMixtureBackend();
-    HelmholtzEOSMixtureBackend(const std::vector<CoolPropFluid> &components, bool generate_SatL_and_SatV = true);
+    HelmholtzEOSMixtureBackend(const std::vector<shared_ptr<CoolPropFluid> > &components, bool generate_SatL_and_SatV = true);
     HelmholtzEOSMixtureBackend(const std::vector<std::string> &component_names, bool generate_SatL_and_SatV = true);
     virtual ~HelmholtzEOSMixtureBackend(){};
+    /// Make an independent copy of this state; the fluids and the reducing function are shared since they are never modified in place
+    virtual HelmholtzEOSMixtureBackend * clone();
     std::string backend_name(void){return "HelmholtzEOSMixtureBackend";}
     shared_ptr<ReducingFunction> Reducing;
     shared_ptr<ResidualHelmholtz> residual_helmholtz;
@@ -50,9 +78,7 @@ public:
     bool clear(){
         // Clear the locally cached values for the derivatives of the residual Helmholtz energy
         // in each component
-        for (std::vector<CoolPropFluid>::iterator it = components.begin(); it != components.end(); ++it){
-            (*it).EOS().alphar.clear();
-        }
+        component_alphar_cached = false;
         return AbstractState::clear();
     };
 
@@ -67,8 +93,8 @@ public:
     bool using_mole_fractions(){return true;}
     bool using_mass_fractions(){return false;}
     bool using_volu_fractions(){return false;}
-    bool is_pure(){ return components.size() == 1 && !components[0].EOS().pseudo_pure; }
-    bool has_melting_line(){ return is_pure_or_pseudopure && components[0].ancillaries.melting_line.enabled();};
+    bool is_pure(){ return components.size() == 1 && !components[0]->EOS().pseudo_pure; }
+    bool has_melting_line(){ return is_pure_or_pseudopure && components[0]->ancillaries.melting_line.enabled();};
     CoolPropDbl calc_melting_line(int param, int given, CoolPropDbl value);
     /// Return a string from the backend for the mixture/fluid
     std::string fluid_param_string(const std::string &);
@@ -120,8 +146,12 @@ public:
 
     const CoolProp::SimpleState &calc_state(const std::string &state);
 
-    const std::vector<CoolPropFluid> &get_components() const {return components;}
-    std::vector<CoolPropFluid> &get_components(){return components;}
+    const std::vector<shared_ptr<CoolPropFluid> > &get_components() const {return components;}
+    std::vector<shared_ptr<CoolPropFluid> > &get_components(){return components;}
+    /// Get a copy of the i-th component that belongs only to this state, so that it can be modified
+    CoolPropFluid &get_mutable_component(std::size_t i);
+    /// Get the derivatives of the residual Helmholtz energy of the i-th component at the current state; only the derivatives up to max_order are guaranteed to be set
+    const HelmholtzDerivatives &get_component_alphar(std::size_t i, int max_order = 4);
     std::vector<CoolPropDbl> &get_K(){ return K; };
     std::vector<CoolPropDbl> &get_lnK(){return lnK;};
     HelmholtzEOSMixtureBackend &get_SatL(){return *SatL;};
@@ -170,7 +200,7 @@ public:
      * @param components The components that are to be used in this mixture
      * @param generate_SatL_and_SatV true if SatL and SatV classes should be added, false otherwise.  Added so that saturation classes can be added without infinite recursion of adding saturation classes
      */
-    void set_components(const std::vector<CoolPropFluid> &components, bool generate_SatL_and_SatV = true);
+    void set_components(const std::vector<shared_ptr<CoolPropFluid> > &components, bool generate_SatL_and_SatV = true);
 
     /** \brief Specify the phase - this phase will always be used in calculations
      * 
@@ -240,11 +270,11 @@ public:
     CoolPropDbl calc_fugacity_coefficient(std::size_t i);
 
     /// Using this backend, calculate the flame hazard
-    CoolPropDbl calc_flame_hazard(void){ return components[0].environment.FH;};
+    CoolPropDbl calc_flame_hazard(void){ return components[0]->environment.FH;};
     /// Using this backend, calculate the health hazard
-    CoolPropDbl calc_health_hazard(void){ return components[0].environment.HH; };
+    CoolPropDbl calc_health_hazard(void){ return components[0]->environment.HH; };
     /// Using this backend, calculate the physical hazard
-    CoolPropDbl calc_physical_hazard(void){ return components[0].environment.PH; };
+    CoolPropDbl calc_physical_hazard(void){ return components[0]->environment.PH; };
 
 	/// Using this backend, calculate the residual Helmholtz energy term \f$\alpha^r\f$ (dimensionless)
     CoolPropDbl calc_alphar(void);
@@ -336,7 +366,14 @@ public:
     std::string calc_name(void);
 	std::vector<std::string> calc_fluid_names(void);
 
-    void calc_all_alphar_deriv_cache(const std::vector<CoolPropDbl> &mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta);
+    /// Calculate the derivatives of the residual Helmholtz energy up to max_order (0 to 4) and store them in the cached values
+    void calc_all_alphar_deriv_cache(const std::vector<CoolPropDbl> &mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta, const int max_order = 4);
+    /** \brief Calculate the derivatives of the residual Helmholtz energy up to max_order (0 to 4) at each of the points (tau[i], delta[i])
+     *
+     * Nothing is cached, and the state of this class is not changed.  This is much faster than updating the state point by point
+     * when the residual Helmholtz energy is wanted at many points, as when building tables.
+     */
+    void calc_all_alphar_deriv_multi(const std::vector<CoolPropDbl> &mole_fractions, const std::vector<CoolPropDbl> &tau, const std::vector<CoolPropDbl> &delta, HelmholtzDerivativesArrays &derivs, const int max_order = 4);
     virtual CoolPropDbl calc_alphar_deriv_nocache(const int nTau, const int nDelta, const std::vector<CoolPropDbl> & mole_fractions, const CoolPropDbl &tau, const CoolPropDbl &delta);
 
     /**
@@ -400,27 +437,35 @@ public:
 class CorrespondingStatesTerm
 {
 public:
-    /// Calculate all the derivatives that do not involve any composition derivatives
-    virtual HelmholtzDerivatives all(HelmholtzEOSMixtureBackend &HEOS, const std::vector<CoolPropDbl> &x, bool cache_values = false)
+    /// Calculate all the derivatives up to max_order that do not involve any composition derivatives
+    virtual HelmholtzDerivatives all(HelmholtzEOSMixtureBackend &HEOS, const std::vector<CoolPropDbl> &x, bool cache_values = false, const int max_order = 4)
     {
         HelmholtzDerivatives summer;
-        const CoolPropDbl tau = HEOS.tau(), delta = HEOS.delta();
         std::size_t N = HEOS.mole_fractions.size();
         for (std::size_t i = 0; i < N; ++i){
-            HelmholtzDerivatives derivs = HEOS.components[i].EOS().alphar.all(tau, delta, cache_values);
-            summer = summer + derivs*HEOS.mole_fractions[i];
+            summer = summer + HEOS.get_component_alphar(i, max_order)*HEOS.mole_fractions[i];
         }
         return summer;
     }
+    /// Calculate all the derivatives up to max_order that do not involve any composition derivatives at each of the points (tau[i], delta[i])
+    virtual void all(HelmholtzEOSMixtureBackend &HEOS, const std::vector<CoolPropDbl> &x, const std::vector<CoolPropDbl> &tau, const std::vector<CoolPropDbl> &delta, HelmholtzDerivativesArrays &derivs, const int max_order = 4)
+    {
+        derivs.resize(tau.size());
+        HelmholtzDerivativesArrays component;
+        for (std::size_t i = 0; i < x.size(); ++i){
+            HEOS.components[i]->EOS().alphar.all(tau, delta, component, max_order);
+            derivs.add(component, x[i]);
+        }
+    }
     CoolPropDbl dalphar_dxi(HelmholtzEOSMixtureBackend &HEOS, std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
     {
         if (xN_flag == XN_INDEPENDENT){
-            return HEOS.components[i].EOS().baser(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).alphar;
         }
         else if (xN_flag == XN_DEPENDENT){
             std::size_t N = x.size();
             if (i == N-1) return 0;
-            return HEOS.components[i].EOS().baser(HEOS.tau(), HEOS.delta()) - HEOS.components[N-1].EOS().baser(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).alphar - HEOS.get_component_alphar(N-1).alphar;
         }
         else{
             throw ValueError(format("xN_flag is invalid"));
@@ -429,12 +474,12 @@ public:
     CoolPropDbl d2alphar_dxi_dTau(HelmholtzEOSMixtureBackend &HEOS, std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
     {
         if (xN_flag == XN_INDEPENDENT){
-            return HEOS.components[i].EOS().dalphar_dTau(HEOS._tau, HEOS._delta);
+            return HEOS.get_component_alphar(i).dalphar_dtau;
         }
         else if (xN_flag == XN_DEPENDENT){
             std::size_t N = x.size();
             if (i==N-1) return 0;
-            return HEOS.components[i].EOS().dalphar_dTau(HEOS._tau, HEOS._delta) - HEOS.components[N-1].EOS().dalphar_dTau(HEOS._tau, HEOS._delta);
+            return HEOS.get_component_alphar(i).dalphar_dtau - HEOS.get_component_alphar(N-1).dalphar_dtau;
         }
         else{
             throw ValueError(format("xN_flag is invalid"));
@@ -443,12 +488,12 @@ public:
     CoolPropDbl d2alphar_dxi_dDelta(HelmholtzEOSMixtureBackend &HEOS, std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
     {
         if (xN_flag == XN_INDEPENDENT){
-            return HEOS.components[i].EOS().dalphar_dDelta(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).dalphar_ddelta;
         }
         else if (xN_flag == XN_DEPENDENT){
             std::size_t N = x.size();
             if (i==N-1) return 0;
-            return HEOS.components[i].EOS().dalphar_dDelta(HEOS.tau(), HEOS.delta()) - HEOS.components[N-1].EOS().dalphar_dDelta(HEOS._tau, HEOS._delta);
+            return HEOS.get_component_alphar(i).dalphar_ddelta - HEOS.get_component_alphar(N-1).dalphar_ddelta;
         }
         else{
             throw ValueError(format("xN_flag is invalid"));
@@ -457,12 +502,12 @@ public:
     CoolPropDbl d3alphar_dxi_dDelta2(HelmholtzEOSMixtureBackend &HEOS, std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
     {
         if (xN_flag == XN_INDEPENDENT){
-            return HEOS.components[i].EOS().d2alphar_dDelta2(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).d2alphar_ddelta2;
         }
         else if (xN_flag == XN_DEPENDENT){
             std::size_t N = x.size();
             if (i==N-1) return 0;
-            return HEOS.components[i].EOS().d2alphar_dDelta2(HEOS.tau(), HEOS.delta()) - HEOS.components[N-1].EOS().d2alphar_dDelta2(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).d2alphar_ddelta2 - HEOS.get_component_alphar(N-1).d2alphar_ddelta2;
         }
         else{
             throw ValueError(format("xN_flag is invalid"));
@@ -471,12 +516,12 @@ public:
     CoolPropDbl d3alphar_dxi_dTau2(HelmholtzEOSMixtureBackend &HEOS, std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
     {
         if (xN_flag == XN_INDEPENDENT){
-            return HEOS.components[i].EOS().d2alphar_dTau2(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).d2alphar_dtau2;
         }
         else if (xN_flag == XN_DEPENDENT){
             std::size_t N = x.size();
             if (i==N-1) return 0;
-            return HEOS.components[i].EOS().d2alphar_dTau2(HEOS.tau(), HEOS.delta()) - HEOS.components[N-1].EOS().d2alphar_dTau2(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).d2alphar_dtau2 - HEOS.get_component_alphar(N-1).d2alphar_dtau2;
         }
         else{
             throw ValueError(format("xN_flag is invalid"));
@@ -485,12 +530,12 @@ public:
     CoolPropDbl d3alphar_dxi_dDelta_dTau(HelmholtzEOSMixtureBackend &HEOS, std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
     {
         if (xN_flag == XN_INDEPENDENT){
-            return HEOS.components[i].EOS().d2alphar_dDelta_dTau(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).d2alphar_ddelta_dtau;
         }
         else if (xN_flag == XN_DEPENDENT){
             std::size_t N = x.size();
             if (i==N-1) return 0;
-            return HEOS.components[i].EOS().d2alphar_dDelta_dTau(HEOS.tau(), HEOS.delta()) - HEOS.components[N-1].EOS().d2alphar_dDelta_dTau(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).d2alphar_ddelta_dtau - HEOS.get_component_alphar(N-1).d2alphar_ddelta_dtau;
         }
         else{
             throw ValueError(format("xN_flag is invalid"));
@@ -513,7 +558,7 @@ public:
     CoolPropDbl d4alphar_dxi_dDelta3(HelmholtzEOSMixtureBackend &HEOS, std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
     {
         if (xN_flag == XN_INDEPENDENT){
-            return HEOS.components[i].EOS().d3alphar_dDelta3(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).d3alphar_ddelta3;
         }
         else{
             throw ValueError(format("xN_flag is invalid"));
@@ -522,7 +567,7 @@ public:
     CoolPropDbl d4alphar_dxi_dTau3(HelmholtzEOSMixtureBackend &HEOS, std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
     {
         if (xN_flag == XN_INDEPENDENT){
-            return HEOS.components[i].EOS().d3alphar_dTau3(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).d3alphar_dtau3;
         }
         else{
             throw ValueError(format("xN_flag is invalid"));
@@ -531,7 +576,7 @@ public:
     CoolPropDbl d4alphar_dxi_dDelta_dTau2(HelmholtzEOSMixtureBackend &HEOS, std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
     {
         if (xN_flag == XN_INDEPENDENT){
-            return HEOS.components[i].EOS().d3alphar_dDelta_dTau2(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).d3alphar_ddelta_dtau2;
         }
         else{
             throw ValueError(format("xN_flag is invalid"));
@@ -540,7 +585,7 @@ public:
     CoolPropDbl d4alphar_dxi_dDelta2_dTau(HelmholtzEOSMixtureBackend &HEOS, std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
     {
         if (xN_flag == XN_INDEPENDENT){
-            return HEOS.components[i].EOS().d3alphar_dDelta2_dTau(HEOS.tau(), HEOS.delta());
+            return HEOS.get_component_alphar(i).d3alphar_ddelta2_dtau;
         }
         else{
             throw ValueError(format("xN_flag is invalid"));
@@ -584,9 +629,18 @@ public:
     ExcessTerm Excess;
     CorrespondingStatesTerm CS;
 
-    virtual HelmholtzDerivatives all(HelmholtzEOSMixtureBackend &HEOS, const std::vector<CoolPropDbl> &mole_fractions, bool cache_values = false)
+    virtual ~ResidualHelmholtz(){};
+    /// Make a copy of this class that does not share the departure functions
+    virtual ResidualHelmholtz *copy(){
+        ResidualHelmholtz *ptr = new ResidualHelmholtz(*this);
+        ptr->Excess = Excess.copy();
+        return ptr;
+    };
+
+    /// All the derivatives of the residual Helmholtz energy w.r.t. tau and delta; only those up to max_order are guaranteed to be set
+    virtual HelmholtzDerivatives all(HelmholtzEOSMixtureBackend &HEOS, const std::vector<CoolPropDbl> &mole_fractions, bool cache_values = false, const int max_order = 4)
     {
-        HelmholtzDerivatives a = CS.all(HEOS, mole_fractions, cache_values) + Excess.all(HEOS.tau(), HEOS.delta(), mole_fractions, cache_values);
+        HelmholtzDerivatives a = CS.all(HEOS, mole_fractions, cache_values, max_order) + Excess.all(HEOS.tau(), HEOS.delta(), mole_fractions, cache_values);
         a.delta_x_dalphar_ddelta = HEOS.delta()*a.dalphar_ddelta;
         a.tau_x_dalphar_dtau = HEOS.tau()*a.dalphar_dtau;
 
@@ -596,6 +650,25 @@ public:
 
         return a;
     }
+    /// All the derivatives of the residual Helmholtz energy w.r.t. tau and delta at each of the points (tau[i], delta[i]); only those up to max_order are guaranteed to be set
+    virtual void all(HelmholtzEOSMixtureBackend &HEOS, const std::vector<CoolPropDbl> &mole_fractions, const std::vector<CoolPropDbl> &tau, const std::vector<CoolPropDbl> &delta, HelmholtzDerivativesArrays &derivs, const int max_order = 4)
+    {
+        CS.all(HEOS, mole_fractions, tau, delta, derivs, max_order);
+        if (Excess.N > 1){
+            // The departure functions keep the values at the point they were last evaluated at, which are those of the current state; leave them alone
+            ExcessTerm excess = Excess.copy();
+            for (std::size_t i = 0; i < tau.size(); ++i){
+                derivs.add(i, excess.all(tau[i], delta[i], mole_fractions));
+            }
+        }
+        for (std::size_t i = 0; i < tau.size(); ++i){
+            derivs.delta_x_dalphar_ddelta[i] = delta[i]*derivs.dalphar_ddelta[i];
+            derivs.tau_x_dalphar_dtau[i] = tau[i]*derivs.dalphar_dtau[i];
+            derivs.delta2_x_d2alphar_ddelta2[i] = POW2(delta[i])*derivs.d2alphar_ddelta2[i];
+            derivs.deltatau_x_d2alphar_ddelta_dtau[i] = delta[i]*tau[i]*derivs.d2alphar_ddelta_dtau[i];
+            derivs.tau2_x_d2alphar_dtau2[i] = POW2(tau[i])*derivs.d2alphar_dtau2[i];
+        }
+    }
     virtual CoolPropDbl dalphar_dxi(HelmholtzEOSMixtureBackend &HEOS, std::size_t i, x_N_dependency_flag xN_flag)
     {
         std::vector<CoolPropDbl> &mole_fractions = HEOS.get_mole_fractions_ref();
@@ -2025,6 +2025,43 @@ TEST_CASE("Mixture derivative checks", "[mixtures],[mixture_derivs]")
         }
     }
 }
+
+TEST_CASE("Cached reducing function values follow in-place changes of the composition", "[mixtures],[reducing_cache]")
+{
+    std::vector<std::string> names = strsplit("Methane&Ethane&Propane", '&');
+    HelmholtzEOSMixtureBackend HEOS(names), fresh(names);
+    std::vector<CoolPropDbl> x1(3), x2(3);
+    x1[0] = 0.5; x1[1] = 0.3; x1[2] = 0.2;
+    x2[0] = 0.2; x2[1] = 0.3; x2[2] = 0.5;
+    HEOS.set_mole_fractions(x1);
+    fresh.set_mole_fractions(x2);
+
+    // Fill the cache for x1, then change the mole fractions in place, as the saturation solvers do
+    std::vector<CoolPropDbl> &x = HEOS.get_mole_fractions_ref();
+    HEOS.Reducing->d_ndrhorbardni_dxj__constxi(x, 0, 1, XN_INDEPENDENT);
+    HEOS.Reducing->d_ndTrdni_dxj__constxi(x, 0, 1, XN_DEPENDENT);
+    x = x2;
+
+    const std::vector<CoolPropDbl> &z = fresh.get_mole_fractions();
+    CHECK(HEOS.Reducing->Tr(x) == fresh.Reducing->Tr(z));
+    CHECK(HEOS.Reducing->rhormolar(x) == fresh.Reducing->rhormolar(z));
+    for (int flag = 0; flag < 2; ++flag){
+        x_N_dependency_flag xN_flag = (flag == 0) ? XN_INDEPENDENT : XN_DEPENDENT;
+        for (std::size_t i = 0; i < 3; ++i){
+            CHECK(HEOS.Reducing->ndTrdni__constnj(x, i, xN_flag) == fresh.Reducing->ndTrdni__constnj(z, i, xN_flag));
+            CHECK(HEOS.Reducing->ndrhorbardni__constnj(x, i, xN_flag) == fresh.Reducing->ndrhorbardni__constnj(z, i, xN_flag));
+            for (std::size_t j = 0; j < 3; ++j){
+                CHECK(HEOS.Reducing->d2Trdxidxj(x, i, j, xN_flag) == fresh.Reducing->d2Trdxidxj(z, i, j, xN_flag));
+                CHECK(HEOS.Reducing->d_ndTrdni_dxj__constxi(x, i, j, xN_flag) == fresh.Reducing->d_ndTrdni_dxj__constxi(z, i, j, xN_flag));
+                CHECK(HEOS.Reducing->d_ndrhorbardni_dxj__constxi(x, i, j, xN_flag) == fresh.Reducing->d_ndrhorbardni_dxj__constxi(z, i, j, xN_flag));
+            }
+        }
+    }
+    // A clone gets a reducing function, and so a cache, of its own
+    shared_ptr<HelmholtzEOSMixtureBackend> copy(HEOS.clone());
+    CHECK(copy->Reducing.get() != HEOS.Reducing.get());
+    CHECK(copy->Reducing->Tr(copy->get_mole_fractions_ref()) == HEOS.Reducing->Tr(x));
+}
 #endif
 
 
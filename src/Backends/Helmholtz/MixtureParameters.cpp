@@ -1,4 +1,5 @@
 #include "MixtureParameters.h"
+#include "CPthreads.h"
 #include "mixture_departure_functions_JSON.h" // Creates the variable mixture_departure_functions_JSON
 #include "mixture_binary_pairs_JSON.h" // Creates the variable mixture_binary_pairs_JSON
 #include "predefined_mixtures_JSON.h" // Makes a std::string variable called predefined_mixtures_JSON
@@ -35,12 +36,13 @@ class PredefinedMixturesLibrary{
         }
     }
 };
-static PredefinedMixturesLibrary predefined_mixtures_library;
+// Loaded the first time it is used
+static LazyInstance<PredefinedMixturesLibrary> predefined_mixtures_library;
 
 std::string get_csv_predefined_mixtures()
 {
     std::vector<std::string> out;
-    for (std::map< std::string, Dictionary >::const_iterator it = predefined_mixtures_library.predefined_mixture_map.begin(); it != predefined_mixtures_library.predefined_mixture_map.end(); ++it)
+    for (std::map< std::string, Dictionary >::const_iterator it = predefined_mixtures_library.get().predefined_mixture_map.begin(); it != predefined_mixtures_library.get().predefined_mixture_map.end(); ++it)
     {
         out.push_back(it->first);
     }
@@ -48,8 +50,8 @@ std::string get_csv_predefined_mixtures()
 }
 
 bool is_predefined_mixture(const std::string &name, Dictionary &dict){
-    std::map<std::string, Dictionary>::const_iterator iter = predefined_mixtures_library.predefined_mixture_map.find(name);
-    if (iter != predefined_mixtures_library.predefined_mixture_map.end()){
+    std::map<std::string, Dictionary>::const_iterator iter = predefined_mixtures_library.get().predefined_mixture_map.find(name);
+    if (iter != predefined_mixtures_library.get().predefined_mixture_map.end()){
         dict = iter->second;
         return true;
     } else { return false; }
@@ -199,20 +201,20 @@ public:
         }
     }
 };
-// The modifiable parameter library
-static MixtureBinaryPairLibrary mixturebinarypairlibrary;
+// The modifiable parameter library, loaded the first time it is used
+static LazyInstance<MixtureBinaryPairLibrary> mixturebinarypairlibrary;
 // A fixed parameter library containing the default values
-static MixtureBinaryPairLibrary mixturebinarypairlibrary_default;
+static LazyInstance<MixtureBinaryPairLibrary> mixturebinarypairlibrary_default;
 
 /// Add a simple mixing rule
 void apply_simple_mixing_rule(const std::string &CAS1, const std::string &CAS2, const std::string &rule){
-    mixturebinarypairlibrary.add_simple_mixing_rule(CAS1, CAS2, rule);
+    mixturebinarypairlibrary.get().add_simple_mixing_rule(CAS1, CAS2, rule);
 }
 
 std::string get_csv_mixture_binary_pairs()
 {
     std::vector<std::string> out;
-    for (std::map< std::vector<std::string>, std::vector<Dictionary> >::const_iterator it = mixturebinarypairlibrary.binary_pair_map.begin(); it != mixturebinarypairlibrary.binary_pair_map.end(); ++it)
+    for (std::map< std::vector<std::string>, std::vector<Dictionary> >::const_iterator it = mixturebinarypairlibrary.get().binary_pair_map.begin(); it != mixturebinarypairlibrary.get().binary_pair_map.end(); ++it)
     {
         out.push_back(strjoin(it->first, "&"));
     }
@@ -226,8 +228,8 @@ std::string get_mixture_binary_pair_data(const std::string &CAS1, const std::str
     CAS.push_back(CAS1);
     CAS.push_back(CAS2);
 
-    if (mixturebinarypairlibrary.binary_pair_map.find(CAS) != mixturebinarypairlibrary.binary_pair_map.end()){
-        std::vector<Dictionary> &v = mixturebinarypairlibrary.binary_pair_map[CAS];
+    if (mixturebinarypairlibrary.get().binary_pair_map.find(CAS) != mixturebinarypairlibrary.get().binary_pair_map.end()){
+        std::vector<Dictionary> &v = mixturebinarypairlibrary.get().binary_pair_map[CAS];
         try{
             if (key == "name1"){ return v[0].get_string("name1"); }
             else if (key == "name2"){ return v[0].get_string("name2"); }
@@ -249,7 +251,7 @@ std::string get_mixture_binary_pair_data(const std::string &CAS1, const std::str
     else{
         // Sort, see if other order works properly
         std::sort(CAS.begin(), CAS.end());
-        if (mixturebinarypairlibrary.binary_pair_map.find(CAS) != mixturebinarypairlibrary.binary_pair_map.end())
+        if (mixturebinarypairlibrary.get().binary_pair_map.find(CAS) != mixturebinarypairlibrary.get().binary_pair_map.end())
         {
             throw ValueError(format("Could not match the binary pair [%s,%s] - order of CAS numbers is backwards; found the swapped CAS numbers.",CAS1.c_str(), CAS2.c_str()));
         }
@@ -265,8 +267,8 @@ void set_mixture_binary_pair_data(const std::string &CAS1, const std::string &CA
     CAS.push_back(CAS1);
     CAS.push_back(CAS2);
 
-    if (mixturebinarypairlibrary.binary_pair_map.find(CAS) != mixturebinarypairlibrary.binary_pair_map.end()){
-        std::vector<Dictionary> &v = mixturebinarypairlibrary.binary_pair_map[CAS];
+    if (mixturebinarypairlibrary.get().binary_pair_map.find(CAS) != mixturebinarypairlibrary.get().binary_pair_map.end()){
+        std::vector<Dictionary> &v = mixturebinarypairlibrary.get().binary_pair_map[CAS];
         try{
             v[0].add_number(key, value);
             double got = v[0].get_double(key);
@@ -282,7 +284,7 @@ void set_mixture_binary_pair_data(const std::string &CAS1, const std::string &CA
     else{
         // Sort, see if other order works properly
         std::sort(CAS.begin(), CAS.end());
-        if (mixturebinarypairlibrary.binary_pair_map.find(CAS) != mixturebinarypairlibrary.binary_pair_map.end())
+        if (mixturebinarypairlibrary.get().binary_pair_map.find(CAS) != mixturebinarypairlibrary.get().binary_pair_map.end())
         {
             throw ValueError(format("Could not match the binary pair [%s,%s] - order of CAS numbers is backwards; found the swapped CAS numbers.",CAS1.c_str(), CAS2.c_str()));
         }
@@ -301,8 +303,8 @@ std::string get_reducing_function_name(const std::string &CAS1, const std::strin
     // Sort the CAS number vector - map is based on sorted CAS codes
     std::sort(CAS.begin(), CAS.end());
 
-    if (mixturebinarypairlibrary.binary_pair_map.find(CAS) != mixturebinarypairlibrary.binary_pair_map.end()){
-        return mixturebinarypairlibrary.binary_pair_map[CAS][0].get_string("function");
+    if (mixturebinarypairlibrary.get().binary_pair_map.find(CAS) != mixturebinarypairlibrary.get().binary_pair_map.end()){
+        return mixturebinarypairlibrary.get().binary_pair_map[CAS][0].get_string("function");
     }
     else{
         throw ValueError(format("Could not match the binary pair [%s,%s] - for now this is an error.",CAS1.c_str(), CAS2.c_str()));
@@ -384,11 +386,12 @@ public:
         }
     }
 };
-static MixtureDepartureFunctionsLibrary mixturedeparturefunctionslibrary;
+// Loaded the first time it is used
+static LazyInstance<MixtureDepartureFunctionsLibrary> mixturedeparturefunctionslibrary;
 
 void MixtureParameters::set_mixture_parameters(HelmholtzEOSMixtureBackend &HEOS)
 {
-    std::vector<CoolPropFluid> components = HEOS.get_components();
+    const std::vector<shared_ptr<CoolPropFluid> > &components = HEOS.get_components();
 
     std::size_t N = components.size();
 
@@ -406,10 +409,10 @@ void MixtureParameters::set_mixture_parameters(HelmholtzEOSMixtureBackend &HEOS)
         {
             if (i == j){ continue; }
 
-            std::string CAS1 = components[i].CAS;
+            std::string CAS1 = components[i]->CAS;
             std::vector<std::string> CAS(2,"");
-            CAS[0] = components[i].CAS;
-            CAS[1] = components[j].CAS;
+            CAS[0] = components[i]->CAS;
+            CAS[1] = components[j]->CAS;
             std::sort(CAS.begin(), CAS.end());
 
             // The variable swapped is true if a swap occured.
@@ -419,13 +422,13 @@ void MixtureParameters::set_mixture_parameters(HelmholtzEOSMixtureBackend &HEOS)
             //         Reducing parameters for binary pair
             // ***************************************************
 
-            if (mixturebinarypairlibrary.binary_pair_map.find(CAS) == mixturebinarypairlibrary.binary_pair_map.end())
+            if (mixturebinarypairlibrary.get().binary_pair_map.find(CAS) == mixturebinarypairlibrary.get().binary_pair_map.end())
             {
                 throw ValueError(format("Could not match the binary pair [%s,%s] - for now this is an error.", CAS[0].c_str(), CAS[1].c_str()));
             }
 
             // Get a reference to the first matching binary pair in the dictionary
-            Dictionary &dict_red = mixturebinarypairlibrary.binary_pair_map[CAS][0];
+            Dictionary &dict_red = mixturebinarypairlibrary.get().binary_pair_map[CAS][0];
 
             // Get the name of the type being used, one of GERG-2008, Lemmon-xi-zeta, etc.
             std::string type_red = dict_red.get_string("type");
@@ -472,10 +475,10 @@ void MixtureParameters::set_mixture_parameters(HelmholtzEOSMixtureBackend &HEOS)
             }
 
             // Get the name of the departure function to be used for this binary pair
-            std::string Name = CoolProp::get_reducing_function_name(components[i].CAS, components[j].CAS);
+            std::string Name = CoolProp::get_reducing_function_name(components[i]->CAS, components[j]->CAS);
 
             // Get the dictionary itself
-            Dictionary &dict_dep = mixturedeparturefunctionslibrary.departure_function_map[Name];
+            Dictionary &dict_dep = mixturedeparturefunctionslibrary.get().departure_function_map[Name];
 
             if (dict_dep.is_empty()){throw ValueError(format("Departure function name [%s] seems to be invalid",Name.c_str()));}
 
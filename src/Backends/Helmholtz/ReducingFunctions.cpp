@@ -2,29 +2,77 @@
 
 namespace CoolProp{
 
-CoolPropDbl ReducingFunction::d_ndTrdni_dxj__constxi(const std::vector<CoolPropDbl> &x, std::size_t i, std::size_t j, x_N_dependency_flag xN_flag)
+void ReducingFunction::calc_nd(const std::vector<CoolPropDbl> &x, x_N_dependency_flag xN_flag)
+{
+    cache.check(x);
+    int k = ReducingFunctionCache::index(xN_flag);
+    if (cache.have_nd[k]){ return; }
+    // GERG Equation 7.54; if x_N is dependent, the sum only runs over the first N-1 components
+    std::size_t Nsum = (xN_flag == XN_INDEPENDENT) ? N : N-1;
+    CoolPropDbl summer_T = 0, summer_rho = 0;
+    for (std::size_t j = 0; j < Nsum; ++j)
+    {
+        summer_T += x[j]*dTrdxi__constxj(x, j, xN_flag);
+        summer_rho += x[j]*drhormolardxi__constxj(x, j, xN_flag);
+    }
+    std::vector<CoolPropDbl> &ndTrdni = cache.ndTrdni[k], &ndrhorbardni = cache.ndrhorbardni[k];
+    ndTrdni.resize(N);
+    ndrhorbardni.resize(N);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        ndTrdni[i] = dTrdxi__constxj(x, i, xN_flag)-summer_T;
+        ndrhorbardni[i] = drhormolardxi__constxj(x, i, xN_flag)-summer_rho;
+    }
+    cache.have_nd[k] = true;
+}
+void ReducingFunction::calc_d_nd(const std::vector<CoolPropDbl> &x, x_N_dependency_flag xN_flag)
 {
-    if (xN_flag == XN_INDEPENDENT){
-        CoolPropDbl s = 0;
-        for (std::size_t k = 0; k < N; k++)
+    cache.check(x);
+    int k = ReducingFunctionCache::index(xN_flag);
+    if (cache.have_d_nd[k]){ return; }
+    STLMatrix &d_ndTrdni_dxj = cache.d_ndTrdni_dxj[k], &d_ndrhorbardni_dxj = cache.d_ndrhorbardni_dxj[k];
+    d_ndTrdni_dxj.resize(N, std::vector<CoolPropDbl>(N, 0));
+    d_ndrhorbardni_dxj.resize(N, std::vector<CoolPropDbl>(N, 0));
+    for (std::size_t j = 0; j < N; ++j)
+    {
+        // The sums only depend on j, so they are shared by all i
+        CoolPropDbl s_T = 0, s_rho = 0;
+        for (std::size_t m = 0; m < N; ++m)
         {
-            s += x[k]*d2Trdxidxj(x,j,k, xN_flag);
+            s_rho += x[m]*d2rhormolardxidxj(x, j, m, xN_flag);
         }
-        return d2Trdxidxj(x,i,j, xN_flag)-dTrdxi__constxj(x,j, xN_flag)-s;
-    }
-    else if (xN_flag == XN_DEPENDENT){
-        if (j == N-1){ return 0;}
-        CoolPropDbl s = 0;
-        for (std::size_t k = 0; k < N-1; k++)
+        if (xN_flag == XN_INDEPENDENT){
+            for (std::size_t m = 0; m < N; ++m)
+            {
+                s_T += x[m]*d2Trdxidxj(x, j, m, xN_flag);
+            }
+        }
+        else if (j != N-1){
+            for (std::size_t m = 0; m < N-1; ++m)
+            {
+                s_T += x[m]*d2Trdxidxj(x, m, j, xN_flag);
+            }
+        }
+        CoolPropDbl dTrdxj = dTrdxi__constxj(x, j, xN_flag), drhordxj = drhormolardxi__constxj(x, j, xN_flag);
+        for (std::size_t i = 0; i < N; ++i)
         {
-            s += x[k]*d2Trdxidxj(x,k,j, xN_flag);
+            // GERG 2004 Monograph equation 7.56 (Gernert, JPCRD, 2014, A29 if x_N is dependent)
+            if (xN_flag == XN_INDEPENDENT){
+                d_ndTrdni_dxj[i][j] = d2Trdxidxj(x, i, j, xN_flag)-dTrdxj-s_T;
+            }
+            else{
+                d_ndTrdni_dxj[i][j] = (j == N-1) ? 0 : d2Trdxidxj(x, j, i, xN_flag)-dTrdxj-s_T;
+            }
+            // GERG 2004 Monograph equation 7.55
+            d_ndrhorbardni_dxj[i][j] = d2rhormolardxidxj(x, j, i, xN_flag)-drhordxj-s_rho;
         }
-        CoolPropDbl val = d2Trdxidxj(x,j,i,xN_flag)-dTrdxi__constxj(x,j, xN_flag)-s;
-        return val;
     }
-    else{
-        throw ValueError(format("xN dependency flag invalid"));
-    }   
+    cache.have_d_nd[k] = true;
+}
+CoolPropDbl ReducingFunction::d_ndTrdni_dxj__constxi(const std::vector<CoolPropDbl> &x, std::size_t i, std::size_t j, x_N_dependency_flag xN_flag)
+{
+    calc_d_nd(x, xN_flag);
+    return cache.d_ndTrdni_dxj[ReducingFunctionCache::index(xN_flag)][i][j];
 }
 CoolPropDbl ReducingFunction::d2_ndTrdni_dxj_dxk__constxi(const std::vector<CoolPropDbl> &x, std::size_t i, std::size_t j, std::size_t k, x_N_dependency_flag xN_flag)
 {
@@ -52,12 +100,8 @@ CoolPropDbl ReducingFunction::d2_ndTrdni_dxj_dxk__constxi(const std::vector<Cool
 }
 CoolPropDbl ReducingFunction::d_ndrhorbardni_dxj__constxi(const std::vector<CoolPropDbl> &x, std::size_t i, std::size_t j, x_N_dependency_flag xN_flag)
 {
-    CoolPropDbl s = 0;
-    for (std::size_t k = 0; k < N; k++)
-    {
-        s += x[k]*d2rhormolardxidxj(x,j,k, xN_flag);
-    }
-    return d2rhormolardxidxj(x,j,i, xN_flag)-drhormolardxi__constxj(x,j, xN_flag)-s;
+    calc_d_nd(x, xN_flag);
+    return cache.d_ndrhorbardni_dxj[ReducingFunctionCache::index(xN_flag)][i][j];
 }
 CoolPropDbl ReducingFunction::d2_ndrhorbardni_dxj_dxk__constxi(const std::vector<CoolPropDbl> &x, std::size_t i, std::size_t j, std::size_t k, x_N_dependency_flag xN_flag)
 {
@@ -70,48 +114,13 @@ CoolPropDbl ReducingFunction::d2_ndrhorbardni_dxj_dxk__constxi(const std::vector
 }
 CoolPropDbl ReducingFunction::ndrhorbardni__constnj(const std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
 {
-    if (xN_flag == XN_INDEPENDENT){
-        CoolPropDbl summer_term1 = 0;
-        for (std::size_t j = 0; j < N; j++)
-        {
-            summer_term1 += x[j]*drhormolardxi__constxj(x,j, xN_flag);
-        }
-        return drhormolardxi__constxj(x,i, xN_flag)-summer_term1;
-    }
-    else if (xN_flag == XN_DEPENDENT){
-        CoolPropDbl summer_term1 = 0;
-        for (std::size_t k = 0; k < N-1; ++k)
-        {
-            summer_term1 += x[k]*drhormolardxi__constxj(x, k, xN_flag);
-        }
-        return drhormolardxi__constxj(x, i, xN_flag)-summer_term1;
-    }
-    else{
-        throw ValueError(format("xN dependency flag invalid"));
-    }
+    calc_nd(x, xN_flag);
+    return cache.ndrhorbardni[ReducingFunctionCache::index(xN_flag)][i];
 }
 CoolPropDbl ReducingFunction::ndTrdni__constnj(const std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
 {
-    if (xN_flag == XN_INDEPENDENT){
-        // GERG Equation 7.54
-        CoolPropDbl summer_term1 = 0;
-        for (std::size_t j = 0; j < N; j++)
-        {
-            summer_term1 += x[j]*dTrdxi__constxj(x,j, xN_flag);
-        }
-        return dTrdxi__constxj(x,i, xN_flag)-summer_term1;
-    }
-    else if (xN_flag == XN_DEPENDENT){
-        CoolPropDbl summer_term1 = 0;
-        for (std::size_t k = 0; k < N-1; ++k)
-        {
-            summer_term1 += x[k]*dTrdxi__constxj(x, k, xN_flag);
-        }
-        return dTrdxi__constxj(x, i, xN_flag)-summer_term1;
-    }
-    else{
-        throw ValueError(format("xN dependency flag invalid"));
-    }
+    calc_nd(x, xN_flag);
+    return cache.ndTrdni[ReducingFunctionCache::index(xN_flag)][i];
 }
 CoolPropDbl ReducingFunction::PSI_rho(const std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
 {
@@ -147,13 +156,55 @@ CoolPropDbl ReducingFunction::d2_PSI_T_dxj_dxk(const std::vector<CoolPropDbl> &x
 }
 
 
+void GERG2008ReducingFunction::calc_Y(const std::vector<CoolPropDbl> &x)
+{
+    cache.check(x);
+    if (cache.have_Y){ return; }
+    cache.Tr = Yr(x, beta_T, gamma_T, T_c, Yc_T);
+    cache.vr = Yr(x, beta_v, gamma_v, v_c, Yc_v);
+    cache.have_Y = true;
+}
+void GERG2008ReducingFunction::calc_dY(const std::vector<CoolPropDbl> &x, x_N_dependency_flag xN_flag)
+{
+    cache.check(x);
+    int k = ReducingFunctionCache::index(xN_flag);
+    if (cache.have_dY[k]){ return; }
+    cache.dTrdxi[k].resize(N);
+    cache.dvrdxi[k].resize(N);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        cache.dTrdxi[k][i] = dYrdxi__constxj(x, i, beta_T, gamma_T, T_c, Yc_T, xN_flag);
+        cache.dvrdxi[k][i] = dYrdxi__constxj(x, i, beta_v, gamma_v, v_c, Yc_v, xN_flag);
+    }
+    cache.have_dY[k] = true;
+}
+void GERG2008ReducingFunction::calc_d2Y(const std::vector<CoolPropDbl> &x, x_N_dependency_flag xN_flag)
+{
+    cache.check(x);
+    int k = ReducingFunctionCache::index(xN_flag);
+    if (cache.have_d2Y[k]){ return; }
+    cache.d2Trdxidxj[k].resize(N, std::vector<CoolPropDbl>(N, 0));
+    cache.d2vrdxidxj[k].resize(N, std::vector<CoolPropDbl>(N, 0));
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t j = 0; j < N; ++j)
+        {
+            cache.d2Trdxidxj[k][i][j] = d2Yrdxidxj(x, i, j, beta_T, gamma_T, T_c, Yc_T, xN_flag);
+            cache.d2vrdxidxj[k][i][j] = d2Yrdxidxj(x, i, j, beta_v, gamma_v, v_c, Yc_v, xN_flag);
+        }
+    }
+    cache.have_d2Y[k] = true;
+}
+
 CoolPropDbl GERG2008ReducingFunction::Tr(const std::vector<CoolPropDbl> &x)
 {
-    return Yr(x, beta_T, gamma_T, T_c, Yc_T);
+    calc_Y(x);
+    return cache.Tr;
 }
 CoolPropDbl GERG2008ReducingFunction::dTrdxi__constxj(const std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
 {
-    return dYrdxi__constxj(x, i, beta_T, gamma_T, T_c, Yc_T, xN_flag);
+    calc_dY(x, xN_flag);
+    return cache.dTrdxi[ReducingFunctionCache::index(xN_flag)][i];
 }
 CoolPropDbl GERG2008ReducingFunction::d2Trdxi2__constxj(const std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
 {
@@ -161,7 +212,8 @@ CoolPropDbl GERG2008ReducingFunction::d2Trdxi2__constxj(const std::vector<CoolPr
 }
 CoolPropDbl GERG2008ReducingFunction::d2Trdxidxj(const std::vector<CoolPropDbl> &x, std::size_t i, std::size_t j, x_N_dependency_flag xN_flag)
 {
-    return d2Yrdxidxj(x, i, j, beta_T, gamma_T, T_c, Yc_T, xN_flag);
+    calc_d2Y(x, xN_flag);
+    return cache.d2Trdxidxj[ReducingFunctionCache::index(xN_flag)][i][j];
 }
 CoolPropDbl GERG2008ReducingFunction::d3Trdxidxjdxk(const std::vector<CoolPropDbl> &x, std::size_t i, std::size_t j, std::size_t k, x_N_dependency_flag xN_flag)
 {
@@ -169,7 +221,8 @@ CoolPropDbl GERG2008ReducingFunction::d3Trdxidxjdxk(const std::vector<CoolPropDb
 }
 CoolPropDbl GERG2008ReducingFunction::rhormolar(const std::vector<CoolPropDbl> &x)
 {
-    return 1/Yr(x, beta_v, gamma_v, v_c, Yc_v);
+    calc_Y(x);
+    return 1/cache.vr;
 }
 CoolPropDbl GERG2008ReducingFunction::drhormolardxi__constxj(const std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
 {
@@ -178,7 +231,8 @@ CoolPropDbl GERG2008ReducingFunction::drhormolardxi__constxj(const std::vector<C
 }
 CoolPropDbl GERG2008ReducingFunction::dvrmolardxi__constxj(const std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
 {
-    return dYrdxi__constxj(x, i, beta_v, gamma_v, v_c, Yc_v, xN_flag);
+    calc_dY(x, xN_flag);
+    return cache.dvrdxi[ReducingFunctionCache::index(xN_flag)][i];
 }
 CoolPropDbl GERG2008ReducingFunction::d2vrmolardxi2__constxj(const std::vector<CoolPropDbl> &x, std::size_t i, x_N_dependency_flag xN_flag)
 {
@@ -186,7 +240,8 @@ CoolPropDbl GERG2008ReducingFunction::d2vrmolardxi2__constxj(const std::vector<C
 }
 CoolPropDbl GERG2008ReducingFunction::d2vrmolardxidxj(const std::vector<CoolPropDbl> &x, std::size_t i, std::size_t j, x_N_dependency_flag xN_flag)
 {
-    return d2Yrdxidxj(x, i, j, beta_v, gamma_v, v_c, Yc_v, xN_flag);
+    calc_d2Y(x, xN_flag);
+    return cache.d2vrdxidxj[ReducingFunctionCache::index(xN_flag)][i][j];
 }
 CoolPropDbl GERG2008ReducingFunction::d3vrmolardxidxjdxk(const std::vector<CoolPropDbl> &x, std::size_t i, std::size_t j, std::size_t k, x_N_dependency_flag xN_flag)
 {
@@ -8,6 +8,7 @@
 #define MIXTURE_BINARY_PAIRS_H
 
 #include <vector>
+#include <algorithm>
 #include "CoolPropFluid.h"
 #include "crossplatform_shared_ptr.h"
 
@@ -21,15 +22,67 @@ enum x_N_dependency_flag{XN_INDEPENDENT, ///< x_N is an independent variable, an
                  
 std::string get_reducing_function_name(const std::string &CAS1, const std::string &CAS2);
 
+/** \brief The composition-dependent values of a reducing function, cached for the composition they were last calculated at
+ *
+ * The mixture derivatives ask for the same reducing terms many times for one composition (several times for each
+ * entry of the Jacobian in the saturation solvers), so they are only calculated once per composition.  The cache
+ * is keyed on the mole fractions themselves, since the solvers update the mole fractions of a state in place.
+ * The arrays indexed by [flag] hold the values for XN_INDEPENDENT and XN_DEPENDENT respectively.
+ */
+struct ReducingFunctionCache
+{
+    std::vector<CoolPropDbl> x; ///< The mole fractions that the cached values belong to
+
+    // Filled in by the reducing function that implements Tr(x) and rhormolar(x)
+    bool have_Y; ///< True if Tr and vr are set
+    CoolPropDbl Tr, vr; ///< The reducing temperature and the reducing molar volume
+    bool have_dY[2]; ///< True if dTrdxi and dvrdxi are set
+    std::vector<CoolPropDbl> dTrdxi[2], dvrdxi[2]; ///< First composition derivatives of \f$T_r\f$ and \f$v_r\f$
+    bool have_d2Y[2]; ///< True if d2Trdxidxj and d2vrdxidxj are set
+    STLMatrix d2Trdxidxj[2], d2vrdxidxj[2]; ///< Second composition derivatives of \f$T_r\f$ and \f$v_r\f$
+
+    // Filled in by ReducingFunction from the derivatives of \f$T_r\f$ and \f$\rho_r\f$
+    bool have_nd[2]; ///< True if ndTrdni and ndrhorbardni are set
+    std::vector<CoolPropDbl> ndTrdni[2], ndrhorbardni[2]; ///< \f$n(\partial T_r/\partial n_i)_{n_j}\f$ and \f$n(\partial \rho_r/\partial n_i)_{n_j}\f$
+    bool have_d_nd[2]; ///< True if d_ndTrdni_dxj and d_ndrhorbardni_dxj are set
+    STLMatrix d_ndTrdni_dxj[2], d_ndrhorbardni_dxj[2]; ///< Their derivatives with respect to \f$x_j\f$, indexed by [i][j]
+
+    ReducingFunctionCache(){ clear(); };
+    /// Mark all the cached values as unset
+    void clear(){
+        have_Y = false;
+        for (int k = 0; k < 2; ++k){ have_dY[k] = false; have_d2Y[k] = false; have_nd[k] = false; have_d_nd[k] = false; }
+    };
+    /// Make the cache hold the values for the composition x, dropping the cached values if the composition has changed
+    void check(const std::vector<CoolPropDbl> &x){
+        if (x.size() != this->x.size() || !std::equal(x.begin(), x.end(), this->x.begin())){
+            this->x = x;
+            clear();
+        }
+    };
+    /// The index of the arrays for the given flag
+    static int index(x_N_dependency_flag xN_flag){
+        if (xN_flag != XN_INDEPENDENT && xN_flag != XN_DEPENDENT){ throw ValueError(format("xN dependency flag invalid")); }
+        return (xN_flag == XN_INDEPENDENT) ? 0 : 1;
+    };
+};
+
 /** \brief Abstract base class for reducing function
  * An abstract base class for the reducing function to allow for
  * Lemmon-Jacobsen, GERG, or other reducing function to yield the 
  * reducing parameters \f$\rho_r\f$ and \f$T_r\f$
+ *
+ * The composition derivatives are cached (see ReducingFunctionCache), so each state needs its own instance; use copy()
 */
 class ReducingFunction
 {
 protected:
     std::size_t N;
+    ReducingFunctionCache cache;
+    /// Make sure that the cached \f$n(\partial Y_r/\partial n_i)_{n_j}\f$ are set for the composition x
+    void calc_nd(const std::vector<CoolPropDbl> &x, x_N_dependency_flag xN_flag);
+    /// Make sure that the cached derivatives of \f$n(\partial Y_r/\partial n_i)_{n_j}\f$ with respect to \f$x_j\f$ are set for the composition x
+    void calc_d_nd(const std::vector<CoolPropDbl> &x, x_N_dependency_flag xN_flag);
 public:
     ReducingFunction():N(0){};
     virtual ~ReducingFunction(){};
@@ -37,6 +90,9 @@ public:
     /// A factory function to generate the requiredreducing function
     static shared_ptr<ReducingFunction> factory(const std::vector<CoolPropFluid*> &components, STLMatrix &F);
 
+    /// Make a new-allocated copy of this reducing function, with its own cache
+    virtual ReducingFunction *copy() = 0;
+
     /// The reduced temperature
     virtual CoolPropDbl Tr(const std::vector<CoolPropDbl> &x) = 0;
     /// The derivative of reduced temperature with respect to component i mole fraction
@@ -103,8 +159,6 @@ public:
  */
 class GERG2008ReducingFunction : public ReducingFunction
 {
-private:
-    GERG2008ReducingFunction(const GERG2008ReducingFunction& that); // No copying
 protected:
     STLMatrix v_c; ///< \f$ v_{c,ij} = \frac{1}{8}\left(v_{c,i}^{1/3}+v_{c,j}^{1/3}\right)^{3}\f$ from GERG-2008
     STLMatrix T_c; ///< \f$ T_{c,ij} = \sqrt{T_{c,i}T_{c,j}} \f$ from GERG=2008
@@ -114,10 +168,17 @@ protected:
     STLMatrix gamma_T; ///< \f$ \gamma_{T,ij} \f$ from GERG-2008
     std::vector<CoolPropDbl> Yc_T; ///< Vector of critical temperatures for all components
     std::vector<CoolPropDbl> Yc_v; ///< Vector of critical molar volumes for all components
-    std::vector<CoolPropFluid> pFluids; ///< List of fluids
+    std::vector<shared_ptr<CoolPropFluid> > pFluids; ///< List of fluids
+
+    /// Make sure that the cached \f$T_r\f$ and \f$v_r\f$ are set for the composition x
+    void calc_Y(const std::vector<CoolPropDbl> &x);
+    /// Make sure that the cached first composition derivatives of \f$T_r\f$ and \f$v_r\f$ are set for the composition x
+    void calc_dY(const std::vector<CoolPropDbl> &x, x_N_dependency_flag xN_flag);
+    /// Make sure that the cached second composition derivatives of \f$T_r\f$ and \f$v_r\f$ are set for the composition x
+    void calc_d2Y(const std::vector<CoolPropDbl> &x, x_N_dependency_flag xN_flag);
 
 public:
-    GERG2008ReducingFunction(std::vector<CoolPropFluid> &pFluids, const STLMatrix &beta_v, const STLMatrix &gamma_v, STLMatrix beta_T, const STLMatrix &gamma_T)
+    GERG2008ReducingFunction(const std::vector<shared_ptr<CoolPropFluid> > &pFluids, const STLMatrix &beta_v, const STLMatrix &gamma_v, STLMatrix beta_T, const STLMatrix &gamma_T)
     {
         this->pFluids = pFluids;
         this->beta_v = beta_v;
@@ -133,16 +194,17 @@ public:
         {
             for (std::size_t j = 0; j < N; j++)
             {
-                T_c[i][j] = sqrt(pFluids[i].EOS().reduce.T*pFluids[j].EOS().reduce.T);
-                v_c[i][j] = 1.0/8.0*pow(pow(pFluids[i].EOS().reduce.rhomolar, -1.0/3.0)+pow(pFluids[j].EOS().reduce.rhomolar, -1.0/3.0),3);
+                T_c[i][j] = sqrt(pFluids[i]->EOS().reduce.T*pFluids[j]->EOS().reduce.T);
+                v_c[i][j] = 1.0/8.0*pow(pow(pFluids[i]->EOS().reduce.rhomolar, -1.0/3.0)+pow(pFluids[j]->EOS().reduce.rhomolar, -1.0/3.0),3);
             }
-            Yc_T[i] = pFluids[i].EOS().reduce.T;
-            Yc_v[i] = 1/pFluids[i].EOS().reduce.rhomolar;
+            Yc_T[i] = pFluids[i]->EOS().reduce.T;
+            Yc_v[i] = 1/pFluids[i]->EOS().reduce.rhomolar;
         }
     };
 
     /// Default destructor
     ~GERG2008ReducingFunction(){};
+    GERG2008ReducingFunction *copy(){ return new GERG2008ReducingFunction(*this); };
     /** \brief The reducing temperature
      * Calculated from \ref Yr with \f$T = Y\f$
      */
@@ -362,11 +424,11 @@ public:
 class ConstantReducingFunction : public ReducingFunction
 {
 private:
-    ConstantReducingFunction(const ConstantReducingFunction& that); // No copying
 	double T_c, rhomolar_c;
 
 public:
 	ConstantReducingFunction(const double T_c, const double rhomolar_c) : T_c(T_c), rhomolar_c(rhomolar_c) {};
+    ConstantReducingFunction *copy(){ return new ConstantReducingFunction(*this); };
 
     /// \brief The reducing temperature
 	CoolPropDbl Tr(const std::vector<CoolPropDbl> &x){ return T_c; };
@@ -420,7 +482,7 @@ protected:
     LemmonAirHFCReducingFunction(const LemmonAirHFCReducingFunction &);
 public:
     /// Set the coefficients based on reducing parameters loaded from JSON
-    static void convert_to_GERG(std::vector<CoolPropFluid> &pFluids,
+    static void convert_to_GERG(const std::vector<shared_ptr<CoolPropFluid> > &pFluids,
                                 std::size_t i,
                                 std::size_t j,
                                 const Dictionary &d,
@@ -433,9 +495,9 @@ public:
         CoolPropDbl zeta_ij = d.get_number("zeta");
         beta_T = 1;
         beta_v = 1;
-        gamma_T = (pFluids[i].EOS().reduce.T + pFluids[j].EOS().reduce.T + xi_ij)/(2*sqrt(pFluids[i].EOS().reduce.T*pFluids[j].EOS().reduce.T));
-        CoolPropDbl v_i = 1/pFluids[i].EOS().reduce.rhomolar;
-        CoolPropDbl v_j = 1/pFluids[j].EOS().reduce.rhomolar;
+        gamma_T = (pFluids[i]->EOS().reduce.T + pFluids[j]->EOS().reduce.T + xi_ij)/(2*sqrt(pFluids[i]->EOS().reduce.T*pFluids[j]->EOS().reduce.T));
+        CoolPropDbl v_i = 1/pFluids[i]->EOS().reduce.rhomolar;
+        CoolPropDbl v_j = 1/pFluids[j]->EOS().reduce.rhomolar;
         CoolPropDbl one_third = 1.0/3.0;
         gamma_v = (v_i + v_j + zeta_ij)/(0.25*pow(pow(v_i, one_third)+pow(v_j, one_third),3));
     };
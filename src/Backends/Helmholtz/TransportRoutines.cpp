@@ -8,8 +8,8 @@ CoolPropDbl TransportRoutines::viscosity_dilute_kinetic_theory(HelmholtzEOSMixtu
 {
     if (HEOS.is_pure_or_pseudopure)
     {
-        CoolPropDbl Tstar = HEOS.T()/HEOS.components[0].transport.epsilon_over_k;
-        CoolPropDbl sigma_nm = HEOS.components[0].transport.sigma_eta*1e9; // 1e9 to convert from m to nm
+        CoolPropDbl Tstar = HEOS.T()/HEOS.components[0]->transport.epsilon_over_k;
+        CoolPropDbl sigma_nm = HEOS.components[0]->transport.sigma_eta*1e9; // 1e9 to convert from m to nm
         CoolPropDbl molar_mass_kgkmol = HEOS.molar_mass()*1000; // 1000 to convert from kg/mol to kg/kmol
 
         // The nondimensional empirical collision integral from Neufeld
@@ -30,14 +30,14 @@ CoolPropDbl TransportRoutines::viscosity_dilute_collision_integral(HelmholtzEOSM
     if (HEOS.is_pure_or_pseudopure)
     {
         // Retrieve values from the state class
-        CoolProp::ViscosityDiluteGasCollisionIntegralData &data = HEOS.components[0].transport.viscosity_dilute.collision_integral;
+        CoolProp::ViscosityDiluteGasCollisionIntegralData &data = HEOS.components[0]->transport.viscosity_dilute.collision_integral;
         const std::vector<CoolPropDbl> &a = data.a, &t = data.t;
         const CoolPropDbl C = data.C, molar_mass = data.molar_mass;
 
         CoolPropDbl S;
         // Unit conversions and variable definitions
-        const CoolPropDbl Tstar = HEOS.T()/HEOS.components[0].transport.epsilon_over_k;
-        const CoolPropDbl sigma_nm = HEOS.components[0].transport.sigma_eta*1e9; // 1e9 to convert from m to nm
+        const CoolPropDbl Tstar = HEOS.T()/HEOS.components[0]->transport.epsilon_over_k;
+        const CoolPropDbl sigma_nm = HEOS.components[0]->transport.sigma_eta*1e9; // 1e9 to convert from m to nm
         const CoolPropDbl molar_mass_kgkmol = molar_mass*1000; // 1000 to convert from kg/mol to kg/kmol
 
         /// Both the collision integral \f$\mathfrak{S}^*\f$ and effective cross section \f$\Omega^{(2,2)}\f$ have the same form,
@@ -63,7 +63,7 @@ CoolPropDbl TransportRoutines::viscosity_dilute_powers_of_T(HelmholtzEOSMixtureB
     if (HEOS.is_pure_or_pseudopure)
     {
         // Retrieve values from the state class
-        CoolProp::ViscosityDiluteGasPowersOfT &data = HEOS.components[0].transport.viscosity_dilute.powers_of_T;
+        CoolProp::ViscosityDiluteGasPowersOfT &data = HEOS.components[0]->transport.viscosity_dilute.powers_of_T;
         const std::vector<CoolPropDbl> &a = data.a, &t = data.t;
 
         CoolPropDbl summer = 0, T = HEOS.T();
@@ -82,7 +82,7 @@ CoolPropDbl TransportRoutines::viscosity_dilute_powers_of_Tr(HelmholtzEOSMixture
     if (HEOS.is_pure_or_pseudopure)
     {
         // Retrieve values from the state class
-        CoolProp::ViscosityDiluteGasPowersOfTr &data = HEOS.components[0].transport.viscosity_dilute.powers_of_Tr;
+        CoolProp::ViscosityDiluteGasPowersOfTr &data = HEOS.components[0]->transport.viscosity_dilute.powers_of_Tr;
         const std::vector<CoolPropDbl> &a = data.a, &t = data.t;
         CoolPropDbl summer = 0, Tr = HEOS.T()/data.T_reducing;
         for (std::size_t i = 0; i < a.size(); ++i){
@@ -100,7 +100,7 @@ CoolPropDbl TransportRoutines::viscosity_dilute_collision_integral_powers_of_T(H
     if (HEOS.is_pure_or_pseudopure)
     {
         // Retrieve values from the state class
-        CoolProp::ViscosityDiluteCollisionIntegralPowersOfTstarData &data = HEOS.components[0].transport.viscosity_dilute.collision_integral_powers_of_Tstar;
+        CoolProp::ViscosityDiluteCollisionIntegralPowersOfTstarData &data = HEOS.components[0]->transport.viscosity_dilute.collision_integral_powers_of_Tstar;
         const std::vector<CoolPropDbl> &a = data.a, &t = data.t;
 
         CoolPropDbl summer = 0, Tstar = HEOS.T()/data.T_reducing;
@@ -119,7 +119,7 @@ CoolPropDbl TransportRoutines::viscosity_higher_order_modified_Batschinski_Hilde
 {
     if (HEOS.is_pure_or_pseudopure)
     {
-        CoolProp::ViscosityModifiedBatschinskiHildebrandData &HO = HEOS.components[0].transport.viscosity_higher_order.modified_Batschinski_Hildebrand;
+        CoolProp::ViscosityModifiedBatschinskiHildebrandData &HO = HEOS.components[0]->transport.viscosity_higher_order.modified_Batschinski_Hildebrand;
 
         CoolPropDbl delta = HEOS.rhomolar()/HO.rhomolar_reduce, tau = HO.T_reduce/HEOS.T();
 
@@ -159,12 +159,12 @@ CoolPropDbl TransportRoutines::viscosity_initial_density_dependence_Rainwater_Fr
     if (HEOS.is_pure_or_pseudopure)
     {
         // Retrieve values from the state class
-        CoolProp::ViscosityRainWaterFriendData &data = HEOS.components[0].transport.viscosity_initial.rainwater_friend;
+        CoolProp::ViscosityRainWaterFriendData &data = HEOS.components[0]->transport.viscosity_initial.rainwater_friend;
         const std::vector<CoolPropDbl> &b = data.b, &t = data.t;
 
         CoolPropDbl B_eta, B_eta_star;
-        CoolPropDbl Tstar = HEOS.T()/HEOS.components[0].transport.epsilon_over_k; // [no units]
-        CoolPropDbl sigma = HEOS.components[0].transport.sigma_eta; // [m]
+        CoolPropDbl Tstar = HEOS.T()/HEOS.components[0]->transport.epsilon_over_k; // [no units]
+        CoolPropDbl sigma = HEOS.components[0]->transport.sigma_eta; // [m]
 
         CoolPropDbl summer = 0;
         for (unsigned int i = 0; i < b.size(); ++i){
@@ -185,7 +185,7 @@ CoolPropDbl TransportRoutines::viscosity_initial_density_dependence_empirical(He
     if (HEOS.is_pure_or_pseudopure)
     {
         // Retrieve values from the state class
-        CoolProp::ViscosityInitialDensityEmpiricalData &data = HEOS.components[0].transport.viscosity_initial.empirical;
+        CoolProp::ViscosityInitialDensityEmpiricalData &data = HEOS.components[0]->transport.viscosity_initial.empirical;
         const std::vector<CoolPropDbl> &n = data.n, &d = data.d, &t = data.t;
 
         CoolPropDbl tau = data.T_reducing/HEOS.T(); // [no units]
@@ -369,7 +369,7 @@ CoolPropDbl TransportRoutines::viscosity_higher_order_friction_theory(HelmholtzE
 {
     if (HEOS.is_pure_or_pseudopure)
     {
-        CoolProp::ViscosityFrictionTheoryData &F = HEOS.components[0].transport.viscosity_higher_order.friction_theory;
+        CoolProp::ViscosityFrictionTheoryData &F = HEOS.components[0]->transport.viscosity_higher_order.friction_theory;
 
         CoolPropDbl tau = F.T_reduce/HEOS.T(), kii = 0, krrr = 0, kaaa = 0, krr, kdrdr;
 
@@ -584,7 +584,7 @@ CoolPropDbl TransportRoutines::viscosity_ethane_higher_order_hardcoded(Helmholtz
 CoolPropDbl TransportRoutines::viscosity_Chung(HelmholtzEOSMixtureBackend &HEOS)
 {
     // Retrieve values from the state class
-    CoolProp::ViscosityChungData &data = HEOS.components[0].transport.viscosity_Chung;
+    CoolProp::ViscosityChungData &data = HEOS.components[0]->transport.viscosity_Chung;
 
     double a0[] = { 0, 6.32402, 0.12102e-2, 5.28346, 6.62263, 19.74540, -1.89992, 24.27450, 0.79716, -0.23816, 0.68629e-1 };
     double a1[] = { 0, 50.41190, -0.11536e-2, 254.20900, 38.09570, 7.63034, -12.53670, 3.44945, 1.11764, 0.67695e-1, 0.34793 };
@@ -633,7 +633,7 @@ CoolPropDbl TransportRoutines::conductivity_dilute_ratio_polynomials(HelmholtzEO
     if (HEOS.is_pure_or_pseudopure)
     {
         // Retrieve values from the state class
-        CoolProp::ConductivityDiluteRatioPolynomialsData &data = HEOS.components[0].transport.conductivity_dilute.ratio_polynomials;
+        CoolProp::ConductivityDiluteRatioPolynomialsData &data = HEOS.components[0]->transport.conductivity_dilute.ratio_polynomials;
 
         CoolPropDbl summer1 = 0, summer2 = 0, Tr = HEOS.T()/data.T_reducing;
         for (std::size_t i = 0; i < data.A.size(); ++i)
@@ -656,7 +656,7 @@ CoolPropDbl TransportRoutines::conductivity_residual_polynomial(HelmholtzEOSMixt
     if (HEOS.is_pure_or_pseudopure)
     {
         // Retrieve values from the state class
-        CoolProp::ConductivityResidualPolynomialData &data = HEOS.components[0].transport.conductivity_residual.polynomials;
+        CoolProp::ConductivityResidualPolynomialData &data = HEOS.components[0]->transport.conductivity_residual.polynomials;
 
         CoolPropDbl summer = 0, tau = data.T_reducing/HEOS.T(), delta = HEOS.keyed_output(CoolProp::iDmass)/data.rhomass_reducing;
         for (std::size_t i = 0; i < data.B.size(); ++i)
@@ -674,7 +674,7 @@ CoolPropDbl TransportRoutines::conductivity_residual_polynomial_and_exponential(
     if (HEOS.is_pure_or_pseudopure)
     {
         // Retrieve values from the state class
-        CoolProp::ConductivityResidualPolynomialAndExponentialData &data = HEOS.components[0].transport.conductivity_residual.polynomial_and_exponential;
+        CoolProp::ConductivityResidualPolynomialAndExponentialData &data = HEOS.components[0]->transport.conductivity_residual.polynomial_and_exponential;
 
         CoolPropDbl summer = 0, tau = HEOS.tau(), delta = HEOS.delta();
         for (std::size_t i = 0; i < data.A.size(); ++i)
@@ -694,7 +694,7 @@ CoolPropDbl TransportRoutines::conductivity_critical_simplified_Olchowy_Sengers(
         // Olchowy and Sengers cross-over term
 
         // Retrieve values from the state class
-        CoolProp::ConductivityCriticalSimplifiedOlchowySengersData &data = HEOS.components[0].transport.conductivity_critical.Olchowy_Sengers;
+        CoolProp::ConductivityCriticalSimplifiedOlchowySengersData &data = HEOS.components[0]->transport.conductivity_critical.Olchowy_Sengers;
 
         double  k = data.k,
                 R0 = data.R0,
@@ -812,7 +812,7 @@ CoolPropDbl TransportRoutines::conductivity_dilute_eta0_and_poly(HelmholtzEOSMix
 
     if (HEOS.is_pure_or_pseudopure)
     {
-        CoolProp::ConductivityDiluteEta0AndPolyData &E = HEOS.components[0].transport.conductivity_dilute.eta0_and_poly;
+        CoolProp::ConductivityDiluteEta0AndPolyData &E = HEOS.components[0]->transport.conductivity_dilute.eta0_and_poly;
 
         double eta0_uPas = HEOS.calc_viscosity_dilute()*1e6; // [uPa-s]
         double summer = E.A[0]*eta0_uPas;
@@ -1170,18 +1170,53 @@ void TransportRoutines::conformal_state_solver(HelmholtzEOSMixtureBackend &HEOS,
     while(std::abs(resid) > 1e-9);
 }
 
+void TransportRoutines::conformal_state_solver_warm_start(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference, CoolPropDbl &T0, CoolPropDbl &rhomolar0)
+{
+    if (T0 > 0 && rhomolar0 > 0){
+        // Start from the given conformal state; this is normally the conformal state of the last call, which is
+        // much closer to the solution than the unity shape factor guess when the state changes in small steps
+        CoolPropDbl T0_guess = T0, rhomolar0_guess = rhomolar0;
+        try{
+            conformal_state_solver(HEOS, HEOS_Reference, T0_guess, rhomolar0_guess);
+            T0 = T0_guess; rhomolar0 = rhomolar0_guess;
+            return;
+        }
+        catch(std::exception &){
+            // Fall through to the unity shape factor guess
+        }
+    }
+    
+    // ************************************
+    // Start with a guess for theta and phi
+    // ************************************
+    CoolPropDbl theta = 1;
+    CoolPropDbl phi = 1;
+
+    // The equivalent substance reducing ratios
+    CoolPropDbl f = HEOS.T_critical()/HEOS_Reference.T_critical()*theta;
+    CoolPropDbl h = HEOS_Reference.rhomolar_critical()/HEOS.rhomolar_critical()*phi; // Must be the ratio of MOLAR densities!!
+
+    // Initial values for the conformal state
+    T0 = HEOS.T()/f;
+    rhomolar0 = HEOS.rhomolar()*h;
+    
+    conformal_state_solver(HEOS, HEOS_Reference, T0, rhomolar0);
+}
+
 CoolPropDbl TransportRoutines::viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference)
+{
+    CoolPropDbl T0 = -1, rhomolar0 = -1;
+    return viscosity_ECS(HEOS, HEOS_Reference, T0, rhomolar0);
+}
+
+CoolPropDbl TransportRoutines::viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference, CoolPropDbl &T0, CoolPropDbl &rhomolar0)
 {
     // Collect some parameters
     CoolPropDbl M = HEOS.molar_mass(),
-                M0 = HEOS_Reference.molar_mass(),
-                Tc = HEOS.T_critical(),
-                Tc0 = HEOS_Reference.T_critical(),
-                rhocmolar = HEOS.rhomolar_critical(),
-                rhocmolar0 = HEOS_Reference.rhomolar_critical();
+                M0 = HEOS_Reference.molar_mass();
 
     // Get a reference to the ECS data
-    CoolProp::ViscosityECSVariables &ECS = HEOS.components[0].transport.viscosity_ecs;
+    CoolProp::ViscosityECSVariables &ECS = HEOS.components[0]->transport.viscosity_ecs;
 
     // The correction polynomial psi_eta
     double psi = 0;
@@ -1192,20 +1227,6 @@ CoolPropDbl TransportRoutines::viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, H
     // The dilute gas portion for the fluid of interest [Pa-s]
     CoolPropDbl eta_dilute = viscosity_dilute_kinetic_theory(HEOS);
 
-    // ************************************
-    // Start with a guess for theta and phi
-    // ************************************
-    CoolPropDbl theta = 1;
-    CoolPropDbl phi = 1;
-
-    // The equivalent substance reducing ratios
-    CoolPropDbl f = Tc/Tc0*theta;
-    CoolPropDbl h = rhocmolar0/rhocmolar*phi; // Must be the ratio of MOLAR densities!!
-
-    // To be solved for
-    CoolPropDbl T0 = HEOS.T()/f;
-    CoolPropDbl rhomolar0 = HEOS.rhomolar()*h;
-    
     // **************************
     // Solver for conformal state
     // **************************
@@ -1213,14 +1234,14 @@ CoolPropDbl TransportRoutines::viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, H
 	// 
 	HEOS_Reference.specify_phase(iphase_gas); // something homogeneous
 	
-    conformal_state_solver(HEOS, HEOS_Reference, T0, rhomolar0);
+    conformal_state_solver_warm_start(HEOS, HEOS_Reference, T0, rhomolar0);
 	
     // Update the reference fluid with the updated conformal state
     HEOS_Reference.update_DmolarT_direct(rhomolar0*psi, T0);
 	
-	// Recalculate ESRR
-	f = HEOS.T()/T0;
-    h = rhomolar0/HEOS.rhomolar(); // Must be the ratio of MOLAR densities!!
+	// The equivalent substance reducing ratios
+	CoolPropDbl f = HEOS.T()/T0;
+    CoolPropDbl h = rhomolar0/HEOS.rhomolar(); // Must be the ratio of MOLAR densities!!
     
     // **********************
     // Remaining calculations
@@ -1239,21 +1260,23 @@ CoolPropDbl TransportRoutines::viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, H
 }
 
 CoolPropDbl TransportRoutines::conductivity_ECS(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference)
+{
+    CoolPropDbl T0 = -1, rhomolar0 = -1;
+    return conductivity_ECS(HEOS, HEOS_Reference, T0, rhomolar0);
+}
+
+CoolPropDbl TransportRoutines::conductivity_ECS(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference, CoolPropDbl &T0, CoolPropDbl &rhomolar0)
 {
     // Collect some parameters
     CoolPropDbl M = HEOS.molar_mass(),
                 M_kmol = M*1000,
                 M0 = HEOS_Reference.molar_mass(),
-                Tc = HEOS.T_critical(),
-                Tc0 = HEOS_Reference.T_critical(),
-                rhocmolar = HEOS.rhomolar_critical(),
-                rhocmolar0 = HEOS_Reference.rhomolar_critical(),
                 R_u = HEOS.gas_constant(),
                 R = HEOS.gas_constant()/HEOS.molar_mass(), //[J/kg/K]
                 R_kJkgK = R_u/M_kmol;
 
     // Get a reference to the ECS data
-    CoolProp::ConductivityECSVariables &ECS = HEOS.components[0].transport.conductivity_ecs;
+    CoolProp::ConductivityECSVariables &ECS = HEOS.components[0]->transport.conductivity_ecs;
 
     // The correction polynomial psi_eta in rho/rho_red
     double psi = 0;
@@ -1279,27 +1302,12 @@ CoolPropDbl TransportRoutines::conductivity_ECS(HelmholtzEOSMixtureBackend &HEOS
     // The dilute gas contribution to the thermal conductivity [W/m/K]
     CoolPropDbl lambda_dilute = 15.0e-3/4.0*R_kJkgK*eta_dilute;
 
-    // ************************************
-    // Start with a guess for theta and phi
-    // ************************************
-    
-    CoolPropDbl theta = 1;
-    CoolPropDbl phi = 1;
-
-    // The equivalent substance reducing ratios
-    CoolPropDbl f = Tc/Tc0*theta;
-    CoolPropDbl h = rhocmolar0/rhocmolar*phi; // Must be the ratio of MOLAR densities!!
-
-    // Initial values for the conformal state
-    CoolPropDbl T0 = HEOS.T()/f;
-    CoolPropDbl rhomolar0 = HEOS.rhomolar()*h;
-    
     // **************************
     // Solver for conformal state
     // **************************
 
     try{
-        conformal_state_solver(HEOS, HEOS_Reference, T0, rhomolar0);
+        conformal_state_solver_warm_start(HEOS, HEOS_Reference, T0, rhomolar0);
     }
     catch(std::exception &e){
         throw ValueError(format("Conformal state solver failed; error was %s",e.what()));
@@ -1308,9 +1316,9 @@ CoolPropDbl TransportRoutines::conductivity_ECS(HelmholtzEOSMixtureBackend &HEOS
     // Update the reference fluid with the conformal state
     HEOS_Reference.update(DmolarT_INPUTS, rhomolar0*psi, T0);
 	
-	// Recalculate ESRR
-	f = HEOS.T()/T0;
-    h = rhomolar0/HEOS.rhomolar(); // Must be the ratio of MOLAR densities!!
+	// The equivalent substance reducing ratios
+	CoolPropDbl f = HEOS.T()/T0;
+    CoolPropDbl h = rhomolar0/HEOS.rhomolar(); // Must be the ratio of MOLAR densities!!
 
     // The reference fluid's contribution to the conductivity [W/m/K]
     CoolPropDbl lambda_resid = HEOS_Reference.calc_conductivity_background();
@@ -265,14 +265,29 @@ public:
 
     */
     static CoolPropDbl viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference);
+    /** \brief ECS viscosity, starting the conformal state solver from (T0, rhomolar0)
+     *
+     * If T0 < 0 and rhomolar0 < 0, or if the solver fails from the given starting point, it is started from unity shape factors instead.
+     * On return, T0 and rhomolar0 hold the conformal state, so that they can be passed to the next call.
+     */
+    static CoolPropDbl viscosity_ECS(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference, CoolPropDbl &T0, CoolPropDbl &rhomolar0);
 
     static CoolPropDbl conductivity_ECS(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference);
+    /// ECS thermal conductivity, starting the conformal state solver from (T0, rhomolar0); see viscosity_ECS
+    static CoolPropDbl conductivity_ECS(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference, CoolPropDbl &T0, CoolPropDbl &rhomolar0);
 
     /* \brief Solver for the conformal state for ECS model
      * 
      */
     static void conformal_state_solver(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference, CoolPropDbl &T0, CoolPropDbl &rhomolar0);
 
+    /* \brief Solve for the conformal state starting from (T0, rhomolar0), falling back to the unity shape factor guess
+     *
+     * If T0 < 0 and rhomolar0 < 0 the solver is started from unity shape factors; otherwise it is started from (T0, rhomolar0),
+     * and if it fails from there it is started again from unity shape factors
+     */
+    static void conformal_state_solver_warm_start(HelmholtzEOSMixtureBackend &HEOS, HelmholtzEOSMixtureBackend &HEOS_Reference, CoolPropDbl &T0, CoolPropDbl &rhomolar0);
+
 }; /* class TransportRoutines */
 
 }; /* namespace CoolProp */
@@ -187,7 +187,7 @@ void SaturationSolvers::saturation_PHSU_pure(HelmholtzEOSMixtureBackend &HEOS, C
             // Invert liquid density ancillary to get temperature
             // TODO: fit inverse ancillaries too
             try{
-                T = HEOS.get_components()[0].ancillaries.pL.invert(specified_value);
+                T = HEOS.get_components()[0]->ancillaries.pL.invert(specified_value);
             }
             catch(...)
             {
@@ -198,7 +198,7 @@ void SaturationSolvers::saturation_PHSU_pure(HelmholtzEOSMixtureBackend &HEOS, C
         {
             CoolProp::SimpleState hs_anchor = HEOS.get_state("hs_anchor");
             // Ancillary is deltah = h - hs_anchor.h
-            try{ T = HEOS.get_components()[0].ancillaries.hL.invert(specified_value - hs_anchor.hmolar); }
+            try{ T = HEOS.get_components()[0]->ancillaries.hL.invert(specified_value - hs_anchor.hmolar); }
             catch(...){
                 throw ValueError("Unable to invert ancillary equation for hL");
             }
@@ -219,7 +219,7 @@ void SaturationSolvers::saturation_PHSU_pure(HelmholtzEOSMixtureBackend &HEOS, C
                     return h_liq + component->ancillaries.hLV.evaluate(T) - h;
                 };
             };
-            Residual resid(HEOS.get_components()[0], HEOS.hmolar());
+            Residual resid(*HEOS.get_components()[0], HEOS.hmolar());
             
             // Ancillary is deltah = h - hs_anchor.h
             std::string errstr;
@@ -237,7 +237,7 @@ void SaturationSolvers::saturation_PHSU_pure(HelmholtzEOSMixtureBackend &HEOS, C
         }
         else if (options.specified_variable == saturation_PHSU_pure_options::IMPOSED_SL)
         {
-            CoolPropFluid &component = HEOS.get_components()[0];
+            CoolPropFluid &component = *HEOS.get_components()[0];
             CoolProp::SaturationAncillaryFunction &anc = component.ancillaries.sL;
             CoolProp::SimpleState hs_anchor = HEOS.get_state("hs_anchor");
             // If near the critical point, use a near critical guess value for T
@@ -273,7 +273,7 @@ void SaturationSolvers::saturation_PHSU_pure(HelmholtzEOSMixtureBackend &HEOS, C
         }
         else if (options.specified_variable == saturation_PHSU_pure_options::IMPOSED_SV)
         {
-            CoolPropFluid &component = HEOS.get_components()[0];
+            CoolPropFluid &component = *HEOS.get_components()[0];
             CoolProp::SimpleState hs_anchor = HEOS.get_state("hs_anchor");
             class Residual : public FuncWrapper1D
             {
@@ -325,8 +325,8 @@ void SaturationSolvers::saturation_PHSU_pure(HelmholtzEOSMixtureBackend &HEOS, C
         T = std::min(T, static_cast<CoolPropDbl>(HEOS.T_critical()-0.1));
 
         // Evaluate densities from the ancillary equations
-        rhoV = HEOS.get_components()[0].ancillaries.rhoV.evaluate(T);
-        rhoL = HEOS.get_components()[0].ancillaries.rhoL.evaluate(T);
+        rhoV = HEOS.get_components()[0]->ancillaries.rhoV.evaluate(T);
+        rhoL = HEOS.get_components()[0]->ancillaries.rhoL.evaluate(T);
 
         // Apply a single step of Newton's method to improve guess value for liquid
         // based on the error between the gas pressure (which is usually very close already)
@@ -589,16 +589,16 @@ void SaturationSolvers::saturation_D_pure(HelmholtzEOSMixtureBackend &HEOS, Cool
         {
             // Invert liquid density ancillary to get temperature
             // TODO: fit inverse ancillaries too
-            T = HEOS.get_components()[0].ancillaries.rhoL.invert(rhomolar);
-            rhoV = HEOS.get_components()[0].ancillaries.rhoV.evaluate(T);
+            T = HEOS.get_components()[0]->ancillaries.rhoL.invert(rhomolar);
+            rhoV = HEOS.get_components()[0]->ancillaries.rhoV.evaluate(T);
             rhoL = rhomolar;
         }
         else if (options.imposed_rho == saturation_D_pure_options::IMPOSED_RHOV)
         {
             // Invert vapor density ancillary to get temperature
             // TODO: fit inverse ancillaries too
-            T = HEOS.get_components()[0].ancillaries.rhoV.invert(rhomolar);
-            rhoL = HEOS.get_components()[0].ancillaries.rhoL.evaluate(T);
+            T = HEOS.get_components()[0]->ancillaries.rhoV.invert(rhomolar);
+            rhoL = HEOS.get_components()[0]->ancillaries.rhoL.evaluate(T);
             rhoV = rhomolar;
         }
         else
@@ -782,12 +782,12 @@ void SaturationSolvers::saturation_T_pure_Akasaka(HelmholtzEOSMixtureBackend &HE
             
             // If very close to the critical temp, evaluate the ancillaries for a slightly lower temperature
             if (T > 0.99*HEOS.get_reducing_state().T){
-                rhoL = HEOS.get_components()[0].ancillaries.rhoL.evaluate(T-0.1);
-                rhoV = HEOS.get_components()[0].ancillaries.rhoV.evaluate(T-0.1);
+                rhoL = HEOS.get_components()[0]->ancillaries.rhoL.evaluate(T-0.1);
+                rhoV = HEOS.get_components()[0]->ancillaries.rhoV.evaluate(T-0.1);
             }
             else{
-                rhoL = HEOS.get_components()[0].ancillaries.rhoL.evaluate(T);
-                rhoV = HEOS.get_components()[0].ancillaries.rhoV.evaluate(T);
+                rhoL = HEOS.get_components()[0]->ancillaries.rhoL.evaluate(T);
+                rhoV = HEOS.get_components()[0]->ancillaries.rhoV.evaluate(T);
                 
                 // Apply a single step of Newton's method to improve guess value for liquid
                 // based on the error between the gas pressure (which is usually very close already)
@@ -917,7 +917,7 @@ void SaturationSolvers::saturation_T_pure_Maxwell(HelmholtzEOSMixtureBackend &HE
     HEOS.calc_reducing_state();
     shared_ptr<HelmholtzEOSMixtureBackend> SatL = HEOS.SatL,
                                            SatV = HEOS.SatV;
-    CoolProp::SimpleState &crit = HEOS.get_components()[0].crit;
+    CoolProp::SimpleState &crit = HEOS.get_components()[0]->crit;
     CoolPropDbl rhoL = _HUGE, rhoV = _HUGE, error = 999, DeltavL, DeltavV, pL, pV, p, last_error;
     int iter = 0, 
         small_step_count = 0, 
@@ -937,16 +937,16 @@ void SaturationSolvers::saturation_T_pure_Maxwell(HelmholtzEOSMixtureBackend &HE
             
             // If very close to the critical temp, evaluate the ancillaries for a slightly lower temperature
             if (T > 0.9999*HEOS.get_reducing_state().T){
-                rhoL = HEOS.get_components()[0].ancillaries.rhoL.evaluate(T-0.1);
-                rhoV = HEOS.get_components()[0].ancillaries.rhoV.evaluate(T-0.1);
+                rhoL = HEOS.get_components()[0]->ancillaries.rhoL.evaluate(T-0.1);
+                rhoV = HEOS.get_components()[0]->ancillaries.rhoV.evaluate(T-0.1);
             }
             else{
-                rhoL = HEOS.get_components()[0].ancillaries.rhoL.evaluate(T);
-                rhoV = HEOS.get_components()[0].ancillaries.rhoV.evaluate(T);
-                p = HEOS.get_components()[0].ancillaries.pV.evaluate(T);
+                rhoL = HEOS.get_components()[0]->ancillaries.rhoL.evaluate(T);
+                rhoV = HEOS.get_components()[0]->ancillaries.rhoV.evaluate(T);
+                p = HEOS.get_components()[0]->ancillaries.pV.evaluate(T);
                 
-                CoolProp::SimpleState &tripleL = HEOS.get_components()[0].triple_liquid;
-                CoolProp::SimpleState &tripleV = HEOS.get_components()[0].triple_vapor;
+                CoolProp::SimpleState &tripleL = HEOS.get_components()[0]->triple_liquid;
+                CoolProp::SimpleState &tripleV = HEOS.get_components()[0]->triple_vapor;
                 
                 // If the guesses are terrible, apply a simple correction
 				// but only if the limits are being checked
@@ -1128,11 +1128,11 @@ void SaturationSolvers::successive_substitution(HelmholtzEOSMixtureBackend &HEOS
     // Use Peneloux volume translation to shift liquid volume
     // As in Horstmann :: doi:10.1016/j.fluid.2004.11.002
     double summer_c = 0, v_SRK = 1/rhomolar_liq;
-    const std::vector<CoolPropFluid> & components = HEOS.get_components();
+    const std::vector<shared_ptr<CoolPropFluid> > &components = HEOS.get_components();
     for (std::size_t i = 0; i < components.size(); ++i){
         
         // Reference to EOS
-        const EquationOfState &EOS = components[i].EOSVector[0];
+        const EquationOfState &EOS = components[i]->EOSVector[0];
 
         // Get the parameters for the cubic EOS
         CoolPropDbl Tc = EOS.reduce.T;
@@ -1223,17 +1223,12 @@ void SaturationSolvers::newton_raphson_saturation::resize(std::size_t N)
 
     if (imposed_variable == newton_raphson_saturation_options::RHOV_IMPOSED){
         r.resize(N+1);
-        negative_r.resize(N+1);
         J.resize(N+1);
-        for (std::size_t i = 0; i < N+1; ++i){
-            J[i].resize(N+1);
-        }
         err_rel.resize(N+1);
     }
     else if (imposed_variable == newton_raphson_saturation_options::P_IMPOSED || imposed_variable == newton_raphson_saturation_options::T_IMPOSED){
         r.resize(N);
-        negative_r.resize(N);
-        J.resize(N, std::vector<CoolPropDbl>(N, 0));
+        J.resize(N);
         err_rel.resize(N);
     }
     else{
@@ -1251,7 +1246,7 @@ void SaturationSolvers::newton_raphson_saturation::check_Jacobian()
     // Make copies of the base
     CoolPropDbl T0 = T;
     std::vector<CoolPropDbl> r0 = r, x0 = x;
-    STLMatrix J0 = J;
+    NewtonRaphsonWorkspace<CoolPropDbl> J0 = J;
     CoolPropDbl rhomolar_liq0 = rSatL.rhomolar();
     CoolPropDbl rhomolar_vap0 = rSatV.rhomolar();
     
@@ -1275,7 +1270,7 @@ void SaturationSolvers::newton_raphson_saturation::check_Jacobian()
         }
         std::cout << format("For T\n");
         std::cout << "numerical: " << vec_to_string(diffn, "%0.11Lg") << std::endl;
-        std::cout << "analytic: " << vec_to_string(get_col(J0, N-1), "%0.11Lg") << std::endl;
+        std::cout << "analytic: " << vec_to_string(J0.col(N-1), "%0.11Lg") << std::endl;
     }
     {
         // Derivatives with respect to rho'
@@ -1297,7 +1292,7 @@ void SaturationSolvers::newton_raphson_saturation::check_Jacobian()
         }
         std::cout << format("For rho\n");
         std::cout << "numerical: " << vec_to_string(difffn, "%0.11Lg") << std::endl;
-        std::cout << "analytic: " << vec_to_string(get_col(J0, N), "%0.11Lg") << std::endl;
+        std::cout << "analytic: " << vec_to_string(J0.col(N), "%0.11Lg") << std::endl;
     }
     for (std::size_t i = 0; i < x.size()-1;  ++i)
     {
@@ -1325,7 +1320,7 @@ void SaturationSolvers::newton_raphson_saturation::check_Jacobian()
         }
         std::cout << format("For x%d N %d\n", i, N);
         std::cout << "numerical: " << vec_to_string(diffn, "%0.11Lg") << std::endl;
-        std::cout << "analytic: " << vec_to_string(get_col(J0, i), "%0.11Lg") << std::endl;
+        std::cout << "analytic: " << vec_to_string(J0.col(i), "%0.11Lg") << std::endl;
     }
 }
 void SaturationSolvers::newton_raphson_saturation::call(HelmholtzEOSMixtureBackend &HEOS, const std::vector<CoolPropDbl> &z, std::vector<CoolPropDbl> &z_incipient, newton_raphson_saturation_options &IO)
@@ -1368,39 +1363,39 @@ void SaturationSolvers::newton_raphson_saturation::call(HelmholtzEOSMixtureBacke
         // Build the Jacobian and residual vectors
         build_arrays();
 
-        // Solve for the step; v is the step with the contents
+        // Solve for the step in place in the workspace; the step has the contents
         // [delta(x_0), delta(x_1), ..., delta(x_{N-2}), delta(spec)]
-        std::vector<CoolPropDbl> v = linsolve(J, negative_r);
+        J.solve();
         
         if (bubble_point){
             for (unsigned int i = 0; i < N-1; ++i){
-                err_rel[i] = v[i]/y[i];
-                y[i] += v[i];
+                err_rel[i] = J.step(i)/y[i];
+                y[i] += J.step(i);
             }        
             y[N-1] = 1 - std::accumulate(y.begin(), y.end()-1, 0.0);
         }
         else{
             for (unsigned int i = 0; i < N-1; ++i){
-                err_rel[i] = v[i]/x[i];
-                x[i] += v[i];
+                err_rel[i] = J.step(i)/x[i];
+                x[i] += J.step(i);
             }        
             x[N-1] = 1 - std::accumulate(x.begin(), x.end()-1, 0.0);
         }
         if (imposed_variable == newton_raphson_saturation_options::P_IMPOSED){
-            T += v[N-1]; err_rel[N-1] = v[N-1]/T;
+            T += J.step(N-1); err_rel[N-1] = J.step(N-1)/T;
         }
         else if (imposed_variable == newton_raphson_saturation_options::T_IMPOSED){
-            p += v[N-1]; err_rel[N-1] = v[N-1]/p;
+            p += J.step(N-1); err_rel[N-1] = J.step(N-1)/p;
         }
         else if (imposed_variable == newton_raphson_saturation_options::RHOV_IMPOSED){
-            T += v[N-1]; err_rel[N-1] = v[N-1]/T;
-            rhomolar_liq += v[N]; err_rel[N] = v[N]/rhomolar_liq;
+            T += J.step(N-1); err_rel[N-1] = J.step(N-1)/T;
+            rhomolar_liq += J.step(N); err_rel[N] = J.step(N)/rhomolar_liq;
         }
         else{
             throw ValueError("invalid imposed_variable");
         }
         if(debug){
-			std::cout << format("\t%Lg ", this->error_rms) << T << " " << rhomolar_liq << " " << rhomolar_vap << " v " << vec_to_string(v, "%0.10Lg")  << " x " << vec_to_string(x, "%0.10Lg") << " r " << vec_to_string(r, "%0.10Lg") << std::endl;
+			std::cout << format("\t%Lg ", this->error_rms) << T << " " << rhomolar_liq << " " << rhomolar_vap << " v " << vec_to_string(J.step(), "%0.10Lg")  << " x " << vec_to_string(x, "%0.10Lg") << " r " << vec_to_string(r, "%0.10Lg") << std::endl;
 		}
         
         min_rel_change = min_abs_value(err_rel);
@@ -1478,25 +1473,25 @@ void SaturationSolvers::newton_raphson_saturation::build_arrays()
             
             for (std::size_t j = 0; j < N-1; ++j){ // j from 0 to N-2
                 if (bubble_point){
-                    J[i][j] = -MixtureDerivatives::dln_fugacity_dxj__constT_rho_xi(rSatV, i, j, xN_flag);
+                    J(i, j) = -MixtureDerivatives::dln_fugacity_dxj__constT_rho_xi(rSatV, i, j, xN_flag);
                 }
                 else{ 
-                    J[i][j] = MixtureDerivatives::dln_fugacity_dxj__constT_rho_xi(rSatL, i, j, xN_flag);
+                    J(i, j) = MixtureDerivatives::dln_fugacity_dxj__constT_rho_xi(rSatL, i, j, xN_flag);
                 }
             }
-            J[i][N-1] = MixtureDerivatives::dln_fugacity_i_dT__constrho_n(rSatL, i, xN_flag) - MixtureDerivatives::dln_fugacity_i_dT__constrho_n(rSatV, i, xN_flag);
-            J[i][N] = MixtureDerivatives::dln_fugacity_i_drho__constT_n(rSatL, i, xN_flag);
+            J(i, N-1) = MixtureDerivatives::dln_fugacity_i_dT__constrho_n(rSatL, i, xN_flag) - MixtureDerivatives::dln_fugacity_i_dT__constrho_n(rSatV, i, xN_flag);
+            J(i, N) = MixtureDerivatives::dln_fugacity_i_drho__constT_n(rSatL, i, xN_flag);
         }
         // ---------------------------------------------------------------
         // Derivatives of pL(T,rho',x)-p(T,rho'',y) with respect to inputs
         // ---------------------------------------------------------------
         r[N] = p_liq - p_vap;
         for (std::size_t j = 0; j < N-1; ++j){ // j from 0 to N-2
-            J[N][j] = MixtureDerivatives::dpdxj__constT_V_xi(rSatL, j, xN_flag); // p'' not a function of x0
+            J(N, j) = MixtureDerivatives::dpdxj__constT_V_xi(rSatL, j, xN_flag); // p'' not a function of x0
         }
         // Fixed composition derivatives
-        J[N][N-1] = rSatL.first_partial_deriv(iP, iT, iDmolar)-rSatV.first_partial_deriv(iP, iT, iDmolar);
-        J[N][N] = rSatL.first_partial_deriv(iP, iDmolar, iT);
+        J(N, N-1) = rSatL.first_partial_deriv(iP, iT, iDmolar)-rSatV.first_partial_deriv(iP, iT, iDmolar);
+        J(N, N) = rSatL.first_partial_deriv(iP, iDmolar, iT);
     }
     else if (imposed_variable == newton_raphson_saturation_options::P_IMPOSED){
         // Independent variables are N-1 mole fractions of incipient phase and T
@@ -1511,13 +1506,13 @@ void SaturationSolvers::newton_raphson_saturation::build_arrays()
             
             for (std::size_t j = 0; j < N-1; ++j){ // j from 0 to N-2
                 if (bubble_point){
-                    J[i][j] = -MixtureDerivatives::dln_fugacity_dxj__constT_p_xi(rSatV, i, j, xN_flag);
+                    J(i, j) = -MixtureDerivatives::dln_fugacity_dxj__constT_p_xi(rSatV, i, j, xN_flag);
                 }
                 else{ 
-                    J[i][j] = MixtureDerivatives::dln_fugacity_dxj__constT_p_xi(rSatL, i, j, xN_flag);
+                    J(i, j) = MixtureDerivatives::dln_fugacity_dxj__constT_p_xi(rSatL, i, j, xN_flag);
                 }
             }
-            J[i][N-1] = MixtureDerivatives::dln_fugacity_i_dT__constp_n(rSatL, i, xN_flag) - MixtureDerivatives::dln_fugacity_i_dT__constp_n(rSatV, i, xN_flag);
+            J(i, N-1) = MixtureDerivatives::dln_fugacity_i_dT__constp_n(rSatL, i, xN_flag) - MixtureDerivatives::dln_fugacity_i_dT__constp_n(rSatV, i, xN_flag);
         }
     }
     else if (imposed_variable == newton_raphson_saturation_options::T_IMPOSED){
@@ -1533,13 +1528,13 @@ void SaturationSolvers::newton_raphson_saturation::build_arrays()
             
             for (std::size_t j = 0; j < N-1; ++j){ // j from 0 to N-2
                 if (bubble_point){
-                    J[i][j] = -MixtureDerivatives::dln_fugacity_dxj__constT_p_xi(rSatV, i, j, xN_flag);
+                    J(i, j) = -MixtureDerivatives::dln_fugacity_dxj__constT_p_xi(rSatV, i, j, xN_flag);
                 }
                 else{
-                    J[i][j] = MixtureDerivatives::dln_fugacity_dxj__constT_p_xi(rSatL, i, j, xN_flag);
+                    J(i, j) = MixtureDerivatives::dln_fugacity_dxj__constT_p_xi(rSatL, i, j, xN_flag);
                 }
             }
-            J[i][N-1] = MixtureDerivatives::dln_fugacity_i_dp__constT_n(rSatL, i, xN_flag) - MixtureDerivatives::dln_fugacity_i_dp__constT_n(rSatV, i, xN_flag);
+            J(i, N-1) = MixtureDerivatives::dln_fugacity_i_dp__constT_n(rSatL, i, xN_flag) - MixtureDerivatives::dln_fugacity_i_dp__constT_n(rSatV, i, xN_flag);
         }
     }
     else{
@@ -1551,7 +1546,7 @@ void SaturationSolvers::newton_raphson_saturation::build_arrays()
     error_rms = 0;
     for (unsigned int i = 0; i < J.size(); ++i)
     {
-        negative_r[i] = -r[i];
+        J.rhs(i) = -r[i];
         error_rms += r[i]*r[i]; // Sum the squares
     }
     error_rms = sqrt(error_rms); // Square-root (The R in RMS)
@@ -1591,8 +1586,7 @@ void SaturationSolvers::newton_raphson_twophase::call(HelmholtzEOSMixtureBackend
     x.resize(N);
     y.resize(N);
     r.resize(2*N-1);
-    negative_r.resize(2*N-1);
-    J.resize(2*N-1, std::vector<CoolPropDbl>(2*N-1, 0));
+    J.resize(2*N-1);
     err_rel.resize(2*N-1);
     
     // Hold a pointer to the backend
@@ -1603,33 +1597,32 @@ void SaturationSolvers::newton_raphson_twophase::call(HelmholtzEOSMixtureBackend
         // Build the Jacobian and residual vectors
         build_arrays();
 
-        // Solve for the step; v is the step with the contents
-        // [delta(x_0), delta(x_1), ..., delta(x_{N-2}), delta(spec)]
+        // Solve for the step in place in the workspace; the step has the contents
+        // [delta(x_0), ..., delta(x_{N-2}), delta(y_0), ..., delta(y_{N-2}), delta(spec)]
         
-        // Uncomment to see Jacobian and residual at every step
-        // std::cout << vec_to_string(J, "%0.12Lg") << std::endl;
-        // std::cout << vec_to_string(negative_r, "%0.12Lg") << std::endl;
+        // Uncomment to see residual at every step
+        // std::cout << vec_to_string(r, "%0.12Lg") << std::endl;
         
-        std::vector<CoolPropDbl> v = linsolve(J, negative_r);
+        J.solve();
         for (unsigned int i = 0; i < N-1; ++i){
-            err_rel[i] = v[i]/x[i];
-            x[i] += v[i];
-            err_rel[i+(N-1)] = v[i+(N-1)]/y[i];
-            y[i] += v[i+(N-1)];
+            err_rel[i] = J.step(i)/x[i];
+            x[i] += J.step(i);
+            err_rel[i+(N-1)] = J.step(i+(N-1))/y[i];
+            y[i] += J.step(i+(N-1));
         }        
         x[N-1] = 1 - std::accumulate(x.begin(), x.end()-1, 0.0);
         y[N-1] = 1 - std::accumulate(y.begin(), y.end()-1, 0.0);
             
         if (imposed_variable == newton_raphson_twophase_options::P_IMPOSED){
-            T += v[2*N-2]; err_rel[2*N-2] = v[2*N-2]/T;
+            T += J.step(2*N-2); err_rel[2*N-2] = J.step(2*N-2)/T;
         }
         else if (imposed_variable == newton_raphson_twophase_options::T_IMPOSED){
-            p += v[2*N-2]; err_rel[2*N-2] = v[2*N-2]/p;
+            p += J.step(2*N-2); err_rel[2*N-2] = J.step(2*N-2)/p;
         }
         else{
             throw ValueError("invalid imposed_variable");
         }
-        //std::cout << format("\t%Lg ", this->error_rms) << T << " " << rhomolar_liq << " " << rhomolar_vap << " v " << vec_to_string(v, "%0.10Lg")  << " x " << vec_to_string(x, "%0.10Lg") << " r " << vec_to_string(r, "%0.10Lg") << std::endl;
+        //std::cout << format("\t%Lg ", this->error_rms) << T << " " << rhomolar_liq << " " << rhomolar_vap << " v " << vec_to_string(J.step(), "%0.10Lg")  << " x " << vec_to_string(x, "%0.10Lg") << " r " << vec_to_string(r, "%0.10Lg") << std::endl;
         
         min_rel_change = min_abs_value(err_rel);
         iter++;
@@ -1699,16 +1692,16 @@ void SaturationSolvers::newton_raphson_twophase::build_arrays()
     for (std::size_t i = 0; i < N; ++i)
     {
         for (std::size_t j = 0; j < N-1; ++j){
-            J[i][j] = MixtureDerivatives::dln_fugacity_dxj__constT_p_xi(rSatL, i, j, xN_flag);
-            J[i][j+N-1] = -MixtureDerivatives::dln_fugacity_dxj__constT_p_xi(rSatV, i, j, xN_flag);
+            J(i, j) = MixtureDerivatives::dln_fugacity_dxj__constT_p_xi(rSatL, i, j, xN_flag);
+            J(i, j+N-1) = -MixtureDerivatives::dln_fugacity_dxj__constT_p_xi(rSatV, i, j, xN_flag);
         }
                 
         // Last derivative with respect to either T or p depending on what is imposed
         if (imposed_variable == newton_raphson_twophase_options::P_IMPOSED){
-            J[i][2*N-2] = MixtureDerivatives::dln_fugacity_i_dT__constp_n(rSatL, i, xN_flag) - MixtureDerivatives::dln_fugacity_i_dT__constp_n(rSatV, i, xN_flag);
+            J(i, 2*N-2) = MixtureDerivatives::dln_fugacity_i_dT__constp_n(rSatL, i, xN_flag) - MixtureDerivatives::dln_fugacity_i_dT__constp_n(rSatV, i, xN_flag);
         }
         else if (imposed_variable == newton_raphson_twophase_options::T_IMPOSED){
-            J[i][2*N-2] = MixtureDerivatives::dln_fugacity_i_dp__constT_n(rSatL, i, xN_flag) - MixtureDerivatives::dln_fugacity_i_dp__constT_n(rSatV, i, xN_flag);
+            J(i, 2*N-2) = MixtureDerivatives::dln_fugacity_i_dp__constT_n(rSatL, i, xN_flag) - MixtureDerivatives::dln_fugacity_i_dp__constT_n(rSatV, i, xN_flag);
         }
         else{
             throw ValueError();
@@ -1718,8 +1711,8 @@ void SaturationSolvers::newton_raphson_twophase::build_arrays()
     for (std::size_t i = 0; i < N-1; ++i)
     {
         std::size_t k = i + N; // N ln f_i residuals
-        J[k][i] =  (z[i]-y[i])/pow(y[i]-x[i], 2);
-        J[k][i+(N-1)] = -(z[i]-x[i])/pow(y[i]-x[i], 2);
+        J(k, i) =  (z[i]-y[i])/pow(y[i]-x[i], 2);
+        J(k, i+(N-1)) = -(z[i]-x[i])/pow(y[i]-x[i], 2);
     }
 
     // Flip all the signs of the entries in the residual vector since we are solving Jv = -r, not Jv=r
@@ -1727,10 +1720,64 @@ void SaturationSolvers::newton_raphson_twophase::build_arrays()
     error_rms = 0;
     for (unsigned int i = 0; i < J.size(); ++i)
     {
-        negative_r[i] = -r[i];
+        J.rhs(i) = -r[i];
         error_rms += r[i]*r[i]; // Sum the squares
     }
     error_rms = sqrt(error_rms); // Square-root (The R in RMS)
 }
 
 } /* namespace CoolProp*/
+
+#ifdef ENABLE_CATCH
+#include "catch.hpp"
+#include "TestObjects.h"
+
+using namespace CoolProp;
+
+TEST_CASE("Warm Newton-Raphson saturation iterations do not allocate", "[mixtures],[NR_workspace]")
+{
+    std::vector<std::string> names = strsplit("Methane&Ethane&Propane", '&');
+    std::vector<CoolPropDbl> z(3);
+    z[0] = 0.5; z[1] = 0.3; z[2] = 0.2;
+    HelmholtzEOSMixtureBackend HEOS(names);
+    HEOS.set_mole_fractions(z);
+    HEOS.update(PQ_INPUTS, 2e6, 0);
+
+    // Two guesses for the bubble point at the same pressure; the second one is further away, so it needs more steps
+    SaturationSolvers::newton_raphson_saturation_options guess;
+    guess.bubble_point = true;
+    guess.imposed_variable = SaturationSolvers::newton_raphson_saturation_options::P_IMPOSED;
+    guess.p = HEOS.p();
+    guess.T = HEOS.T() + 0.5;
+    guess.rhomolar_liq = HEOS.SatL->rhomolar();
+    guess.rhomolar_vap = HEOS.SatV->rhomolar();
+    guess.x = z;
+    guess.y = HEOS.SatV->get_mole_fractions();
+    SaturationSolvers::newton_raphson_saturation_options far_guess = guess;
+    far_guess.T = HEOS.T() + 5;
+    far_guess.y[0] += 0.05; far_guess.y[2] -= 0.05;
+
+    // The first call sizes the solver, the saturated states and the outputs
+    SaturationSolvers::newton_raphson_saturation NR;
+    SaturationSolvers::newton_raphson_saturation_options IO = guess;
+    NR.call(HEOS, z, IO.y, IO);
+
+    SaturationSolvers::newton_raphson_saturation_options guesses[2] = {guess, far_guess};
+    std::size_t allocations[2], steps[2];
+    for (int g = 0; g < 2; ++g){
+        IO = guesses[g];
+        std::vector<CoolPropDbl> y = guesses[g].y;
+        std::size_t count_before = CoolPropTesting::heap_allocations();
+        NR.call(HEOS, z, y, IO);
+        allocations[g] = CoolPropTesting::heap_allocations() - count_before;
+        steps[g] = IO.Nsteps;
+        CHECK(std::abs(IO.T - HEOS.T()) < 1e-6*HEOS.T());
+    }
+    CAPTURE(steps[0]);
+    CAPTURE(steps[1]);
+    CAPTURE(allocations[0]);
+    REQUIRE(steps[1] > steps[0]);
+    // Whatever a warm call allocates does not grow with the number of steps
+    CHECK(allocations[1] == allocations[0]);
+}
+#endif
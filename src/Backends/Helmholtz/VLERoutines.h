@@ -3,6 +3,7 @@
 #define VLEROUTINES_H
 
 #include "HelmholtzEOSMixtureBackend.h"
+#include "MatrixMath.h"
 
 namespace CoolProp{
 
@@ -46,7 +47,7 @@ namespace SaturationSolvers
     @param i Index of component [-]
     */
     static CoolPropDbl Wilson_lnK_factor(const HelmholtzEOSMixtureBackend &HEOS, CoolPropDbl T, CoolPropDbl p, std::size_t i){ 
-        const EquationOfState &EOS = HEOS.get_components()[i].EOS(); 
+        const EquationOfState &EOS = HEOS.get_components()[i]->EOS(); 
         return log(EOS.reduce.p/p)+5.373*(1 + EOS.acentric)*(1-EOS.reduce.T/T);
     };
 
@@ -160,7 +161,7 @@ namespace SaturationSolvers
         
         for (unsigned int i = 0; i < z.size(); i++)
         {
-            const EquationOfState &EOS = HEOS.get_components()[i].EOS(); 
+            const EquationOfState &EOS = HEOS.get_components()[i]->EOS(); 
 
             ptriple += EOS.sat_min_liquid.p*z[i];
             pcrit += EOS.reduce.p*z[i];
@@ -246,8 +247,8 @@ namespace SaturationSolvers
         std::size_t N;
         bool logging;
         int Nsteps;
-        STLMatrix J;
-        std::vector<CoolPropDbl> K, x, y, z, r, negative_r, err_rel;
+        NewtonRaphsonWorkspace<CoolPropDbl> J; ///< The Jacobian matrix, the negative of the residual vector, and the step, allocated once per call
+        std::vector<CoolPropDbl> K, x, y, z, r, err_rel;
         std::vector<SuccessiveSubstitutionStep> step_logger;
 
         newton_raphson_twophase() : HEOS(NULL), imposed_variable(newton_raphson_twophase_options::NO_VARIABLE_IMPOSED), error_rms(_HUGE), rhomolar_liq(_HUGE), rhomolar_vap(_HUGE), T(_HUGE), p(_HUGE), min_rel_change(_HUGE), beta(_HUGE), N(0), logging(false), Nsteps(0)
@@ -328,10 +329,10 @@ namespace SaturationSolvers
         bool logging;
         bool bubble_point;
         int Nsteps;
-        STLMatrix J;
+        NewtonRaphsonWorkspace<CoolPropDbl> J; ///< The Jacobian matrix, the negative of the residual vector, and the step, allocated once per call
         HelmholtzEOSMixtureBackend *HEOS;
         CoolPropDbl dTsat_dPsat, dPsat_dTsat;
-        std::vector<CoolPropDbl> K, x, y, r, negative_r, err_rel;
+        std::vector<CoolPropDbl> K, x, y, r, err_rel;
         std::vector<SuccessiveSubstitutionStep> step_logger;
 
         newton_raphson_saturation(){};
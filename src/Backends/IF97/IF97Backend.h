@@ -21,6 +21,8 @@ protected:
 public:
     /// The name of the backend being used
     std::string backend_name(void){return "IF97Backend";}
+    /// Make an independent copy of this state
+    IF97Backend * clone(){ return new IF97Backend(*this); };
 
     // REQUIRED BUT NOT USED IN IF97 FUNCTIONS
     bool using_mole_fractions(void){return false;};
@@ -47,6 +49,8 @@ public:
                 throw ValueError("bad input_pair");
         }
     };
+    // update_many is not specialized: update() only stores T and p and each output is a single IF97 call, so the
+    // generic loop in AbstractState has nothing to share between the points
 
     /** We have to override some of the functions from the AbstractState.
 	 *  IF97 is only mass-based and does not support conversion
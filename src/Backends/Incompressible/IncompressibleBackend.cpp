@@ -55,7 +55,45 @@ void IncompressibleBackend::update(CoolProp::input_pairs input_pair, double valu
     }
 
     clear();
+    check_fractions();
+    update_TP(input_pair, value1, value2);
+}
+
+void IncompressibleBackend::update_many(CoolProp::input_pairs input_pair, const double *Value1, const double *Value2, std::size_t N, const parameters *outputs, std::size_t Nout, double *out, std::string *first_error) {
+    clear();
+    try{
+        check_fractions();
+    }
+    catch(std::exception &e){
+        // None of the state points can be calculated with an invalid composition
+        for (std::size_t i = 0; i < N*Nout; ++i){ out[i] = _HUGE; }
+        if (first_error != NULL && first_error->empty()){ *first_error = e.what(); }
+        return;
+    }
+    for (std::size_t i = 0; i < N; ++i){
+        double *row = out + i*Nout;
+        try{
+            clear();
+            update_TP(input_pair, Value1[i], Value2[i]);
+        }
+        catch(std::exception &e){
+            for (std::size_t j = 0; j < Nout; ++j){ row[j] = _HUGE; }
+            if (first_error != NULL && first_error->empty()){ *first_error = e.what(); }
+            continue;
+        }
+        for (std::size_t j = 0; j < Nout; ++j){
+            try{
+                row[j] = keyed_output(outputs[j]);
+            }
+            catch(std::exception &e){
+                row[j] = _HUGE;
+                if (first_error != NULL && first_error->empty()){ *first_error = e.what(); }
+            }
+        }
+    }
+}
 
+void IncompressibleBackend::check_fractions(void) {
     if (get_debug_level()>=50) {
         std::cout << format("Incompressible backend: _fractions are %s ",vec_to_string(_fractions).c_str()) << std::endl;
     }
@@ -75,7 +113,9 @@ void IncompressibleBackend::update(CoolProp::input_pairs input_pair, double valu
             throw ValueError(format("%s is a solution or brine. Mass fractions must be set to a vector with one entry between 0 and 1. %s is not valid.",this->name().c_str(),vec_to_string(_fractions).c_str()));
         }
     }
+}
 
+void IncompressibleBackend::update_TP(CoolProp::input_pairs input_pair, double value1, double value2) {
     this->_phase = iphase_liquid;
     if (get_debug_level()>=50) std::cout << format("Incompressible backend: Phase type is  %d ",this->_phase) << std::endl;
 
@@ -124,6 +164,7 @@ void IncompressibleBackend::update(CoolProp::input_pairs input_pair, double valu
     if (!ValidNumber(_T)){ throw ValueError("T is not a valid number");}
     if (get_debug_level()>=50) std::cout << format("Incompressible backend: Update finished T=%f, p=%f, x=%s ",this->_T,this->_p,vec_to_string(_fractions).c_str()) << std::endl;
     fluid->checkTPX(_T,_p,_fractions[0]);
+    _T_last = _T;
 }
 
 /// Clear all the cached values
@@ -172,6 +213,7 @@ void IncompressibleBackend::set_fractions(const std::vector<CoolPropDbl> &fracti
          ( this->_fractions[0]!=fractions[0] ) ) { // Change it!
         if (get_debug_level()>=20) std::cout << format("Incompressible backend: Updating the fractions triggered a change in reference state %s -> %s",vec_to_string(this->_fractions).c_str(),vec_to_string(fractions).c_str()) << std::endl;
         this->_fractions = fractions;
+        fluid->collapse(this->_fractions[0], fixed);
         set_reference_state(T_ref(), p_ref(), this->_fractions[0], h_ref(), s_ref());
     }
 }
@@ -341,6 +383,29 @@ double IncompressibleBackend::smass_ref(void){
 	return _smass_ref;
 }
 
+bool IncompressibleBackend::newton_T(FuncWrapper1DWithDeriv &res, const IncompressibleInverseT &inverse, double y, double &T){
+    const double Tmin = fluid->getTmin(), Tmax = fluid->getTmax();
+    double T0;
+    if (inverse.is_set()) {
+        T0 = inverse.T_at(y);
+    } else if (_T_last && static_cast<double>(_T_last) >= Tmin && static_cast<double>(_T_last) <= Tmax) {
+        T0 = _T_last;
+    } else {
+        return false;
+    }
+    try{
+        std::string errstring;
+        // The same tolerance in T as the Brent fallback, converted with the slope at the starting point
+        double ftol = DBL_EPSILON*1e3*std::abs(res.deriv(T0));
+        int maxiter = 10;
+        T = Newton(res, T0, ftol, maxiter, errstring);
+    }
+    catch(std::exception &){
+        return false;
+    }
+    return ValidNumber(T) && T >= Tmin && T <= Tmax;
+}
+
 /// Calculate T given pressure and density
 /**
 @param rhomass The mass density in kg/m^3
@@ -348,6 +413,27 @@ double IncompressibleBackend::smass_ref(void){
 @returns T The temperature in K
 */
 CoolPropDbl IncompressibleBackend::DmassP_flash(CoolPropDbl rhomass, CoolPropDbl p){
+
+    class DmassP_residual : public FuncWrapper1DWithDeriv {
+    protected:
+        double p,x,rho_in;
+        IncompressibleBackend* backend;
+    public:
+        DmassP_residual(IncompressibleBackend* backend, const double &p,  const double &x, const double &rho_in)
+        : p(p),x(x),rho_in(rho_in),backend(backend){}
+        double call(double target){
+            return backend->rho_at(target,p,x) - rho_in;
+        }
+        double deriv(double target){
+            return backend->calc_drhodTatPx(target,p,x);
+        }
+    };
+
+    if (fixed.x == _fractions[0] && fixed.density.has_derivatives()) {
+        DmassP_residual res = DmassP_residual(this, p, _fractions[0], rhomass);
+        double T;
+        if (newton_T(res, fixed.T_of_density, rhomass, T)) return T;
+    }
     return fluid->T_rho(rhomass, p, _fractions[0]);
 }
 /// Calculate T given pressure and enthalpy
@@ -358,7 +444,7 @@ CoolPropDbl IncompressibleBackend::DmassP_flash(CoolPropDbl rhomass, CoolPropDbl
 */
 CoolPropDbl IncompressibleBackend::HmassP_flash(CoolPropDbl hmass, CoolPropDbl p){
 
-    class HmassP_residual : public FuncWrapper1D {
+    class HmassP_residual : public FuncWrapper1DWithDeriv {
     protected:
         double p,x,h_in;
         IncompressibleBackend* backend;
@@ -368,11 +454,17 @@ CoolPropDbl IncompressibleBackend::HmassP_flash(CoolPropDbl hmass, CoolPropDbl p
         double call(double target){
             return backend->raw_calc_hmass(target,p,x) - h_in; //fluid.u(target,p,x)+ p / fluid.rho(target,p,x) - h_in;
         }
-        //double deriv(double target);
+        double deriv(double target){
+            return backend->calc_dhdTatPx(target,p,x);
+        }
     };
 
     HmassP_residual res = HmassP_residual(this, p, _fractions[0], hmass-h_ref()+hmass_ref());
 
+    // Newton's method with dh/dT = cp, starting close to the solution
+    double T;
+    if (newton_T(res, fixed.T_of_enthalpy, hmass-h_ref()+hmass_ref(), T)) return T;
+
     std::string errstring;
     double macheps = DBL_EPSILON;
     double tol     = DBL_EPSILON*1e3;
@@ -389,7 +481,7 @@ CoolPropDbl IncompressibleBackend::HmassP_flash(CoolPropDbl hmass, CoolPropDbl p
 */
 CoolPropDbl IncompressibleBackend::PSmass_flash(CoolPropDbl p, CoolPropDbl smass){
 
-    class PSmass_residual : public FuncWrapper1D {
+    class PSmass_residual : public FuncWrapper1DWithDeriv {
     protected:
         double p,x,s_in;
         IncompressibleBackend* backend;
@@ -399,10 +491,17 @@ CoolPropDbl IncompressibleBackend::PSmass_flash(CoolPropDbl p, CoolPropDbl smass
         double call(double target){
             return backend->raw_calc_smass(target,p,x) - s_in;
         }
+        double deriv(double target){
+            return backend->calc_dsdTatPx(target,p,x);
+        }
     };
 
     PSmass_residual res = PSmass_residual(this, p, _fractions[0], smass-s_ref()+smass_ref());
 
+    // Newton's method with ds/dT = cp/T, starting close to the solution
+    double T;
+    if (newton_T(res, fixed.T_of_entropy, smass-s_ref()+smass_ref(), T)) return T;
+
     std::string errstring;
     double macheps = DBL_EPSILON;
     double tol     = DBL_EPSILON*1e3;
@@ -473,12 +572,74 @@ CoolPropDbl IncompressibleBackend::calc_smass(void){
 
 /// Functions that can be used with the solver, they miss the reference values!
 CoolPropDbl IncompressibleBackend::raw_calc_hmass(double T, double p, double x){
-	return calc_dhdTatPxdT(T,p,x) + p * calc_dhdpatTx(T,fluid->rho(T, p, x),calc_drhodTatPx(T,p,x));
+	return calc_dhdTatPxdT(T,p,x) + p * calc_dhdpatTx(T,rho_at(T, p, x),calc_drhodTatPx(T,p,x));
 };
 CoolPropDbl IncompressibleBackend::raw_calc_smass(double T, double p, double x){
-	return calc_dsdTatPxdT(T,p,x) + p * calc_dsdpatTx(  fluid->rho(T, p, x),calc_drhodTatPx(T,p,x));
+	return calc_dsdTatPxdT(T,p,x) + p * calc_dsdpatTx(  rho_at(T, p, x),calc_drhodTatPx(T,p,x));
 };
 
+void IncompressibleBackend::calc_many_T(parameters output, const double *T, std::size_t N, double *out){
+    check_fractions();
+    const double x = _fractions[0];
+    switch (output) {
+        case iDmass:
+            for (std::size_t i = 0; i < N; ++i){ out[i] = rho_at(T[i], _p, x); }
+            break;
+        case iCpmass:
+        case iCvmass:
+            for (std::size_t i = 0; i < N; ++i){ out[i] = c_at(T[i], _p, x); }
+            break;
+        case iHmass: {
+            const double offset = h_ref() - hmass_ref();
+            for (std::size_t i = 0; i < N; ++i){ out[i] = offset + raw_calc_hmass(T[i], _p, x); }
+            break;
+        }
+        case iSmass: {
+            const double offset = s_ref() - smass_ref();
+            for (std::size_t i = 0; i < N; ++i){ out[i] = offset + raw_calc_smass(T[i], _p, x); }
+            break;
+        }
+        case iviscosity:
+            for (std::size_t i = 0; i < N; ++i){ out[i] = fixed.viscosity.is_set() ? fixed.viscosity.value(T[i]) : fluid->visc(T[i], _p, x); }
+            break;
+        case iconductivity:
+            for (std::size_t i = 0; i < N; ++i){ out[i] = fixed.conductivity.is_set() ? fixed.conductivity.value(T[i]) : fluid->cond(T[i], _p, x); }
+            break;
+        default:
+            throw ValueError(format("Output [%s] is not supported by calc_many_T", get_parameter_information(output, "short").c_str()));
+    }
+}
+
+/// Use the collapsed polynomials when they were made for this composition and fall back to the fluid otherwise
+double IncompressibleBackend::rho_at(double T, double p, double x){
+    if (fixed.x == x && fixed.density.is_set()) return fixed.density.value(T);
+    return fluid->rho(T, p, x);
+}
+double IncompressibleBackend::c_at(double T, double p, double x){
+    if (fixed.x == x && fixed.specific_heat.is_set()) return fixed.specific_heat.value(T);
+    return fluid->c(T, p, x);
+}
+CoolPropDbl IncompressibleBackend::calc_viscosity(void){
+    if (fixed.x == _fractions[0] && fixed.viscosity.is_set()) return fixed.viscosity.value(_T);
+    return fluid->visc(_T, _p, _fractions[0]);
+}
+CoolPropDbl IncompressibleBackend::calc_conductivity(void){
+    if (fixed.x == _fractions[0] && fixed.conductivity.is_set()) return fixed.conductivity.value(_T);
+    return fluid->cond(_T, _p, _fractions[0]);
+}
+double IncompressibleBackend::calc_drhodTatPx(double T, double p, double x){
+    if (fixed.x == x && fixed.density.has_derivatives()) return fixed.density.derivative(T);
+    return fluid->drhodTatPx(T, p, x);
+}
+double IncompressibleBackend::calc_dsdTatPxdT(double T, double p, double x){
+    if (fixed.x == x && fixed.specific_heat.has_derivatives()) return fixed.specific_heat.integral_over_T(T);
+    return fluid->dsdTatPxdT(T, p, x);
+}
+double IncompressibleBackend::calc_dhdTatPxdT(double T, double p, double x){
+    if (fixed.x == x && fixed.specific_heat.has_derivatives()) return fixed.specific_heat.integral(T);
+    return fluid->dhdTatPxdT(T, p, x);
+}
+
 /// Calculate the first partial derivative for the desired derivative
 CoolPropDbl IncompressibleBackend::calc_first_partial_deriv(parameters Of, parameters Wrt, parameters Constant){
 	// TODO: Can this be accelerated?
@@ -1034,4 +1195,62 @@ TEST_CASE("Internal consistency checks and example use cases for the incompressi
 //    }
 }
 
+TEST_CASE("Collapsed temperature polynomials of the incompressible backend","[IncompressibleBackend][collapsed]")
+{
+    CoolProp::IncompressibleFluid fluid = CoolPropTesting::incompressibleFluidObject();
+    CoolProp::IncompressibleBackend backend = CoolProp::IncompressibleBackend(&fluid);
+    double p = 10e5;
+    double x = 0.25;
+    backend.set_mass_fractions(std::vector<CoolPropDbl>(1,x));
+
+    std::vector<double> T;
+    for (double Ti = 263.15; Ti < 293.15; Ti += 5){ T.push_back(Ti); }
+    backend.update(CoolProp::PT_INPUTS, p, T[0]);
+    std::vector<double> rho(T.size()), cp(T.size()), h(T.size()), s(T.size()), cond(T.size());
+    backend.calc_many_T(CoolProp::iDmass, &T[0], T.size(), &rho[0]);
+    backend.calc_many_T(CoolProp::iCpmass, &T[0], T.size(), &cp[0]);
+    backend.calc_many_T(CoolProp::iHmass, &T[0], T.size(), &h[0]);
+    backend.calc_many_T(CoolProp::iSmass, &T[0], T.size(), &s[0]);
+    backend.calc_many_T(CoolProp::iconductivity, &T[0], T.size(), &cond[0]);
+    CHECK_THROWS(backend.calc_many_T(CoolProp::iP, &T[0], T.size(), &rho[0]));
+
+    for (std::size_t i = 0; i < T.size(); ++i){
+        CAPTURE(T[i]);
+        CHECK(std::abs(rho[i]/fluid.rho(T[i],p,x)-1) < 1e-12);
+        CHECK(std::abs(cp[i]/fluid.c(T[i],p,x)-1) < 1e-12);
+        CHECK(std::abs(cond[i]/fluid.cond(T[i],p,x)-1) < 1e-12);
+        // The integrals from the full 2D polynomials
+        double h_full = fluid.dhdTatPxdT(T[i],p,x) + p/fluid.rho(T[i],p,x)*(1 + T[i]/fluid.rho(T[i],p,x)*fluid.drhodTatPx(T[i],p,x));
+        double h0_full = fluid.dhdTatPxdT(T[0],p,x) + p/fluid.rho(T[0],p,x)*(1 + T[0]/fluid.rho(T[0],p,x)*fluid.drhodTatPx(T[0],p,x));
+        CHECK(std::abs((h[i]-h[0])-(h_full-h0_full)) < 1e-6*std::abs(h_full));
+        double s_full = fluid.dsdTatPxdT(T[i],p,x) + p/fluid.rho(T[i],p,x)/fluid.rho(T[i],p,x)*fluid.drhodTatPx(T[i],p,x);
+        double s0_full = fluid.dsdTatPxdT(T[0],p,x) + p/fluid.rho(T[0],p,x)/fluid.rho(T[0],p,x)*fluid.drhodTatPx(T[0],p,x);
+        CHECK(std::abs((s[i]-s[0])-(s_full-s0_full)) < 1e-8*std::abs(s_full)+1e-8);
+        backend.update(CoolProp::PT_INPUTS, p, T[i]);
+        CHECK(std::abs(h[i]-backend.hmass()) < 1e-8*std::abs(backend.hmass())+1e-8);
+        CHECK(std::abs(s[i]-backend.smass()) < 1e-8*std::abs(backend.smass())+1e-8);
+        CHECK(std::abs(backend.calc_viscosity()/fluid.visc(T[i],p,x)-1) < 1e-12);
+    }
+}
+
+TEST_CASE("Flash routines of the incompressible backend","[IncompressibleBackend][flash]")
+{
+    CoolProp::IncompressibleFluid fluid = CoolPropTesting::incompressibleFluidObject();
+    CoolProp::IncompressibleBackend backend = CoolProp::IncompressibleBackend(&fluid);
+    double p = 10e5;
+    backend.set_mass_fractions(std::vector<CoolPropDbl>(1,0.25));
+
+    for (double T = 263.15; T < 293.15; T += 3.7){
+        backend.update(CoolProp::PT_INPUTS, p, T);
+        double h = backend.hmass(), s = backend.smass(), rho = backend.rhomass();
+        CAPTURE(T);
+        backend.update(CoolProp::HmassP_INPUTS, h, p);
+        CHECK(std::abs(backend.T()-T) < 1e-8);
+        backend.update(CoolProp::PSmass_INPUTS, p, s);
+        CHECK(std::abs(backend.T()-T) < 1e-8);
+        backend.update(CoolProp::DmassP_INPUTS, rho, p);
+        CHECK(std::abs(backend.T()-T) < 1e-6);
+    }
+}
+
 #endif /* ENABLE_CATCH */
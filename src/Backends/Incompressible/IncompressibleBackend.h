@@ -30,16 +30,35 @@ protected:
 
     IncompressibleFluid *fluid;
 
+    /// The properties of the fluid collapsed onto the temperature axis at the current composition
+    IncompressibleFixedComposition fixed;
+    /// Density, specific heat and the derivatives and integrals of both, from the collapsed polynomials if they are for x
+    double rho_at(double T, double p, double x);
+    double c_at(double T, double p, double x);
+
+    /// The temperature of the last successful update, kept across clear() to start the flash routines
+    CachedElement _T_last;
+    /// Solve res(T) = 0 with Newton's method, starting from the cached inverse at y, or else from the last temperature
+    /** Returns false if there is no starting point, or if Newton's method fails or ends up outside [Tmin, Tmax] */
+    bool newton_T(FuncWrapper1DWithDeriv &res, const IncompressibleInverseT &inverse, double y, double &T);
+
     /// Set the fractions
     /**
     @param fractions The vector of fractions of the components converted to the correct input
     */
     void set_fractions(const std::vector<CoolPropDbl> &fractions);
 
+    /// Check that the composition is valid for this fluid and set the fluid type accordingly
+    void check_fractions(void);
+    /// Set the temperature and pressure from a pair of inputs, assumes that the composition has already been checked
+    void update_TP(CoolProp::input_pairs input_pair, double value1, double value2);
+
 public:
     IncompressibleBackend();
     virtual ~IncompressibleBackend(){};
     std::string backend_name(void){return "IncompressibleBackend";}
+    /// Make an independent copy of this state; the fluid itself belongs to the library and is shared
+    IncompressibleBackend * clone(){ return new IncompressibleBackend(*this); };
 
     /// The instantiator
     /// @param fluid object, mostly for testing purposes
@@ -66,6 +85,9 @@ public:
     @param value2 Second input value
     */
     void update(CoolProp::input_pairs input_pair, double value1, double value2);
+
+    /// Update the state for a set of state points, the composition is only checked once
+    void update_many(CoolProp::input_pairs input_pair, const double *Value1, const double *Value2, std::size_t N, const parameters *outputs, std::size_t Nout, double *out, std::string *first_error = NULL);
     
     std::string fluid_param_string(const std::string &ParamName){
         if (!ParamName.compare("long_name")){
@@ -179,12 +201,12 @@ public:
 //    CoolPropDbl PUmass_flash(CoolPropDbl p, CoolPropDbl umass);
 
     /// We start with the functions that do not need a reference state
-    CoolPropDbl calc_rhomass(void){return fluid->rho(_T, _p, _fractions[0]);};
-    CoolPropDbl calc_cmass(void){return fluid->c(_T, _p, _fractions[0]);};
+    CoolPropDbl calc_rhomass(void){return rho_at(_T, _p, _fractions[0]);};
+    CoolPropDbl calc_cmass(void){return c_at(_T, _p, _fractions[0]);};
     CoolPropDbl calc_cpmass(void){return cmass();};
     CoolPropDbl calc_cvmass(void){return cmass();};
-    CoolPropDbl calc_viscosity(void){return fluid->visc(_T, _p, _fractions[0]);};
-    CoolPropDbl calc_conductivity(void){return fluid->cond(_T, _p, _fractions[0]);};
+    CoolPropDbl calc_viscosity(void);
+    CoolPropDbl calc_conductivity(void);
     CoolPropDbl calc_T_freeze(void){return fluid->Tfreeze(_p, _fractions[0]);};
     CoolPropDbl calc_melting_line(int param, int given, CoolPropDbl value);
     CoolPropDbl calc_umass(void);
@@ -198,6 +220,13 @@ public:
     CoolPropDbl raw_calc_hmass(double T, double p, double x);
     CoolPropDbl raw_calc_smass(double T, double p, double x);
 
+    /// Evaluate one output at the current pressure and composition for an array of temperatures
+    /** Supports iDmass, iCpmass, iCvmass, iHmass, iSmass, iviscosity and iconductivity. Unlike update(),
+     *  the temperatures are not checked against the limits of the fluid, so this is meant for dense
+     *  sweeps over a range that is known to be valid.
+     */
+    void calc_many_T(parameters output, const double *T, std::size_t N, double *out);
+
 
 protected:
     /// Calculate the first partial derivative for the desired derivative
@@ -208,19 +237,19 @@ protected:
 	 * derive the different functions with respect to temperature.
 	 */
 	/// Partial derivative of density with respect to temperature at constant pressure and composition
-	double calc_drhodTatPx(double T, double p, double x){return fluid->drhodTatPx(T,p,x);};
+	double calc_drhodTatPx(double T, double p, double x);
 	/// Partial derivative of entropy with respect to temperature at constant pressure and composition
-	double calc_dsdTatPx  (double T, double p, double x){return fluid->c(T,p,x)/T;};
+	double calc_dsdTatPx  (double T, double p, double x){return c_at(T,p,x)/T;};
 	/// Partial derivative of enthalpy with respect to temperature at constant pressure and composition
-	double calc_dhdTatPx  (double T, double p, double x){return fluid->c(T,p,x);};
+	double calc_dhdTatPx  (double T, double p, double x){return c_at(T,p,x);};
     /// Partial derivative of entropy
     ///  with respect to temperature at constant pressure and composition
     ///  integrated in temperature
-	double calc_dsdTatPxdT(double T, double p, double x){return fluid->dsdTatPxdT(T,p,x);};
+	double calc_dsdTatPxdT(double T, double p, double x);
 	/// Partial derivative of enthalpy
 	///  with respect to temperature at constant pressure and composition
 	///  integrated in temperature
-	double calc_dhdTatPxdT(double T, double p, double x){return fluid->dhdTatPxdT(T,p,x);};
+	double calc_dhdTatPxdT(double T, double p, double x);
 
 
 	/* Other useful derivatives
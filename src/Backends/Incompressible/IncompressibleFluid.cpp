@@ -32,41 +32,140 @@ bool IncompressibleFluid::is_pure() {
 }
 
 /// Base exponential function
-double IncompressibleFluid::baseExponential(IncompressibleData data, double y, double ybase){
-    Eigen::VectorXd coeffs = makeVector(data.coeffs);
-    size_t r=coeffs.rows(),c=coeffs.cols();
+double IncompressibleFluid::baseExponential(const IncompressibleData &data, double y, double ybase){
+    const Eigen::MatrixXd &coeffs = data.coeffs;
+    if (coeffs.size()<1 || (coeffs.rows()!=1 && coeffs.cols()!=1)) throw ValueError(format("Your matrix (%d,%d) cannot be converted into a vector (x,1).",coeffs.rows(),coeffs.cols()));
+    size_t r=coeffs.size(),c=1;
     if (strict && (r!=3 || c!=1) ) throw ValueError(format("%s (%d): You have to provide a 3,1 matrix of coefficients, not  (%d,%d).",__FILE__,__LINE__,r,c));
-    return exp( (double) (coeffs[0] / ( (y-ybase)+coeffs[1] ) - coeffs[2] ) );
+    return exp( (double) (coeffs(0) / ( (y-ybase)+coeffs(1) ) - coeffs(2) ) );
 }
 /// Base exponential function with logarithmic term
-double IncompressibleFluid::baseLogexponential(IncompressibleData data, double y, double ybase){
-    Eigen::VectorXd coeffs = makeVector(data.coeffs);
-    size_t r=coeffs.rows(),c=coeffs.cols();
+double IncompressibleFluid::baseLogexponential(const IncompressibleData &data, double y, double ybase){
+    const Eigen::MatrixXd &coeffs = data.coeffs;
+    if (coeffs.size()<1 || (coeffs.rows()!=1 && coeffs.cols()!=1)) throw ValueError(format("Your matrix (%d,%d) cannot be converted into a vector (x,1).",coeffs.rows(),coeffs.cols()));
+    size_t r=coeffs.size(),c=1;
     if (strict && (r!=3 || c!=1) ) throw ValueError(format("%s (%d): You have to provide a 3,1 matrix of coefficients, not  (%d,%d).",__FILE__,__LINE__,r,c));
-    return exp( (double) ( log( (double) (1.0/((y-ybase)+coeffs[0]) + 1.0/((y-ybase)+coeffs[0])/((y-ybase)+coeffs[0]) ) ) *coeffs[1]+coeffs[2] ) );
+    return exp( (double) ( log( (double) (1.0/((y-ybase)+coeffs(0)) + 1.0/((y-ybase)+coeffs(0))/((y-ybase)+coeffs(0)) ) ) *coeffs(1)+coeffs(2) ) );
 }
 
-double IncompressibleFluid::basePolyOffset(IncompressibleData data, double y, double z){
+double IncompressibleFluid::basePolyOffset(const IncompressibleData &data, double y, double z){
     size_t r=data.coeffs.rows(),c=data.coeffs.cols();
-    double offset = 0.0;
-    double in     = 0.0;
-    Eigen::MatrixXd coeffs;
+    double in = 0.0;
     if (r>0 && c>0) {
-        offset = data.coeffs(0,0);
         if (r==1 && c>1) { // row vector -> function of z
-            coeffs = Eigen::MatrixXd(data.coeffs.block(0,1,r,c-1));
             in = z;
         } else if (r>1 && c==1) { // column vector -> function of y
-            coeffs = Eigen::MatrixXd(data.coeffs.block(1,0,r-1,c));
             in = y;
         } else {
             throw ValueError(format("%s (%d): You have to provide a vector (1D matrix) of coefficients, not  (%d,%d).",__FILE__,__LINE__,r,c));
         }
-        return poly.evaluate(coeffs, in, 0, offset);
+        // The first entry is the offset, the others are the coefficients in (in-offset)
+        const double offset = data.coeffs(0);
+        double result = 0.0;
+        for (int i = static_cast<int>(data.coeffs.size())-1; i > 0; i--) {
+            result = result*(in-offset) + data.coeffs(i);
+        }
+        return result;
     }
     throw ValueError(format("%s (%d): You have to provide a vector (1D matrix) of coefficients, not  (%d,%d).",__FILE__,__LINE__,r,c));
 }
 
+void IncompressiblePolynomialT::set(const IncompressibleData &data, double x, double Tbase, double xbase){
+    type = IncompressibleData::INCOMPRESSIBLE_NOT_SET;
+    coeffs.clear(); dcoeffs.clear(); icoeffs.clear(); fcoeffs.clear();
+    flog = 0;
+    if (data.type!=IncompressibleData::INCOMPRESSIBLE_POLYNOMIAL && data.type!=IncompressibleData::INCOMPRESSIBLE_EXPPOLYNOMIAL) return;
+    const Eigen::MatrixXd &C = data.coeffs;
+    if (C.rows()<1 || C.cols()<1) return;
+    this->Tbase = Tbase;
+    // Sum out the concentration axis, the rows are temperature
+    coeffs.resize(C.rows());
+    for (int i = 0; i < C.rows(); i++) {
+        double a = 0;
+        for (int j = static_cast<int>(C.cols())-1; j >= 0; j--) { a = a*(x-xbase) + C(i,j); }
+        coeffs[i] = a;
+    }
+    type = data.type;
+    if (!has_derivatives()) return;
+    const std::size_t N = coeffs.size();
+    dcoeffs.resize(N > 1 ? N-1 : 1, 0.0);
+    for (std::size_t i = 1; i < N; i++) { dcoeffs[i-1] = i*coeffs[i]; }
+    icoeffs.resize(N+1, 0.0);
+    for (std::size_t i = 0; i < N; i++) { icoeffs[i+1] = coeffs[i]/(i+1.); }
+    // Expand in powers of T, b_m = sum_j a_j binom(j,m) (-Tbase)^(j-m), to integrate p/T term by term
+    std::vector<double> b(N, 0.0), binom(N, 0.0);
+    for (std::size_t j = 0; j < N; j++) {
+        // binom holds row j of Pascal's triangle
+        for (std::size_t m = j; m > 0; m--) { binom[m] += binom[m-1]; }
+        binom[0] = 1.0;
+        double power = 1.0; // (-Tbase)^(j-m), m running down from j
+        for (std::size_t m = j+1; m-- > 0; ) {
+            b[m] += coeffs[j]*binom[m]*power;
+            power *= -Tbase;
+        }
+    }
+    flog = b[0];
+    fcoeffs.resize(N, 0.0);
+    for (std::size_t m = 1; m < N; m++) { fcoeffs[m] = b[m]/m; }
+}
+
+void IncompressibleInverseT::set(const std::vector<double> &T, const std::vector<double> &y, const std::vector<double> &dydT){
+    clear();
+    const std::size_t N = T.size();
+    if (N < 2 || y.size() != N || dydT.size() != N) return;
+    const bool increasing = y[N-1] > y[0];
+    for (std::size_t i = 0; i < N; ++i) {
+        if (!ValidNumber(y[i]) || !ValidNumber(dydT[i]) || dydT[i] == 0 || (dydT[i] > 0) != increasing) return;
+        if (i > 0 && (y[i] > y[i-1]) != increasing) return;
+    }
+    this->T = T;
+    this->y = y;
+    dTdy.resize(N);
+    for (std::size_t i = 0; i < N; ++i) { dTdy[i] = 1/dydT[i]; }
+}
+
+double IncompressibleInverseT::T_at(double yval) const {
+    const std::size_t N = T.size();
+    const bool increasing = y[N-1] > y[0];
+    if ((yval <= y[0]) == increasing) return T[0];
+    if ((yval >= y[N-1]) == increasing) return T[N-1];
+    std::size_t lo = 0, hi = N-1;
+    while (hi - lo > 1) {
+        std::size_t mid = (lo + hi)/2;
+        if ((y[mid] < yval) == increasing) { lo = mid; } else { hi = mid; }
+    }
+    const double h = y[hi]-y[lo], t = (yval-y[lo])/h, t2 = t*t, t3 = t2*t;
+    double Tval = (2*t3-3*t2+1)*T[lo] + (t3-2*t2+t)*h*dTdy[lo] + (-2*t3+3*t2)*T[hi] + (t3-t2)*h*dTdy[hi];
+    // The cubic can overshoot where the slope of y is small, but the solution is always within the interval
+    return std::min(std::max(Tval, T[lo]), T[hi]);
+}
+
+void IncompressibleFluid::collapse(double x, IncompressibleFixedComposition &fixed) const {
+    fixed.x = x;
+    fixed.density.set(density, x, Tbase, xbase);
+    fixed.specific_heat.set(specific_heat, x, Tbase, xbase);
+    fixed.viscosity.set(viscosity, x, Tbase, xbase);
+    fixed.conductivity.set(conductivity, x, Tbase, xbase);
+
+    fixed.T_of_density.clear();
+    fixed.T_of_enthalpy.clear();
+    fixed.T_of_entropy.clear();
+    if (!(Tmin > 0 && Tmin < Tmax && ValidNumber(Tmax))) return;
+    const std::size_t N = 20;
+    std::vector<double> T(N), y(N), dydT(N);
+    for (std::size_t i = 0; i < N; ++i) { T[i] = Tmin + (Tmax-Tmin)*i/(N-1.); }
+    if (fixed.density.has_derivatives()) {
+        for (std::size_t i = 0; i < N; ++i) { y[i] = fixed.density.value(T[i]); dydT[i] = fixed.density.derivative(T[i]); }
+        fixed.T_of_density.set(T, y, dydT);
+    }
+    if (fixed.specific_heat.has_derivatives()) {
+        for (std::size_t i = 0; i < N; ++i) { y[i] = fixed.specific_heat.integral(T[i]); dydT[i] = fixed.specific_heat.value(T[i]); }
+        fixed.T_of_enthalpy.set(T, y, dydT);
+        for (std::size_t i = 0; i < N; ++i) { y[i] = fixed.specific_heat.integral_over_T(T[i]); dydT[i] /= T[i]; }
+        fixed.T_of_entropy.set(T, y, dydT);
+    }
+}
+
 
 /// Density as a function of temperature, pressure and composition.
 double IncompressibleFluid::rho (double T, double p, double x){
@@ -1,6 +1,7 @@
 #include "IncompressibleLibrary.h"
 #include "MatrixMath.h"
 #include "DataStructures.h"
+#include "CPthreads.h"
 //#include "crossplatform_shared_ptr.h"
 #include "rapidjson/rapidjson_include.h"
 #include "all_incompressibles_JSON.h" // Makes a std::string variable called all_incompressibles_JSON
@@ -585,6 +586,8 @@ IncompressibleFluid& JSONIncompressibleLibrary::get(std::size_t key) {
 
 
 static JSONIncompressibleLibrary library;
+/// Guards the loading of the library, which happens the first time it is used
+static Once library_loaded;
 
 void load_incompressible_library()
 {
@@ -601,21 +604,21 @@ void load_incompressible_library()
 }
 
 JSONIncompressibleLibrary & get_incompressible_library(void){
-    if (library.is_empty()){ load_incompressible_library(); }
+    library_loaded.call(load_incompressible_library);
     return library;
 }
 
 IncompressibleFluid& get_incompressible_fluid(const std::string &fluid_string){
-    if (library.is_empty()){ load_incompressible_library(); }
+    library_loaded.call(load_incompressible_library);
     return library.get(fluid_string);
 }
 
 std::string get_incompressible_list_pure(void){
-    if (library.is_empty()){ load_incompressible_library(); }
+    library_loaded.call(load_incompressible_library);
     return library.get_incompressible_list_pure();
 };
 std::string get_incompressible_list_solution(void){
-    if (library.is_empty()){ load_incompressible_library(); }
+    library_loaded.call(load_incompressible_library);
     return library.get_incompressible_list_solution();
 };
 
@@ -4,24 +4,23 @@
 #include "MatrixMath.h"
 #include "Backends/Helmholtz/PhaseEnvelopeRoutines.h"
 
-void CoolProp::BicubicBackend::find_native_nearest_good_indices(SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, double x, double y, std::size_t &i, std::size_t &j)
+void CoolProp::BicubicBackend::find_native_nearest_good_indices(SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, double x, double y, std::size_t &i, std::size_t &j)
 {
     table.find_native_nearest_good_cell(x, y, i, j);
-    const CellCoeffs &cell = coeffs[i][j];
-    if (!cell.valid()){
-        if (cell.has_valid_neighbor()){
+    if (!coeffs.valid(i, j)){
+        if (coeffs.has_valid_neighbor(i, j)){
             // Get new good neighbor
-            cell.get_alternate(i, j);
+            coeffs.get_alternate(i, j);
         }
         else{
-            if (!cell.valid()){ throw ValueError(format("Cell is invalid and has no good neighbors for x = %g, y= %g", x, y)); }
+            throw ValueError(format("Cell is invalid and has no good neighbors for x = %g, y= %g", x, y));
         }
     }
 }
 
 /// Ask the derived class to find the nearest neighbor (pure virtual)
 void CoolProp::BicubicBackend::find_nearest_neighbor(SinglePhaseGriddedTableData &table,
-    const std::vector<std::vector<CellCoeffs> > &coeffs,
+    const CellCoeffsTable &coeffs,
     const parameters variable1,
     const double value1,
     const parameters otherkey,
@@ -29,14 +28,13 @@ void CoolProp::BicubicBackend::find_nearest_neighbor(SinglePhaseGriddedTableData
     std::size_t &i,
     std::size_t &j){
     table.find_nearest_neighbor(variable1, value1, otherkey, otherval, i, j);
-    const CellCoeffs &cell = coeffs[i][j];
-    if (!cell.valid()){
-        if (cell.has_valid_neighbor()){
+    if (!coeffs.valid(i, j)){
+        if (coeffs.has_valid_neighbor(i, j)){
             // Get new good neighbor
-            cell.get_alternate(i, j);
+            coeffs.get_alternate(i, j);
         }
         else{
-            if (!cell.valid()){ throw ValueError(format("Cell is invalid and has no good neighbors for x = %g, y = %g", value1, otherval)); }
+            throw ValueError(format("Cell is invalid and has no good neighbors for x = %g, y = %g", value1, otherval));
         }
     }
 }
@@ -51,7 +49,7 @@ void CoolProp::BicubicBackend::find_nearest_neighbor(SinglePhaseGriddedTableData
 double CoolProp::BicubicBackend::evaluate_single_phase_transport(SinglePhaseGriddedTableData &table, parameters output, double x, double y, std::size_t i, std::size_t j)
 {
     // By definition i,i+1,j,j+1 are all in range and valid
-    std::vector<std::vector<double> > *f = NULL;
+    TableMatrix *f = NULL;
     switch(output){
         case iconductivity:
             f = &table.cond; break;
@@ -76,13 +74,10 @@ double CoolProp::BicubicBackend::evaluate_single_phase_transport(SinglePhaseGrid
     return val;
 }
 // Use the single_phase table to evaluate an output
-double CoolProp::BicubicBackend::evaluate_single_phase(const SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, const parameters output, const double x, const double y, const std::size_t i, const std::size_t j)
+double CoolProp::BicubicBackend::evaluate_single_phase(const SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, const parameters output, const double x, const double y, const std::size_t i, const std::size_t j)
 {
-    // Get the cell
-    const CellCoeffs &cell = coeffs[i][j];
-    
-	// Get the alpha coefficients
-    const std::vector<double> &alpha = cell.get(output);
+	// Get the alpha coefficients of the cell
+    const double *alpha = coeffs.get(output, i, j);
     
     // Normalized value in the range (0, 1)
 	double xhat = (x - table.xvec[i])/(table.xvec[i+1] - table.xvec[i]);
@@ -112,14 +107,11 @@ double CoolProp::BicubicBackend::evaluate_single_phase(const SinglePhaseGriddedT
     return val;
 }
 /// Use the single_phase table to evaluate an output
-double CoolProp::BicubicBackend::evaluate_single_phase_derivative(SinglePhaseGriddedTableData &table, std::vector<std::vector<CellCoeffs> > &coeffs, parameters output, double x, double y, std::size_t i, std::size_t j, std::size_t Nx, std::size_t Ny)
+double CoolProp::BicubicBackend::evaluate_single_phase_derivative(SinglePhaseGriddedTableData &table, CellCoeffsTable &coeffs, parameters output, double x, double y, std::size_t i, std::size_t j, std::size_t Nx, std::size_t Ny)
 {
 
-    // Get the cell
-    CellCoeffs &cell = coeffs[i][j];
-    
-	// Get the alpha coefficients
-    const std::vector<double> &alpha = cell.get(output);
+	// Get the alpha coefficients of the cell
+    const double *alpha = coeffs.get(output, i, j);
     
     // Normalized value in the range (0, 1)
 	double xhat = (x - table.xvec[i])/(table.xvec[i+1] - table.xvec[i]);
@@ -161,13 +153,10 @@ double CoolProp::BicubicBackend::evaluate_single_phase_derivative(SinglePhaseGri
 }
 
 /// Use the single_phase table to invert for x given a y
-void CoolProp::BicubicBackend::invert_single_phase_x(const SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, parameters other_key, double other, double y, std::size_t i, std::size_t j)
+void CoolProp::BicubicBackend::invert_single_phase_x(const SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, parameters other_key, double other, double y, std::size_t i, std::size_t j)
 {
-    // Get the cell
-    const CellCoeffs &cell = coeffs[i][j];
-    
-	// Get the alpha coefficients
-    const std::vector<double> &alpha = cell.get(other_key);
+	// Get the alpha coefficients of the cell
+    const double *alpha = coeffs.get(other_key, i, j);
     
     // Normalized value in the range (0, 1)
     double yhat = (y - table.yvec[j])/(table.yvec[j+1] - table.yvec[j]);
@@ -216,13 +205,10 @@ void CoolProp::BicubicBackend::invert_single_phase_x(const SinglePhaseGriddedTab
 }
 
 /// Use the single_phase table to solve for y given an x
-void CoolProp::BicubicBackend::invert_single_phase_y(const SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, parameters other_key, double other, double x, std::size_t i, std::size_t j)
+void CoolProp::BicubicBackend::invert_single_phase_y(const SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, parameters other_key, double other, double x, std::size_t i, std::size_t j)
 {
-    // Get the cell
-    const CellCoeffs &cell = coeffs[i][j];
-    
-	// Get the alpha coefficients
-    const std::vector<double> &alpha = cell.get(other_key);
+	// Get the alpha coefficients of the cell
+    const double *alpha = coeffs.get(other_key, i, j);
     
     // Normalized value in the range (0, 1)
     double xhat = (x - table.xvec[i])/(table.xvec[i+1] - table.xvec[i]);
@@ -69,27 +69,25 @@ class BicubicBackend : public TabularBackend
             imposed_phase_index = iphase_not_imposed;
             // If a pure fluid or a predefined mixture, don't need to set fractions, go ahead and build
             if (!this->AS->get_mole_fractions().empty()){
+                // The library builds the coefficients along with the tables
                 check_tables();
-                SinglePhaseGriddedTableData &single_phase_logph = dataset->single_phase_logph;
-                SinglePhaseGriddedTableData &single_phase_logpT = dataset->single_phase_logpT;
-                dataset->build_coeffs(single_phase_logph, dataset->coeffs_ph);
-                dataset->build_coeffs(single_phase_logpT, dataset->coeffs_pT);
                 is_mixture = (this->AS->get_mole_fractions().size() > 1);
             }
 		};
         void set_mole_fractions(const std::vector<CoolPropDbl> &mole_fractions){ 
             this->AS->set_mole_fractions(mole_fractions); 
             is_mixture = true;
-            // Check the tables and build if necessary
+            // Check the tables and build if necessary; for mixtures, the construction of the coefficients
+            // is delayed until this function so that the set_mole_fractions function can be called
             check_tables();
-            // For mixtures, the construction of the coefficients is delayed until this 
-            // function so that the set_mole_fractions function can be called
-            SinglePhaseGriddedTableData &single_phase_logph = dataset->single_phase_logph;
-            SinglePhaseGriddedTableData &single_phase_logpT = dataset->single_phase_logpT;
-            dataset->build_coeffs(single_phase_logph, dataset->coeffs_ph);
-            dataset->build_coeffs(single_phase_logpT, dataset->coeffs_pT);
         };
         std::string backend_name(void){return "BicubicBackend";}
+        /// Make an independent copy of this state; the tables belong to the library and are shared
+        BicubicBackend * clone(){
+            BicubicBackend *ptr = new BicubicBackend(*this);
+            ptr->AS.reset(AS->clone());
+            return ptr;
+        };
         
         /**
          * @brief Evaluate a derivative in terms of the native inputs of the table
@@ -104,7 +102,7 @@ class BicubicBackend : public TabularBackend
          * @param Ny The number of derivatives with respect to y with x held constant
          * @return 
          */
-        double evaluate_single_phase_derivative(SinglePhaseGriddedTableData &table, std::vector<std::vector<CellCoeffs> > &coeffs, parameters output, double x, double y, std::size_t i, std::size_t j, std::size_t Nx, std::size_t Ny);
+        double evaluate_single_phase_derivative(SinglePhaseGriddedTableData &table, CellCoeffsTable &coeffs, parameters output, double x, double y, std::size_t i, std::size_t j, std::size_t Nx, std::size_t Ny);
 		double evaluate_single_phase_phmolar_derivative(parameters output, std::size_t i, std::size_t j, std::size_t Nx, std::size_t Ny){
             return evaluate_single_phase_derivative(dataset->single_phase_logph, dataset->coeffs_ph, output, _hmolar, _p, i, j, Nx, Ny);
         };
@@ -123,7 +121,7 @@ class BicubicBackend : public TabularBackend
          * @param j
          * @return 
          */
-		double evaluate_single_phase(const SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, const parameters output, const double x, const double y, const std::size_t i, const std::size_t j);
+		double evaluate_single_phase(const SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, const parameters output, const double x, const double y, const std::size_t i, const std::size_t j);
         double evaluate_single_phase_phmolar(parameters output, std::size_t i, std::size_t j){
 			return evaluate_single_phase(dataset->single_phase_logph, dataset->coeffs_ph, output, _hmolar, _p, i, j);
 		};
@@ -131,11 +129,11 @@ class BicubicBackend : public TabularBackend
 			return evaluate_single_phase(dataset->single_phase_logpT, dataset->coeffs_pT, output, _T, _p, i, j);
 		};
 
-        virtual void find_native_nearest_good_indices(SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, double x, double y, std::size_t &i, std::size_t &j);
+        virtual void find_native_nearest_good_indices(SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, double x, double y, std::size_t &i, std::size_t &j);
         
         /// Ask the derived class to find the nearest neighbor (pure virtual)
         virtual void find_nearest_neighbor(SinglePhaseGriddedTableData &table,
-            const std::vector<std::vector<CellCoeffs> > &coeffs,
+            const CellCoeffsTable &coeffs,
             const parameters variable1,
             const double value1,
             const parameters otherkey,
@@ -169,8 +167,8 @@ class BicubicBackend : public TabularBackend
          * @param i The x-coordinate of the cell
          * @param j The y-coordinate of the cell
          */
-        void invert_single_phase_x(const SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, parameters other_key, double other, double y, std::size_t i, std::size_t j);
-        void invert_single_phase_y(const SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, parameters other_key, double other, double x, std::size_t i, std::size_t j);
+        void invert_single_phase_x(const SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, parameters other_key, double other, double y, std::size_t i, std::size_t j);
+        void invert_single_phase_y(const SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, parameters other_key, double other, double x, std::size_t i, std::size_t j);
 };
 
 }
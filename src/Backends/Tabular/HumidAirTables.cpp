@@ -0,0 +1,446 @@
+#if !defined(NO_TABULAR_BACKENDS)
+
+#include "HumidAirTables.h"
+#include "Solvers.h"
+#include <cfloat>
+
+namespace HumidAir
+{
+
+/// The outputs that are tabulated; T and W are the axes of the tables
+static const char * tabulated_outputs[] = {"H", "Hha", "S", "Sha", "U", "Uha", "V", "Vha", "B", "D", "R", "Y", "C", "Cha", "CV", "CVha", "M", "K", "Z", "P_w", "speed_of_sound", "isentropic_exponent"};
+
+HumidAirTableLimits HumidAirTableLimits::from_config()
+{
+    HumidAirTableLimits limits;
+    limits.Tmin = CoolProp::get_config_double(HUMID_AIR_TABLE_TMIN);
+    limits.Tmax = CoolProp::get_config_double(HUMID_AIR_TABLE_TMAX);
+    limits.Wmax = CoolProp::get_config_double(HUMID_AIR_TABLE_WMAX);
+    limits.pmin = CoolProp::get_config_double(HUMID_AIR_TABLE_PMIN);
+    limits.pmax = CoolProp::get_config_double(HUMID_AIR_TABLE_PMAX);
+    return limits;
+}
+
+HumidAirTables::HumidAirTables(const HumidAirTableLimits &limits) : revision(1), limits(limits), NT(91), NW(51), Np(1), tolerance(_HUGE)
+{
+    outputs.assign(tabulated_outputs, tabulated_outputs + sizeof(tabulated_outputs)/sizeof(tabulated_outputs[0]));
+    if (limits.pmax > limits.pmin){ Np = 5; }
+    make_axis_vectors();
+}
+
+void HumidAirTables::make_axis_vectors()
+{
+    Tvec = linspace(limits.Tmin, limits.Tmax, NT);
+    Wvec = linspace(0.0, limits.Wmax, NW);
+    pvec = (Np > 1) ? linspace(limits.pmin, limits.pmax, Np) : std::vector<double>(1, limits.pmin);
+    tolerance = CoolProp::get_config_double(HUMID_AIR_TABLE_TOLERANCE);
+}
+
+std::string HumidAirTables::path_to_tables() const
+{
+    return CoolProp::get_table_directory() + format("HumidAir(T=[%0.6f,%0.6f]&W=[0,%0.8f]&p=[%0.3f,%0.3f])", limits.Tmin, limits.Tmax, limits.Wmax, limits.pmin, limits.pmax);
+}
+
+void HumidAirTables::set_keys(HumidAirTableKey key)
+{
+    indices.clear();
+    for (std::size_t m = 0; m < outputs.size(); ++m){
+        int k = key(outputs[m]);
+        if (k >= static_cast<int>(indices.size())){ indices.resize(k+1, -1); }
+        indices[k] = static_cast<int>(m);
+    }
+}
+
+/// The derivative along one axis of the nodal values f[0..N-1] with spacing h: central differences inside, one-sided at the ends
+static void finite_difference(const std::vector<double> &f, double h, std::vector<double> &dfdx)
+{
+    std::size_t N = f.size();
+    dfdx.resize(N);
+    for (std::size_t i = 1; i < N-1; ++i){
+        dfdx[i] = (f[i+1] - f[i-1])/(2*h);
+    }
+    dfdx[0] = (-3*f[0] + 4*f[1] - f[2])/(2*h);
+    dfdx[N-1] = (3*f[N-1] - 4*f[N-2] + f[N-3])/(2*h);
+}
+
+void HumidAirTables::build_coeffs()
+{
+    std::size_t Nout = outputs.size();
+    double hT = Tvec[1] - Tvec[0], hW = Wvec[1] - Wvec[0];
+    coeffs.resize(Np*Nout);
+    std::vector<double> column(NT), derivative;
+    for (std::size_t km = 0; km < Np*Nout; ++km){
+        const std::vector<std::vector<double> > &f = values[km];
+        // The derivatives at the nodes from finite differences; an invalid node (_HUGE) makes its neighbors invalid too
+        std::vector<std::vector<double> > fT(NT, std::vector<double>(NW)), fW(NT, std::vector<double>(NW)), fTW(NT, std::vector<double>(NW));
+        for (std::size_t i = 0; i < NT; ++i){
+            finite_difference(f[i], hW, fW[i]);
+        }
+        for (std::size_t j = 0; j < NW; ++j){
+            for (std::size_t i = 0; i < NT; ++i){ column[i] = f[i][j]; }
+            finite_difference(column, hT, derivative);
+            for (std::size_t i = 0; i < NT; ++i){ fT[i][j] = derivative[i]; }
+            for (std::size_t i = 0; i < NT; ++i){ column[i] = fW[i][j]; }
+            finite_difference(column, hT, derivative);
+            for (std::size_t i = 0; i < NT; ++i){ fTW[i][j] = derivative[i]; }
+        }
+        coeffs[km].resize(16*(NT-1)*(NW-1));
+        for (std::size_t i = 0; i < NT-1; ++i){
+            for (std::size_t j = 0; j < NW-1; ++j){
+                // Same layout as in TabularDataSet::build_coeffs, with T as x and W as y
+                double F[16] = {f[i][j], f[i+1][j], f[i][j+1], f[i+1][j+1],
+                                fT[i][j]*hT, fT[i+1][j]*hT, fT[i][j+1]*hT, fT[i+1][j+1]*hT,
+                                fW[i][j]*hW, fW[i+1][j]*hW, fW[i][j+1]*hW, fW[i+1][j+1]*hW,
+                                fTW[i][j]*hT*hW, fTW[i+1][j]*hT*hW, fTW[i][j+1]*hT*hW, fTW[i+1][j+1]*hT*hW};
+                CoolProp::calculate_bicubic_coefficients(F, &(coeffs[km][16*(i*(NW-1) + j)]));
+            }
+        }
+    }
+}
+
+/// Evaluate the bicubic polynomial with the coefficients alpha at the normalized coordinates (xhat, yhat)
+static double evaluate_bicubic(const double *alpha, double xhat, double yhat)
+{
+    double B0 = ((alpha[3*4+0]*yhat + alpha[2*4+0])*yhat + alpha[1*4+0])*yhat + alpha[0*4+0];
+    double B1 = ((alpha[3*4+1]*yhat + alpha[2*4+1])*yhat + alpha[1*4+1])*yhat + alpha[0*4+1];
+    double B2 = ((alpha[3*4+2]*yhat + alpha[2*4+2])*yhat + alpha[1*4+2])*yhat + alpha[0*4+2];
+    double B3 = ((alpha[3*4+3]*yhat + alpha[2*4+3])*yhat + alpha[1*4+3])*yhat + alpha[0*4+3];
+    return ((B3*xhat + B2)*xhat + B1)*xhat + B0;
+}
+
+bool HumidAirTables::find_cell(double T, double W, std::size_t &i, std::size_t &j, double &That, double &What) const
+{
+    // The axes are evenly spaced, so the cell is found directly
+    double rT = (T - Tvec[0])/(Tvec[1] - Tvec[0]), rW = (W - Wvec[0])/(Wvec[1] - Wvec[0]);
+    if (!(rT >= -1e-10 && rT <= NT-1+1e-10 && rW >= -1e-10 && rW <= NW-1+1e-10)){ return false; }
+    i = std::min(static_cast<std::size_t>(std::max(rT, 0.0)), NT-2);
+    j = std::min(static_cast<std::size_t>(std::max(rW, 0.0)), NW-2);
+    That = rT - i; What = rW - j;
+    return true;
+}
+
+bool HumidAirTables::pressure_weights(double p, std::size_t &k, std::size_t &kmin, std::size_t &Nk, double weights[4]) const
+{
+    if (Np == 1){
+        k = 0; kmin = 0; Nk = 1; weights[0] = 1;
+        return std::abs(p - pvec[0]) <= 1e-10*pvec[0];
+    }
+    double r = (p - pvec[0])/(pvec[1] - pvec[0]);
+    if (!(r >= -1e-10 && r <= Np-1+1e-10)){ return false; }
+    k = std::min(static_cast<std::size_t>(std::max(r, 0.0)), Np-2);
+    if (std::abs(r - k) <= 1e-10 || std::abs(r - (k+1)) <= 1e-10){
+        // At one of the tabulated pressures
+        kmin = (std::abs(r - k) <= 1e-10) ? k : k+1; Nk = 1; weights[0] = 1;
+        return true;
+    }
+    // The four nearest pressures (or all of them if there are fewer)
+    Nk = std::min(static_cast<std::size_t>(4), Np);
+    kmin = (k > 0) ? k-1 : 0;
+    if (kmin + Nk > Np){ kmin = Np - Nk; }
+    for (std::size_t a = 0; a < Nk; ++a){
+        weights[a] = 1;
+        for (std::size_t b = 0; b < Nk; ++b){
+            if (a != b){ weights[a] *= (r - (kmin+b))/static_cast<double>(static_cast<int>(a) - static_cast<int>(b)); }
+        }
+    }
+    return true;
+}
+
+double HumidAirTables::interpolate_cell(std::size_t m, std::size_t kmin, std::size_t Nk, const double weights[4], std::size_t i, std::size_t j, double That, double What) const
+{
+    double value = 0;
+    for (std::size_t a = 0; a < Nk; ++a){
+        value += weights[a]*evaluate_bicubic(&(coeffs[(kmin + a)*outputs.size() + m][16*(i*(NW-1) + j)]), That, What);
+    }
+    return value;
+}
+
+bool HumidAirTables::interpolate(std::size_t m, double p, double T, double W, double &value) const
+{
+    std::size_t k, kmin, Nk, i, j;
+    double weights[4], That, What;
+    if (!pressure_weights(p, k, kmin, Nk, weights) || !find_cell(T, W, i, j, That, What)){ return false; }
+    // The cell must be accurate enough at each of the pressures, and in between them if p is not one of them
+    for (std::size_t a = 0; a < Nk; ++a){
+        if (!(errors[kmin + a][i][j] <= tolerance)){ return false; }
+    }
+    if (Nk > 1 && !(pressure_errors[k][i][j] <= tolerance)){ return false; }
+    value = interpolate_cell(m, kmin, Nk, weights, i, j, That, What);
+    return true;
+}
+
+/// The difference between the interpolated output and its target, along T or W with the other held constant
+class HumidAirTableResidual : public CoolProp::FuncWrapper1D
+{
+public:
+    const HumidAirTables &tables;
+    std::size_t m;
+    double target, scale, p, given;
+    bool T_given;
+    HumidAirTableResidual(const HumidAirTables &tables, std::size_t m, double target, double p, double given, bool T_given)
+        : tables(tables), m(m), target(target), scale(1), p(p), given(given), T_given(T_given) {};
+    double call(double x){
+        double value;
+        bool ok = (T_given) ? tables.interpolate(m, p, given, x, value) : tables.interpolate(m, p, x, given, value);
+        if (!ok){ throw CoolProp::ValueError("point is not in the humid air tables"); }
+        return (value - target)/scale;
+    };
+};
+
+bool HumidAirTables::solve(std::size_t m, double target, double p, double given, bool T_given, double &x) const
+{
+    const std::vector<double> &nodes = (T_given) ? Wvec : Tvec;
+    HumidAirTableResidual resid(*this, m, target, p, given, T_given);
+    // Scan the nodes for the first interval in which the residual changes sign
+    double rprev = _HUGE;
+    for (std::size_t j = 0; j < nodes.size(); ++j){
+        double r;
+        try{
+            r = resid.call(nodes[j]);
+        }
+        catch(CoolProp::ValueError &){
+            rprev = _HUGE; continue;
+        }
+        if (r == 0){ x = nodes[j]; return true; }
+        if (j > 0 && ValidNumber(rprev) && rprev*r < 0){
+            try{
+                std::string errstr;
+                resid.scale = std::abs(r - rprev);
+                x = CoolProp::Brent(resid, nodes[j-1], nodes[j], DBL_EPSILON, 1e-12, 50, errstr);
+                return errstr.empty();
+            }
+            catch(std::exception &){
+                return false;
+            }
+        }
+        rprev = r;
+    }
+    return false;
+}
+
+bool HumidAirTables::solve_W(std::size_t m, double target, double p, double T, double &W) const
+{
+    return solve(m, target, p, T, true, W);
+}
+
+bool HumidAirTables::solve_T(std::size_t m, double target, double p, double W, double &T) const
+{
+    return solve(m, target, p, W, false, T);
+}
+
+void HumidAirTables::build(HumidAirTableEvaluator evaluate)
+{
+    std::size_t Nout = outputs.size();
+    if (CoolProp::get_debug_level() > 0){ std::cout << format("Building humid air tables in %s\n", path_to_tables().c_str()); }
+
+    // The nodes of one pressure, i-major
+    std::vector<double> T(NT*NW), W(NT*NW);
+    for (std::size_t i = 0; i < NT; ++i){
+        for (std::size_t j = 0; j < NW; ++j){ T[i*NW + j] = Tvec[i]; W[i*NW + j] = Wvec[j]; }
+    }
+    values.assign(Np*Nout, std::vector<std::vector<double> >(NT, std::vector<double>(NW, _HUGE)));
+    std::vector<std::vector<double> > IO;
+    for (std::size_t k = 0; k < Np; ++k){
+        evaluate(outputs, pvec[k], T, W, IO);
+        for (std::size_t i = 0; i < NT; ++i){
+            for (std::size_t j = 0; j < NW; ++j){
+                for (std::size_t m = 0; m < Nout; ++m){ values[k*Nout + m][i][j] = IO[i*NW + j][m]; }
+            }
+        }
+    }
+    build_coeffs();
+
+    // Where an output is close to zero, its error is taken relative to 1% of its span over the table at the pressure
+    std::vector<std::vector<double> > floors(Np, std::vector<double>(Nout));
+    for (std::size_t k = 0; k < Np; ++k){
+        for (std::size_t m = 0; m < Nout; ++m){
+            double fmin = _HUGE, fmax = -_HUGE;
+            for (std::size_t i = 0; i < NT; ++i){
+                for (std::size_t j = 0; j < NW; ++j){
+                    double f = values[k*Nout + m][i][j];
+                    if (ValidNumber(f)){ fmin = std::min(fmin, f); fmax = std::max(fmax, f); }
+                }
+            }
+            floors[k][m] = (fmax > fmin) ? 0.01*(fmax - fmin) : DBL_MIN;
+        }
+    }
+    // Estimate the error of each cell by comparing with the exact values at its centre, at each pressure and halfway between them
+    errors.resize(Np);
+    for (std::size_t k = 0; k < Np; ++k){
+        cell_errors(evaluate, pvec[k], floors, errors[k]);
+    }
+    pressure_errors.resize(Np - 1);
+    for (std::size_t k = 0; k + 1 < Np; ++k){
+        cell_errors(evaluate, (pvec[k] + pvec[k+1])/2, floors, pressure_errors[k]);
+    }
+}
+
+void HumidAirTables::cell_errors(HumidAirTableEvaluator evaluate, double p, const std::vector<std::vector<double> > &floors, std::vector<std::vector<double> > &err) const
+{
+    std::size_t Nout = outputs.size();
+    std::vector<double> Tc((NT-1)*(NW-1)), Wc((NT-1)*(NW-1));
+    for (std::size_t i = 0; i < NT-1; ++i){
+        for (std::size_t j = 0; j < NW-1; ++j){
+            Tc[i*(NW-1) + j] = (Tvec[i] + Tvec[i+1])/2; Wc[i*(NW-1) + j] = (Wvec[j] + Wvec[j+1])/2;
+        }
+    }
+    std::vector<std::vector<double> > IO;
+    evaluate(outputs, p, Tc, Wc, IO);
+    std::size_t k, kmin, Nk;
+    double weights[4];
+    pressure_weights(p, k, kmin, Nk, weights);
+    // The floors of the tabulated pressure, or of the one below p if p is between two of them
+    const std::vector<double> &floor = floors[(Nk == 1) ? kmin : k];
+    err.assign(NT-1, std::vector<double>(NW-1, 0.0));
+    for (std::size_t m = 0; m < Nout; ++m){
+        for (std::size_t i = 0; i < NT-1; ++i){
+            for (std::size_t j = 0; j < NW-1; ++j){
+                double exact = IO[i*(NW-1) + j][m];
+                double interpolated = interpolate_cell(m, kmin, Nk, weights, i, j, 0.5, 0.5);
+                double e = std::abs(interpolated - exact)/std::max(std::abs(exact), floor[m]);
+                // An error that is not a number (an invalid node, for instance) rules the cell out
+                err[i][j] = (ValidNumber(e)) ? std::max(err[i][j], e) : _HUGE;
+            }
+        }
+    }
+}
+
+void HumidAirTables::write_tables() const
+{
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, *this);
+    CoolProp::write_compressed_table(sbuf, path_to_tables(), "humid_air");
+}
+
+void HumidAirTables::load_tables()
+{
+    std::string path = path_to_tables() + "/humid_air.bin.z";
+    std::vector<char> buffer = CoolProp::load_compressed_table(path);
+    HumidAirTables temp;
+    try{
+        msgpack::unpacked msg;
+        msgpack::unpack(&msg, &(buffer[0]), buffer.size());
+        msg.get().convert(&temp);
+    }
+    catch(std::exception &e){
+        throw CoolProp::UnableToLoadError(format("Unable to msgpack deserialize %s; err: %s", path.c_str(), e.what()));
+    }
+    if (temp.revision < revision){
+        throw CoolProp::UnableToLoadError(format("loaded revision [%d] is older than current revision [%d]", temp.revision, revision));
+    }
+    if (!(temp.limits == limits) || temp.NT != NT || temp.NW != NW || temp.Np != Np || temp.outputs != outputs){
+        throw CoolProp::UnableToLoadError(format("The humid air tables in %s do not match the current limits", path.c_str()));
+    }
+    if (temp.values.size() != Np*outputs.size() || temp.errors.size() != Np || temp.pressure_errors.size() != Np - 1){
+        throw CoolProp::UnableToLoadError(format("The humid air tables in %s are incomplete", path.c_str()));
+    }
+    values.swap(temp.values);
+    errors.swap(temp.errors);
+    pressure_errors.swap(temp.pressure_errors);
+    build_coeffs();
+}
+
+/// The tables that have been loaded or built, one set per set of limits; NULL if they could not be built
+/// They are never removed, so a pointer to them stays valid
+static std::map<std::string, shared_ptr<HumidAirTables> > humid_air_tables;
+/// Guards the map above; the tables themselves are not changed after they have been loaded or built
+static CoolProp::Mutex humid_air_tables_mutex;
+
+/// The tables for the limits that the thread asked for most recently, so that the mutex is only taken when the limits change
+struct CurrentHumidAirTables{
+    HumidAirTableLimits limits;
+    const HumidAirTables *tables;
+    bool set;
+    CurrentHumidAirTables() : tables(NULL), set(false) {};
+};
+static CoolProp::ThreadLocal<CurrentHumidAirTables> current_tables;
+
+const HumidAirTables * get_humid_air_tables(HumidAirTableEvaluator evaluate, HumidAirTableKey key)
+{
+    HumidAirTableLimits limits = HumidAirTableLimits::from_config();
+    CurrentHumidAirTables &current = current_tables.get();
+    if (current.set && limits == current.limits){ return current.tables; }
+
+    CoolProp::ScopedLock lock(humid_air_tables_mutex);
+    shared_ptr<HumidAirTables> tables(new HumidAirTables(limits));
+    const std::string path = tables->path_to_tables();
+    std::map<std::string, shared_ptr<HumidAirTables> >::iterator it = humid_air_tables.find(path);
+    if (it == humid_air_tables.end()){
+        // Any other thread that wants the tables waits on the lock until they have been loaded or built
+        try{
+            try{
+                tables->load_tables();
+            }
+            catch(CoolProp::UnableToLoadError &){
+                make_dirs(path);
+                CoolProp::TableFileLock file_lock(path + "/build.lock");
+                try{
+                    tables->load_tables();
+                }
+                catch(CoolProp::UnableToLoadError &){
+                    CoolProp::check_table_directory_size(path);
+                    tables->build(evaluate);
+                    tables->write_tables();
+                }
+            }
+            tables->set_keys(key);
+        }
+        catch(std::exception &e){
+            CoolProp::set_warning_string(format("Unable to build the humid air tables; the full calculation is used instead: %s", e.what()));
+            tables.reset();
+        }
+        it = humid_air_tables.insert(std::pair<std::string, shared_ptr<HumidAirTables> >(path, tables)).first;
+    }
+    current.limits = limits;
+    current.tables = it->second.get();
+    current.set = true;
+    return current.tables;
+}
+
+} /* namespace HumidAir */
+
+#if defined(ENABLE_CATCH)
+#include "catch.hpp"
+
+/// The amplitude of the oscillation in pressure of the synthetic outputs below
+static double synthetic_wiggle = 0;
+
+/// Synthetic outputs that are linear in T and W, so that only the interpolation in pressure has an error
+static void synthetic_humid_air(const std::vector<std::string> &outputs, double p, const std::vector<double> &T, const std::vector<double> &W, std::vector<std::vector<double> > &IO)
+{
+    double x = (p - 1e5)/1e5;
+    IO.assign(T.size(), std::vector<double>(outputs.size()));
+    for (std::size_t i = 0; i < T.size(); ++i){
+        for (std::size_t m = 0; m < outputs.size(); ++m){
+            IO[i][m] = (T[i] + 1000*W[i] + m)*(1 + 0.1*x + synthetic_wiggle*sin(20*x));
+        }
+    }
+}
+
+TEST_CASE("The humid air tables are checked between the tabulated pressures", "[HumidAirTables]")
+{
+    HumidAir::HumidAirTableLimits limits;
+    limits.Tmin = 280; limits.Tmax = 300; limits.Wmax = 0.02; limits.pmin = 1e5; limits.pmax = 2e5;
+    double p_node = 1.25e5, p_between = 1.375e5, value;
+
+    // Smooth in pressure; the cells can be used at any pressure
+    synthetic_wiggle = 0;
+    HumidAir::HumidAirTables smooth(limits);
+    smooth.build(synthetic_humid_air);
+    CHECK(smooth.interpolate(0, p_node, 290.1, 0.0101, value));
+    REQUIRE(smooth.interpolate(0, p_between, 290.1, 0.0101, value));
+    std::vector<std::vector<double> > IO;
+    synthetic_humid_air(smooth.outputs, p_between, std::vector<double>(1, 290.1), std::vector<double>(1, 0.0101), IO);
+    CHECK(std::abs(value/IO[0][0] - 1) < 1e-10);
+
+    // Too wiggly in pressure for the Lagrange interpolation; the cells can only be used at the tabulated pressures
+    synthetic_wiggle = 0.01;
+    HumidAir::HumidAirTables wiggly(limits);
+    wiggly.build(synthetic_humid_air);
+    CHECK(wiggly.interpolate(0, p_node, 290.1, 0.0101, value));
+    CHECK(!wiggly.interpolate(0, p_between, 290.1, 0.0101, value));
+    CHECK(!wiggly.interpolate(0, 1.3e5, 290.1, 0.0101, value));
+}
+#endif // ENABLE_CATCH
+
+#endif // !defined(NO_TABULAR_BACKENDS)
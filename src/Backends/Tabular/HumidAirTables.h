@@ -0,0 +1,111 @@
+#ifndef HUMIDAIRTABLES_H
+#define HUMIDAIRTABLES_H
+
+#include "TabularBackends.h"
+
+namespace HumidAir
+{
+
+/** \brief Evaluates the tabulated outputs exactly (without the tables) at a set of state points at one pressure
+ *
+ * IO is resized to one row per state point and one column per output; an output that cannot be calculated is _HUGE
+ */
+typedef void (*HumidAirTableEvaluator)(const std::vector<std::string> &outputs, double p, const std::vector<double> &T, const std::vector<double> &W, std::vector<std::vector<double> > &IO);
+
+/// Converts the name of an output to the integer key that the caller uses for it
+typedef int (*HumidAirTableKey)(const std::string &output);
+
+/// The range of the humid air tables, taken from the HUMID_AIR_TABLE_* configuration keys
+struct HumidAirTableLimits{
+    double Tmin, Tmax, Wmax, pmin, pmax;
+    HumidAirTableLimits() : Tmin(_HUGE), Tmax(_HUGE), Wmax(_HUGE), pmin(_HUGE), pmax(_HUGE) {};
+    /// Read the limits from the configuration
+    static HumidAirTableLimits from_config();
+    bool operator==(const HumidAirTableLimits &other) const {
+        return Tmin == other.Tmin && Tmax == other.Tmax && Wmax == other.Wmax && pmin == other.pmin && pmax == other.pmax;
+    };
+};
+
+/** \brief Tables of humid air properties for bicubic interpolation in the dry-bulb temperature and the humidity ratio
+ *
+ * The outputs are tabulated on a regular grid in T and W at each of a set of evenly spaced pressures (just one
+ * if pmin == pmax).  Within a pressure the outputs are interpolated bicubically, with the derivatives at the nodes
+ * taken from finite differences of the nodal values; between pressures the values from the nearest (up to four)
+ * pressures are combined by Lagrange interpolation.
+ *
+ * When the tables are built, the interpolated value of each output is compared with the exact value at the centre of
+ * each cell.  The largest relative error of any output in the cell (relative to 1% of the span of the output over the
+ * table where the output is close to zero) is stored with the cell, and a cell whose error exceeds
+ * HUMID_AIR_TABLE_TOLERANCE is not used.  Between two tabulated pressures the error of the interpolation in pressure
+ * is checked in the same way at the pressure halfway between them, and a cell whose error there exceeds the tolerance
+ * is only used at the tabulated pressures.
+ */
+class HumidAirTables
+{
+public:
+    int revision;
+    HumidAirTableLimits limits;
+    std::size_t NT, NW, Np; ///< The number of nodes in T, W and p
+    std::vector<std::string> outputs; ///< The names of the tabulated outputs, as accepted by HAPropsSI
+    /// The nodal values; values[k*outputs.size()+m][i][j] is output m at the k-th pressure, i-th temperature and j-th humidity ratio
+    std::vector<std::vector<std::vector<double> > > values;
+    /// errors[k][i][j] is the largest estimated relative error of any output in cell (i,j) at the k-th pressure
+    std::vector<std::vector<std::vector<double> > > errors;
+    /// pressure_errors[k][i][j] is the same as errors, but halfway between the k-th and (k+1)-th pressures
+    std::vector<std::vector<std::vector<double> > > pressure_errors;
+    MSGPACK_DEFINE(revision, limits.Tmin, limits.Tmax, limits.Wmax, limits.pmin, limits.pmax, NT, NW, Np, outputs, values, errors, pressure_errors);
+
+    explicit HumidAirTables(const HumidAirTableLimits &limits = HumidAirTableLimits());
+
+    /// The directory that the tables for these limits are stored in
+    std::string path_to_tables() const;
+    /// Calculate the nodal values and the error estimates of the cells, and then the coefficients
+    void build(HumidAirTableEvaluator evaluate);
+    /// Write the tables to path_to_tables()
+    void write_tables() const;
+    /// Load the tables from path_to_tables(); throws UnableToLoadError if they are missing or do not belong to these limits
+    void load_tables();
+    /// Set up output_index() for the keys that key() gives to the names of the outputs
+    void set_keys(HumidAirTableKey key);
+    /// The index in outputs of the output with the given key, or -1 if it is not tabulated
+    int output_index(int key) const { return (key >= 0 && key < static_cast<int>(indices.size())) ? indices[key] : -1; };
+
+    /// Interpolate output m at (p, T, W); returns false if the point is outside the tables or in a cell that is not accurate enough
+    bool interpolate(std::size_t m, double p, double T, double W, double &value) const;
+    /// Find the humidity ratio at which output m takes the value target at (p, T); returns false if there is none in the tables
+    bool solve_W(std::size_t m, double target, double p, double T, double &W) const;
+    /// Find the temperature at which output m takes the value target at (p, W); returns false if there is none in the tables
+    bool solve_T(std::size_t m, double target, double p, double W, double &T) const;
+
+private:
+    std::vector<double> Tvec, Wvec, pvec;
+    double tolerance; ///< The largest estimated error of a cell that is used
+    /// The coefficients; coeffs[k*outputs.size()+m] holds the 16 coefficients of each cell (i,j) in row-major order
+    std::vector<std::vector<double> > coeffs;
+    std::vector<int> indices; ///< The index in outputs for each key, or -1
+
+    void make_axis_vectors();
+    void build_coeffs();
+    /// Find the cell (i,j) that contains (T, W) and the normalized coordinates within it; returns false if it is outside the tables
+    bool find_cell(double T, double W, std::size_t &i, std::size_t &j, double &That, double &What) const;
+    /// Find the pressures and the Lagrange weights that are combined at pressure p; returns false if p is outside the tables
+    /// k is the index of the tabulated pressure at or below p
+    bool pressure_weights(double p, std::size_t &k, std::size_t &kmin, std::size_t &Nk, double weights[4]) const;
+    /// Interpolate output m in cell (i,j) at pressure p without checking the error of the cell
+    double interpolate_cell(std::size_t m, std::size_t kmin, std::size_t Nk, const double weights[4], std::size_t i, std::size_t j, double That, double What) const;
+    /// The largest relative error of any output in each cell, from the exact values at the cell centres at pressure p
+    void cell_errors(HumidAirTableEvaluator evaluate, double p, const std::vector<std::vector<double> > &floors, std::vector<std::vector<double> > &err) const;
+    /// Solve for the free variable (W if T_given, otherwise T) by scanning the nodes for a bracket and then using Brent's method
+    bool solve(std::size_t m, double target, double p, double given, bool T_given, double &x) const;
+};
+
+/** \brief Get the humid air tables for the limits in the configuration, loading them or building them (with evaluate) if needed
+ *
+ * The tables are shared by all threads and are only loaded or built once.  Returns NULL if the tables are unavailable
+ * because they could not be built; the full calculation is then used.
+ */
+const HumidAirTables * get_humid_air_tables(HumidAirTableEvaluator evaluate, HumidAirTableKey key);
+
+} /* namespace HumidAir */
+
+#endif
@@ -21,7 +21,7 @@ double CoolProp::TTSEBackend::evaluate_single_phase_transport(SinglePhaseGridded
     if (!is_valid){
         throw ValueError("Cell to TTSEBackend::evaluate_single_phase_transport must have four valid corners for now");
     }
-    const std::vector<std::vector<double> > &f = table.get(output);
+    const TableMatrix &f = table.get(output);
 
     double x1 = table.xvec[i], x2 = table.xvec[i+1], y1 = table.yvec[j], y2 = table.yvec[j+1];
     double f11 = f[i][j], f12 = f[i][j+1], f21 = f[i+1][j], f22 = f[i+1][j+1];
@@ -39,7 +39,7 @@ double CoolProp::TTSEBackend::evaluate_single_phase_transport(SinglePhaseGridded
     return val;
 }
 /// Solve for deltax
-void CoolProp::TTSEBackend::invert_single_phase_x(const SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, parameters output, double x, double y, std::size_t i, std::size_t j)
+void CoolProp::TTSEBackend::invert_single_phase_x(const SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, parameters output, double x, double y, std::size_t i, std::size_t j)
 {   
     connect_pointers(output, table);
     
@@ -97,7 +97,7 @@ void CoolProp::TTSEBackend::invert_single_phase_x(const SinglePhaseGriddedTableD
     }
 }
 /// Solve for deltay
-void CoolProp::TTSEBackend::invert_single_phase_y(const SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, parameters output, double y, double x, std::size_t i, std::size_t j)
+void CoolProp::TTSEBackend::invert_single_phase_y(const SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, parameters output, double y, double x, std::size_t i, std::size_t j)
 {   
     connect_pointers(output, table);
     
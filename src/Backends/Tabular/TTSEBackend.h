@@ -10,16 +10,19 @@ class TTSEBackend : public TabularBackend
 {
     public:
         std::string backend_name(void){return "TTSEBackend";}
+        /// Make an independent copy of this state; the tables belong to the library and are shared
+        TTSEBackend * clone(){
+            TTSEBackend *ptr = new TTSEBackend(*this);
+            ptr->AS.reset(AS->clone());
+            return ptr;
+        };
         /// Instantiator; base class loads or makes tables
         TTSEBackend(shared_ptr<CoolProp::AbstractState> AS) : TabularBackend (AS) {
             imposed_phase_index = iphase_not_imposed;
             // If a pure fluid or a predefined mixture, don't need to set fractions, go ahead and build
             if (!this->AS->get_mole_fractions().empty()){
+                // The library builds the coefficients along with the tables
                 check_tables();
-                SinglePhaseGriddedTableData &single_phase_logph = dataset->single_phase_logph;
-                SinglePhaseGriddedTableData &single_phase_logpT = dataset->single_phase_logpT;
-                dataset->build_coeffs(single_phase_logph, dataset->coeffs_ph);
-                dataset->build_coeffs(single_phase_logpT, dataset->coeffs_pT);
                 is_mixture = (this->AS->get_mole_fractions().size() > 1);
             }
         }
@@ -41,16 +44,16 @@ class TTSEBackend : public TabularBackend
             SinglePhaseGriddedTableData &single_phase_logpT = dataset->single_phase_logpT;
             return evaluate_single_phase_transport(single_phase_logpT, output, _T, _p, i, j);
         }
-        void invert_single_phase_x(const SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, parameters output, double x, double y, std::size_t i, std::size_t j);
-        void invert_single_phase_y(const SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, parameters output, double y, double x, std::size_t i, std::size_t j);
+        void invert_single_phase_x(const SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, parameters output, double x, double y, std::size_t i, std::size_t j);
+        void invert_single_phase_y(const SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, parameters output, double y, double x, std::size_t i, std::size_t j);
         
         /// Find the best set of i,j for native inputs.  
-        virtual void find_native_nearest_good_indices(SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, double x, double y, std::size_t &i, std::size_t &j){
+        virtual void find_native_nearest_good_indices(SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, double x, double y, std::size_t &i, std::size_t &j){
             return table.find_native_nearest_good_neighbor(x, y, i, j);
         };
         /// Ask the derived class to find the nearest neighbor (pure virtual)
         virtual void find_nearest_neighbor(SinglePhaseGriddedTableData &table,
-            const std::vector<std::vector<CellCoeffs> > &coeffs,
+            const CellCoeffsTable &coeffs,
             const parameters variable1,
             const double value1,
             const parameters otherkey,
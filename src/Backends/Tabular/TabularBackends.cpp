@@ -4,8 +4,12 @@
 #include "TabularBackends.h"
 #include "CoolProp.h"
 #include <sstream>
+#include <cstdio>
 #include "time.h"
 #include "miniz.h"
+#if defined(_OPENMP)
+    #include <omp.h>
+#endif
 
 /// The inverse of the A matrix for the bicubic interpolation (http://en.wikipedia.org/wiki/Bicubic_interpolation)
 /// NOTE: The matrix is transposed below
@@ -32,17 +36,14 @@ static CoolProp::TabularDataLibrary library;
 
 namespace CoolProp{
 
-/**
- * @brief 
- * @param table
- * @param path_to_tables
- * @param filename
- */
-template <typename T> void load_table(T &table, const std::string &path_to_tables, const std::string &filename){
-    
-    double tic = clock();
-    std::string path_to_table = path_to_tables + "/" + filename;
-    if (get_debug_level() > 0){std::cout << format("Loading table: %s", path_to_table.c_str()) << std::endl;}
+void calculate_bicubic_coefficients(const double *F, double *alpha)
+{
+    Eigen::Map<const Eigen::Matrix<double, 16, 1> > Fmap(F);
+    Eigen::Map<Eigen::Matrix<double, 16, 1> > alphamap(alpha);
+    alphamap = Ainv.transpose()*Fmap; // 16x1; Watch out for the transpose!
+}
+
+std::vector<char> load_compressed_table(const std::string &path_to_table){
     std::vector<char> raw;
     try{
          raw = get_binary_file_contents(path_to_table.c_str());
@@ -70,7 +71,47 @@ template <typename T> void load_table(T &table, const std::string &path_to_table
         }
     }while(code != 0);
     // Copy the buffer from unsigned char to char (yuck)
-    std::vector<char> charbuffer(newBuffer.begin(), newBuffer.begin() + newBufferSize);
+    return std::vector<char>(newBuffer.begin(), newBuffer.begin() + newBufferSize);
+}
+
+void write_compressed_table(const msgpack::sbuffer &sbuf, const std::string &path_to_tables, const std::string &name)
+{
+    std::string tabPath = std::string(path_to_tables + "/" + name + ".bin");
+    std::string zPath = tabPath + ".z";
+    std::vector<char> buffer(sbuf.size());
+    uLong outSize = static_cast<uLong>(buffer.size());
+    compress((unsigned char *)(&(buffer[0])), &outSize, 
+             (unsigned char*)(sbuf.data()), static_cast<mz_ulong>(sbuf.size()));
+    // Written by way of temporary files so that a process that is loading the tables never sees a partial file
+    AtomicFileWriter zFile(zPath);
+    std::ofstream ofs2(zFile.temporary().c_str(), std::ofstream::binary);
+    ofs2.write(&buffer[0], outSize);
+    ofs2.close();
+    if (!ofs2){ throw ValueError(format("Unable to write table %s", zPath.c_str())); }
+    zFile.commit();
+    
+    if (CoolProp::get_config_bool(SAVE_RAW_TABLES)){
+        AtomicFileWriter tabFile(tabPath);
+        std::ofstream ofs(tabFile.temporary().c_str(), std::ofstream::binary);
+        ofs.write(sbuf.data(), sbuf.size());
+        ofs.close();
+        if (!ofs){ throw ValueError(format("Unable to write table %s", tabPath.c_str())); }
+        tabFile.commit();
+    }
+}
+
+/**
+ * @brief 
+ * @param table
+ * @param path_to_tables
+ * @param filename
+ */
+template <typename T> void load_table(T &table, const std::string &path_to_tables, const std::string &filename){
+    
+    double tic = clock();
+    std::string path_to_table = path_to_tables + "/" + filename;
+    if (get_debug_level() > 0){std::cout << format("Loading table: %s", path_to_table.c_str()) << std::endl;}
+    std::vector<char> charbuffer = load_compressed_table(path_to_table);
     try{
         msgpack::unpacked msg;
         msgpack::unpack(&msg, &(charbuffer[0]), charbuffer.size());
@@ -91,24 +132,175 @@ template <typename T> void write_table(const T &table, const std::string &path_t
 {
     msgpack::sbuffer sbuf;
     msgpack::pack(sbuf, table);
-    std::string tabPath = std::string(path_to_tables + "/" + name + ".bin");
-    std::string zPath = tabPath + ".z";
-    std::vector<char> buffer(sbuf.size());
-    uLong outSize = static_cast<uLong>(buffer.size());
-    compress((unsigned char *)(&(buffer[0])), &outSize, 
-             (unsigned char*)(sbuf.data()), static_cast<mz_ulong>(sbuf.size()));
-    std::ofstream ofs2(zPath.c_str(), std::ofstream::binary);
-    ofs2.write(&buffer[0], outSize);
-    ofs2.close();
-    
-    if (CoolProp::get_config_bool(SAVE_RAW_TABLES)){
-        std::ofstream ofs(tabPath.c_str(), std::ofstream::binary);
-        ofs.write(sbuf.data(), sbuf.size());
+    write_compressed_table(sbuf, path_to_tables, name);
+}
+/// The hash that ties the memory-mapped tables to the backend, fluids and composition encoded in the name of the table directory
+static unsigned long long table_fluid_hash(const std::string &path_to_tables){
+    std::size_t i = path_to_tables.find_last_of("/\\");
+    return table_hash((i == std::string::npos) ? path_to_tables : path_to_tables.substr(i+1));
+}
+
+
+static TableBuildCallback table_build_callback = NULL;
+static void *table_build_user_data = NULL;
+
+void set_table_build_callback(TableBuildCallback callback, void *user_data){
+    table_build_callback = callback;
+    table_build_user_data = user_data;
+}
+
+/// The wall-clock time in seconds, used to time the builds of the tables
+static double table_build_time(){
+    #if defined(_OPENMP)
+        return omp_get_wtime();
+    #else
+        // Without OpenMP the tables are built on one thread, so the processor time is a good measure
+        return static_cast<double>(clock())/CLOCKS_PER_SEC;
+    #endif
+}
+
+/// Counts the rows of a table as they are built, and reports the progress to the table build callback
+class TableBuildProgress{
+private:
+    std::string table;
+    std::size_t done, total;
+    double start;
+public:
+    TableBuildProgress(const std::string &table, std::size_t total) : table(table), done(0), total(total), start(table_build_time()) {
+        if (table_build_callback != NULL){ table_build_callback(table, done, total, 0, table_build_user_data); }
+    };
+    const std::string & name() const { return table; };
+    /// Called by any of the threads when a row has been built
+    void step(){
+        #if defined(_OPENMP)
+        #pragma omp critical(table_build_progress)
+        #endif
+        {
+            ++done;
+            if (table_build_callback != NULL){ table_build_callback(table, done, total, table_build_time() - start, table_build_user_data); }
+        }
+    };
+};
+
+/// Sets a boolean configuration key for as long as it is in scope, and then restores the value it had before, even if an exception is thrown
+class ScopedConfigBool{
+private:
+    configuration_keys key;
+    bool previous;
+    ScopedConfigBool(const ScopedConfigBool &);
+    ScopedConfigBool & operator=(const ScopedConfigBool &);
+public:
+    ScopedConfigBool(configuration_keys key, bool value) : key(key), previous(get_config_bool(key)) { set_config_bool(key, value); };
+    ~ScopedConfigBool(){ set_config_bool(key, previous); };
+};
+
+/// True if the backend supports clone(), in which case each row of a table can be built with its own copy of AS
+static bool table_build_can_clone(shared_ptr<AbstractState> &AS){
+    try{
+        delete AS->clone();
+        return true;
+    }
+    catch(NotImplementedError &){
+        return false;
     }
 }
 
+/// The number of threads used to build a table; the table is built serially with AS itself if AS cannot be cloned
+static int table_build_number_of_threads(bool cloneable){
+    #if defined(_OPENMP)
+        if (!cloneable){ return 1; }
+        int Nthreads = static_cast<int>(get_config_double(TABLE_BUILD_NUMBER_OF_THREADS));
+        return (Nthreads <= 0) ? omp_get_max_threads() : Nthreads;
+    #else
+        return 1;
+    #endif
+}
+
+/// Get the state that is used to build one row (or point) of a table: a fresh copy of AS if possible, otherwise AS itself
+static shared_ptr<AbstractState> table_build_state(shared_ptr<AbstractState> &AS, bool cloneable){
+    if (!cloneable){ return AS; }
+    shared_ptr<AbstractState> copy;
+    // AS is shared by all the threads, so the copies are made one at a time
+    #if defined(_OPENMP)
+    #pragma omp critical(table_build_clone)
+    #endif
+    {
+        copy.reset(AS->clone());
+    }
+    return copy;
+}
+
 } // namespace CoolProp
 
+bool CoolProp::PureFluidSaturationTableData::build_point(AbstractState &AS, std::size_t i, double p)
+{
+    const bool debug = get_debug_level() > 5 || false;
+    // Saturated liquid
+    try{
+        AS.update(PQ_INPUTS, p, 0);
+        pL[i] = p; TL[i] = AS.T();  rhomolarL[i] = AS.rhomolar(); 
+        hmolarL[i] = AS.hmolar(); smolarL[i] = AS.smolar(); umolarL[i] = AS.umolar();
+        logpL[i] = log(p); logrhomolarL[i] = log(rhomolarL[i]);
+        cpmolarL[i] = AS.cpmolar(); cvmolarL[i] = AS.cvmolar(); speed_soundL[i] = AS.speed_sound();
+    }
+    catch(std::exception &e){
+        // That failed for some reason, go to the next pair
+        if (debug){std::cout << " " << e.what() << std::endl;}
+        return false;
+    }
+    // Transport properties - if no transport properties, just keep going
+    try{
+        viscL[i] = AS.viscosity(); condL[i] = AS.conductivity();
+        logviscL[i] = log(viscL[i]);
+    }
+    catch(std::exception &e){
+        if (debug){std::cout << " " << e.what() << std::endl;}
+    }
+    // Saturated vapor
+    try{
+        AS.update(PQ_INPUTS, p, 1);
+        pV[i] = p; TV[i] = AS.T(); rhomolarV[i] = AS.rhomolar();
+        hmolarV[i] = AS.hmolar(); smolarV[i] = AS.smolar(); umolarV[i] = AS.umolar();
+        logpV[i] = log(p); logrhomolarV[i] = log(rhomolarV[i]);
+        cpmolarV[i] = AS.cpmolar(); cvmolarV[i] = AS.cvmolar(); speed_soundV[i] = AS.speed_sound();
+    }
+    catch(std::exception &e){
+        // That failed for some reason, go to the next pair
+        if (debug){std::cout << " " << e.what() << std::endl;}
+        return false;
+    }
+    // Transport properties - if no transport properties, just keep going
+    try{
+        viscV[i] = AS.viscosity(); condV[i] = AS.conductivity();
+        logviscV[i] = log(viscV[i]);
+    }
+    catch(std::exception &e){
+        if (debug){std::cout << " " << e.what() << std::endl;}
+    }
+    return true;
+}
+
+void CoolProp::RegularAxisIndex::set(const double *vec, std::size_t N, bool logscale)
+{
+    this->N = N; this->logscale = logscale;
+    regular = false;
+    if (N < 3 || vec == NULL){ return; }
+    // The spacing is taken from the nodes before the last one, which need not be on the regular spacing
+    double first = (logscale) ? log(vec[0]) : vec[0], before_last = (logscale) ? log(vec[N-2]) : vec[N-2];
+    if (!ValidNumber(first) || !ValidNumber(before_last) || !(before_last > first)){ return; }
+    x0 = first;
+    inverse_step = (N-2)/(before_last - first);
+    for (std::size_t k = 0; k < N; ++k){
+        if (!ValidNumber(vec[k]) || (k > 0 && !(vec[k] > vec[k-1]))){ return; }
+        // Each of the regular nodes must be within a fraction of a step of where it should be
+        if (k < N-1){
+            double r = ((logscale) ? log(vec[k]) : vec[k]) - x0;
+            if (std::abs(r*inverse_step - static_cast<double>(k)) > 0.25){ return; }
+        }
+    }
+    regular = true;
+}
+
 void CoolProp::PureFluidSaturationTableData::build(shared_ptr<CoolProp::AbstractState> &AS){
     const bool debug = get_debug_level() > 5 || false;
     if (debug){
@@ -123,61 +315,33 @@ void CoolProp::PureFluidSaturationTableData::build(shared_ptr<CoolProp::Abstract
     CoolPropDbl Tmin = std::max(AS->Ttriple(), AS->Tmin());
     AS->update(QT_INPUTS, 0, Tmin);
     CoolPropDbl p_triple = AS->p();
-    CoolPropDbl p, pmin = p_triple, pmax = 0.9999*AS->p_critical();
-    for (std::size_t i = 0; i < N-1; ++i)
+    CoolPropDbl pmin = p_triple, pmax = 0.9999*AS->p_critical();
+    bool cloneable = table_build_can_clone(AS);
+    TableBuildProgress progress("saturation", N);
+    
+    // The first point is at the triple point, where the property limits must not be checked; the configuration
+    // is global, so this point is done on its own before the other points are spread over the threads
     {
-        if (i==0){
-            CoolProp::set_config_bool(DONT_CHECK_PROPERTY_LIMITS, true);
-        }
+        ScopedConfigBool dont_check_limits(DONT_CHECK_PROPERTY_LIMITS, true);
+        shared_ptr<AbstractState> point_state = table_build_state(AS, cloneable);
+        build_point(*point_state, 0, pmin);
+    }
+    progress.step();
+    
+    // Each point starts from its own copy of AS, so the result does not depend on the order in which they are built
+    long Npoints = static_cast<long>(N) - 1;
+    #if defined(_OPENMP)
+    #pragma omp parallel for schedule(dynamic) num_threads(table_build_number_of_threads(cloneable))
+    #endif
+    for (long k = 1; k < Npoints; ++k){
+        std::size_t i = static_cast<std::size_t>(k);
         // Log spaced
-        p = exp(log(pmin) + (log(pmax) - log(pmin))/(N-1)*i);
-        
-        // Saturated liquid
-        try{
-            AS->update(PQ_INPUTS, p, 0);
-            pL[i] = p; TL[i] = AS->T();  rhomolarL[i] = AS->rhomolar(); 
-            hmolarL[i] = AS->hmolar(); smolarL[i] = AS->smolar(); umolarL[i] = AS->umolar();
-            logpL[i] = log(p); logrhomolarL[i] = log(rhomolarL[i]);
-            cpmolarL[i] = AS->cpmolar(); cvmolarL[i] = AS->cvmolar(); speed_soundL[i] = AS->speed_sound();
-        }
-        catch(std::exception &e){
-            // That failed for some reason, go to the next pair
-            if (debug){std::cout << " " << e.what() << std::endl;}
-            continue;
-        }
-        // Transport properties - if no transport properties, just keep going
-        try{
-            viscL[i] = AS->viscosity(); condL[i] = AS->conductivity();
-            logviscL[i] = log(viscL[i]);
-        }
-        catch(std::exception &e){
-            if (debug){std::cout << " " << e.what() << std::endl;}
-        }
-        // Saturated vapor
-        try{
-            AS->update(PQ_INPUTS, p, 1);
-            pV[i] = p; TV[i] = AS->T(); rhomolarV[i] = AS->rhomolar();
-            hmolarV[i] = AS->hmolar(); smolarV[i] = AS->smolar(); umolarV[i] = AS->umolar();
-            logpV[i] = log(p); logrhomolarV[i] = log(rhomolarV[i]);
-            cpmolarV[i] = AS->cpmolar(); cvmolarV[i] = AS->cvmolar(); speed_soundV[i] = AS->speed_sound();
-        }
-        catch(std::exception &e){
-            // That failed for some reason, go to the next pair
-            if (debug){std::cout << " " << e.what() << std::endl;}
-            continue;
-        }
-        // Transport properties - if no transport properties, just keep going
-        try{
-            viscV[i] = AS->viscosity(); condV[i] = AS->conductivity();
-            logviscV[i] = log(viscV[i]);
-        }
-        catch(std::exception &e){
-            if (debug){std::cout << " " << e.what() << std::endl;}
-        }
-        if (i==0){
-            CoolProp::set_config_bool(DONT_CHECK_PROPERTY_LIMITS, false);
-        }
+        CoolPropDbl p = exp(log(pmin) + (log(pmax) - log(pmin))/(N-1)*i);
+        shared_ptr<AbstractState> point_state = table_build_state(AS, cloneable);
+        build_point(*point_state, i, p);
+        progress.step();
     }
+    
     // Last point is at the critical point
     AS->update(PQ_INPUTS, AS->p_critical(), 1);
     std::size_t i = N-1;
@@ -201,11 +365,108 @@ void CoolProp::PureFluidSaturationTableData::build(shared_ptr<CoolProp::Abstract
 
     logpL[i] = log(AS->p()); 
 	logrhomolarL[i] = log(rhomolarL[i]);
+    progress.step();
+    make_pressure_indices();
+}
+
+void CoolProp::SinglePhaseGriddedTableData::build_row(AbstractState &AS, std::size_t i)
+{
+    const bool debug = get_debug_level() > 5 || false;
+    CoolPropDbl x = xvec[i];
+    for (std::size_t j = 0; j < Ny; ++j)
+    {
+        CoolPropDbl y = yvec[j];
+        
+        if (debug){std::cout << "x: " << x << " y: " << y << std::endl;}
+        
+        // Generate the input pair
+        CoolPropDbl v1, v2;
+        input_pairs input_pair = generate_update_pair(xkey, x, ykey, y, v1, v2);
+        
+        // --------------------
+        //   Update the state
+        // --------------------
+        try{
+            AS.update(input_pair, v1, v2);
+            if (!ValidNumber(AS.rhomolar())){
+                throw ValueError("rhomolar is invalid");
+            }
+        }
+        catch(std::exception &e){
+            // That failed for some reason, go to the next pair
+            if (debug){std::cout << " " << e.what() << std::endl;}
+            continue;
+        }
+        
+        // Skip two-phase states - they will remain as _HUGE holes in the table
+        if (is_in_closed_range(0.0, 1.0, AS.Q())){ 
+            if (debug){std::cout << " 2Phase" << std::endl;}
+            continue;
+        };
+        
+        // --------------------
+        //   State variables
+        // --------------------
+        T[i][j] = AS.T();
+        p[i][j] = AS.p();
+        rhomolar[i][j] = AS.rhomolar();
+        hmolar[i][j] = AS.hmolar();
+        smolar[i][j] = AS.smolar();
+        umolar[i][j] = AS.umolar();
+        
+        // -------------------------
+        //   Transport properties
+        // -------------------------
+        try{
+            visc[i][j] = AS.viscosity();
+            cond[i][j] = AS.conductivity();
+        }
+        catch(std::exception &){
+            // Failures will remain as holes in table
+        }
+        
+        // ----------------------------------------
+        //   First derivatives of state variables
+        // ----------------------------------------
+        dTdx[i][j] = AS.first_partial_deriv(iT, xkey, ykey);
+        dTdy[i][j] = AS.first_partial_deriv(iT, ykey, xkey);
+        dpdx[i][j] = AS.first_partial_deriv(iP, xkey, ykey);
+        dpdy[i][j] = AS.first_partial_deriv(iP, ykey, xkey);
+        drhomolardx[i][j] = AS.first_partial_deriv(iDmolar, xkey, ykey);
+        drhomolardy[i][j] = AS.first_partial_deriv(iDmolar, ykey, xkey);
+        dhmolardx[i][j] = AS.first_partial_deriv(iHmolar, xkey, ykey);
+        dhmolardy[i][j] = AS.first_partial_deriv(iHmolar, ykey, xkey);
+        dsmolardx[i][j] = AS.first_partial_deriv(iSmolar, xkey, ykey);
+        dsmolardy[i][j] = AS.first_partial_deriv(iSmolar, ykey, xkey);
+        dumolardx[i][j] = AS.first_partial_deriv(iUmolar, xkey, ykey);
+        dumolardy[i][j] = AS.first_partial_deriv(iUmolar, ykey, xkey);
+        
+        // ----------------------------------------
+        //   Second derivatives of state variables
+        // ----------------------------------------
+        d2Tdx2[i][j] = AS.second_partial_deriv(iT, xkey, ykey, xkey, ykey);
+        d2Tdxdy[i][j] = AS.second_partial_deriv(iT, xkey, ykey, ykey, xkey);
+        d2Tdy2[i][j] = AS.second_partial_deriv(iT, ykey, xkey, ykey, xkey);
+        d2pdx2[i][j] = AS.second_partial_deriv(iP, xkey, ykey, xkey, ykey);
+        d2pdxdy[i][j] = AS.second_partial_deriv(iP, xkey, ykey, ykey, xkey);
+        d2pdy2[i][j] = AS.second_partial_deriv(iP, ykey, xkey, ykey, xkey);
+        d2rhomolardx2[i][j] = AS.second_partial_deriv(iDmolar, xkey, ykey, xkey, ykey);
+        d2rhomolardxdy[i][j] = AS.second_partial_deriv(iDmolar, xkey, ykey, ykey, xkey);
+        d2rhomolardy2[i][j] = AS.second_partial_deriv(iDmolar, ykey, xkey, ykey, xkey);
+        d2hmolardx2[i][j] = AS.second_partial_deriv(iHmolar, xkey, ykey, xkey, ykey);
+        d2hmolardxdy[i][j] = AS.second_partial_deriv(iHmolar, xkey, ykey, ykey, xkey);
+        d2hmolardy2[i][j] = AS.second_partial_deriv(iHmolar, ykey, xkey, ykey, xkey);
+        d2smolardx2[i][j] = AS.second_partial_deriv(iSmolar, xkey, ykey, xkey, ykey);
+        d2smolardxdy[i][j] = AS.second_partial_deriv(iSmolar, xkey, ykey, ykey, xkey);
+        d2smolardy2[i][j] = AS.second_partial_deriv(iSmolar, ykey, xkey, ykey, xkey);
+        d2umolardx2[i][j] = AS.second_partial_deriv(iUmolar, xkey, ykey, xkey, ykey);
+        d2umolardxdy[i][j] = AS.second_partial_deriv(iUmolar, xkey, ykey, ykey, xkey);
+        d2umolardy2[i][j] = AS.second_partial_deriv(iUmolar, ykey, xkey, ykey, xkey);
+    }
 }
     
 void CoolProp::SinglePhaseGriddedTableData::build(shared_ptr<CoolProp::AbstractState> &AS)
 {
-    CoolPropDbl x, y;
     const bool debug = get_debug_level() > 5 || false;
 
     resize(Nx, Ny);
@@ -215,120 +476,54 @@ void CoolProp::SinglePhaseGriddedTableData::build(shared_ptr<CoolProp::AbstractS
         std::cout << format(" Single-Phase Table (%s) \n", strjoin(AS->fluid_names(), "&").c_str());
         std::cout << format("***********************************************\n");
     }
-    // ------------------------
-    // Actually build the table
-    // ------------------------
-    for (std::size_t i = 0; i < Nx; ++i)
-    {
-        // Calculate the x value
+    // Calculate the values of x and y at the nodes
+    for (std::size_t i = 0; i < Nx; ++i){
         if (logx){
             // Log spaced
-            x = exp(log(xmin) + (log(xmax) - log(xmin))/(Nx-1)*i);
+            xvec[i] = exp(log(xmin) + (log(xmax) - log(xmin))/(Nx-1)*i);
         }
         else{
             // Linearly spaced
-            x = xmin + (xmax - xmin)/(Nx-1)*i;
+            xvec[i] = xmin + (xmax - xmin)/(Nx-1)*i;
         }
-        xvec[i] = x;
-        for (std::size_t j = 0; j < Ny; ++j)
-        {
-            // Calculate the x value
-            if (logy){
-                // Log spaced
-                y = exp(log(ymin) + (log(ymax/ymin))/(Ny-1)*j);
-            }
-            else{
-                // Linearly spaced
-                y = ymin + (ymax - ymin)/(Ny-1)*j;
-            }
-            yvec[j] = y;
-            
-            if (debug){std::cout << "x: " << x << " y: " << y << std::endl;}
-            
-            // Generate the input pair
-            CoolPropDbl v1, v2;
-            input_pairs input_pair = generate_update_pair(xkey, x, ykey, y, v1, v2);
-            
-            // --------------------
-            //   Update the state
-            // --------------------
-            try{
-                AS->update(input_pair, v1, v2);
-                if (!ValidNumber(AS->rhomolar())){
-                    throw ValueError("rhomolar is invalid");
-                }
-            }
-            catch(std::exception &e){
-                // That failed for some reason, go to the next pair
-                if (debug){std::cout << " " << e.what() << std::endl;}
-                continue;
-            }
-            
-            // Skip two-phase states - they will remain as _HUGE holes in the table
-            if (is_in_closed_range(0.0, 1.0, AS->Q())){ 
-                if (debug){std::cout << " 2Phase" << std::endl;}
-                continue;
-            };
-            
-            // --------------------
-            //   State variables
-            // --------------------
-            T[i][j] = AS->T();
-            p[i][j] = AS->p();
-            rhomolar[i][j] = AS->rhomolar();
-            hmolar[i][j] = AS->hmolar();
-            smolar[i][j] = AS->smolar();
-			umolar[i][j] = AS->umolar();
-            
-            // -------------------------
-            //   Transport properties
-            // -------------------------
-            try{
-                visc[i][j] = AS->viscosity();
-                cond[i][j] = AS->conductivity();
-            }
-            catch(std::exception &){
-                // Failures will remain as holes in table
-            }
-            
-            // ----------------------------------------
-            //   First derivatives of state variables
-            // ----------------------------------------
-            dTdx[i][j] = AS->first_partial_deriv(iT, xkey, ykey);
-            dTdy[i][j] = AS->first_partial_deriv(iT, ykey, xkey);
-            dpdx[i][j] = AS->first_partial_deriv(iP, xkey, ykey);
-            dpdy[i][j] = AS->first_partial_deriv(iP, ykey, xkey);
-            drhomolardx[i][j] = AS->first_partial_deriv(iDmolar, xkey, ykey);
-            drhomolardy[i][j] = AS->first_partial_deriv(iDmolar, ykey, xkey);
-            dhmolardx[i][j] = AS->first_partial_deriv(iHmolar, xkey, ykey);
-            dhmolardy[i][j] = AS->first_partial_deriv(iHmolar, ykey, xkey);
-            dsmolardx[i][j] = AS->first_partial_deriv(iSmolar, xkey, ykey);
-            dsmolardy[i][j] = AS->first_partial_deriv(iSmolar, ykey, xkey);
-			dumolardx[i][j] = AS->first_partial_deriv(iUmolar, xkey, ykey);
-            dumolardy[i][j] = AS->first_partial_deriv(iUmolar, ykey, xkey);
-            
-            // ----------------------------------------
-            //   Second derivatives of state variables
-            // ----------------------------------------
-            d2Tdx2[i][j] = AS->second_partial_deriv(iT, xkey, ykey, xkey, ykey);
-            d2Tdxdy[i][j] = AS->second_partial_deriv(iT, xkey, ykey, ykey, xkey);
-            d2Tdy2[i][j] = AS->second_partial_deriv(iT, ykey, xkey, ykey, xkey);
-            d2pdx2[i][j] = AS->second_partial_deriv(iP, xkey, ykey, xkey, ykey);
-            d2pdxdy[i][j] = AS->second_partial_deriv(iP, xkey, ykey, ykey, xkey);
-            d2pdy2[i][j] = AS->second_partial_deriv(iP, ykey, xkey, ykey, xkey);
-            d2rhomolardx2[i][j] = AS->second_partial_deriv(iDmolar, xkey, ykey, xkey, ykey);
-            d2rhomolardxdy[i][j] = AS->second_partial_deriv(iDmolar, xkey, ykey, ykey, xkey);
-            d2rhomolardy2[i][j] = AS->second_partial_deriv(iDmolar, ykey, xkey, ykey, xkey);
-            d2hmolardx2[i][j] = AS->second_partial_deriv(iHmolar, xkey, ykey, xkey, ykey);
-            d2hmolardxdy[i][j] = AS->second_partial_deriv(iHmolar, xkey, ykey, ykey, xkey);
-            d2hmolardy2[i][j] = AS->second_partial_deriv(iHmolar, ykey, xkey, ykey, xkey);
-            d2smolardx2[i][j] = AS->second_partial_deriv(iSmolar, xkey, ykey, xkey, ykey);
-            d2smolardxdy[i][j] = AS->second_partial_deriv(iSmolar, xkey, ykey, ykey, xkey);
-            d2smolardy2[i][j] = AS->second_partial_deriv(iSmolar, ykey, xkey, ykey, xkey);
-			d2umolardx2[i][j] = AS->second_partial_deriv(iUmolar, xkey, ykey, xkey, ykey);
-            d2umolardxdy[i][j] = AS->second_partial_deriv(iUmolar, xkey, ykey, ykey, xkey);
-            d2umolardy2[i][j] = AS->second_partial_deriv(iUmolar, ykey, xkey, ykey, xkey);
+    }
+    for (std::size_t j = 0; j < Ny; ++j){
+        if (logy){
+            // Log spaced
+            yvec[j] = exp(log(ymin) + (log(ymax/ymin))/(Ny-1)*j);
+        }
+        else{
+            // Linearly spaced
+            yvec[j] = ymin + (ymax - ymin)/(Ny-1)*j;
+        }
+    }
+    make_axis_indices();
+    // ------------------------
+    // Actually build the table
+    // ------------------------
+    // Each row is built with its own copy of AS, so the rows can be built in any order, on any number of threads,
+    // and the table is always the same.  An error in a row is re-thrown once all the rows are done; if several
+    // rows fail, the error of the first of them is the one that is re-thrown, as in a serial build.
+    bool cloneable = table_build_can_clone(AS);
+    TableBuildProgress progress(format("single-phase %s,%s", get_parameter_information(xkey, "short").c_str(), get_parameter_information(ykey, "short").c_str()), Nx);
+    std::vector<std::string> errors(Nx);
+    #if defined(_OPENMP)
+    #pragma omp parallel for schedule(dynamic) num_threads(table_build_number_of_threads(cloneable))
+    #endif
+    for (long k = 0; k < static_cast<long>(Nx); ++k){
+        std::size_t i = static_cast<std::size_t>(k);
+        try{
+            shared_ptr<AbstractState> row_state = table_build_state(AS, cloneable);
+            build_row(*row_state, i);
+        }
+        catch(std::exception &e){
+            errors[i] = e.what();
+            if (errors[i].empty()){ errors[i] = "unknown error"; }
         }
+        progress.step();
+    }
+    for (std::size_t i = 0; i < Nx; ++i){
+        if (!errors[i].empty()){ throw ValueError(format("Unable to build row %d of the %s table: %s", i, progress.name().c_str(), errors[i].c_str())); }
     }
 }
 std::string CoolProp::TabularBackend::path_to_tables(void){
@@ -347,26 +542,18 @@ std::string CoolProp::TabularBackend::path_to_tables(void){
 }
 
 void CoolProp::TabularBackend::write_tables(){
-    std::string path_to_tables = this->path_to_tables();
-    make_dirs(path_to_tables);
-    bool loaded = false;
-    dataset = library.get_set_of_tables(this->AS, loaded);
-    PhaseEnvelopeData & phase_envelope = dataset->phase_envelope;
-    PureFluidSaturationTableData &pure_saturation = dataset->pure_saturation;
-    SinglePhaseGriddedTableData &single_phase_logph = dataset->single_phase_logph;
-    SinglePhaseGriddedTableData &single_phase_logpT = dataset->single_phase_logpT;
-    write_table(single_phase_logph, path_to_tables, "single_phase_logph");
-    write_table(single_phase_logpT, path_to_tables, "single_phase_logpT");
-    write_table(pure_saturation, path_to_tables, "pure_saturation");
-    write_table(phase_envelope, path_to_tables, "phase_envelope");
+    check_tables();
+    const std::string path = this->path_to_tables();
+    make_dirs(path);
+    TableFileLock lock(path + "/build.lock");
+    dataset->write_tables(path);
 }
-void CoolProp::TabularBackend::load_tables(){
-    bool loaded = false;
-    dataset = library.get_set_of_tables(this->AS, loaded); 
-    if (loaded == false){
-        throw UnableToLoadError("Could not load tables");
+void CoolProp::TabularBackend::check_tables(){
+    if (!tables_loaded){
+        dataset = library.get_set_of_tables(this->AS);
+        // Set the flag saying tables have been successfully loaded
+        tables_loaded = true;
     }
-    if (get_debug_level() > 0){ std::cout << "Tables loaded" << std::endl; }
 }
 
 CoolPropDbl CoolProp::TabularBackend::calc_saturated_vapor_keyed_output(parameters key){
@@ -1068,6 +1255,31 @@ void CoolProp::TabularDataSet::write_tables(const std::string &path_to_tables)
     write_table(single_phase_logpT, path_to_tables, "single_phase_logpT");
     write_table(pure_saturation, path_to_tables, "pure_saturation");
     write_table(phase_envelope, path_to_tables, "phase_envelope");
+    const std::string logph_path = path_to_tables + "/single_phase_logph.cptable";
+    const std::string logpT_path = path_to_tables + "/single_phase_logpT.cptable";
+    const std::string saturation_path = path_to_tables + "/pure_saturation.cptable";
+    if (get_config_bool(MEMORY_MAPPED_TABLES)){
+        const unsigned long long hash = table_fluid_hash(path_to_tables);
+        single_phase_logph.write_mapped(logph_path, hash);
+        single_phase_logpT.write_mapped(logpT_path, hash);
+        pure_saturation.write_mapped(saturation_path, hash);
+        write_coeffs(path_to_tables);
+    }
+    else{
+        // Remove any mapped tables from an earlier build so that they cannot get out of step with the compressed tables
+        std::remove(logph_path.c_str());
+        std::remove(logpT_path.c_str());
+        std::remove(saturation_path.c_str());
+        std::remove((path_to_tables + "/coeffs_ph.cptable").c_str());
+        std::remove((path_to_tables + "/coeffs_pT.cptable").c_str());
+    }
+}
+
+void CoolProp::TabularDataSet::write_coeffs(const std::string &path_to_tables)
+{
+    const unsigned long long hash = table_fluid_hash(path_to_tables);
+    if (!coeffs_ph.empty()){ coeffs_ph.write_mapped(path_to_tables + "/coeffs_ph.cptable", hash, single_phase_logph); }
+    if (!coeffs_pT.empty()){ coeffs_pT.write_mapped(path_to_tables + "/coeffs_pT.cptable", hash, single_phase_logpT); }
 }
 
 void CoolProp::TabularDataSet::load_tables(const std::string &path_to_tables, shared_ptr<CoolProp::AbstractState> &AS)
@@ -1077,10 +1289,49 @@ void CoolProp::TabularDataSet::load_tables(const std::string &path_to_tables, sh
     pure_saturation.AS = AS;
     single_phase_logph.set_limits();
     single_phase_logpT.set_limits();
-    load_table(single_phase_logph, path_to_tables, "single_phase_logph.bin.z");
-    load_table(single_phase_logpT, path_to_tables, "single_phase_logpT.bin.z");
-    load_table(pure_saturation, path_to_tables, "pure_saturation.bin.z");
-    load_table(phase_envelope, path_to_tables, "phase_envelope.bin.z");
+    bool mapped = false;
+    if (get_config_bool(MEMORY_MAPPED_TABLES)){
+        // Use the uncompressed tables in place if they are available and belong to this fluid
+        try{
+            const unsigned long long hash = table_fluid_hash(path_to_tables);
+            single_phase_logph.load_mapped(path_to_tables + "/single_phase_logph.cptable", hash);
+            single_phase_logpT.load_mapped(path_to_tables + "/single_phase_logpT.cptable", hash);
+            pure_saturation.load_mapped(path_to_tables + "/pure_saturation.cptable", hash);
+            mapped = true;
+        }
+        catch(UnableToLoadError &e){
+            if (get_debug_level() > 0){ std::cout << format("Unable to use mapped tables: %s", e.what()) << std::endl; }
+        }
+    }
+    if (!mapped){
+        load_table(single_phase_logph, path_to_tables, "single_phase_logph.bin.z");
+        load_table(single_phase_logpT, path_to_tables, "single_phase_logpT.bin.z");
+        load_table(pure_saturation, path_to_tables, "pure_saturation.bin.z");
+    }
+    // The phase envelope is only built for mixtures; for pure fluids the stored one is empty
+    if (!mapped || AS->get_mole_fractions().size() > 1){
+        load_table(phase_envelope, path_to_tables, "phase_envelope.bin.z");
+    }
+    if (mapped){
+        // Attach the bicubic coefficients that were stored with the tables; if they are missing
+        // (or stale), build them now and store them so that the next process can attach them
+        try{
+            const unsigned long long hash = table_fluid_hash(path_to_tables);
+            coeffs_ph.load_mapped(path_to_tables + "/coeffs_ph.cptable", hash, single_phase_logph);
+            coeffs_pT.load_mapped(path_to_tables + "/coeffs_pT.cptable", hash, single_phase_logpT);
+        }
+        catch(UnableToLoadError &e){
+            if (get_debug_level() > 0){ std::cout << format("Unable to use mapped coefficients: %s", e.what()) << std::endl; }
+            coeffs_ph = CellCoeffsTable(); coeffs_pT = CellCoeffsTable();
+            build_coeffs();
+            try{
+                write_coeffs(path_to_tables);
+            }
+            catch(std::exception &e){
+                if (get_debug_level() > 0){ std::cout << format("Unable to write mapped coefficients: %s", e.what()) << std::endl; }
+            }
+        }
+    }
     tables_loaded = true;
     if (get_debug_level() > 0){ std::cout << "Tables loaded" << std::endl; }
 };
@@ -1101,50 +1352,221 @@ void CoolProp::TabularDataSet::build_tables(shared_ptr<CoolProp::AbstractState>
     }
     single_phase_logph.build(AS);
     single_phase_logpT.build(AS);
+    // Build the bicubic coefficients now so that they are written along with the tables
+    coeffs_ph = CellCoeffsTable(); coeffs_pT = CellCoeffsTable();
+    build_coeffs();
     tables_loaded = true;
 }
 
-/// Return the set of tabular datasets
-CoolProp::TabularDataSet * CoolProp::TabularDataLibrary::get_set_of_tables(shared_ptr<AbstractState> &AS, bool &loaded)
+void CoolProp::SinglePhaseGriddedTableData::write_mapped(const std::string &path, unsigned long long fluid_hash) const
 {
-    const std::string path = path_to_tables(AS);
-    // Try to find tabular set if it is already loaded
-    std::map<std::string, TabularDataSet>::iterator it = data.find(path);
-    // It is already in the map, return it
-    if (it != data.end()){
-        loaded = it->second.tables_loaded;
-        return &(it->second);
-    }
-    // It is not in the map, build it
-    else{
-        TabularDataSet set;
-        data.insert(std::pair<std::string, TabularDataSet>(path, set));
-        TabularDataSet &dataset = data[path];
+    MappedTableWriter writer(revision, fluid_hash, Nx, Ny, xmin, xmax, ymin, ymax);
+    /* Use X macros to auto-generate the code; each will look something like: writer.add("T", T.data(), T.rows()*T.cols()); */
+    #define X(name) writer.add(#name, name.data(), name.rows()*name.cols());
+    LIST_OF_MATRICES
+    #undef X
+    writer.write(path);
+}
+
+void CoolProp::SinglePhaseGriddedTableData::load_mapped(const std::string &path, unsigned long long fluid_hash)
+{
+    shared_ptr<MappedTableFile> file(new MappedTableFile(path));
+    const MappedTableHeader &h = file->header();
+    if (h.fluid_hash != fluid_hash){
+        throw UnableToLoadError(format("Mapped table %s was built for a different fluid", path.c_str()));
+    }
+    else if (h.Nx != Nx || h.Ny != Ny){
+        throw UnableToLoadError(format("old [%dx%d] and new [%dx%d] dimensions don't agree", static_cast<std::size_t>(h.Nx), static_cast<std::size_t>(h.Ny), Nx, Ny));
+    }
+    else if (revision > h.revision){
+        throw UnableToLoadError(format("loaded revision [%d] is older than current revision [%d]", h.revision, revision));
+    }
+    else if ((std::abs(xmin) > 1e-10 && std::abs(xmax) > 1e-10) && (std::abs(h.xmin - xmin)/xmin > 1e-6 || std::abs(h.xmax - xmax)/xmax > 1e-6)){
+        throw UnableToLoadError(format("Current limits for x [%g,%g] do not agree with loaded limits [%g,%g]", xmin, xmax, h.xmin, h.xmax));
+    }
+    else if ((std::abs(ymin) > 1e-10 && std::abs(ymax) > 1e-10) && (std::abs(h.ymin - ymin)/ymin > 1e-6 || std::abs(h.ymax - ymax)/ymax > 1e-6)){
+        throw UnableToLoadError(format("Current limits for y [%g,%g] do not agree with loaded limits [%g,%g]", ymin, ymax, h.ymin, h.ymax));
+    }
+    revision = h.revision;
+    xmin = h.xmin; xmax = h.xmax; ymin = h.ymin; ymax = h.ymax;
+    /* Use X macros to auto-generate the code; each will look something like: T.attach(file->get("T", Nx*Ny), Nx, Ny); */
+    #define X(name) name.attach(file->get(#name, Nx*Ny), Nx, Ny);
+    LIST_OF_MATRICES
+    #undef X
+    mapped_file = file;
+    make_axis_vectors();
+    make_good_neighbors();
+}
+
+void CoolProp::PureFluidSaturationTableData::write_mapped(const std::string &path, unsigned long long fluid_hash) const
+{
+    MappedTableWriter writer(revision, fluid_hash, N, 1, 0, 0, 0, 0);
+    /* Use X macros to auto-generate the code; each will look something like: writer.add("TL", TL.data(), TL.size()); */
+    #define X(name) writer.add(#name, name.data(), name.size());
+    LIST_OF_SATURATION_VECTORS
+    #undef X
+    writer.write(path);
+}
+
+void CoolProp::PureFluidSaturationTableData::load_mapped(const std::string &path, unsigned long long fluid_hash)
+{
+    shared_ptr<MappedTableFile> file(new MappedTableFile(path));
+    const MappedTableHeader &h = file->header();
+    if (h.fluid_hash != fluid_hash){
+        throw UnableToLoadError(format("Mapped table %s was built for a different fluid", path.c_str()));
+    }
+    else if (h.Nx != N){
+        throw UnableToLoadError(format("old [%d] and new [%d] sizes don't agree", static_cast<std::size_t>(h.Nx), N));
+    }
+    else if (revision > h.revision){
+        throw UnableToLoadError(format("loaded revision [%d] is older than current revision [%d]", h.revision, revision));
+    }
+    revision = h.revision;
+    /* Use X macros to auto-generate the code; each will look something like: TL.attach(file->get("TL", N), N); */
+    #define X(name) name.attach(file->get(#name, N), N);
+    LIST_OF_SATURATION_VECTORS
+    #undef X
+    mapped_file = file;
+    make_pressure_indices();
+}
+
+void CoolProp::CellCoeffsTable::write_mapped(const std::string &path, unsigned long long fluid_hash, const SinglePhaseGriddedTableData &table) const
+{
+    // The revision and limits of the table are stored so that the coefficients can be matched to it when they are loaded
+    MappedTableWriter writer(table.revision, fluid_hash, Nx, Ny, table.xmin, table.xmax, table.ymin, table.ymax);
+    /* Use X macros to auto-generate the code; each will look something like: writer.add("T", T.data(), T.size()); */
+    #define X(name) writer.add(#name, name.data(), name.size());
+    LIST_OF_CELL_COEFFS
+    #undef X
+    writer.add("alternate", alternate.data(), alternate.size());
+    writer.write(path);
+}
+
+void CoolProp::CellCoeffsTable::load_mapped(const std::string &path, unsigned long long fluid_hash, const SinglePhaseGriddedTableData &table)
+{
+    shared_ptr<MappedTableFile> file(new MappedTableFile(path));
+    const MappedTableHeader &h = file->header();
+    if (h.fluid_hash != fluid_hash){
+        throw UnableToLoadError(format("Mapped coefficients %s were built for a different fluid", path.c_str()));
+    }
+    else if (h.Nx + 1 != table.Nx || h.Ny + 1 != table.Ny){
+        throw UnableToLoadError(format("Mapped coefficients %s are for %dx%d cells; table has %dx%d nodes", path.c_str(), static_cast<std::size_t>(h.Nx), static_cast<std::size_t>(h.Ny), table.Nx, table.Ny));
+    }
+    else if (h.revision != table.revision || h.xmin != table.xmin || h.xmax != table.xmax || h.ymin != table.ymin || h.ymax != table.ymax){
+        throw UnableToLoadError(format("Mapped coefficients %s do not belong to the loaded table", path.c_str()));
+    }
+    std::size_t Ncells = table.Nx - 1, Mcells = table.Ny - 1, count = 0;
+    const double *data = NULL;
+    /* Use X macros to auto-generate the code; each will look something like: data = file->find("T", count); ... T.attach(data, count); */
+    #define X(name) data = file->find(#name, count); \
+                    if (count != 0 && count != 16*Ncells*Mcells){ throw UnableToLoadError(format("Coefficient array %s has %d values", #name, count)); } \
+                    name.attach(data, count);
+    LIST_OF_CELL_COEFFS
+    #undef X
+    alternate.attach(file->get("alternate", Ncells*Mcells), Ncells*Mcells);
+    Nx = Ncells; Ny = Mcells;
+    mapped_file = file;
+}
+
+namespace CoolProp{
+
+/// Check the size of the directory the tables are about to be written to against MAXIMUM_TABLE_DIRECTORY_SIZE_IN_GB
+void check_table_directory_size(const std::string &table_path){
+    #if defined(__ISWINDOWS__)
+        double directory_size_in_GB = CalculateDirSize(std::wstring(table_path.begin(), table_path.end()))/POW3(1024.0);
+    #else
+        double directory_size_in_GB = CalculateDirSize(table_path)/POW3(1024.0);
+    #endif
+    double allowed_size_in_GB = get_config_double(MAXIMUM_TABLE_DIRECTORY_SIZE_IN_GB);
+    if (get_debug_level() > 0){std::cout << "Tabular directory size is " << directory_size_in_GB << " GB\n";}
+    if (directory_size_in_GB > 1.5*allowed_size_in_GB){
+        throw DirectorySizeError(format("Maximum allowed tabular directory size is %g GB, you have exceeded 1.5 times this limit", allowed_size_in_GB));
+    }
+    else if (directory_size_in_GB > allowed_size_in_GB){
+        set_warning_string(format("Maximum allowed tabular directory size is %g GB, you have exceeded this limit", allowed_size_in_GB));
+    }
+}
+
+} // namespace CoolProp
+
+void CoolProp::TabularDataLibrary::load_or_build(TabularDataSet &dataset, const std::string &path, shared_ptr<AbstractState> &AS)
+{
+    // Start from an empty set, in case an earlier attempt failed part of the way through
+    dataset = TabularDataSet();
+    try{
+        /// Try to load the tables if you can.
+        dataset.load_tables(path, AS);
+    }
+    catch(UnableToLoadError &e){
+        if (get_debug_level() > 0){ std::cout << format("Table loading failed with error: %s\n", e.what()); }
+        // Only one process at a time builds the tables; any other process waits here until they have been written,
+        // so it tries to load them again before it builds them itself
+        make_dirs(path);
+        TableFileLock lock(path + "/build.lock");
         try{
-            if (!dataset.tables_loaded){
-                dataset.load_tables(path, AS);
-            }
-            loaded = true;
+            dataset.load_tables(path, AS);
+        }
+        catch(UnableToLoadError &){
+            check_table_directory_size(path);
+            /// If you cannot load the tables, build them and then write them to file
+            dataset.build_tables(AS);
+            dataset.pack_matrices();
+            dataset.write_tables(path);
+            /// Load the tables back into memory as a consistency check
+            dataset.load_tables(path, AS);
+        }
+    }
+    // The coefficients are only built here if they were neither loaded nor built with the tables
+    dataset.build_coeffs();
+}
+
+CoolProp::TabularDataSet * CoolProp::TabularDataLibrary::get_set_of_tables(shared_ptr<AbstractState> &AS)
+{
+    const std::string path = path_to_tables(AS);
+    TabularDataSet *dataset = NULL;
+    {
+        ScopedLock lock(mutex);
+        // Wait for any other thread that is loading or building this set
+        while (in_progress.find(path) != in_progress.end()){
+            finished.wait(mutex);
         }
-        catch (std::exception &){
-            loaded = false;
+        // The map never moves its elements, so the pointer stays valid as other sets are added
+        dataset = &(data[path]);
+        if (dataset->tables_loaded){
+            return dataset;
         }
-        return &(dataset);
+        // This thread loads or builds the set; other threads that want it wait above until it is done
+        in_progress.insert(path);
     }
+    try{
+        load_or_build(*dataset, path, AS);
+    }
+    catch(...){
+        // Leave the set to be tried again by the next thread that asks for it
+        ScopedLock lock(mutex);
+        dataset->tables_loaded = false;
+        in_progress.erase(path);
+        finished.notify_all();
+        throw;
+    }
+    ScopedLock lock(mutex);
+    in_progress.erase(path);
+    finished.notify_all();
+    return dataset;
 }
 
-void CoolProp::TabularDataSet::build_coeffs(SinglePhaseGriddedTableData &table, std::vector<std::vector<CellCoeffs> > &coeffs)
+void CoolProp::TabularDataSet::build_coeffs(SinglePhaseGriddedTableData &table, CellCoeffsTable &coeffs)
 {
     if (!coeffs.empty()){ return; }
     const bool debug = get_debug_level() > 5 || false;
     const int param_count = 6;
     parameters param_list[param_count] = { iDmolar, iT, iSmolar, iHmolar, iP, iUmolar };
-    std::vector<std::vector<double> > *f = NULL, *fx = NULL, *fy = NULL, *fxy = NULL;
+    TableMatrix *f = NULL, *fx = NULL, *fy = NULL, *fxy = NULL;
 
     clock_t t1 = clock();
 
     // Resize the coefficient structures
-    coeffs.resize(table.Nx - 1, std::vector<CellCoeffs>(table.Ny - 1));
+    coeffs.resize(table.Nx - 1, table.Ny - 1);
 
     int valid_cell_count = 0;
     for (std::size_t k = 0; k < param_count; ++k){
@@ -1173,6 +1595,7 @@ void CoolProp::TabularDataSet::build_coeffs(SinglePhaseGriddedTableData &table,
         default:
             throw ValueError("Invalid variable type to build_coeffs");
         }
+        coeffs.get_vector(param).resize(16*(table.Nx - 1)*(table.Ny - 1), _HUGE);
         for (std::size_t i = 0; i < table.Nx-1; ++i) // -1 since we have one fewer cells than nodes
         {
             for (std::size_t j = 0; j < table.Ny-1; ++j) // -1 since we have one fewer cells than nodes
@@ -1185,28 +1608,24 @@ void CoolProp::TabularDataSet::build_coeffs(SinglePhaseGriddedTableData &table,
                     F(0) = (*f)[i][j]; F(1) = (*f)[i+1][j]; F(2) = (*f)[i][j+1]; F(3) = (*f)[i+1][j+1];
                     // Scaling parameter
                     // d(f)/dxhat = df/dx * dx/dxhat, where xhat = (x-x_i)/(x_{i+1}-x_i)
-                    coeffs[i][j].dx_dxhat = table.xvec[i+1]-table.xvec[i];
-                    double dx_dxhat = coeffs[i][j].dx_dxhat;
+                    double dx_dxhat = table.xvec[i+1]-table.xvec[i];
                     F(4) = (*fx)[i][j]*dx_dxhat; F(5) = (*fx)[i+1][j]*dx_dxhat;
                     F(6) = (*fx)[i][j+1]*dx_dxhat; F(7) = (*fx)[i+1][j+1]*dx_dxhat;
                     // Scaling parameter
                     // d(f)/dyhat = df/dy * dy/dyhat, where yhat = (y-y_j)/(y_{j+1}-y_j)
-                    coeffs[i][j].dy_dyhat = table.yvec[j+1]-table.yvec[j];
-                    double dy_dyhat = coeffs[i][j].dy_dyhat;
+                    double dy_dyhat = table.yvec[j+1]-table.yvec[j];
                     F(8) = (*fy)[i][j]*dy_dyhat; F(9) = (*fy)[i+1][j]*dy_dyhat;
                     F(10) = (*fy)[i][j+1]*dy_dyhat; F(11) = (*fy)[i+1][j+1]*dy_dyhat;
                     // Cross derivatives are doubly scaled following the examples above
                     F(12) = (*fxy)[i][j]*dy_dyhat*dx_dxhat; F(13) = (*fxy)[i+1][j]*dy_dyhat*dx_dxhat;
                     F(14) = (*fxy)[i][j+1]*dy_dyhat*dx_dxhat; F(15) = (*fxy)[i+1][j+1]*dy_dyhat*dx_dxhat;
-                    // Calculate the alpha coefficients
-                    Eigen::MatrixXd alpha = Ainv.transpose()*F; // 16x1; Watch out for the transpose!
-                    std::vector<double> valpha = eigen_to_vec1D(alpha);
-                    coeffs[i][j].set(param, valpha);
-                    coeffs[i][j].set_valid();
+                    // Calculate the alpha coefficients in place
+                    calculate_bicubic_coefficients(F.data(), coeffs.get(param, i, j));
+                    coeffs.set_valid(i, j);
                     valid_cell_count++;
                 }
                 else{
-                    coeffs[i][j].set_invalid();
+                    coeffs.set_invalid(i, j);
                 }
             }
         }
@@ -1221,7 +1640,7 @@ void CoolProp::TabularDataSet::build_coeffs(SinglePhaseGriddedTableData &table,
             for (std::size_t j = 0; j < table.Ny-1; ++j) // -1 since we have one fewer cells than nodes
             {
                 // Not a valid cell
-                if (!coeffs[i][j].valid()){
+                if (!coeffs.valid(i, j)){
                     // Offsets that we are going to try in order (left, right, top, bottom, diagonals)
                     int xoffsets[] = { -1, 1, 0, 0, -1, 1, 1, -1 };
                     int yoffsets[] = { 0, 0, 1, -1, -1, -1, 1, 1 };
@@ -1230,8 +1649,8 @@ void CoolProp::TabularDataSet::build_coeffs(SinglePhaseGriddedTableData &table,
                     for (std::size_t k = 0; k < N; ++k){
                         std::size_t iplus = i + xoffsets[k];
                         std::size_t jplus = j + yoffsets[k];
-                        if (0 < iplus && iplus < table.Nx-1 && 0 < jplus && jplus < table.Ny-1 && coeffs[iplus][jplus].valid()){
-                            coeffs[i][j].set_alternate(iplus, jplus);
+                        if (0 < iplus && iplus < table.Nx-1 && 0 < jplus && jplus < table.Ny-1 && coeffs.valid(iplus, jplus)){
+                            coeffs.set_alternate(i, j, iplus, jplus);
                             remap_count++;
                             if (debug){ std::cout << format("Mapping %d,%d to %d,%d\n", i, j, iplus, jplus); }
                             break;
@@ -1248,6 +1667,7 @@ void CoolProp::TabularDataSet::build_coeffs(SinglePhaseGriddedTableData &table,
 
 #if defined(ENABLE_CATCH)
 #include "catch.hpp"
+#include <fstream>
 
 // Defined global so we only load once
 static shared_ptr<CoolProp::AbstractState> ASHEOS, ASTTSE, ASBICUBIC;
@@ -1263,6 +1683,205 @@ public:
         if (ASBICUBIC.get() == NULL){ ASBICUBIC.reset(CoolProp::AbstractState::factory("BICUBIC&HEOS", "Water")); }
     }
 };
+TEST_CASE("Memory-mapped tables", "[Tabular],[mapped_tables]")
+{
+    const std::string path = "mapped_table_test.cptable";
+    CoolProp::LogPTTable table;
+    table.Nx = 5; table.Ny = 4; table.xmin = 300; table.xmax = 400; table.ymin = 1e5; table.ymax = 1e6;
+    table.resize(table.Nx, table.Ny);
+    for (std::size_t i = 0; i < table.Nx; ++i){
+        for (std::size_t j = 0; j < table.Ny; ++j){
+            table.T[i][j] = table.xvec[i]; table.p[i][j] = table.yvec[j]; table.hmolar[i][j] = 10.0*i + j;
+        }
+    }
+    table.write_mapped(path, 12345);
+    CoolProp::LogPTTable loaded;
+    loaded.Nx = 5; loaded.Ny = 4; loaded.xmin = 300; loaded.xmax = 400; loaded.ymin = 1e5; loaded.ymax = 1e6;
+    SECTION("values are used in place"){
+        loaded.load_mapped(path, 12345);
+        CHECK(loaded.hmolar.is_view());
+        CHECK(loaded.hmolar[3][2] == 32.0);
+        CHECK(loaded.T[4][0] == table.T[4][0]);
+        CHECK(loaded.p[0][3] == table.p[0][3]);
+        // Copies of the table keep the mapping alive
+        CoolProp::LogPTTable copy = loaded;
+        loaded = CoolProp::LogPTTable();
+        CHECK(copy.hmolar[1][1] == 11.0);
+    }
+    SECTION("table for another fluid is rejected"){
+        CHECK_THROWS(loaded.load_mapped(path, 54321));
+    }
+    SECTION("table with other dimensions is rejected"){
+        loaded.Ny = 5;
+        CHECK_THROWS(loaded.load_mapped(path, 12345));
+    }
+    SECTION("bicubic coefficients are stored with the table"){
+        const std::string coeffs_path = "mapped_coeffs_test.cptable";
+        /* Give all the nodes finite values and derivatives */
+        #define X(name) std::fill(table.name.data(), table.name.data() + table.Nx*table.Ny, 1.0);
+        LIST_OF_MATRICES
+        #undef X
+        table.hmolar[2][1] = 3.0;
+        CoolProp::TabularDataSet dataset;
+        dataset.build_coeffs(table, dataset.coeffs_pT);
+        dataset.coeffs_pT.write_mapped(coeffs_path, 12345, table);
+        loaded.load_mapped(path, 12345);
+        CoolProp::CellCoeffsTable coeffs;
+        coeffs.load_mapped(coeffs_path, 12345, loaded);
+        CHECK(coeffs.hmolar.is_view());
+        CHECK(coeffs.T.empty()); // T is an input of the table, so it has no coefficients
+        CHECK(coeffs.valid(1, 1));
+        for (std::size_t k = 0; k < 16; ++k){
+            CHECK(coeffs.get(CoolProp::iHmolar, 1, 1)[k] == dataset.coeffs_pT.get(CoolProp::iHmolar, 1, 1)[k]);
+        }
+        CoolProp::CellCoeffsTable other_fluid;
+        CHECK_THROWS(other_fluid.load_mapped(coeffs_path, 54321, loaded));
+        std::remove(coeffs_path.c_str());
+    }
+    SECTION("damaged array directory is rejected"){
+        const std::string damaged_path = "mapped_table_damaged_test.cptable";
+        std::ifstream ifs(path.c_str(), std::ifstream::binary);
+        std::vector<char> original((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        ifs.close();
+        REQUIRE(original.size() > sizeof(CoolProp::MappedTableHeader) + sizeof(CoolProp::MappedTableArrayInfo));
+        for (int damage = 0; damage < 4; ++damage){
+            CAPTURE(damage);
+            std::vector<char> bytes = original;
+            CoolProp::MappedTableHeader *h = reinterpret_cast<CoolProp::MappedTableHeader *>(&(bytes[0]));
+            CoolProp::MappedTableArrayInfo *info = reinterpret_cast<CoolProp::MappedTableArrayInfo *>(&(bytes[0]) + sizeof(CoolProp::MappedTableHeader));
+            switch (damage){
+                case 0: std::memset(info->name, 'x', sizeof(info->name)); break; // A name that runs into the offset
+                case 1: info->count = 1ULL << 60; break; // Values past the end of the file
+                case 2: info->offset = bytes.size() + 8; break;
+                case 3: h->Narrays = 0xFFFFFFFFu; break; // A directory past the end of the file
+            }
+            std::ofstream ofs(damaged_path.c_str(), std::ofstream::binary);
+            ofs.write(&(bytes[0]), bytes.size());
+            ofs.close();
+            CHECK_THROWS_AS(CoolProp::MappedTableFile((damaged_path)), CoolProp::UnableToLoadError);
+        }
+        std::remove(damaged_path.c_str());
+    }
+    std::remove(path.c_str());
+}
+
+static void count_table_build_rows(const std::string &, std::size_t done, std::size_t, double, void *user_data){
+    std::size_t *rows = static_cast<std::size_t *>(user_data);
+    if (done > 0){ ++(*rows); }
+}
+TEST_CASE("Parallel build of a single-phase table", "[Tabular],[table_build]")
+{
+    shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory("HEOS", "Water"));
+    double Nthreads = CoolProp::get_config_double(TABLE_BUILD_NUMBER_OF_THREADS);
+    CoolProp::LogPTTable serial, parallel;
+    serial.AS = AS; serial.set_limits(); serial.Nx = 12; serial.Ny = 10;
+    parallel.AS = AS; parallel.set_limits(); parallel.Nx = 12; parallel.Ny = 10;
+    std::size_t rows = 0;
+    CoolProp::set_table_build_callback(count_table_build_rows, &rows);
+    CoolProp::set_config_double(TABLE_BUILD_NUMBER_OF_THREADS, 1);
+    serial.build(AS);
+    CoolProp::set_config_double(TABLE_BUILD_NUMBER_OF_THREADS, 4);
+    parallel.build(AS);
+    CoolProp::set_config_double(TABLE_BUILD_NUMBER_OF_THREADS, Nthreads);
+    CoolProp::set_table_build_callback(NULL);
+    CHECK(rows == 24);
+    /* The tables are identical, value for value; each will look something like: CHECK(std::equal(...)); */
+    #define X(name) CHECK(std::equal(serial.name.data(), serial.name.data() + 12*10, parallel.name.data()));
+    LIST_OF_MATRICES
+    #undef X
+    CHECK(ValidNumber(parallel.hmolar[6][5]));
+}
+
+TEST_CASE("Building a saturation table leaves DONT_CHECK_PROPERTY_LIMITS as it was", "[Tabular],[table_build]")
+{
+    shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory("HEOS", "Water"));
+    bool dont_check = CoolProp::get_config_bool(DONT_CHECK_PROPERTY_LIMITS);
+    for (int value = 0; value < 2; ++value){
+        CAPTURE(value);
+        CoolProp::set_config_bool(DONT_CHECK_PROPERTY_LIMITS, value == 1);
+        CoolProp::PureFluidSaturationTableData table;
+        table.N = 20;
+        table.build(AS);
+        CHECK(CoolProp::get_config_bool(DONT_CHECK_PROPERTY_LIMITS) == (value == 1));
+    }
+    CoolProp::set_config_bool(DONT_CHECK_PROPERTY_LIMITS, dont_check);
+}
+static void count_table_builds(const std::string &table, std::size_t done, std::size_t, double, void *user_data){
+    std::size_t *builds = static_cast<std::size_t *>(user_data);
+    if (done == 0 && table == "saturation"){ ++(*builds); }
+}
+TEST_CASE("Writers of the same file use different temporary files", "[Tabular],[atomic_file]")
+{
+    CoolProp::AtomicFileWriter first("table.bin"), second("table.bin");
+    CHECK(first.temporary() != second.temporary());
+    CHECK(first.temporary().find("table.bin.") == 0);
+}
+TEST_CASE("Direct lookup of the interval on a regular axis", "[Tabular],[axis_index]")
+{
+    std::vector<std::vector<double> > axes;
+    std::vector<bool> logscale;
+    axes.push_back(linspace(-50.0, 3000.0, 200)); logscale.push_back(false);
+    axes.push_back(logspace(611.0, 2.2e7, 200)); logscale.push_back(true);
+    // Log spaced, apart from the last point, like the saturation table
+    std::vector<double> sat = logspace(611.0, 0.9999*2.2e7, 101);
+    sat.back() = 2.2064e7;
+    axes.push_back(sat); logscale.push_back(true);
+    for (std::size_t k = 0; k < axes.size(); ++k){
+        const std::vector<double> &v = axes[k];
+        CoolProp::RegularAxisIndex index;
+        index.set(&(v[0]), v.size(), logscale[k]);
+        CHECK(index.is_regular());
+        std::size_t i_direct = 9999, i_bisect = 9999;
+        // The nodes themselves and points in between them
+        for (std::size_t n = 0; n < 4*v.size() - 3; ++n){
+            double val = (n % 4 == 0) ? v[n/4] : v[n/4] + (v[n/4+1] - v[n/4])*(n % 4)/4.0;
+            index.find(v, val, i_direct);
+            CAPTURE(val);
+            CHECK(v[i_direct] <= val);
+            CHECK((val < v[i_direct+1] || i_direct == v.size()-2));
+            // Bisection is only unambiguous between the nodes
+            if (n % 4 != 0){
+                bisect_vector(v, val, i_bisect);
+                CHECK(i_direct == i_bisect);
+            }
+        }
+    }
+    SECTION("irregular axis falls back to bisection"){
+        std::vector<double> v = linspace(0.0, 1.0, 11);
+        v[5] = 0.58;
+        CoolProp::RegularAxisIndex index;
+        index.set(&(v[0]), v.size(), false);
+        CHECK(!index.is_regular());
+        std::size_t i = 9999;
+        index.find(v, 0.55, i);
+        CHECK(i == 4);
+    }
+}
+TEST_CASE("Tables requested by several threads at once are built once", "[Tabular],[table_library]")
+{
+    std::string alt_path = CoolProp::get_config_string(ALTERNATIVE_TABLES_DIRECTORY);
+    CoolProp::set_config_string(ALTERNATIVE_TABLES_DIRECTORY, get_home_dir() + "/.CoolProp/Tables/concurrent_test/");
+    // The fluid library is loaded on first use, which must not happen on several threads at once
+    shared_ptr<CoolProp::AbstractState> HEOS(CoolProp::AbstractState::factory("HEOS", "R134a"));
+    std::size_t builds = 0;
+    CoolProp::set_table_build_callback(count_table_builds, &builds);
+    std::vector<double> h(4, _HUGE);
+    #if defined(_OPENMP)
+    #pragma omp parallel for num_threads(4)
+    #endif
+    for (int i = 0; i < 4; ++i){
+        shared_ptr<CoolProp::AbstractState> AS(CoolProp::AbstractState::factory("BICUBIC&HEOS", "R134a"));
+        AS->update(CoolProp::PT_INPUTS, 1e5, 300);
+        h[i] = AS->hmolar();
+    }
+    CoolProp::set_table_build_callback(NULL);
+    CoolProp::set_config_string(ALTERNATIVE_TABLES_DIRECTORY, alt_path);
+    // None of the threads builds the tables if they are already on disk from an earlier run
+    CHECK(builds <= 1);
+    CHECK(ValidNumber(h[0]));
+    CHECK(h[3] == h[0]);
+}
+
 TEST_CASE_METHOD(TabularFixture, "Tests for tabular backends with water", "[Tabular]")
 {
     SECTION("first_saturation_deriv invalid quality"){
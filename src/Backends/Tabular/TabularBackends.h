@@ -10,6 +10,9 @@
 #include <sstream>
 #include "Configuration.h"
 #include "../Helmholtz/PhaseEnvelopeRoutines.h"
+#include "TabularStorage.h"
+#include "CPthreads.h"
+#include <set>
 
 
 
@@ -25,6 +28,12 @@
  */
 #define LIST_OF_SATURATION_VECTORS X(TL) X(pL) X(logpL) X(hmolarL) X(smolarL) X(umolarL) X(rhomolarL) X(logrhomolarL) X(viscL) X(condL) X(logviscL) X(TV) X(pV) X(logpV) X(hmolarV) X(smolarV) X(umolarV) X(rhomolarV) X(logrhomolarV) X(viscV) X(condV) X(logviscV) X(cpmolarV) X(cpmolarL) X(cvmolarV) X(cvmolarL) X(speed_soundL) X(speed_soundV)
 
+/** ***MAGIC WARNING***!! X Macros in use
+ * See http://stackoverflow.com/a/148610
+ * See http://stackoverflow.com/questions/147267/easy-way-to-use-variables-of-enum-types-as-string-in-c#202511
+ */
+#define LIST_OF_CELL_COEFFS X(T) X(p) X(rhomolar) X(hmolar) X(smolar) X(umolar)
+
 namespace CoolProp{
 
 /// Get a conversion factor from mass to molar if needed
@@ -46,6 +55,75 @@ inline void mass_to_molar(parameters &param, double &conversion_factor, double m
     }
 }
 
+/** \brief A function that is called to report the progress of the tables as they are built
+ *
+ * It is called once when the build of a table starts (with done = 0) and then each time a row of the table has
+ * been built.  The rows may be finished by several threads, but the calls are never made concurrently.
+ *
+ * @param table The name of the table that is being built
+ * @param done The number of rows of the table that have been built
+ * @param total The number of rows in the table
+ * @param elapsed The wall-clock time since the build of this table started, in seconds
+ * @param user_data The pointer that was passed to set_table_build_callback()
+ */
+typedef void (*TableBuildCallback)(const std::string &table, std::size_t done, std::size_t total, double elapsed, void *user_data);
+
+/// Set the function that is called to report the progress of the tables as they are built; pass NULL to stop reporting
+void set_table_build_callback(TableBuildCallback callback, void *user_data = NULL);
+
+/// Read and uncompress a table file written by write_compressed_table(); throws UnableToLoadError if that is not possible
+std::vector<char> load_compressed_table(const std::string &path_to_table);
+
+/// Compress a packed table and write it to path_to_tables/name.bin.z (and, if SAVE_RAW_TABLES is set, to name.bin)
+void write_compressed_table(const msgpack::sbuffer &sbuf, const std::string &path_to_tables, const std::string &name);
+
+/** \brief Calculate the 16 coefficients of a bicubic cell
+ *
+ * F holds the values at the corners (i,j), (i+1,j), (i,j+1), (i+1,j+1), then the x-derivatives, the y-derivatives
+ * and the cross derivatives at the same corners, all scaled to the normalized coordinates of the cell.  alpha[k*4+l]
+ * then multiplies \f$\hat x^l \hat y^k\f$.
+ */
+void calculate_bicubic_coefficients(const double *F, double *alpha);
+
+/// Check the size of the directory the tables are about to be written to against MAXIMUM_TABLE_DIRECTORY_SIZE_IN_GB
+void check_table_directory_size(const std::string &table_path);
+
+/** \brief Finds the interval of a linearly or logarithmically spaced axis that contains a value without bisection
+ *
+ * find() gives the index i for which vec[i] <= val < vec[i+1], as bisect_vector does, but it computes the index
+ * directly from the spacing of the axis and then corrects it for round-off by looking at the neighboring nodes.
+ * The last node is allowed to be off the regular spacing (the critical point at the end of the saturation
+ * curve, for instance).  If the axis is not regularly spaced, or the vector has changed size since set() was
+ * called, find() falls back to bisect_vector.
+ */
+class RegularAxisIndex{
+    private:
+        std::size_t N; ///< The number of nodes in the axis
+        bool logscale; ///< True if the nodes are spaced evenly in log(x) rather than in x
+        bool regular; ///< True if the nodes are spaced evenly so that find() can compute the index
+        double x0; ///< The value of the first node (or its logarithm)
+        double inverse_step; ///< The inverse of the spacing between the nodes (or their logarithms)
+    public:
+        RegularAxisIndex() : N(0), logscale(false), regular(false), x0(0), inverse_step(0) {};
+        /// Check the spacing of the N nodes in vec so that find() can be used with them
+        void set(const double *vec, std::size_t N, bool logscale);
+        bool is_regular() const { return regular; };
+        /// Find the index i of the interval [vec[i], vec[i+1]) that contains val; vec must be the nodes passed to set()
+        template <typename Vector> void find(const Vector &vec, double val, std::size_t &i) const {
+            if (!regular || vec.size() != N || !ValidNumber(val)){
+                bisect_vector(vec, val, i); return;
+            }
+            double r = ((logscale) ? log(val) : val) - x0;
+            r *= inverse_step;
+            if (!(r > 0)){ i = 0; }
+            else if (r >= static_cast<double>(N-2)){ i = N-2; }
+            else { i = static_cast<std::size_t>(r); }
+            // At most one step is needed in either direction for the nodes to bound the value
+            while (i > 0 && val < vec[i]){ --i; }
+            while (i < N-2 && val >= vec[i+1]){ ++i; }
+        };
+};
+
 /** \brief This class holds the data for a two-phase table that is log spaced in p
  * 
  * It contains very few members or methods, mostly it just holds the data
@@ -57,16 +135,22 @@ class PureFluidSaturationTableData{
     
 		PureFluidSaturationTableData(){N = 1000; revision = 1;}
         
-        /// Build this table
+        /// Build this table; the points are spread over TABLE_BUILD_NUMBER_OF_THREADS threads if the backend supports clone()
         void build(shared_ptr<CoolProp::AbstractState> &AS);
+        /// Build the saturated liquid and vapor states at the pressure p into the i-th element of the vectors; returns false if the state could not be calculated
+        bool build_point(AbstractState &AS, std::size_t i, double p);
     
-		/* Use X macros to auto-generate the variables; each will look something like: std::vector<double> T; */
-		#define X(name) std::vector<double> name;
+		/* Use X macros to auto-generate the variables; each will look something like: TableVector T; */
+		#define X(name) TableVector name;
 		LIST_OF_SATURATION_VECTORS
 		#undef X
 
 		int revision;
 		std::map<std::string, std::vector<double> > vectors;
+		/// The memory-mapped file that the vectors are views onto, if loaded by load_mapped()
+		shared_ptr<MappedTableFile> mapped_file;
+		/// Used to find the pressure interval in is_inside(); the pressures are log spaced, apart from the critical point at the end
+		RegularAxisIndex pL_index, pV_index;
     
 		MSGPACK_DEFINE(revision, vectors); // write the member variables that you want to pack
 
@@ -84,7 +168,7 @@ class PureFluidSaturationTableData{
          \note If PQ or QT are inputs, yL and yV will correspond to the other main variable: p->T or T->p
          */
         bool is_inside(parameters main, double mainval, parameters other, double val, std::size_t &iL, std::size_t &iV, CoolPropDbl &yL, CoolPropDbl &yV){
-            std::vector<double> *yvecL = NULL, *yvecV = NULL;
+            TableVector *yvecL = NULL, *yvecV = NULL;
             switch(other){
                 case iT: yvecL = &TL; yvecV = &TV; break;
                 case iHmolar: yvecL = &hmolarL; yvecV = &hmolarV; break;
@@ -116,8 +200,8 @@ class PureFluidSaturationTableData{
             // In general iV and iL will be the same, but if pseudo-pure, they might
             // be different
             if (main ==iP){
-                bisect_vector(pV, mainval, iV);
-                bisect_vector(pL, mainval, iL);
+                pV_index.find(pV, mainval, iV);
+                pL_index.find(pL, mainval, iL);
             }
             else if (main == iT){
                 bisect_vector(TV, mainval, iV);
@@ -174,15 +258,15 @@ class PureFluidSaturationTableData{
         }
 		/// Resize all the vectors
 		void resize(std::size_t N){
-			/* Use X macros to auto-generate the code; each will look something like: T.resize(N); std::fill(T.begin(), T.end(), _HUGE); */
-			#define X(name) name.resize(N); std::fill(name.begin(), name.end(), _HUGE);
+			/* Use X macros to auto-generate the code; each will look something like: T.resize(N, _HUGE); */
+			#define X(name) name.resize(N, _HUGE);
 			LIST_OF_SATURATION_VECTORS
 			#undef X
 		};
         /// Take all the vectors that are in the class and pack them into the vectors map for easy unpacking using msgpack
 		void pack(){
 			/* Use X macros to auto-generate the packing code; each will look something like: matrices.insert(std::pair<std::vector<std::vector<double> > >("T", T)); */
-			#define X(name) vectors.insert(std::pair<std::string, std::vector<double> >(#name, name));
+			#define X(name) vectors.insert(std::pair<std::string, std::vector<double> >(#name, name.to_vector()));
 			LIST_OF_SATURATION_VECTORS
 			#undef X
 		};
@@ -195,12 +279,22 @@ class PureFluidSaturationTableData{
         }
 		/// Take all the vectors that are in the class and unpack them from the vectors map
 		void unpack(){
-			/* Use X macros to auto-generate the unpacking code; each will look something like: T = get_vector_iterator("T")->second */
-			#define X(name) name = get_vector_iterator(#name)->second;
+			/* Use X macros to auto-generate the unpacking code; each will look something like: T.assign(get_vector_iterator("T")->second) */
+			#define X(name) name.assign(get_vector_iterator(#name)->second);
 			LIST_OF_SATURATION_VECTORS
 			#undef X
 			N = TL.size();
+			make_pressure_indices();
+		};
+		/// Set up pL_index and pV_index once the pressures are known
+		void make_pressure_indices(void){
+			pL_index.set(pL.data(), pL.size(), true);
+			pV_index.set(pV.data(), pV.size(), true);
 		};
+		/// Write the vectors to a file that can be memory-mapped by load_mapped()
+		void write_mapped(const std::string &path, unsigned long long fluid_hash) const;
+		/// Use the vectors in a file written by write_mapped() in place; throws UnableToLoadError if the file does not belong to this table
+		void load_mapped(const std::string &path, unsigned long long fluid_hash);
         void deserialize(msgpack::object &deserialized){       
             PureFluidSaturationTableData temp;
             deserialized.convert(&temp);
@@ -317,7 +411,7 @@ class PureFluidSaturationTableData{
         double first_saturation_deriv(parameters Of1, parameters Wrt1, int Q, double val, std::size_t i)
         {
             if (i < 2 || i > TL.size() - 2){throw ValueError(format("Invalid index (%d) to calc_first_saturation_deriv in TabularBackends",i));}
-            std::vector<double> *x, *y;
+            TableVector *x, *y;
             // Connect pointers for each vector
             switch(Wrt1){
                 case iT: x = (Q == 0) ? &TL : &TV; break;
@@ -356,6 +450,8 @@ class SinglePhaseGriddedTableData{
 		CoolProp::parameters xkey, ykey;
 		shared_ptr<CoolProp::AbstractState> AS;
 		std::vector<double> xvec, yvec;
+		/// Used to find the cell that contains a value of x or y without bisecting xvec or yvec
+		RegularAxisIndex xindex, yindex;
         std::vector<std::vector<std::size_t> > nearest_neighbor_i, nearest_neighbor_j;
 		bool logx, logy;
 		double xmin, ymin, xmax, ymax;
@@ -369,20 +465,24 @@ class SinglePhaseGriddedTableData{
             xmin = _HUGE; xmax = _HUGE; ymin = _HUGE; ymax = _HUGE;
         }
     
-		/* Use X macros to auto-generate the variables; each will look something like: std::vector< std::vector<double> > T; */
-		#define X(name) std::vector< std::vector<double> > name;
+		/* Use X macros to auto-generate the variables; each will look something like: TableMatrix T; */
+		#define X(name) TableMatrix name;
 		LIST_OF_MATRICES
 		#undef X
 		int revision;
 		std::map<std::string, std::vector<std::vector<double> > > matrices;
-        /// Build this table
+		/// The memory-mapped file that the matrices are views onto, if loaded by load_mapped()
+		shared_ptr<MappedTableFile> mapped_file;
+        /// Build this table; the rows are spread over TABLE_BUILD_NUMBER_OF_THREADS threads if the backend supports clone()
         void build(shared_ptr<CoolProp::AbstractState> &AS);
+        /// Build the nodes of the i-th row of the table; xvec and yvec must already have been filled
+        void build_row(AbstractState &AS, std::size_t i);
     
 		MSGPACK_DEFINE(revision, matrices, xmin, xmax, ymin, ymax); // write the member variables that you want to pack
 		/// Resize all the matrices
 		void resize(std::size_t Nx, std::size_t Ny){
-			/* Use X macros to auto-generate the code; each will look something like: T.resize(Nx, std::vector<double>(Ny, _HUGE)); */
-			#define X(name) name.resize(Nx, std::vector<double>(Ny, _HUGE));
+			/* Use X macros to auto-generate the code; each will look something like: T.resize(Nx, Ny, _HUGE); */
+			#define X(name) name.resize(Nx, Ny, _HUGE);
 			LIST_OF_MATRICES
 			#undef X
 			make_axis_vectors();
@@ -401,6 +501,12 @@ class SinglePhaseGriddedTableData{
 			else{
 				yvec = linspace(ymin, ymax, Ny);
 			}
+			make_axis_indices();
+		};
+		/// Set up xindex and yindex for the values in xvec and yvec
+		void make_axis_indices(void){
+			xindex.set((xvec.empty()) ? NULL : &(xvec[0]), xvec.size(), logx);
+			yindex.set((yvec.empty()) ? NULL : &(yvec[0]), yvec.size(), logy);
 		};
         /// Make matrices of good neighbors if the current value for i,j corresponds to a bad node
 		void make_good_neighbors(void){
@@ -431,7 +537,7 @@ class SinglePhaseGriddedTableData{
 		/// Take all the matrices that are in the class and pack them into the matrices map for easy unpacking using msgpack
 		void pack(){
 			/* Use X macros to auto-generate the packing code; each will look something like: matrices.insert(std::pair<std::vector<std::vector<double> > >("T", T)); */
-			#define X(name) matrices.insert(std::pair<std::string, std::vector<std::vector<double> > >(#name, name));
+			#define X(name) matrices.insert(std::pair<std::string, std::vector<std::vector<double> > >(#name, name.to_nested()));
 			LIST_OF_MATRICES
 			#undef X
 		};
@@ -444,14 +550,18 @@ class SinglePhaseGriddedTableData{
         }
 		/// Take all the matrices that are in the class and pack them into the matrices map for easy unpacking using msgpack
 		void unpack(){
-			/* Use X macros to auto-generate the unpacking code; each will look something like: T = *(matrices.find("T")).second */
-			#define X(name) name = get_matrices_iterator(#name)->second;
+			/* Use X macros to auto-generate the unpacking code; each will look something like: T.assign(get_matrices_iterator("T")->second) */
+			#define X(name) name.assign(get_matrices_iterator(#name)->second);
 			LIST_OF_MATRICES
 			#undef X
-			Nx = T.size(); Ny = T[0].size();
+			Nx = T.rows(); Ny = T.cols();
 			make_axis_vectors();
             make_good_neighbors();
 		};
+		/// Write the matrices to a file that can be memory-mapped by load_mapped()
+		void write_mapped(const std::string &path, unsigned long long fluid_hash) const;
+		/// Use the matrices in a file written by write_mapped() in place; throws UnableToLoadError if the file does not belong to this table
+		void load_mapped(const std::string &path, unsigned long long fluid_hash);
 		/// Check that the native inputs (the inputs the table is based on) are in range
 		bool native_inputs_are_in_range(double x, double y){
             double e = 10*DBL_EPSILON;
@@ -459,9 +569,9 @@ class SinglePhaseGriddedTableData{
 		}
 		/// @brief Find the nearest neighbor for native inputs (the inputs the table is based on)
 		/// Does not check whether this corresponds to a valid node or not
-		/// Use bisection since it is faster than calling a logarithm (surprising, but true)
+		/// The cell is computed directly from the spacing of the axes, which is faster than bisection
 		void find_native_nearest_neighbor(double x, double y, std::size_t &i, std::size_t &j){
-			bisect_vector(xvec, x, i);
+			xindex.find(xvec, x, i);
 			if (i != Nx-1){
 				if(!logx){
 					if (x > (xvec[i]+xvec[i+1])/2.0){i++;}
@@ -470,7 +580,7 @@ class SinglePhaseGriddedTableData{
 					if (x > sqrt(xvec[i]*xvec[i+1])){i++;}
 				}
 			}
-			bisect_vector(yvec, y, j);
+			yindex.find(yvec, y, j);
 			if (j != Ny-1){
 				if(!logy){
 					if (y > (yvec[j]+yvec[j+1])/2.0){j++;}
@@ -483,7 +593,7 @@ class SinglePhaseGriddedTableData{
         /// @brief Find the nearest neighbor for one (given) variable native, one variable non-native
 		void find_nearest_neighbor(parameters givenkey, double givenval, parameters otherkey, double otherval, std::size_t &i, std::size_t &j){
 			if (givenkey == ykey){
-                bisect_vector(yvec, givenval, j);
+                yindex.find(yvec, givenval, j);
                 // This one is problematic because we need to make a slice against the grain in the "matrix"
                 // which requires a slightly different algorithm
                 try{
@@ -491,7 +601,7 @@ class SinglePhaseGriddedTableData{
                 }
                 catch(...){
                     // Now we go for a less intelligent solution, we simply try to find the one that is the closest
-                    const std::vector<std::vector<double> > & mat = get(otherkey);
+                    const TableMatrix & mat = get(otherkey);
                     double closest_diff = 1e20;
                     std::size_t closest_i = 0;
                     for (std::size_t index = 0; index < mat.size(); ++index){
@@ -504,10 +614,10 @@ class SinglePhaseGriddedTableData{
                 }
             }
             else if (givenkey == xkey){
-                bisect_vector(xvec, givenval, i);
+                xindex.find(xvec, givenval, i);
                 // This one is fine because we now end up with a vector<double> in the other variable
-                const std::vector<std::vector<double> > & v = get(otherkey);
-                bisect_vector(v[i], otherval, j);
+                const TableMatrix & v = get(otherkey);
+                bisect_vector(v.row(i), otherval, j);
             }
 		}
 		/// Find the nearest good neighbor node for inputs that are the same as the grid inputs
@@ -527,10 +637,10 @@ class SinglePhaseGriddedTableData{
 		/// Find the nearest cell with lower left coordinate (i,j) where (i,j) is a good node, and so are (i+1,j), (i,j+1), (i+1,j+1)
 		/// This is needed for bicubic interpolation
 		void find_native_nearest_good_cell(double x, double y, std::size_t &i, std::size_t &j){
-			bisect_vector(xvec, x, i);
-			bisect_vector(yvec, y, j);
+			xindex.find(xvec, x, i);
+			yindex.find(yvec, y, j);
 		}
-        const std::vector<std::vector<double> > & get(parameters key){
+        const TableMatrix & get(parameters key){
             switch(key){
                 case iDmolar: return rhomolar;
                 case iT: return T;
@@ -633,23 +743,38 @@ class LogPTTable : public SinglePhaseGriddedTableData
         };
 };
 
-/// This structure holds the coefficients for one cell, the coefficients are stored in matrices
-/// and can be obtained by the get() function.  
-class CellCoeffs{
-private:
-    std::size_t alt_i, alt_j;
-    bool _valid, _has_valid_neighbor;
+/** \brief This class holds the bicubic coefficients for all the cells of a single-phase table
+ *
+ * For each parameter, the 16 coefficients of a cell are contiguous and the cells are stored in row-major
+ * order, so one interpolation reads 128 contiguous bytes (two cache lines).  The coefficients for the
+ * input variables of the table are not calculated and those vectors are left empty.
+ */
+class CellCoeffsTable{
 public:
-    double dx_dxhat, dy_dyhat;
-    CellCoeffs(){
-        _valid = false; _has_valid_neighbor = false;
-        dx_dxhat = _HUGE; dy_dyhat = _HUGE;
-        alt_i = 9999999; alt_j = 9999999;
-    }
-    std::vector<double> T, rhomolar, hmolar, p, smolar, umolar;
-    /// Return a const reference to the desired matrix
-    const std::vector<double> & get(const parameters params) const
-    {
+    std::size_t Nx, Ny; ///< The number of cells in each direction (one fewer than the number of nodes)
+    /* Use X macros to auto-generate the variables; each will look something like: TableVector T; */
+    #define X(name) TableVector name;
+    LIST_OF_CELL_COEFFS
+    #undef X
+    /// For each cell, the index i*Ny+j of the cell to be used: the cell itself if it is valid, a valid neighbor, or -1 if there is none
+    TableVector alternate;
+    /// The memory-mapped file that the coefficients are views onto, if loaded by load_mapped()
+    shared_ptr<MappedTableFile> mapped_file;
+
+    CellCoeffsTable() : Nx(0), Ny(0) {};
+    /// Returns true if the coefficients have not been calculated
+    bool empty() const { return alternate.empty(); };
+    /// Resize to Nx x Ny cells, all of which are invalid and have no coefficients
+    void resize(std::size_t Nx, std::size_t Ny){
+        this->Nx = Nx; this->Ny = Ny;
+        /* Use X macros to auto-generate the code; each will look something like: T.resize(0, _HUGE); */
+        #define X(name) name.resize(0, _HUGE);
+        LIST_OF_CELL_COEFFS
+        #undef X
+        alternate.resize(Nx*Ny, -1);
+    };
+    /// Return a reference to the coefficient vector for the desired parameter
+    TableVector & get_vector(const parameters params){
         switch (params){
         case iT: return T;
         case iP: return p;
@@ -657,42 +782,33 @@ public:
         case iHmolar: return hmolar;
         case iSmolar: return smolar;
         case iUmolar: return umolar;
-        default: throw KeyError(format("Invalid key to get() function of CellCoeffs"));
-        }
-    };
-    /// Set one of the matrices in this class
-    void set(parameters params, const std::vector<double> &mat){
-        switch (params){
-        case iT: T = mat; break;
-        case iP: p = mat; break;
-        case iDmolar: rhomolar = mat; break;
-        case iHmolar: hmolar = mat; break;
-        case iSmolar: smolar = mat; break;
-        case iUmolar: umolar = mat; break;
-        default: throw KeyError(format("Invalid key to set() function of CellCoeffs"));
+        default: throw KeyError(format("Invalid key to get() function of CellCoeffsTable"));
         }
     };
+    const TableVector & get_vector(const parameters params) const { return const_cast<CellCoeffsTable *>(this)->get_vector(params); };
+    /// Return a pointer to the 16 coefficients of cell (i,j) for the desired parameter
+    const double * get(const parameters params, std::size_t i, std::size_t j) const { return get_vector(params).data() + 16*(i*Ny + j); };
+    double * get(const parameters params, std::size_t i, std::size_t j){ return get_vector(params).data() + 16*(i*Ny + j); };
     /// Returns true if the cell coefficients seem to have been calculated properly
-    bool valid() const { return _valid; };
+    bool valid(std::size_t i, std::size_t j) const { return alternate[i*Ny + j] == static_cast<double>(i*Ny + j); };
     /// Call this function to set the valid flag to true
-    void set_valid(){ _valid = true; };
+    void set_valid(std::size_t i, std::size_t j){ alternate[i*Ny + j] = static_cast<double>(i*Ny + j); };
     /// Call this function to set the valid flag to false
-    void set_invalid(){ _valid = false; };
+    void set_invalid(std::size_t i, std::size_t j){ alternate[i*Ny + j] = -1; };
     /// Set the neighboring (alternate) cell to be used if the cell is invalid
-    void set_alternate(std::size_t i, std::size_t j){ alt_i = i; alt_j = j; _has_valid_neighbor = true; }
-    /// Get neighboring(alternate) cell to be used if this cell is invalid
-    void get_alternate(std::size_t &i, std::size_t &j) const {
-        if (_has_valid_neighbor){
-            i = alt_i; j = alt_j;
-        }
-        else{
-            throw ValueError("No valid neighbor");
-        }
-    }
+    void set_alternate(std::size_t i, std::size_t j, std::size_t ialt, std::size_t jalt){ alternate[i*Ny + j] = static_cast<double>(ialt*Ny + jalt); };
     /// Returns true if cell is invalid and it has valid neighbor
-    bool has_valid_neighbor() const{
-        return _has_valid_neighbor;
-    }
+    bool has_valid_neighbor(std::size_t i, std::size_t j) const { return !valid(i, j) && alternate[i*Ny + j] >= 0; };
+    /// Replace (i,j) with the neighboring (alternate) cell to be used because this cell is invalid
+    void get_alternate(std::size_t &i, std::size_t &j) const {
+        double k = alternate[i*Ny + j];
+        if (k < 0){ throw ValueError("No valid neighbor"); }
+        i = static_cast<std::size_t>(k)/Ny; j = static_cast<std::size_t>(k) % Ny;
+    };
+    /// Write the coefficients for the given table to a file that can be memory-mapped by load_mapped()
+    void write_mapped(const std::string &path, unsigned long long fluid_hash, const SinglePhaseGriddedTableData &table) const;
+    /// Use the coefficients in a file written by write_mapped() in place; throws UnableToLoadError if the file does not belong to the given table
+    void load_mapped(const std::string &path, unsigned long long fluid_hash, const SinglePhaseGriddedTableData &table);
 };
 
 /// This class contains the data for one set of Tabular data including single-phase and two-phase data
@@ -704,23 +820,59 @@ public:
     LogPTTable single_phase_logpT;
     PureFluidSaturationTableData pure_saturation;
     PhaseEnvelopeData phase_envelope;
-    std::vector<std::vector<CellCoeffs> > coeffs_ph, coeffs_pT;
+    CellCoeffsTable coeffs_ph, coeffs_pT;
 
     TabularDataSet(){ tables_loaded = false; }
     /// Write the tables to files on the computer
     void write_tables(const std::string &path_to_tables);
+    /// Write the bicubic coefficients to files on the computer (memory-mapped format only)
+    void write_coeffs(const std::string &path_to_tables);
     /// Load the tables from file
     void load_tables(const std::string &path_to_tables, shared_ptr<CoolProp::AbstractState> &AS);
     /// Build the tables (single-phase PH, single-phase PT, phase envelope, etc.)
     void build_tables(shared_ptr<CoolProp::AbstractState> &AS);
+    /// Pack the tables into the maps of matrices and vectors that are written by msgpack
+    void pack_matrices(){
+        single_phase_logph.pack();
+        single_phase_logpT.pack();
+        pure_saturation.pack();
+        phase_envelope.pack();
+    };
     /// Build the \f$a_{i,j}\f$ coefficients for bicubic interpolation
-    void build_coeffs(SinglePhaseGriddedTableData &table, std::vector<std::vector<CellCoeffs> > &coeffs);
+    void build_coeffs(SinglePhaseGriddedTableData &table, CellCoeffsTable &coeffs);
+    /// Build the coefficients for both single-phase tables, unless they have already been built or loaded with the tables
+    void build_coeffs(){
+        build_coeffs(single_phase_logph, coeffs_ph);
+        build_coeffs(single_phase_logpT, coeffs_pT);
+    };
 };
 
+/// The directory in which the sets of tables are stored, ALTERNATIVE_TABLES_DIRECTORY if it is set
+inline std::string get_table_directory(){
+    std::string table_directory = get_home_dir() + "/.CoolProp/Tables/";
+    std::string alt_table_directory = get_config_string(ALTERNATIVE_TABLES_DIRECTORY);
+    if (!alt_table_directory.empty()){
+        table_directory = alt_table_directory;
+    }
+    return table_directory;
+}
+
+/** \brief The sets of tables that are in memory, one for each backend, fluid and composition
+ *
+ * The library can be used from several threads at once.  The first thread that asks for a set that is not in
+ * memory loads it (or builds and writes it, if it cannot be loaded) while the other threads that ask for the same
+ * set wait until it is ready.  A lock file in the table directory keeps several processes from building and
+ * writing the same set of tables at the same time.
+ */
 class TabularDataLibrary
 {
 private:
     std::map<std::string, TabularDataSet> data;
+    std::set<std::string> in_progress; ///< The paths of the sets that are being loaded or built
+    Mutex mutex; ///< Guards data and in_progress
+    ConditionVariable finished; ///< Notified each time a set has been loaded or built (or has failed to be)
+    /// Load the set of tables from file, or build and write it if that is not possible
+    void load_or_build(TabularDataSet &dataset, const std::string &path, shared_ptr<AbstractState> &AS);
 public:
     TabularDataLibrary(){};
     std::string path_to_tables(shared_ptr<CoolProp::AbstractState> &AS){
@@ -730,15 +882,10 @@ public:
         for (std::size_t i = 0; i < fluids.size(); ++i){
             components.push_back(format("%s[%0.10Lf]", fluids[i].c_str(), fractions[i]));
         }
-        std::string table_directory = get_home_dir() + "/.CoolProp/Tables/";
-        std::string alt_table_directory = get_config_string(ALTERNATIVE_TABLES_DIRECTORY);
-        if (!alt_table_directory.empty()){
-            table_directory = alt_table_directory;
-        }
-        return table_directory + AS->backend_name() + "(" + strjoin(components, "&") + ")";
+        return get_table_directory() + AS->backend_name() + "(" + strjoin(components, "&") + ")";
     }
-    /// Return a pointer to the set of tabular datasets
-    TabularDataSet * get_set_of_tables(shared_ptr<AbstractState> &AS, bool &loaded);
+    /// Return a pointer to the set of tables for AS, which are loaded or built if they are not yet in memory
+    TabularDataSet * get_set_of_tables(shared_ptr<AbstractState> &AS);
 };
 
 /**
@@ -756,12 +903,12 @@ class TabularBackend : public AbstractState
         selected_table_options selected_table;
         std::size_t cached_single_phase_i, cached_single_phase_j;
         std::size_t cached_saturation_iL, cached_saturation_iV;
-        std::vector<std::vector<double> > const *z;
-        std::vector<std::vector<double> > const *dzdx;
-        std::vector<std::vector<double> > const *dzdy;
-        std::vector<std::vector<double> > const *d2zdx2;
-        std::vector<std::vector<double> > const *d2zdxdy;
-        std::vector<std::vector<double> > const *d2zdy2;
+        TableMatrix const *z;
+        TableMatrix const *dzdx;
+        TableMatrix const *dzdy;
+        TableMatrix const *d2zdx2;
+        TableMatrix const *d2zdxdy;
+        TableMatrix const *d2zdy2;
         std::vector<CoolPropDbl> mole_fractions;
     public:
         shared_ptr<CoolProp::AbstractState> AS;
@@ -856,10 +1003,10 @@ class TabularBackend : public AbstractState
         virtual double evaluate_single_phase_pT_derivative(parameters output, std::size_t i, std::size_t j, std::size_t Nx, std::size_t Ny) = 0;
 
         /// Ask the derived class to find the nearest good set of i,j that it wants to use (pure virtual)
-        virtual void find_native_nearest_good_indices(SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, double x, double y, std::size_t &i, std::size_t &j) = 0;
+        virtual void find_native_nearest_good_indices(SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, double x, double y, std::size_t &i, std::size_t &j) = 0;
         /// Ask the derived class to find the nearest neighbor (pure virtual)
         virtual void find_nearest_neighbor(SinglePhaseGriddedTableData &table, 
-                                           const std::vector<std::vector<CellCoeffs> > &coeffs, 
+                                           const CellCoeffsTable &coeffs, 
                                            const parameters variable1, 
                                            const double value1, 
                                            const parameters other, 
@@ -867,9 +1014,9 @@ class TabularBackend : public AbstractState
                                            std::size_t &i, 
                                            std::size_t &j) = 0;
         /// 
-        virtual void invert_single_phase_x(const SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, parameters output, double x, double y, std::size_t i, std::size_t j) = 0;
+        virtual void invert_single_phase_x(const SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, parameters output, double x, double y, std::size_t i, std::size_t j) = 0;
         /// 
-        virtual void invert_single_phase_y(const SinglePhaseGriddedTableData &table, const std::vector<std::vector<CellCoeffs> > &coeffs, parameters output, double x, double y, std::size_t i, std::size_t j) = 0;
+        virtual void invert_single_phase_y(const SinglePhaseGriddedTableData &table, const CellCoeffsTable &coeffs, parameters output, double x, double y, std::size_t i, std::size_t j) = 0;
 
 
         phases calc_phase(void){ return _phase; }
@@ -897,18 +1044,6 @@ class TabularBackend : public AbstractState
 
         /// Returns the path to the tables that shall be written
         std::string path_to_tables(void);
-        /// Load the tables from file; throws UnableToLoadException if there is a problem
-        void load_tables();
-        void pack_matrices(){
-            PhaseEnvelopeData & phase_envelope = dataset->phase_envelope;
-            PureFluidSaturationTableData &pure_saturation = dataset->pure_saturation;
-            SinglePhaseGriddedTableData &single_phase_logph = dataset->single_phase_logph;
-            SinglePhaseGriddedTableData &single_phase_logpT = dataset->single_phase_logpT;
-            single_phase_logph.pack();
-            single_phase_logpT.pack();
-            pure_saturation.pack();
-            phase_envelope.pack();
-        }
         /// Write the tables to file
         void write_tables();        
         
@@ -946,42 +1081,8 @@ class TabularBackend : public AbstractState
         CoolPropDbl calc_first_saturation_deriv(parameters Of1, parameters Wrt1);
         CoolPropDbl calc_first_two_phase_deriv(parameters Of, parameters Wrt, parameters Constant);
 
-        void check_tables(){
-            if (!tables_loaded){
-                try{
-                    /// Try to load the tables if you can.
-                    load_tables();
-                    // Set the flag saying tables have been successfully loaded
-                    tables_loaded = true;
-                }
-                catch(CoolProp::UnableToLoadError &e){
-                    if (get_debug_level() > 0){ std::cout << format("Table loading failed with error: %s\n", e.what()); }
-                    /// Check directory size
-                    std::string table_path = path_to_tables();
-                    #if defined(__ISWINDOWS__)
-                        double directory_size_in_GB = CalculateDirSize(std::wstring(table_path.begin(), table_path.end()))/POW3(1024.0);
-                    #else
-                        double directory_size_in_GB = CalculateDirSize(table_path)/POW3(1024.0);
-                    #endif
-                    double allowed_size_in_GB = get_config_double(MAXIMUM_TABLE_DIRECTORY_SIZE_IN_GB);
-                    if (get_debug_level() > 0){std::cout << "Tabular directory size is " << directory_size_in_GB << " GB\n";}
-                    if (directory_size_in_GB > 1.5*allowed_size_in_GB){
-                        throw DirectorySizeError(format("Maximum allowed tabular directory size is %g GB, you have exceeded 1.5 times this limit", allowed_size_in_GB));
-                    }
-                    else if (directory_size_in_GB > allowed_size_in_GB){
-                        set_warning_string(format("Maximum allowed tabular directory size is %g GB, you have exceeded this limit", allowed_size_in_GB));
-                    }
-                    /// If you cannot load the tables, build them and then write them to file
-                    dataset->build_tables(this->AS);
-                    pack_matrices();
-                    write_tables();
-                    /// Load the tables back into memory as a consistency check
-                    load_tables();
-                    // Set the flag saying tables have been successfully loaded
-                    tables_loaded = true;
-                }
-            }
-        };
+        /// Get the tables from the library, which loads them, or builds and writes them, if they are not yet in memory
+        void check_tables();
 };
 
 
@@ -0,0 +1,284 @@
+#if !defined(NO_TABULAR_BACKENDS)
+
+#include "TabularStorage.h"
+#include "CPthreads.h"
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+
+#if defined(__ISWINDOWS__)
+#include <windows.h>
+#ifdef min
+#undef min
+#endif
+#ifdef max
+#undef max
+#endif
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <cstdio>
+
+namespace CoolProp{
+
+static const char table_magic[8] = "CPTABLE";
+/// Each array in a mapped table file starts on a boundary of this many bytes
+static const std::size_t table_alignment = 64;
+
+static std::size_t align_offset(std::size_t offset){
+    return ((offset + table_alignment - 1)/table_alignment)*table_alignment;
+}
+
+/// True if the array directory of a file of the given length has room for Narrays entries after the header
+static bool table_directory_fits(unsigned int Narrays, std::size_t length){
+    return length >= sizeof(MappedTableHeader) && Narrays <= (length - sizeof(MappedTableHeader))/sizeof(MappedTableArrayInfo);
+}
+/// True if the values of the array lie within a file of the given length and are aligned for doubles
+static bool table_array_in_bounds(const MappedTableArrayInfo &info, std::size_t length){
+    return info.offset % sizeof(double) == 0 && info.offset <= length && info.count <= (length - info.offset)/sizeof(double);
+}
+/// The length of the name of the array, which need not be terminated within its field in a damaged file
+static std::size_t table_array_name_length(const MappedTableArrayInfo &info){
+    const char *end = static_cast<const char *>(std::memchr(info.name, '\0', sizeof(info.name)));
+    return (end != NULL) ? static_cast<std::size_t>(end - info.name) : sizeof(info.name);
+}
+
+unsigned long long table_hash(const std::string &s){
+    unsigned long long hash = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < s.size(); ++i){
+        hash ^= static_cast<unsigned char>(s[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+MappedTableFile::MappedTableFile(const std::string &path) : path(path), base(NULL), length(0)
+{
+    #if defined(__ISWINDOWS__)
+        file_handle = NULL; mapping_handle = NULL;
+        HANDLE hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (hFile == INVALID_HANDLE_VALUE){ throw UnableToLoadError(format("Unable to open mapped table %s", path.c_str())); }
+        file_handle = hFile;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0){ unmap(); throw UnableToLoadError(format("Mapped table %s is empty", path.c_str())); }
+        length = static_cast<std::size_t>(size.QuadPart);
+        mapping_handle = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping_handle == NULL){ unmap(); throw UnableToLoadError(format("Unable to map table %s", path.c_str())); }
+        base = static_cast<const char *>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+        if (base == NULL){ unmap(); throw UnableToLoadError(format("Unable to map table %s", path.c_str())); }
+    #else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0){ throw UnableToLoadError(format("Unable to open mapped table %s", path.c_str())); }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0){ close(fd); throw UnableToLoadError(format("Mapped table %s is empty", path.c_str())); }
+        length = static_cast<std::size_t>(st.st_size);
+        void *p = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+        // The mapping remains valid after the file descriptor has been closed
+        close(fd);
+        if (p == MAP_FAILED){ throw UnableToLoadError(format("Unable to map table %s", path.c_str())); }
+        base = static_cast<const char *>(p);
+    #endif
+
+    // Validate the header and the array directory so that get() can hand out pointers without further checks
+    if (length < sizeof(MappedTableHeader)){ unmap(); throw UnableToLoadError(format("Mapped table %s is truncated", path.c_str())); }
+    const MappedTableHeader &h = header();
+    if (std::memcmp(h.magic, table_magic, sizeof(table_magic)) != 0){ unmap(); throw UnableToLoadError(format("%s is not a mapped table", path.c_str())); }
+    if (h.byte_order != byte_order_mark){ unmap(); throw UnableToLoadError(format("Mapped table %s was written with a different byte order", path.c_str())); }
+    if (h.format_version != format_version){
+        unsigned int version = h.format_version;
+        unmap();
+        throw UnableToLoadError(format("Mapped table %s has format version %d; expected %d", path.c_str(), version, static_cast<unsigned int>(format_version)));
+    }
+    if (!table_directory_fits(h.Narrays, length)){ unmap(); throw UnableToLoadError(format("Mapped table %s is truncated", path.c_str())); }
+    const MappedTableArrayInfo *info = reinterpret_cast<const MappedTableArrayInfo *>(base + sizeof(MappedTableHeader));
+    for (std::size_t k = 0; k < h.Narrays; ++k){
+        if (!table_array_in_bounds(info[k], length)){
+            unmap(); throw UnableToLoadError(format("Array %d of mapped table %s is out of bounds", k, path.c_str()));
+        }
+        if (table_array_name_length(info[k]) == sizeof(info[k].name)){
+            unmap(); throw UnableToLoadError(format("Array %d of mapped table %s has a name that is not terminated", k, path.c_str()));
+        }
+    }
+}
+
+void MappedTableFile::unmap()
+{
+    #if defined(__ISWINDOWS__)
+        if (base != NULL){ UnmapViewOfFile(base); }
+        if (mapping_handle != NULL){ CloseHandle(mapping_handle); }
+        if (file_handle != NULL){ CloseHandle(file_handle); }
+        file_handle = NULL; mapping_handle = NULL;
+    #else
+        if (base != NULL){ munmap(const_cast<char *>(base), length); }
+    #endif
+    base = NULL; length = 0;
+}
+
+const double * MappedTableFile::find(const std::string &name, std::size_t &count) const
+{
+    const MappedTableHeader &h = header();
+    if (!table_directory_fits(h.Narrays, length)){ throw UnableToLoadError(format("Mapped table %s is truncated", path.c_str())); }
+    const MappedTableArrayInfo *info = reinterpret_cast<const MappedTableArrayInfo *>(base + sizeof(MappedTableHeader));
+    for (std::size_t k = 0; k < h.Narrays; ++k){
+        std::size_t name_length = table_array_name_length(info[k]);
+        if (name.size() != name_length || name.compare(0, name_length, info[k].name, name_length) != 0){ continue; }
+        if (!table_array_in_bounds(info[k], length)){
+            throw UnableToLoadError(format("Array %s of mapped table %s is out of bounds", name.c_str(), path.c_str()));
+        }
+        count = static_cast<std::size_t>(info[k].count);
+        return reinterpret_cast<const double *>(base + info[k].offset);
+    }
+    throw UnableToLoadError(format("could not find array %s in mapped table %s", name.c_str(), path.c_str()));
+}
+
+const double * MappedTableFile::get(const std::string &name, std::size_t count) const
+{
+    std::size_t actual_count = 0;
+    const double *data = find(name, actual_count);
+    if (actual_count != count){
+        throw UnableToLoadError(format("Array %s of mapped table %s has %d values; expected %d", name.c_str(), path.c_str(), actual_count, count));
+    }
+    return data;
+}
+
+MappedTableWriter::MappedTableWriter(int revision, unsigned long long fluid_hash, std::size_t Nx, std::size_t Ny, double xmin, double xmax, double ymin, double ymax)
+{
+    std::memset(&head, 0, sizeof(head));
+    std::memcpy(head.magic, table_magic, sizeof(table_magic));
+    head.format_version = MappedTableFile::format_version;
+    head.byte_order = MappedTableFile::byte_order_mark;
+    head.revision = revision;
+    head.Nx = Nx; head.Ny = Ny;
+    head.fluid_hash = fluid_hash;
+    head.xmin = xmin; head.xmax = xmax; head.ymin = ymin; head.ymax = ymax;
+}
+
+void MappedTableWriter::add(const std::string &name, const double *data, std::size_t count)
+{
+    if (name.size() >= sizeof(MappedTableArrayInfo().name)){ throw ValueError(format("Array name %s is too long for a mapped table", name.c_str())); }
+    names.push_back(name);
+    arrays.push_back(data);
+    counts.push_back(count);
+}
+
+void MappedTableWriter::write(const std::string &path) const
+{
+    MappedTableHeader h = head;
+    h.Narrays = static_cast<unsigned int>(names.size());
+    std::vector<MappedTableArrayInfo> info(names.size());
+    std::size_t offset = align_offset(sizeof(MappedTableHeader) + names.size()*sizeof(MappedTableArrayInfo));
+    for (std::size_t k = 0; k < names.size(); ++k){
+        std::memset(&info[k], 0, sizeof(MappedTableArrayInfo));
+        std::strncpy(info[k].name, names[k].c_str(), sizeof(info[k].name) - 1);
+        info[k].offset = offset;
+        info[k].count = counts[k];
+        offset = align_offset(offset + counts[k]*sizeof(double));
+    }
+    AtomicFileWriter file(path);
+    std::ofstream ofs(file.temporary().c_str(), std::ofstream::binary);
+    if (!ofs){ throw ValueError(format("Unable to open %s for writing", path.c_str())); }
+    ofs.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    if (!info.empty()){
+        ofs.write(reinterpret_cast<const char *>(&(info[0])), info.size()*sizeof(MappedTableArrayInfo));
+    }
+    std::size_t position = sizeof(MappedTableHeader) + info.size()*sizeof(MappedTableArrayInfo);
+    const std::vector<char> padding(table_alignment, 0);
+    for (std::size_t k = 0; k < names.size(); ++k){
+        ofs.write(&(padding[0]), info[k].offset - position);
+        ofs.write(reinterpret_cast<const char *>(arrays[k]), counts[k]*sizeof(double));
+        position = info[k].offset + counts[k]*sizeof(double);
+    }
+    if (!ofs){ throw ValueError(format("Unable to write mapped table %s", path.c_str())); }
+    ofs.close();
+    file.commit();
+}
+
+TableFileLock::TableFileLock(const std::string &path)
+{
+    #if defined(__ISWINDOWS__)
+        handle = NULL;
+        HANDLE h = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (h == INVALID_HANDLE_VALUE){ return; }
+        OVERLAPPED overlapped;
+        std::memset(&overlapped, 0, sizeof(overlapped));
+        if (!LockFileEx(h, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped)){ CloseHandle(h); return; }
+        handle = h;
+    #else
+        fd = open(path.c_str(), O_RDWR | O_CREAT, 0666);
+        if (fd < 0){ return; }
+        int code;
+        do{
+            code = flock(fd, LOCK_EX);
+        } while (code != 0 && errno == EINTR);
+        if (code != 0){ close(fd); fd = -1; }
+    #endif
+}
+
+TableFileLock::~TableFileLock()
+{
+    #if defined(__ISWINDOWS__)
+        if (handle != NULL){
+            OVERLAPPED overlapped;
+            std::memset(&overlapped, 0, sizeof(overlapped));
+            UnlockFileEx(handle, 0, 1, 0, &overlapped);
+            CloseHandle(handle);
+        }
+    #else
+        if (fd >= 0){
+            flock(fd, LOCK_UN);
+            close(fd);
+        }
+    #endif
+}
+
+bool TableFileLock::locked() const
+{
+    #if defined(__ISWINDOWS__)
+        return handle != NULL;
+    #else
+        return fd >= 0;
+    #endif
+}
+
+/// Counts the writers made in this process, so that threads writing the same file at the same time use different temporary files
+static unsigned long atomic_file_writer_count = 0;
+static Mutex atomic_file_writer_mutex;
+
+AtomicFileWriter::AtomicFileWriter(const std::string &path) : path(path), committed(false)
+{
+    unsigned long count;
+    {
+        ScopedLock lock(atomic_file_writer_mutex);
+        count = atomic_file_writer_count++;
+    }
+    // The process id keeps the temporary files of processes that write the same file at the same time apart, the count those of threads
+    #if defined(__ISWINDOWS__)
+        temporary_path = format("%s.%d.%d.tmp", path.c_str(), static_cast<int>(GetCurrentProcessId()), count);
+    #else
+        temporary_path = format("%s.%d.%d.tmp", path.c_str(), static_cast<int>(getpid()), count);
+    #endif
+}
+
+AtomicFileWriter::~AtomicFileWriter()
+{
+    if (!committed){ std::remove(temporary_path.c_str()); }
+}
+
+void AtomicFileWriter::commit()
+{
+    #if defined(__ISWINDOWS__)
+        bool ok = (MoveFileExA(temporary_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+    #else
+        bool ok = (std::rename(temporary_path.c_str(), path.c_str()) == 0);
+    #endif
+    if (!ok){ throw ValueError(format("Unable to move %s into place as %s", temporary_path.c_str(), path.c_str())); }
+    committed = true;
+}
+
+} /* namespace CoolProp */
+
+#endif // !defined(NO_TABULAR_BACKENDS)
@@ -0,0 +1,241 @@
+#ifndef TABULAR_STORAGE_H
+#define TABULAR_STORAGE_H
+
+#include "CoolPropTools.h"
+#include "Exceptions.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+
+namespace CoolProp{
+
+/** \brief A contiguous array of doubles that holds one vector of tabular data
+ *
+ * The values are either owned by this class, or the class is a read-only view onto memory that is owned
+ * by someone else (a memory-mapped table file, for instance).  A view must never be written to; the owner
+ * of the memory is responsible for keeping it alive as long as the view is in use.
+ */
+class TableVector{
+private:
+    std::vector<double> owned; ///< The values if they are owned by this class
+    double *ptr; ///< Pointer to the first value, either into owned, or into external memory
+    std::size_t N; ///< The number of values
+public:
+    typedef double value_type;
+    TableVector() : ptr(NULL), N(0) {};
+    TableVector(const TableVector &other) : ptr(NULL), N(0) { *this = other; };
+    TableVector & operator=(const TableVector &other){
+        if (this != &other){
+            if (other.is_view()){
+                attach(other.ptr, other.N);
+            }
+            else{
+                owned = other.owned;
+                ptr = owned.empty() ? NULL : &(owned[0]);
+                N = owned.size();
+            }
+        }
+        return *this;
+    };
+    /// Resize to N values, all of which are set to value; a view becomes owned storage
+    void resize(std::size_t N, double value){
+        owned.assign(N, value);
+        ptr = owned.empty() ? NULL : &(owned[0]);
+        this->N = N;
+    };
+    /// Copy the values of a std::vector into owned storage
+    void assign(const std::vector<double> &v){
+        owned = v;
+        ptr = owned.empty() ? NULL : &(owned[0]);
+        N = owned.size();
+    };
+    /// Make this a view onto N values owned by someone else
+    void attach(const double *data, std::size_t N){
+        std::vector<double>().swap(owned);
+        ptr = const_cast<double *>(data);
+        this->N = N;
+    };
+    /// Copy the values out into a std::vector
+    std::vector<double> to_vector() const { return std::vector<double>(ptr, ptr + N); };
+    /// True if the values are not owned by this class
+    bool is_view() const { return ptr != NULL && owned.empty(); };
+    std::size_t size() const { return N; };
+    bool empty() const { return N == 0; };
+    double * data(){ return ptr; };
+    const double * data() const { return ptr; };
+    double & operator[](std::size_t i){ return ptr[i]; };
+    const double & operator[](std::size_t i) const { return ptr[i]; };
+};
+
+/** \brief A row-major matrix of doubles that holds one matrix of tabular data
+ *
+ * All the values are stored in a single contiguous block (see TableVector for the ownership rules), and
+ * matrix[i][j] indexing is supported, as for the std::vector<std::vector<double> > it replaces.
+ */
+class TableMatrix{
+private:
+    TableVector values;
+    std::size_t Nrows, Ncols;
+public:
+    typedef double value_type;
+    TableMatrix() : Nrows(0), Ncols(0) {};
+    /// Resize to Nrows x Ncols values, all of which are set to value
+    void resize(std::size_t Nrows, std::size_t Ncols, double value){
+        values.resize(Nrows*Ncols, value);
+        this->Nrows = Nrows; this->Ncols = Ncols;
+    };
+    /// Copy the values of a std::vector<std::vector<double> > into owned storage; all rows must be the same length
+    void assign(const std::vector<std::vector<double> > &mat){
+        std::size_t Nc = (mat.empty()) ? 0 : mat[0].size();
+        resize(mat.size(), Nc, _HUGE);
+        for (std::size_t i = 0; i < mat.size(); ++i){
+            if (mat[i].size() != Nc){ throw ValueError(format("Row %d of matrix has length %d; should be %d", i, mat[i].size(), Nc)); }
+            std::copy(mat[i].begin(), mat[i].end(), (*this)[i]);
+        }
+    };
+    /// Make this a view onto Nrows x Ncols values owned by someone else
+    void attach(const double *data, std::size_t Nrows, std::size_t Ncols){
+        values.attach(data, Nrows*Ncols);
+        this->Nrows = Nrows; this->Ncols = Ncols;
+    };
+    /// Copy the values out into a std::vector<std::vector<double> >
+    std::vector<std::vector<double> > to_nested() const {
+        std::vector<std::vector<double> > mat(Nrows);
+        for (std::size_t i = 0; i < Nrows; ++i){
+            mat[i].assign((*this)[i], (*this)[i] + Ncols);
+        }
+        return mat;
+    };
+    /// A read-only view of one row, valid as long as this matrix is not resized
+    TableVector row(std::size_t i) const {
+        TableVector v; v.attach((*this)[i], Ncols); return v;
+    };
+    /// The number of rows, as for a vector of rows
+    std::size_t size() const { return Nrows; };
+    std::size_t rows() const { return Nrows; };
+    std::size_t cols() const { return Ncols; };
+    bool empty() const { return Nrows == 0; };
+    bool is_view() const { return values.is_view(); };
+    double * data(){ return values.data(); };
+    const double * data() const { return values.data(); };
+    double * operator[](std::size_t i){ return values.data() + i*Ncols; };
+    const double * operator[](std::size_t i) const { return values.data() + i*Ncols; };
+};
+
+/** \brief The header at the start of a memory-mapped table file
+ *
+ * The file consists of this header, followed by Narrays MappedTableArrayInfo entries, followed by the arrays
+ * of doubles, each of which starts on a 64 byte boundary.  All values are in the native byte order of the
+ * machine that wrote the file.
+ */
+struct MappedTableHeader{
+    char magic[8]; ///< "CPTABLE" followed by a null character
+    unsigned int format_version; ///< The version of the file layout
+    unsigned int byte_order; ///< Always MappedTableFile::byte_order_mark, used to reject files from machines with a different byte order
+    int revision; ///< The revision of the table data
+    unsigned int Narrays; ///< The number of arrays in the file
+    unsigned long long Nx, Ny; ///< The dimensions of the table
+    unsigned long long fluid_hash; ///< Hash of the backend, fluids and composition the table was built for
+    double xmin, xmax, ymin, ymax; ///< The limits of the table
+};
+
+/// An entry in the array directory of a memory-mapped table file
+struct MappedTableArrayInfo{
+    char name[48]; ///< The name of the array, null-terminated
+    unsigned long long offset; ///< The offset of the array from the start of the file, in bytes
+    unsigned long long count; ///< The number of doubles in the array
+};
+
+/** \brief A read-only memory mapping of a table file written by MappedTableWriter
+ *
+ * The arrays are used in place, without any decompression or copying; the mapping is released when this
+ * object is destroyed, so it must outlive any TableVector or TableMatrix views onto it.
+ */
+class MappedTableFile{
+private:
+    std::string path;
+    const char *base;
+    std::size_t length;
+    #if defined(__ISWINDOWS__)
+    void *file_handle, *mapping_handle;
+    #endif
+    MappedTableFile(const MappedTableFile &);
+    MappedTableFile & operator=(const MappedTableFile &);
+    void unmap();
+public:
+    static const unsigned int format_version = 1;
+    static const unsigned int byte_order_mark = 0x01020304;
+
+    /// Map the file and validate its header and array directory; throws UnableToLoadError if that is not possible
+    explicit MappedTableFile(const std::string &path);
+    ~MappedTableFile(){ unmap(); };
+    const MappedTableHeader & header() const { return *reinterpret_cast<const MappedTableHeader *>(base); };
+    /// Get a pointer to the array with the given name; throws UnableToLoadError if it is missing or does not have count values
+    const double * get(const std::string &name, std::size_t count) const;
+    /// Get a pointer to the array with the given name and the number of values in it; throws UnableToLoadError if it is missing
+    const double * find(const std::string &name, std::size_t &count) const;
+};
+
+/// Collects arrays and writes them to a file that can be opened with MappedTableFile
+class MappedTableWriter{
+private:
+    MappedTableHeader head;
+    std::vector<std::string> names;
+    std::vector<const double *> arrays;
+    std::vector<std::size_t> counts;
+public:
+    MappedTableWriter(int revision, unsigned long long fluid_hash, std::size_t Nx, std::size_t Ny, double xmin, double xmax, double ymin, double ymax);
+    /// Add an array to be written; the data must remain valid until write() has been called
+    void add(const std::string &name, const double *data, std::size_t count);
+    /// Write the header, the array directory and the arrays to file
+    void write(const std::string &path) const;
+};
+
+/// A 64-bit FNV-1a hash of a string, used to tie a table file to the fluid it was built for
+unsigned long long table_hash(const std::string &s);
+
+/** \brief An exclusive lock on a file that is held across processes, used so that only one process at a time builds and writes a set of tables
+ *
+ * The lock file is created if needed and is left in place; the lock is released when this object is destroyed
+ * (or when the process exits).  If the lock file cannot be created (a read-only directory, for instance), no lock
+ * is taken and locked() returns false.
+ */
+class TableFileLock{
+private:
+    #if defined(__ISWINDOWS__)
+    void *handle;
+    #else
+    int fd;
+    #endif
+    TableFileLock(const TableFileLock &);
+    TableFileLock & operator=(const TableFileLock &);
+public:
+    /// Block until the lock on the file at path has been acquired
+    explicit TableFileLock(const std::string &path);
+    ~TableFileLock();
+    bool locked() const;
+};
+
+/** \brief Write a file by way of a temporary file that is then renamed over path
+ *
+ * A reader (in this process or another one) sees either the old file or the complete new one, never one that is
+ * partially written.  The temporary file is removed if writing it fails.
+ */
+class AtomicFileWriter{
+private:
+    std::string path, temporary_path;
+    bool committed;
+    AtomicFileWriter(const AtomicFileWriter &);
+    AtomicFileWriter & operator=(const AtomicFileWriter &);
+public:
+    explicit AtomicFileWriter(const std::string &path);
+    ~AtomicFileWriter();
+    /// The path that is to be written to
+    const std::string & temporary() const { return temporary_path; };
+    /// Move the temporary file into place; throws ValueError if that is not possible
+    void commit();
+};
+
+} /* namespace CoolProp */
+
+#endif
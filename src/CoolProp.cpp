@@ -40,6 +40,12 @@
 #include "Backends/Helmholtz/MixtureParameters.h"
 #include "DataStructures.h"
 #include "Backends/REFPROP/REFPROPMixtureBackend.h"
+#include "Configuration.h"
+#include "CPthreads.h"
+
+#if defined(_OPENMP)
+    #include <omp.h>
+#endif
 
 #if defined(ENABLE_CATCH)
     #include "catch.hpp"
@@ -48,22 +54,25 @@
 namespace CoolProp
 {
 
-static int debug_level = 0;
-static std::string error_string;
-static std::string warning_string;
+/// The error and warning strings; each thread has its own, so that concurrent calls do not see each other's errors
+struct ErrorChannels{
+    std::string error_string, warning_string;
+};
+static AtomicInt debug_level(0);
+static ThreadLocal<ErrorChannels> error_channels;
 
-void set_debug_level(int level){debug_level = level;}
-int get_debug_level(void){return debug_level;}
+void set_debug_level(int level){debug_level.store(level);}
+int get_debug_level(void){return debug_level.load();}
 
 //// This is very hacky, but pull the git revision from the file
 #include "gitrevision.h" // Contents are like "std::string gitrevision = "aa121435436ggregrea4t43t433";"
 #include "cpversion.h" // Contents are like "char version [] = "2.5";"
 
 void set_warning_string(const std::string &warning){
-    warning_string = warning;
+    error_channels.get().warning_string = warning;
 }
 void set_error_string(const std::string &error){
-    error_string = error;
+    error_channels.get().error_string = error;
 }
 
 // Return true if the string has "BACKEND::*" format where * signifies a wildcard
@@ -181,6 +190,22 @@ std::string extract_fractions(const std::string &fluid_string, std::vector<doubl
     }
 }
 
+/// Set the composition of the state in whatever fractions it uses; a predefined mixture or a pure fluid keeps its mole fractions
+void _PropsSI_set_fractions(shared_ptr<AbstractState> &State, const std::vector<double> &fractions){
+    if (State->using_mole_fractions()){
+        // If a predefined mixture or a pure fluid, the fractions will already be set
+        if (State->get_mole_fractions().empty()){
+            State->set_mole_fractions(fractions);
+        }
+    } else if (State->using_mass_fractions()){
+        State->set_mass_fractions(fractions);
+    } else if (State->using_volu_fractions()){
+        State->set_volu_fractions(fractions);
+    } else {
+        if (get_debug_level()>50) std::cout << format("%s:%d: _PropsSI, could not set composition to %s, defaulting to mole fraction.\n",__FILE__,__LINE__, vec_to_string(fractions).c_str()).c_str();
+    }
+}
+
 void _PropsSI_initialize(const std::string &backend,
                          const std::vector<std::string> &fluid_names,
                          const std::vector<double> &z,
@@ -227,18 +252,7 @@ void _PropsSI_initialize(const std::string &backend,
     }
 
     // Set the fraction for the state
-    if (State->using_mole_fractions()){
-        // If a predefined mixture or a pure fluid, the fractions will already be set
-        if (State->get_mole_fractions().empty()){
-            State->set_mole_fractions(*fractions_ptr);
-        }
-    } else if (State->using_mass_fractions()){
-        State->set_mass_fractions(*fractions_ptr);
-    } else if (State->using_volu_fractions()){
-        State->set_volu_fractions(*fractions_ptr);
-    } else {
-        if (get_debug_level()>50) std::cout << format("%s:%d: _PropsSI, could not set composition to %s, defaulting to mole fraction.\n",__FILE__,__LINE__, vec_to_string(z).c_str()).c_str();
-    }
+    _PropsSI_set_fractions(State, *fractions_ptr);
 }
 
 struct output_parameter{
@@ -330,10 +344,41 @@ void _PropsSI_outputs(shared_ptr<AbstractState> &State,
     // Throw an error if at the end, there were no successes
     bool success = false;
 
+    // If there are several state points and only normal outputs, hand the whole batch to the backend
+    bool all_normal_outputs = true;
+    for (std::size_t j = 0; j < output_parameters.size(); ++j){
+        if (output_parameters[j].type != output_parameter::OUTPUT_TYPE_NORMAL && output_parameters[j].type != output_parameter::OUTPUT_TYPE_TRIVIAL){
+            all_normal_outputs = false; break;
+        }
+    }
+    if (IO.size() > 1 && all_normal_outputs && input_pair != INPUT_PAIR_INVALID && !all_trivial_outputs && !all_outputs_in_inputs){
+        if (get_debug_level() > 100)
+        {
+            std::cout << format("%s (%d): Batch update of %d input value pairs.",__FILE__,__LINE__,IO.size()) << std::endl;
+        }
+        std::vector<parameters> keys(N2);
+        for (std::size_t j = 0; j < N2; ++j){ keys[j] = output_parameters[j].Of1; }
+        std::vector<double> out(N1*N2, _HUGE);
+        std::string first_error;
+        State->update_many(input_pair, &(in1[0]), &(in2[0]), N1, &(keys[0]), N2, &(out[0]), &first_error);
+        for (std::size_t i = 0; i < N1; ++i){
+            for (std::size_t j = 0; j < N2; ++j){
+                IO[i][j] = out[i*N2+j];
+                if (out[i*N2+j] != _HUGE){ success = true; }
+            }
+        }
+        if (success == false) { IO.clear(); throw ValueError(format("No outputs were able to be calculated"));}
+        // Some of the state points failed; report the first of them
+        if (!first_error.empty()){ set_error_string(first_error); }
+        return;
+    }
+
     if (get_debug_level() > 100)
     {
         std::cout << format("%s (%d): Iterating over %d input value pairs.",__FILE__,__LINE__,IO.size()) << std::endl;
     }
+    // The error from the first state point that could not be calculated
+    std::string first_error;
 	// Iterate over the state variable inputs
 	for (std::size_t i = 0; i < IO.size(); ++i){
 		try{
@@ -342,6 +387,13 @@ void _PropsSI_outputs(shared_ptr<AbstractState> &State,
                 State->update(input_pair, in1[i], in2[i]);
             }
         }
+        catch(std::exception &e){
+            if (one_input_one_output){IO.clear(); throw;} // Re-raise the exception since we want to bubble the error
+            if (first_error.empty()){ first_error = e.what(); }
+            // All the outputs are filled with _HUGE; go to next input
+            for (std::size_t j = 0; j < IO[i].size(); ++j){ IO[i][j] = _HUGE; }
+            continue;
+        }
         catch(...){
             if (one_input_one_output){IO.clear(); throw;} // Re-raise the exception since we want to bubble the error
             // All the outputs are filled with _HUGE; go to next input
@@ -380,6 +432,11 @@ void _PropsSI_outputs(shared_ptr<AbstractState> &State,
                 // At least one has succeeded
                 success = true;
             }
+            catch(std::exception &e){
+                if (one_input_one_output){IO.clear(); throw;} // Re-raise the exception since we want to bubble the error
+                if (first_error.empty()){ first_error = e.what(); }
+                IO[i][j] = _HUGE;
+            }
             catch(...){
                 if (one_input_one_output){IO.clear(); throw;} // Re-raise the exception since we want to bubble the error
                 IO[i][j] = _HUGE;
@@ -387,6 +444,99 @@ void _PropsSI_outputs(shared_ptr<AbstractState> &State,
         }
 	}
     if (success == false) { IO.clear(); throw ValueError(format("No outputs were able to be calculated"));}
+    // Some of the state points failed; report the first of them
+    if (!first_error.empty()){ set_error_string(first_error); }
+}
+
+/// Get the number of threads that should be used to evaluate N state points with the given backend
+std::size_t _PropsSImulti_number_of_threads(const std::string &backend, std::size_t N){
+    #if defined(_OPENMP)
+        // REFPROP keeps its state in global variables, so it can only be called from one thread
+        if (backend.find("REFPROP") != std::string::npos){ return 1; }
+        int Nthreads = static_cast<int>(get_config_double(PROPSSIMULTI_NUMBER_OF_THREADS));
+        if (Nthreads <= 0){ Nthreads = omp_get_max_threads(); }
+        return std::max(static_cast<std::size_t>(1), std::min(static_cast<std::size_t>(Nthreads), N));
+    #else
+        return 1;
+    #endif
+}
+
+/// Evaluate the outputs with a pool of states, one per thread
+/// The state points are split into blocks that are handed out to the threads as they become idle;
+/// a point that fails is filled with _HUGE, just as in the serial case.  The error strings are per-thread,
+/// so the errors from the blocks are collected and the first of them is set on the calling thread
+void _PropsSI_outputs_parallel(shared_ptr<AbstractState> &State,
+                               const std::string &backend,
+                               const std::vector<std::string> &fluids,
+                               const std::vector<double> &fractions,
+                               std::size_t Nthreads,
+                               const std::vector<output_parameter> &output_parameters,
+                               CoolProp::input_pairs input_pair,
+                               const std::vector<double> &in1,
+                               const std::vector<double> &in2,
+                               std::vector<std::vector<double> > &IO){
+
+    if (in1.size() != in2.size()){ throw ValueError(format("lengths of in1 [%d] and in2 [%d] are not the same", in1.size(), in2.size()));}
+
+    // All the states are constructed on this thread since the fluid libraries are not thread-safe while loading
+    std::vector<shared_ptr<AbstractState> > States(Nthreads);
+    States[0] = State;
+    for (std::size_t i = 1; i < Nthreads; ++i){
+        try{
+            States[i].reset(State->clone());
+        }
+        catch(NotImplementedError &){
+            _PropsSI_initialize(backend, fluids, fractions, States[i]);
+        }
+    }
+
+    std::size_t N = in1.size();
+    std::size_t Nout = std::max(static_cast<std::size_t>(1), output_parameters.size());
+    IO.resize(N, std::vector<double>(Nout, _HUGE));
+
+    // Several blocks per thread so that the load is balanced when some points are slower than others
+    std::size_t block_size = std::max(static_cast<std::size_t>(1), N/(8*Nthreads));
+    long Nblocks = static_cast<long>((N + block_size - 1)/block_size);
+    std::vector<int> block_success(Nblocks, 0);
+    std::vector<std::string> block_errors(Nblocks);
+
+    // The calling thread is one of the workers; keep its error string so that it is not taken for the error of a block
+    std::string caller_error = get_global_param_string("errstring");
+
+    #if defined(_OPENMP)
+    #pragma omp parallel for schedule(dynamic) num_threads(static_cast<int>(Nthreads))
+    #endif
+    for (long b = 0; b < Nblocks; ++b){
+        #if defined(_OPENMP)
+            shared_ptr<AbstractState> &ThreadState = States[omp_get_thread_num()];
+        #else
+            shared_ptr<AbstractState> &ThreadState = States[0];
+        #endif
+        std::size_t imin = static_cast<std::size_t>(b)*block_size, imax = std::min(N, imin + block_size);
+        std::vector<double> block_in1(in1.begin() + imin, in1.begin() + imax), block_in2(in2.begin() + imin, in2.begin() + imax);
+        std::vector<std::vector<double> > block_IO;
+        try{
+            _PropsSI_outputs(ThreadState, output_parameters, input_pair, block_in1, block_in2, block_IO);
+            for (std::size_t i = imin; i < imax; ++i){ IO[i] = block_IO[i - imin]; }
+            block_success[b] = 1;
+            // Take the error of the points that failed from this thread's error string
+            block_errors[b] = get_global_param_string("errstring");
+        }
+        catch(std::exception &e){
+            // Nothing in this block could be calculated; the outputs stay _HUGE
+            block_errors[b] = e.what();
+        }
+        catch(...){
+            block_errors[b] = "Undefined error";
+        }
+    }
+    if (std::find(block_success.begin(), block_success.end(), 1) == block_success.end()){
+        IO.clear(); throw ValueError(format("No outputs were able to be calculated"));
+    }
+    for (long b = 0; b < Nblocks; ++b){
+        if (!block_errors[b].empty()){ set_error_string(block_errors[b]); return; }
+    }
+    set_error_string(caller_error);
 }
 
 void _PropsSImulti(const std::vector<std::string> &Outputs,
@@ -434,7 +584,13 @@ void _PropsSImulti(const std::vector<std::string> &Outputs,
     }
 
     // Calculate the output(s).  In the case of a failure, all values will be filled with _HUGE
-    _PropsSI_outputs(State, output_parameters, input_pair, v1, v2, IO);
+    std::size_t Nthreads = _PropsSImulti_number_of_threads(backend, v1.size());
+    if (Nthreads > 1){
+        _PropsSI_outputs_parallel(State, backend, fluids, fractions, Nthreads, output_parameters, input_pair, v1, v2, IO);
+    }
+    else{
+        _PropsSI_outputs(State, output_parameters, input_pair, v1, v2, IO);
+    }
 }
 
 std::vector<std::vector<double> > PropsSImulti(const std::vector<std::string> &Outputs,
@@ -472,6 +628,70 @@ std::vector<std::vector<double> > PropsSImulti(const std::vector<std::string> &O
     #endif
     return std::vector<std::vector<double> >();
 }
+#if defined(ENABLE_CATCH)
+TEST_CASE("Check PropsSImulti with several threads against the serial evaluation","[PropsSImulti]")
+{
+    std::vector<std::string> outputs(1, "Dmass"), fluids(1, "Water");
+    outputs.push_back("Hmass");
+    std::vector<double> T, p;
+    for (std::size_t i = 0; i < 200; ++i){
+        T.push_back(300 + i); p.push_back(101325);
+    }
+    T[17] = -1; // An invalid state point
+    double Nthreads = get_config_double(PROPSSIMULTI_NUMBER_OF_THREADS);
+    set_config_double(PROPSSIMULTI_NUMBER_OF_THREADS, 1);
+    std::vector<std::vector<double> > serial = CoolProp::PropsSImulti(outputs, "T", T, "P", p, "HEOS", fluids, std::vector<double>(1, 1.0));
+    set_config_double(PROPSSIMULTI_NUMBER_OF_THREADS, 4);
+    std::vector<std::vector<double> > parallel = CoolProp::PropsSImulti(outputs, "T", T, "P", p, "HEOS", fluids, std::vector<double>(1, 1.0));
+    set_config_double(PROPSSIMULTI_NUMBER_OF_THREADS, Nthreads);
+    REQUIRE(serial.size() == parallel.size());
+    for (std::size_t i = 0; i < serial.size(); ++i){
+        CAPTURE(i);
+        CHECK(serial[i] == parallel[i]);
+    }
+    CHECK(parallel[17][0] == _HUGE);
+}
+TEST_CASE("PropsSImulti reports the error of a failed point when the points are handed to update_many","[PropsSImulti]")
+{
+    std::vector<std::string> outputs(1, "Dmass"), fluids(1, "Water");
+    std::vector<double> T(20, 350), p(20, 101325);
+    T[7] = -1; // An invalid state point
+    double Nthreads = get_config_double(PROPSSIMULTI_NUMBER_OF_THREADS);
+    set_config_double(PROPSSIMULTI_NUMBER_OF_THREADS, 1);
+    get_global_param_string("errstring");
+    std::vector<std::vector<double> > IO = CoolProp::PropsSImulti(outputs, "T", T, "P", p, "HEOS", fluids, std::vector<double>(1, 1.0));
+    std::string error = get_global_param_string("errstring");
+    set_config_double(PROPSSIMULTI_NUMBER_OF_THREADS, Nthreads);
+    REQUIRE(IO.size() == T.size());
+    CHECK(IO[7][0] == _HUGE);
+    CHECK(ValidNumber(IO[6][0]));
+    CHECK(!error.empty());
+}
+TEST_CASE("PropsSImulti with several threads reports the error of a failed point on the calling thread","[PropsSImulti]")
+{
+    // A plain output, for which the points of a block are handed to update_many, and a derivative, for which they are evaluated one at a time
+    const char *output_names[] = {"Dmass", "d(Dmass)/d(T)|P"};
+    for (std::size_t k = 0; k < 2; ++k){
+        CAPTURE(output_names[k]);
+        std::vector<std::string> outputs(1, output_names[k]), fluids(1, "Water");
+        std::vector<double> T(200, 350), p(200, 101325);
+        T[150] = -1; // An invalid state point, evaluated on one of the other threads
+        double Nthreads = get_config_double(PROPSSIMULTI_NUMBER_OF_THREADS);
+        set_config_double(PROPSSIMULTI_NUMBER_OF_THREADS, 1);
+        get_global_param_string("errstring");
+        CoolProp::PropsSImulti(outputs, "T", T, "P", p, "HEOS", fluids, std::vector<double>(1, 1.0));
+        std::string serial_error = get_global_param_string("errstring");
+        set_config_double(PROPSSIMULTI_NUMBER_OF_THREADS, 4);
+        std::vector<std::vector<double> > IO = CoolProp::PropsSImulti(outputs, "T", T, "P", p, "HEOS", fluids, std::vector<double>(1, 1.0));
+        std::string parallel_error = get_global_param_string("errstring");
+        set_config_double(PROPSSIMULTI_NUMBER_OF_THREADS, Nthreads);
+        REQUIRE(IO.size() == T.size());
+        CHECK(IO[150][0] == _HUGE);
+        CHECK(!serial_error.empty());
+        CHECK(parallel_error == serial_error);
+    }
+}
+#endif
 double PropsSI(const std::string &Output, const std::string &Name1, double Prop1, const std::string &Name2, double Prop2, const std::string &Ref)
 {
     #if !defined(NO_ERROR_CATCHING)
@@ -706,6 +926,28 @@ bool is_valid_fluid_string(const std::string &input_fluid_string)
         return false;
     }
 }
+void warm_up(const std::vector<std::string> &fluids)
+{
+    // The tables of parameters and input pairs that every call needs, and the index of the fluids
+    get_parameter_index("T");
+    get_input_pair_index("PT_INPUTS");
+    get_library();
+    for (std::size_t i = 0; i < fluids.size(); ++i){
+        std::string backend, fluid;
+        std::vector<double> fractions;
+        extract_backend(fluids[i], backend, fluid);
+        std::string fluid_string = extract_fractions(fluid, fractions);
+        try{
+            // Making the state parses the fluids (and the mixture parameters), and loads or builds any tables;
+            // the tables of a mixture are only loaded or built once its composition is set
+            shared_ptr<AbstractState> State(AbstractState::factory(backend, fluid_string));
+            if (!fractions.empty()){ _PropsSI_set_fractions(State, fractions); }
+        }
+        catch(std::exception &e){
+            throw ValueError(format("Unable to warm up fluid [%s]: %s", fluids[i].c_str(), e.what()));
+        }
+    }
+}
 double saturation_ancillary(const std::string &fluid_name, const std::string &output, int Q, const std::string &input, double value){
 
     // Generate the state instance
@@ -823,7 +1065,7 @@ void set_reference_stateD(const std::string &Ref, double T, double rhomolar, dou
     double deltas = HEOS.smass() - s0; // offset from specified entropy in J/mol/K
     double delta_a1 = deltas/(8.314472/HEOS.molar_mass());
     double delta_a2 = -deltah/(8.314472/HEOS.molar_mass()*HEOS.get_reducing_state().T);
-    HEOS.get_components()[0].EOS().alpha0.EnthalpyEntropyOffset.set(delta_a1, delta_a2, "custom");
+    HEOS.get_mutable_component(0).EOS().alpha0.EnthalpyEntropyOffset.set(delta_a1, delta_a2, "custom");
     HEOS.update_states();
 }
 
@@ -835,9 +1077,11 @@ std::string get_global_param_string(const std::string &ParamName)
         return gitrevision;
     }
     else if (!ParamName.compare("errstring")){
+        std::string &error_string = error_channels.get().error_string;
         std::string temp = error_string; error_string = ""; return temp;
     }
     else if (!ParamName.compare("warnstring")){
+        std::string &warning_string = error_channels.get().warning_string;
         std::string temp = warning_string; warning_string = ""; return temp;
     }
     else if (!ParamName.compare("FluidsList") || !ParamName.compare("fluids_list") || !ParamName.compare("fluidslist")){
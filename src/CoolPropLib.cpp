@@ -526,19 +526,18 @@ EXPORT_CODE void CONVENTION AbstractState_update_and_common_out(const long handl
     try{
         shared_ptr<CoolProp::AbstractState> &AS = handle_manager.get(handle);
 
-        for (int i = 0; i<length; i++){
-            try{
-                AS->update(static_cast<CoolProp::input_pairs>(input_pair), *(value1+i), *(value2+i));
-                *(T+i) = AS->T();
-                *(p+i) = AS->p();
-                *(rhomolar+i) = AS->rhomolar();
-                *(hmolar+i) = AS->hmolar();
-                *(smolar+i) = AS->smolar();
-            }
-            catch (...){
-                
-            }
-        };
+        if (length > 0){
+            const CoolProp::parameters keys[5] = {CoolProp::iT, CoolProp::iP, CoolProp::iDmolar, CoolProp::iHmolar, CoolProp::iSmolar};
+            std::vector<double> out(5*length);
+            AS->update_many(static_cast<CoolProp::input_pairs>(input_pair), value1, value2, length, keys, 5, &(out[0]));
+            for (int i = 0; i<length; i++){
+                *(T+i) = out[5*i];
+                *(p+i) = out[5*i+1];
+                *(rhomolar+i) = out[5*i+2];
+                *(hmolar+i) = out[5*i+3];
+                *(smolar+i) = out[5*i+4];
+            };
+        }
     }
     catch (CoolProp::HandleError &e){
         std::string errmsg = std::string("HandleError: ") + e.what();
@@ -561,19 +560,19 @@ EXPORT_CODE void CONVENTION AbstractState_update_and_5_out(const long handle, co
     try{
         shared_ptr<CoolProp::AbstractState> &AS = handle_manager.get(handle);
 
-        for (int i = 0; i<length; i++){
-            try{
-                AS->update(static_cast<CoolProp::input_pairs>(input_pair), *(value1+i), *(value2+i));
-                *(out1+i) = AS->keyed_output(static_cast<CoolProp::parameters>(outputs[0]));
-                *(out2+i) = AS->keyed_output(static_cast<CoolProp::parameters>(outputs[1]));
-                *(out3+i) = AS->keyed_output(static_cast<CoolProp::parameters>(outputs[2]));
-                *(out4+i) = AS->keyed_output(static_cast<CoolProp::parameters>(outputs[3]));
-                *(out5+i) = AS->keyed_output(static_cast<CoolProp::parameters>(outputs[4]));
-            }
-            catch (...){
-
-            }
-        };
+        if (length > 0){
+            CoolProp::parameters keys[5];
+            for (int j = 0; j < 5; j++){ keys[j] = static_cast<CoolProp::parameters>(outputs[j]); }
+            std::vector<double> out(5*length);
+            AS->update_many(static_cast<CoolProp::input_pairs>(input_pair), value1, value2, length, keys, 5, &(out[0]));
+            for (int i = 0; i<length; i++){
+                *(out1+i) = out[5*i];
+                *(out2+i) = out[5*i+1];
+                *(out3+i) = out[5*i+2];
+                *(out4+i) = out[5*i+3];
+                *(out5+i) = out[5*i+4];
+            };
+        }
     }
     catch (CoolProp::HandleError &e){
         std::string errmsg = std::string("HandleError: ") + e.what();
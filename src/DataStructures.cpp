@@ -4,6 +4,7 @@
 #include "Exceptions.h"
 #include "CoolPropTools.h"
 #include "CoolProp.h"
+#include "CPthreads.h"
 
 namespace CoolProp{
 
@@ -146,14 +147,15 @@ private:
     }
 };
 
-static ParameterInformation parameter_information;
+// Filled the first time it is used
+static LazyInstance<ParameterInformation> parameter_information;
 
 bool is_trivial_parameter(int key)
 {
     // Try to find it
-    std::map<int, bool>::const_iterator it = parameter_information.trivial_map.find(key);
+    std::map<int, bool>::const_iterator it = parameter_information.get().trivial_map.find(key);
     // If equal to end, not found
-    if (it != parameter_information.trivial_map.end())
+    if (it != parameter_information.get().trivial_map.end())
     {
         // Found it, return it
         return it->second;
@@ -170,16 +172,16 @@ std::string get_parameter_information(int key, const std::string &info)
 
     // Hook up the right map (since they are all of the same type)
     if (!info.compare("IO")){
-        M = &(parameter_information.IO_map);
+        M = &(parameter_information.get().IO_map);
     }
     else if (!info.compare("short")){
-        M = &(parameter_information.short_desc_map);
+        M = &(parameter_information.get().short_desc_map);
     }
     else if (!info.compare("long")){
-        M = &(parameter_information.description_map);
+        M = &(parameter_information.get().description_map);
     }
     else if (!info.compare("units")){
-        M = &(parameter_information.units_map);
+        M = &(parameter_information.get().units_map);
     }
     else
         throw ValueError(format("Bad info string [%s] to get_parameter_information",info.c_str()));
@@ -202,7 +204,7 @@ std::string get_parameter_information(int key, const std::string &info)
 std::string get_csv_parameter_list()
 {
     std::vector<std::string> strings;
-    for(std::map<std::string,int>::const_iterator it = parameter_information.index_map.begin(); it != parameter_information.index_map.end(); ++it )
+    for(std::map<std::string,int>::const_iterator it = parameter_information.get().index_map.begin(); it != parameter_information.get().index_map.end(); ++it )
     {
         strings.push_back(it->first);
     }
@@ -211,9 +213,9 @@ std::string get_csv_parameter_list()
 bool is_valid_parameter(const std::string &param_name, parameters &iOutput)
 {
     // Try to find it
-    std::map<std::string, int>::const_iterator it = parameter_information.index_map.find(param_name);
+    std::map<std::string, int>::const_iterator it = parameter_information.get().index_map.find(param_name);
     // If equal to end, not found
-    if (it != parameter_information.index_map.end()){
+    if (it != parameter_information.get().index_map.end()){
         // Found, return it
         iOutput = static_cast<parameters>(it->second);
         return true;
@@ -353,18 +355,19 @@ public:
         }
     }
 };
-static PhaseInformation phase_information;
+// Filled the first time it is used
+static LazyInstance<PhaseInformation> phase_information;
 
 const std::string& get_phase_short_desc(phases phase)
 {
-    return phase_information.short_desc_map[phase];
+    return phase_information.get().short_desc_map[phase];
 }
 bool is_valid_phase(const std::string &phase_name, phases &iOutput)
 {
     // Try to find it
-    std::map<std::string, phases>::const_iterator it = phase_information.index_map.find(phase_name);
+    std::map<std::string, phases>::const_iterator it = phase_information.get().index_map.find(phase_name);
     // If equal to end, not found
-    if (it != phase_information.index_map.end()){
+    if (it != phase_information.get().index_map.end()){
         // Found, return it
         iOutput = static_cast<phases>(it->second);
         return true;
@@ -463,12 +466,13 @@ public:
     }
 };
 
-static InputPairInformation input_pair_information;
+// Filled the first time it is used
+static LazyInstance<InputPairInformation> input_pair_information;
 
 input_pairs get_input_pair_index(const std::string &input_pair_name)
 {
-    std::map<std::string, input_pairs>::iterator it = input_pair_information.index_map.find(input_pair_name);
-    if (it != input_pair_information.index_map.end()){
+    std::map<std::string, input_pairs>::iterator it = input_pair_information.get().index_map.find(input_pair_name);
+    if (it != input_pair_information.get().index_map.end()){
         return it->second;
     }
     else{
@@ -478,11 +482,11 @@ input_pairs get_input_pair_index(const std::string &input_pair_name)
 
 const std::string& get_input_pair_short_desc(input_pairs pair)
 {
-    return input_pair_information.short_desc_map[pair];
+    return input_pair_information.get().short_desc_map[pair];
 }
 const std::string& get_input_pair_long_desc(input_pairs pair)
 {
-    return input_pair_information.long_desc_map[pair];
+    return input_pair_information.get().long_desc_map[pair];
 }
 void split_input_pair(input_pairs pair, parameters &p1, parameters &p2)
 {
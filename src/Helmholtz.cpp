@@ -1,4 +1,5 @@
 #include <numeric>
+#include <cstring>
 #include "Helmholtz.h"
 
 #ifdef __ANDROID__
@@ -34,108 +35,410 @@ double ramp(double x)
         return 0;
 }
 
-/*
-void ResidualHelmholtzGeneralizedExponential::allEigen(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw()
+void ResidualHelmholtzGeneralizedExponentialFamily::push_back(const ResidualHelmholtzGeneralizedExponentialElement &el, bool delta_l, bool tau_m, bool eta1_in_u, bool eta2_in_u, bool beta1_in_u, bool beta2_in_u)
 {
-    double log_tau = log(tau), log_delta = log(delta), 
-           one_over_delta = 1/delta, one_over_tau = 1/tau; // division is much slower than multiplication, so do one division here
-    
-    Eigen::Map<Eigen::ArrayXd> nE(&(n[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXd> dE(&(d[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXd> tE(&(t[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXd> cE(&(c[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXi> l_intE(&(l_int[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXd> l_doubleE(&(l_double[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXd> eta1E(&(eta1[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXd> eta2E(&(eta2[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXd> epsilon1E(&(epsilon1[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXd> epsilon2E(&(epsilon2[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXd> beta1E(&(beta1[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXd> beta2E(&(beta2[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXd> gamma1E(&(gamma1[0]), elements.size());
-    Eigen::Map<Eigen::ArrayXd> gamma2E(&(gamma2[0]), elements.size());
-    
-    // ****************************************
-    // The u part in exp(u) and its derivatives
-    // ****************************************
-    
-    #if defined(EIGEN_VECTORIZE_SSE2)
-        //std::cout << "EIGEN_VECTORIZE_SSE2" << std::endl;
-    #endif
+    n.push_back(el.n); d.push_back(el.d); t.push_back(el.t);
+    c.push_back(delta_l ? el.c : 0); l_int.push_back(delta_l ? el.l_int : 0); l_double.push_back(delta_l ? el.l_double : 0);
+    omega.push_back(tau_m ? el.omega : 0); m.push_back(tau_m ? el.m_double : 0);
+    eta1.push_back(eta1_in_u ? el.eta1 : 0); epsilon1.push_back(eta1_in_u ? el.epsilon1 : 0);
+    eta2.push_back(eta2_in_u ? el.eta2 : 0); epsilon2.push_back(eta2_in_u ? el.epsilon2 : 0);
+    beta1.push_back(beta1_in_u ? el.beta1 : 0); gamma1.push_back(beta1_in_u ? el.gamma1 : 0);
+    beta2.push_back(beta2_in_u ? el.beta2 : 0); gamma2.push_back(beta2_in_u ? el.gamma2 : 0);
+}
 
-    // Set the u part of exp(u) to zero
-    uE.fill(0);
-    du_ddeltaE.fill(0);
-    du_dtauE.fill(0);
-    d2u_ddelta2E.fill(0);
-    d2u_dtau2E.fill(0);
-    d3u_ddelta3E.fill(0);
-    d3u_dtau3E.fill(0);
-    
-    if (delta_li_in_u){
-        Eigen::ArrayXd u_increment = -cE*(log_delta*l_doubleE).exp(); //pow(delta,L) -> exp(L*log(delta))
-        uE += u_increment;
-        du_ddeltaE += l_doubleE*u_increment*one_over_delta;
-        d2u_ddelta2E += (l_doubleE-1)*l_doubleE*u_increment*one_over_delta*one_over_delta;
-        d3u_ddelta3E += (l_doubleE-2)*(l_doubleE-1)*l_doubleE*u_increment*one_over_delta*one_over_delta*one_over_delta;
+void ResidualHelmholtzGeneralizedExponential::pack()
+{
+    // A kernel generated for the terms as they were no longer applies
+    kernel = NULL;
+    typedef ResidualHelmholtzGeneralizedExponentialFamily Family;
+    std::vector<Family> grouped;
+    grouped.push_back(Family(Family::FAMILY_POWER));
+    grouped.push_back(Family(Family::FAMILY_EXPONENTIAL));
+    grouped.push_back(Family(Family::FAMILY_GAUSSIAN));
+    grouped.push_back(Family(Family::FAMILY_GENERAL));
+    for (std::size_t i = 0; i < elements.size(); ++i){
+        const ResidualHelmholtzGeneralizedExponentialElement &el = elements[i];
+        // The same tests as in all_reference(), which skips the parts of u for which these are false
+        bool delta_l = delta_li_in_u && ValidNumber(el.l_double) && el.l_int > 0;
+        bool tau_m = tau_mi_in_u && std::abs(el.m_double) > 0;
+        bool e1 = eta1_in_u && ValidNumber(el.eta1) && el.eta1 != 0, e2 = eta2_in_u && ValidNumber(el.eta2) && el.eta2 != 0;
+        bool b1 = beta1_in_u && ValidNumber(el.beta1) && el.beta1 != 0, b2 = beta2_in_u && ValidNumber(el.beta2) && el.beta2 != 0;
+        bool gaussian = e1 || e2 || b1 || b2;
+        Family::family_type type;
+        if (tau_m || (delta_l && gaussian)){ type = Family::FAMILY_GENERAL; }
+        else if (delta_l){ type = Family::FAMILY_EXPONENTIAL; }
+        else if (gaussian){ type = Family::FAMILY_GAUSSIAN; }
+        else{ type = Family::FAMILY_POWER; }
+        grouped[type].push_back(el, delta_l, tau_m, e1, e2, b1, b2);
     }
-    
-//    if (tau_mi_in_u){
-//        CoolPropDbl omegai = el.omega, m_double = el.m_double;
-//        if (std::abs(m_double) > 0){
-//            CoolPropDbl u_increment = -omegai*pow(tau, m_double);
-//            CoolPropDbl du_dtau_increment = m_double*u_increment*one_over_tau;
-//            CoolPropDbl d2u_dtau2_increment = (m_double-1)*du_dtau_increment*one_over_tau;
-//            CoolPropDbl d3u_dtau3_increment = (m_double-2)*d2u_dtau2_increment*one_over_tau;
-//            u += u_increment;
-//            du_dtau += du_dtau_increment;
-//            d2u_dtau2 += d2u_dtau2_increment;
-//            d3u_dtau3 += d3u_dtau3_increment;
-//        }
-//    }
-    if (eta1_in_u){
-        uE += -eta1E*(delta-epsilon1E);
-        du_ddeltaE += -eta1E;
+    families.clear();
+    for (std::size_t k = 0; k < grouped.size(); ++k){
+        if (grouped[k].size() == 0){ continue; }
+        while (grouped[k].size() % block_size != 0){
+            // A term with n = 0 that contributes nothing
+            grouped[k].push_back(ResidualHelmholtzGeneralizedExponentialElement(), false, false, false, false, false, false);
+        }
+        families.push_back(grouped[k]);
+    }
+}
+
+// On x86 with GCC or clang, the generalized exponential terms are evaluated with AVX2 or AVX-512 instructions if the
+// processor has them, and with the baseline instructions otherwise
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(__MINGW32__)
+    #define GENEXP_RUNTIME_DISPATCH
+    #define GENEXP_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+    #define GENEXP_ALWAYS_INLINE inline
+#endif
+
+namespace {
+
+/// Indices of the sums in the accumulators, in the order of the derivatives in HelmholtzDerivatives
+enum { SUM_A, SUM_D, SUM_T, SUM_DD, SUM_DT, SUM_TT, SUM_DDD, SUM_DDT, SUM_DTT, SUM_TTT, SUM_DDDD, SUM_DDDT, SUM_DDTT, SUM_DTTT, SUM_TTTT, NUMBER_OF_SUMS };
+
+const int block_size = ResidualHelmholtzGeneralizedExponential::block_size;
+
+/// The values of tau and delta, and the functions of them that every term needs, for the points of one block
+struct GeneralizedExponentialPoints{
+    double tau[block_size], delta[block_size], log_tau[block_size], log_delta[block_size], one_over_tau[block_size], one_over_delta[block_size];
+    void set(std::size_t j, double tau, double delta){
+        this->tau[j] = tau; this->delta[j] = delta;
+        // At tau or delta = 0 the logarithms are clamped, so that 0*log(0) in the terms that do not depend on them gives 0 rather than NaN
+        log_tau[j] = std::max(static_cast<double>(log(tau)), -745.2); log_delta[j] = std::max(static_cast<double>(log(delta)), -745.2);
+        one_over_tau[j] = 1/tau; one_over_delta[j] = 1/delta;
+    }
+};
+
+/** exp(x) in a form that the compiler can vectorize; accurate to about one ulp
+ *
+ * x = k*ln(2) + r with |r| <= ln(2)/2, so that exp(x) = 2^k*exp(r); exp(r) is given by its Taylor series and 2^k is
+ * built from its bits.  2^k is applied in two halves so that results that underflow or overflow come out as 0 or infinity.
+ * x is clamped at -745.2, below which exp(x) rounds to 0, so that x = -infinity gives 0 rather than NaN.
+ */
+GENEXP_ALWAYS_INLINE double exp_vectorizable(double x)
+{
+    x = (x < -745.2) ? -745.2 : x;
+    const double log2e = 1.4426950408889634, ln2_hi = 0.6931471803691238, ln2_lo = 1.9082149292705877e-10;
+    const double shifter = 6755399441055744.0; // 1.5*2^52; adding and subtracting it rounds to the nearest integer
+    const double k = (x*log2e + shifter) - shifter;
+    const double r = (x - k*ln2_hi) - k*ln2_lo;
+    double p = 1.0/479001600;
+    p = p*r + 1.0/39916800; p = p*r + 1.0/3628800; p = p*r + 1.0/362880; p = p*r + 1.0/40320; p = p*r + 1.0/5040;
+    p = p*r + 1.0/720; p = p*r + 1.0/120; p = p*r + 1.0/24; p = p*r + 1.0/6; p = p*r + 0.5; p = p*r + 1.0; p = p*r + 1.0;
+    const double k1 = (0.5*k + shifter) - shifter, k2 = k - k1;
+    double scale[2], halves[2] = {k1 + shifter, k2 + shifter};
+    for (int h = 0; h < 2; ++h){
+        long long bits;
+        std::memcpy(&bits, &(halves[h]), sizeof(bits));
+        bits -= 0x4338000000000000LL; // The bits of the shifter, leaving the integer
+        bits = (bits < -1022) ? -1022 : bits;
+        bits = (bits > 1023) ? 1023 : bits;
+        bits = (bits + 1023) << 52;
+        std::memcpy(&(scale[h]), &bits, sizeof(bits));
+    }
+    return p*scale[0]*scale[1];
+}
+
+/** Add the contributions of one block of lanes to the accumulators, before the division by the powers of delta and tau
+ *
+ * Lane j evaluates term i + term_step*j of the family at point point_step*j, so that with term_step = 1 and
+ * point_step = 0 a block is block_size terms at one point, and with term_step = 0 and point_step = 1 it is one term
+ * at block_size points.  Each step is a separate loop over the lanes without any branches, so that the compiler
+ * vectorizes it; the branches on the family type and max_order are taken once per block.
+ */
+template<bool vectorized, int term_step, int point_step>
+GENEXP_ALWAYS_INLINE void generalized_exponential_block(const ResidualHelmholtzGeneralizedExponentialFamily &f, const std::size_t i, const GeneralizedExponentialPoints &p, const int max_order, double acc[][block_size])
+{
+    typedef ResidualHelmholtzGeneralizedExponentialFamily Family;
+    const int B = block_size;
+    const double *n = &(f.n[i]), *d = &(f.d[i]), *t = &(f.t[i]);
+    const double *tau = p.tau, *delta = p.delta, *one_over_tau = p.one_over_tau, *one_over_delta = p.one_over_delta;
+
+    // The u part of exp(u) and its derivatives
+    double u[B], du_ddelta[B], d2u_ddelta2[B], d3u_ddelta3[B], d4u_ddelta4[B], du_dtau[B], d2u_dtau2[B], d3u_dtau3[B], d4u_dtau4[B];
+    for (int j = 0; j < B; ++j){
+        u[j] = 0; du_ddelta[j] = 0; d2u_ddelta2[j] = 0; d3u_ddelta3[j] = 0; d4u_ddelta4[j] = 0;
+        du_dtau[j] = 0; d2u_dtau2[j] = 0; d3u_dtau3[j] = 0; d4u_dtau4[j] = 0;
     }
-    if (eta2_in_u){
-        uE += -eta2E*POW2(delta-epsilon2E);
-        du_ddeltaE += -2*eta2E*(delta-epsilon2E);
-        d2u_ddelta2E += -2*eta2E;
+    if (f.type == Family::FAMILY_EXPONENTIAL || f.type == Family::FAMILY_GENERAL){
+        const double *c = &(f.c[i]), *l_int = &(f.l_int[i]), *l_double = &(f.l_double[i]);
+        for (int j = 0; j < B; ++j){
+            const int k = term_step*j, q = point_step*j;
+            const double delta_to_l = vectorized ? exp_vectorizable(l_int[k]*p.log_delta[q]) : pow(delta[q], static_cast<int>(l_int[k]));
+            const double u_increment = -c[k]*delta_to_l;
+            const double du_ddelta_increment = l_double[k]*u_increment*one_over_delta[q];
+            const double d2u_ddelta2_increment = (l_double[k]-1)*du_ddelta_increment*one_over_delta[q];
+            const double d3u_ddelta3_increment = (l_double[k]-2)*d2u_ddelta2_increment*one_over_delta[q];
+            u[j] += u_increment;
+            du_ddelta[j] += du_ddelta_increment;
+            d2u_ddelta2[j] += d2u_ddelta2_increment;
+            d3u_ddelta3[j] += d3u_ddelta3_increment;
+            d4u_ddelta4[j] += (l_double[k]-3)*d3u_ddelta3_increment*one_over_delta[q];
+        }
     }
-    if (beta1_in_u){
-        uE += -beta1E*(tau-gamma1E);
-        du_dtauE += -beta1E;
+    if (f.type == Family::FAMILY_GENERAL){
+        const double *omega = &(f.omega[i]), *m = &(f.m[i]);
+        for (int j = 0; j < B; ++j){
+            const int k = term_step*j, q = point_step*j;
+            const double tau_to_m = vectorized ? exp_vectorizable(m[k]*p.log_tau[q]) : pow(tau[q], m[k]);
+            const double u_increment = -omega[k]*tau_to_m;
+            const double du_dtau_increment = m[k]*u_increment*one_over_tau[q];
+            const double d2u_dtau2_increment = (m[k]-1)*du_dtau_increment*one_over_tau[q];
+            const double d3u_dtau3_increment = (m[k]-2)*d2u_dtau2_increment*one_over_tau[q];
+            u[j] += u_increment;
+            du_dtau[j] += du_dtau_increment;
+            d2u_dtau2[j] += d2u_dtau2_increment;
+            d3u_dtau3[j] += d3u_dtau3_increment;
+            d4u_dtau4[j] += (m[k]-3)*d3u_dtau3_increment*one_over_tau[q];
+        }
     }
-    if (beta2_in_u){
-        uE += -beta2E*POW2(tau-gamma2E);
-        du_dtauE += -2*beta2E*(tau-gamma2E);
-        d2u_dtau2E += -2*beta2E;
+    if (f.type == Family::FAMILY_GAUSSIAN || f.type == Family::FAMILY_GENERAL){
+        const double *eta1 = &(f.eta1[i]), *epsilon1 = &(f.epsilon1[i]), *eta2 = &(f.eta2[i]), *epsilon2 = &(f.epsilon2[i]);
+        const double *beta1 = &(f.beta1[i]), *gamma1 = &(f.gamma1[i]), *beta2 = &(f.beta2[i]), *gamma2 = &(f.gamma2[i]);
+        for (int j = 0; j < B; ++j){
+            const int k = term_step*j, q = point_step*j;
+            u[j] += -eta1[k]*(delta[q]-epsilon1[k]) - eta2[k]*POW2(delta[q]-epsilon2[k]) - beta1[k]*(tau[q]-gamma1[k]) - beta2[k]*POW2(tau[q]-gamma2[k]);
+            du_ddelta[j] += -eta1[k] - 2*eta2[k]*(delta[q]-epsilon2[k]);
+            d2u_ddelta2[j] += -2*eta2[k];
+            du_dtau[j] += -beta1[k] - 2*beta2[k]*(tau[q]-gamma2[k]);
+            d2u_dtau2[j] += -2*beta2[k];
+        }
     }
-    
-    Eigen::ArrayXd ndteuE = nE*exp(tE*log_tau + dE*log_delta + uE);
-    Eigen::ArrayXd B_deltaE = delta*du_ddeltaE + dE;
-    Eigen::ArrayXd B_tauE = tau*du_dtauE + tE;
-    Eigen::ArrayXd B_delta2E = POW2(delta)*(d2u_ddelta2E + du_ddeltaE.square()) + 2*dE*delta*du_ddeltaE + dE*(dE-1);
-    Eigen::ArrayXd B_tau2E = POW2(tau)*(d2u_dtau2E + du_dtauE.square()) + 2*tE*tau*du_dtauE + tE*(tE-1);
-    Eigen::ArrayXd B_delta3E = POW3(delta)*d3u_ddelta3E + 3*dE*POW2(delta)*d2u_ddelta2E+3*POW3(delta)*d2u_ddelta2E*du_ddeltaE+3*dE*POW2(delta*du_ddeltaE)+3*dE*(dE-1)*delta*du_ddeltaE+dE*(dE-1)*(dE-2)+POW3(delta*du_ddeltaE);
-    Eigen::ArrayXd B_tau3E = POW3(tau)*d3u_dtau3E + 3*tE*POW2(tau)*d2u_dtau2E+3*POW3(tau)*d2u_dtau2E*du_dtauE+3*tE*POW2(tau*du_dtauE)+3*tE*(tE-1)*tau*du_dtauE+tE*(tE-1)*(tE-2)+POW3(tau*du_dtauE);
-    
-    derivs.alphar                +=  ndteuE.sum();
-    derivs.dalphar_ddelta        += (ndteuE*B_deltaE).sum()*one_over_delta;
-    derivs.dalphar_dtau          += (ndteuE*B_tauE).sum()*one_over_tau;
-    derivs.d2alphar_ddelta2      += (ndteuE*B_delta2E).sum()*POW2(one_over_delta);
-    derivs.d2alphar_dtau2        += (ndteuE*B_tau2E).sum()*POW2(one_over_tau);
-    derivs.d2alphar_ddelta_dtau  += (ndteuE*B_deltaE*B_tauE).sum()*one_over_delta*one_over_tau;
-    
-    derivs.d3alphar_ddelta3      += (ndteuE*B_delta3E).sum()*POW3(one_over_delta);
-    derivs.d3alphar_dtau3        += (ndteuE*B_tau3E).sum()*POW3(one_over_tau);
-    derivs.d3alphar_ddelta2_dtau += (ndteuE*B_delta2E*B_tauE).sum()*POW2(one_over_delta)*one_over_tau;
-    derivs.d3alphar_ddelta_dtau2 += (ndteuE*B_deltaE*B_tau2E).sum()*one_over_delta*POW2(one_over_tau);
-    
-    return;
+
+    // n*delta^d*tau^t*exp(u), and the B factors from which the derivatives follow, as in all_reference()
+    double ndteu[B], B_delta[B], B_tau[B], dB_delta_ddelta[B], B_delta2[B], dB_tau_dtau[B], B_tau2[B];
+    double d2B_delta_ddelta2[B], B_delta3[B], d2B_tau_dtau2[B], B_tau3[B];
+    for (int j = 0; j < B; ++j){
+        const int k = term_step*j, q = point_step*j;
+        const double x = t[k]*p.log_tau[q] + d[k]*p.log_delta[q] + u[j];
+        ndteu[j] = n[k]*(vectorized ? exp_vectorizable(x) : exp(x));
+        acc[SUM_A][j] += ndteu[j];
+    }
+    if (max_order < 1){ return; }
+    for (int j = 0; j < B; ++j){
+        const int k = term_step*j, q = point_step*j;
+        B_delta[j] = delta[q]*du_ddelta[j] + d[k];
+        B_tau[j] = tau[q]*du_dtau[j] + t[k];
+        acc[SUM_D][j] += ndteu[j]*B_delta[j];
+        acc[SUM_T][j] += ndteu[j]*B_tau[j];
+    }
+    if (max_order < 2){ return; }
+    for (int j = 0; j < B; ++j){
+        const int q = point_step*j;
+        dB_delta_ddelta[j] = delta[q]*d2u_ddelta2[j] + du_ddelta[j];
+        B_delta2[j] = delta[q]*dB_delta_ddelta[j] + (B_delta[j] - 1)*B_delta[j];
+        dB_tau_dtau[j] = tau[q]*d2u_dtau2[j] + du_dtau[j];
+        B_tau2[j] = tau[q]*dB_tau_dtau[j] + (B_tau[j] - 1)*B_tau[j];
+        acc[SUM_DD][j] += ndteu[j]*B_delta2[j];
+        acc[SUM_DT][j] += ndteu[j]*B_delta[j]*B_tau[j];
+        acc[SUM_TT][j] += ndteu[j]*B_tau2[j];
+    }
+    if (max_order < 3){ return; }
+    for (int j = 0; j < B; ++j){
+        const int q = point_step*j;
+        d2B_delta_ddelta2[j] = delta[q]*d3u_ddelta3[j] + 2*d2u_ddelta2[j];
+        const double dB_delta2_ddelta = delta[q]*d2B_delta_ddelta2[j] + 2*B_delta[j]*dB_delta_ddelta[j];
+        B_delta3[j] = delta[q]*dB_delta2_ddelta + (B_delta[j] - 2)*B_delta2[j];
+        d2B_tau_dtau2[j] = tau[q]*d3u_dtau3[j] + 2*d2u_dtau2[j];
+        const double dB_tau2_dtau = tau[q]*d2B_tau_dtau2[j] + 2*B_tau[j]*dB_tau_dtau[j];
+        B_tau3[j] = tau[q]*dB_tau2_dtau + (B_tau[j] - 2)*B_tau2[j];
+        acc[SUM_DDD][j] += ndteu[j]*B_delta3[j];
+        acc[SUM_DDT][j] += ndteu[j]*B_delta2[j]*B_tau[j];
+        acc[SUM_DTT][j] += ndteu[j]*B_delta[j]*B_tau2[j];
+        acc[SUM_TTT][j] += ndteu[j]*B_tau3[j];
+    }
+    if (max_order < 4){ return; }
+    for (int j = 0; j < B; ++j){
+        const int q = point_step*j;
+        const double d3B_delta_ddelta3 = delta[q]*d4u_ddelta4[j] + 3*d3u_ddelta3[j];
+        const double dB_delta3_ddelta = delta[q]*delta[q]*d3B_delta_ddelta3 + 3*delta[q]*B_delta[j]*d2B_delta_ddelta2[j] + 3*delta[q]*POW2(dB_delta_ddelta[j]) + 3*B_delta[j]*(B_delta[j]-1)*dB_delta_ddelta[j];
+        const double B_delta4 = delta[q]*dB_delta3_ddelta + (B_delta[j] - 3)*B_delta3[j];
+        const double d3B_tau_dtau3 = tau[q]*d4u_dtau4[j] + 3*d3u_dtau3[j];
+        const double dB_tau3_dtau = tau[q]*tau[q]*d3B_tau_dtau3 + 3*tau[q]*B_tau[j]*d2B_tau_dtau2[j] + 3*tau[q]*POW2(dB_tau_dtau[j]) + 3*B_tau[j]*(B_tau[j]-1)*dB_tau_dtau[j];
+        const double B_tau4 = tau[q]*dB_tau3_dtau + (B_tau[j] - 3)*B_tau3[j];
+        acc[SUM_DDDD][j] += ndteu[j]*B_delta4;
+        acc[SUM_DDDT][j] += ndteu[j]*B_delta3[j]*B_tau[j];
+        acc[SUM_DDTT][j] += ndteu[j]*B_delta2[j]*B_tau2[j];
+        acc[SUM_DTTT][j] += ndteu[j]*B_delta[j]*B_tau3[j];
+        acc[SUM_TTTT][j] += ndteu[j]*B_tau4;
+    }
+}
+
+/// Add the sums over all the terms of one family at the single point in p[0] to sums, evaluating block_size terms at a time
+template<bool vectorized>
+GENEXP_ALWAYS_INLINE void generalized_exponential_sums(const ResidualHelmholtzGeneralizedExponentialFamily &f, const GeneralizedExponentialPoints &p, const int max_order, double *sums)
+{
+    // Each lane has its own partial sums, so that the additions do not depend on each other
+    double acc[NUMBER_OF_SUMS][block_size];
+    for (int k = 0; k < NUMBER_OF_SUMS; ++k){ for (int j = 0; j < block_size; ++j){ acc[k][j] = 0; } }
+    for (std::size_t i = 0; i < f.size(); i += block_size){
+        generalized_exponential_block<vectorized, 1, 0>(f, i, p, max_order, acc);
+    }
+    for (int k = 0; k < NUMBER_OF_SUMS; ++k){
+        for (int j = 0; j < block_size; ++j){ sums[k] += acc[k][j]; }
+    }
+}
+
+/// Add the sums over all the terms of one family at each of the block_size points in p to acc, evaluating one term at all the points at a time
+template<bool vectorized>
+GENEXP_ALWAYS_INLINE void generalized_exponential_points(const ResidualHelmholtzGeneralizedExponentialFamily &f, const GeneralizedExponentialPoints &p, const int max_order, double acc[][block_size])
+{
+    // Accumulate in a local copy, which cannot alias the coefficients, so that the compiler does not reload them for each lane
+    double acc_local[NUMBER_OF_SUMS][block_size];
+    std::memcpy(acc_local, acc, sizeof(acc_local));
+    for (std::size_t i = 0; i < f.size(); ++i){
+        generalized_exponential_block<vectorized, 0, 1>(f, i, p, max_order, acc_local);
+    }
+    std::memcpy(acc, acc_local, sizeof(acc_local));
+}
+
+typedef void (*generalized_exponential_sums_function)(const ResidualHelmholtzGeneralizedExponentialFamily &, const GeneralizedExponentialPoints &, const int, double *);
+typedef void (*generalized_exponential_points_function)(const ResidualHelmholtzGeneralizedExponentialFamily &, const GeneralizedExponentialPoints &, const int, double [][block_size]);
+
+void generalized_exponential_sums_scalar(const ResidualHelmholtzGeneralizedExponentialFamily &f, const GeneralizedExponentialPoints &p, const int max_order, double *sums){
+    generalized_exponential_sums<false>(f, p, max_order, sums);
+}
+void generalized_exponential_points_scalar(const ResidualHelmholtzGeneralizedExponentialFamily &f, const GeneralizedExponentialPoints &p, const int max_order, double acc[][block_size]){
+    generalized_exponential_points<false>(f, p, max_order, acc);
+}
+#if defined(GENEXP_RUNTIME_DISPATCH)
+__attribute__((target("avx2,fma")))
+void generalized_exponential_sums_avx2(const ResidualHelmholtzGeneralizedExponentialFamily &f, const GeneralizedExponentialPoints &p, const int max_order, double *sums){
+    generalized_exponential_sums<true>(f, p, max_order, sums);
+}
+__attribute__((target("avx2,fma")))
+void generalized_exponential_points_avx2(const ResidualHelmholtzGeneralizedExponentialFamily &f, const GeneralizedExponentialPoints &p, const int max_order, double acc[][block_size]){
+    generalized_exponential_points<true>(f, p, max_order, acc);
+}
+__attribute__((target("avx512f,fma")))
+void generalized_exponential_sums_avx512(const ResidualHelmholtzGeneralizedExponentialFamily &f, const GeneralizedExponentialPoints &p, const int max_order, double *sums){
+    generalized_exponential_sums<true>(f, p, max_order, sums);
+}
+__attribute__((target("avx512f,fma")))
+void generalized_exponential_points_avx512(const ResidualHelmholtzGeneralizedExponentialFamily &f, const GeneralizedExponentialPoints &p, const int max_order, double acc[][block_size]){
+    generalized_exponential_points<true>(f, p, max_order, acc);
+}
+#endif
+
+/// The versions of the kernels that are used, the fastest ones that the processor can run
+struct GeneralizedExponentialKernels{
+    generalized_exponential_sums_function sums;
+    generalized_exponential_points_function points;
+    GeneralizedExponentialKernels() : sums(generalized_exponential_sums_scalar), points(generalized_exponential_points_scalar) {
+        #if defined(GENEXP_RUNTIME_DISPATCH)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")){
+                sums = generalized_exponential_sums_avx512; points = generalized_exponential_points_avx512;
+            }
+            else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")){
+                sums = generalized_exponential_sums_avx2; points = generalized_exponential_points_avx2;
+            }
+        #endif
+    };
 };
-*/
-void ResidualHelmholtzGeneralizedExponential::all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw()
+const GeneralizedExponentialKernels & generalized_exponential_kernels(){
+    static const GeneralizedExponentialKernels kernels;
+    return kernels;
+}
+
+} /* namespace */
+
+bool ResidualHelmholtzGeneralizedExponential::set_kernel(GeneratedHelmholtzKernel kernel)
+{
+    this->kernel = NULL;
+    if (kernel == NULL){ return true; }
+    // Points that cover the range of the terms; the coefficients in the kernel were parsed by another tool, so they can differ in the last bit
+    const CoolPropDbl taus[] = {0.3, 1.0, 2.7}, deltas[] = {0.05, 1.0, 3.1};
+    for (std::size_t i = 0; i < sizeof(taus)/sizeof(taus[0]); ++i){
+        for (std::size_t j = 0; j < sizeof(deltas)/sizeof(deltas[0]); ++j){
+            HelmholtzDerivatives generated, generic;
+            kernel(taus[i], deltas[j], generated, 4);
+            all(taus[i], deltas[j], generic, 4);
+            if (!generated.is_close(generic, 1e-9, 1e-12)){ return false; }
+        }
+    }
+    this->kernel = kernel;
+    return true;
+}
+
+void ResidualHelmholtzGeneralizedExponential::all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs, const int max_order) throw()
+{
+    if (kernel != NULL){ kernel(tau, delta, derivs, max_order); return; }
+    const GeneralizedExponentialKernels &kernels = generalized_exponential_kernels();
+    GeneralizedExponentialPoints p;
+    p.set(0, tau, delta);
+    double sums[NUMBER_OF_SUMS] = {0};
+    for (std::size_t k = 0; k < families.size(); ++k){
+        kernels.sums(families[k], p, max_order, sums);
+    }
+    const CoolPropDbl one_over_delta = p.one_over_delta[0], one_over_tau = p.one_over_tau[0];
+    derivs.alphar                 += sums[SUM_A];
+    if (max_order < 1){ return; }
+    derivs.dalphar_ddelta         += sums[SUM_D]*one_over_delta;
+    derivs.dalphar_dtau           += sums[SUM_T]*one_over_tau;
+    if (max_order < 2){ return; }
+    derivs.d2alphar_ddelta2       += sums[SUM_DD]*POW2(one_over_delta);
+    derivs.d2alphar_dtau2         += sums[SUM_TT]*POW2(one_over_tau);
+    derivs.d2alphar_ddelta_dtau   += sums[SUM_DT]*one_over_delta*one_over_tau;
+    if (max_order < 3){ return; }
+    derivs.d3alphar_ddelta3       += sums[SUM_DDD]*POW3(one_over_delta);
+    derivs.d3alphar_dtau3         += sums[SUM_TTT]*POW3(one_over_tau);
+    derivs.d3alphar_ddelta2_dtau  += sums[SUM_DDT]*POW2(one_over_delta)*one_over_tau;
+    derivs.d3alphar_ddelta_dtau2  += sums[SUM_DTT]*one_over_delta*POW2(one_over_tau);
+    if (max_order < 4){ return; }
+    derivs.d4alphar_ddelta4       += sums[SUM_DDDD]*POW4(one_over_delta);
+    derivs.d4alphar_dtau4         += sums[SUM_TTTT]*POW4(one_over_tau);
+    derivs.d4alphar_ddelta3_dtau  += sums[SUM_DDDT]*POW3(one_over_delta)*one_over_tau;
+    derivs.d4alphar_ddelta2_dtau2 += sums[SUM_DDTT]*POW2(one_over_delta)*POW2(one_over_tau);
+    derivs.d4alphar_ddelta_dtau3  += sums[SUM_DTTT]*one_over_delta*POW3(one_over_tau);
+}
+
+void ResidualHelmholtzGeneralizedExponential::all(const std::vector<CoolPropDbl> &tau, const std::vector<CoolPropDbl> &delta, HelmholtzDerivativesArrays &derivs, const int max_order)
+{
+    if (tau.size() != delta.size()){ throw ValueError(format("Lengths of tau [%d] and delta [%d] are not the same", tau.size(), delta.size())); }
+    if (derivs.size() != tau.size()){ throw ValueError(format("Length of derivs [%d] is not the same as that of tau [%d]", derivs.size(), tau.size())); }
+    const GeneralizedExponentialKernels &kernels = generalized_exponential_kernels();
+    for (std::size_t i0 = 0; i0 < tau.size(); i0 += block_size)
+    {
+        // The last block is padded by repeating its last point
+        const std::size_t Npoints = std::min(static_cast<std::size_t>(block_size), tau.size() - i0);
+        GeneralizedExponentialPoints p;
+        for (std::size_t j = 0; j < static_cast<std::size_t>(block_size); ++j){
+            const std::size_t i = i0 + std::min(j, Npoints - 1);
+            p.set(j, tau[i], delta[i]);
+        }
+        double acc[NUMBER_OF_SUMS][block_size];
+        for (int k = 0; k < NUMBER_OF_SUMS; ++k){ for (int j = 0; j < block_size; ++j){ acc[k][j] = 0; } }
+        for (std::size_t k = 0; k < families.size(); ++k){
+            kernels.points(families[k], p, max_order, acc);
+        }
+        for (std::size_t j = 0; j < Npoints; ++j){
+            const std::size_t i = i0 + j;
+            const CoolPropDbl one_over_delta = p.one_over_delta[j], one_over_tau = p.one_over_tau[j];
+            derivs.alphar[i]                 += acc[SUM_A][j];
+            if (max_order < 1){ continue; }
+            derivs.dalphar_ddelta[i]         += acc[SUM_D][j]*one_over_delta;
+            derivs.dalphar_dtau[i]           += acc[SUM_T][j]*one_over_tau;
+            if (max_order < 2){ continue; }
+            derivs.d2alphar_ddelta2[i]       += acc[SUM_DD][j]*POW2(one_over_delta);
+            derivs.d2alphar_dtau2[i]         += acc[SUM_TT][j]*POW2(one_over_tau);
+            derivs.d2alphar_ddelta_dtau[i]   += acc[SUM_DT][j]*one_over_delta*one_over_tau;
+            if (max_order < 3){ continue; }
+            derivs.d3alphar_ddelta3[i]       += acc[SUM_DDD][j]*POW3(one_over_delta);
+            derivs.d3alphar_dtau3[i]         += acc[SUM_TTT][j]*POW3(one_over_tau);
+            derivs.d3alphar_ddelta2_dtau[i]  += acc[SUM_DDT][j]*POW2(one_over_delta)*one_over_tau;
+            derivs.d3alphar_ddelta_dtau2[i]  += acc[SUM_DTT][j]*one_over_delta*POW2(one_over_tau);
+            if (max_order < 4){ continue; }
+            derivs.d4alphar_ddelta4[i]       += acc[SUM_DDDD][j]*POW4(one_over_delta);
+            derivs.d4alphar_dtau4[i]         += acc[SUM_TTTT][j]*POW4(one_over_tau);
+            derivs.d4alphar_ddelta3_dtau[i]  += acc[SUM_DDDT][j]*POW3(one_over_delta)*one_over_tau;
+            derivs.d4alphar_ddelta2_dtau2[i] += acc[SUM_DDTT][j]*POW2(one_over_delta)*POW2(one_over_tau);
+            derivs.d4alphar_ddelta_dtau3[i]  += acc[SUM_DTTT][j]*one_over_delta*POW3(one_over_tau);
+        }
+    }
+}
+
+void ResidualHelmholtzGeneralizedExponential::all_reference(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs, const int max_order) throw()
 {
     CoolPropDbl log_tau = log(tau), log_delta = log(delta), ndteu, 
                 one_over_delta = 1/delta, one_over_tau = 1/tau; // division is much slower than multiplication, so do one division here
@@ -222,49 +525,47 @@ void ResidualHelmholtzGeneralizedExponential::all(const CoolPropDbl &tau, const
         }
         
         ndteu = ni*exp(ti*log_tau + di*log_delta + u);
-        
-        const CoolPropDbl dB_delta_ddelta = delta*d2u_ddelta2 + du_ddelta;
-        const CoolPropDbl d2B_delta_ddelta2 = delta*d3u_ddelta3 + 2*d2u_ddelta2;
-        const CoolPropDbl d3B_delta_ddelta3 = delta*d4u_ddelta4 + 3*d3u_ddelta3;
-		
-		const CoolPropDbl B_delta = (delta*du_ddelta + di);
-        const CoolPropDbl B_delta2 = delta*dB_delta_ddelta + (B_delta - 1)*B_delta;
-        const CoolPropDbl dB_delta2_ddelta = delta*d2B_delta_ddelta2 + 2*B_delta*dB_delta_ddelta;
-        const CoolPropDbl B_delta3 = delta*dB_delta2_ddelta + (B_delta -  2)*B_delta2;
-        const CoolPropDbl dB_delta3_ddelta = delta*delta*d3B_delta_ddelta3 + 3*delta*B_delta*d2B_delta_ddelta2 + 3*delta*POW2(dB_delta_ddelta)+3*B_delta*(B_delta-1)*dB_delta_ddelta;
-        const CoolPropDbl B_delta4 = delta*dB_delta3_ddelta + (B_delta -  3)*B_delta3;
-        
-		const CoolPropDbl dB_tau_dtau = tau*d2u_dtau2 + du_dtau;
-        const CoolPropDbl d2B_tau_dtau2 = tau*d3u_dtau3 + 2*d2u_dtau2;
-        const CoolPropDbl d3B_tau_dtau3 = tau*d4u_dtau4 + 3*d3u_dtau3;
-        
-		const CoolPropDbl B_tau = (tau*du_dtau + ti);
-		const CoolPropDbl B_tau2 = tau*dB_tau_dtau + (B_tau - 1)*B_tau;
-        const CoolPropDbl dB_tau2_dtau = tau*d2B_tau_dtau2 + 2*B_tau*dB_tau_dtau;
-        const CoolPropDbl B_tau3 = tau*dB_tau2_dtau + (B_tau -  2)*B_tau2;
-        const CoolPropDbl dB_tau3_dtau = tau*tau*d3B_tau_dtau3 + 3*tau*B_tau*d2B_tau_dtau2 + 3*tau*POW2(dB_tau_dtau)+3*B_tau*(B_tau-1)*dB_tau_dtau;
-        const CoolPropDbl B_tau4 = tau*dB_tau3_dtau + (B_tau -  3)*B_tau3;
-
         derivs.alphar += ndteu;
+        if (max_order < 1){ continue; }
         
+        const CoolPropDbl B_delta = (delta*du_ddelta + di);
+        const CoolPropDbl B_tau = (tau*du_dtau + ti);
         derivs.dalphar_ddelta += ndteu*B_delta;
         derivs.dalphar_dtau += ndteu*B_tau;
+        if (max_order < 2){ continue; }
         
+        const CoolPropDbl dB_delta_ddelta = delta*d2u_ddelta2 + du_ddelta;
+        const CoolPropDbl B_delta2 = delta*dB_delta_ddelta + (B_delta - 1)*B_delta;
+        const CoolPropDbl dB_tau_dtau = tau*d2u_dtau2 + du_dtau;
+        const CoolPropDbl B_tau2 = tau*dB_tau_dtau + (B_tau - 1)*B_tau;
         derivs.d2alphar_ddelta2 += ndteu*B_delta2;
         derivs.d2alphar_ddelta_dtau += ndteu*B_delta*B_tau;
         derivs.d2alphar_dtau2 += ndteu*B_tau2;
+        if (max_order < 3){ continue; }
         
+        const CoolPropDbl d2B_delta_ddelta2 = delta*d3u_ddelta3 + 2*d2u_ddelta2;
+        const CoolPropDbl dB_delta2_ddelta = delta*d2B_delta_ddelta2 + 2*B_delta*dB_delta_ddelta;
+        const CoolPropDbl B_delta3 = delta*dB_delta2_ddelta + (B_delta -  2)*B_delta2;
+        const CoolPropDbl d2B_tau_dtau2 = tau*d3u_dtau3 + 2*d2u_dtau2;
+        const CoolPropDbl dB_tau2_dtau = tau*d2B_tau_dtau2 + 2*B_tau*dB_tau_dtau;
+        const CoolPropDbl B_tau3 = tau*dB_tau2_dtau + (B_tau -  2)*B_tau2;
         derivs.d3alphar_ddelta3 += ndteu*B_delta3;
         derivs.d3alphar_ddelta2_dtau += ndteu*B_delta2*B_tau;
         derivs.d3alphar_ddelta_dtau2 += ndteu*B_delta*B_tau2;
         derivs.d3alphar_dtau3 += ndteu*B_tau3;
-
+        if (max_order < 4){ continue; }
+        
+        const CoolPropDbl d3B_delta_ddelta3 = delta*d4u_ddelta4 + 3*d3u_ddelta3;
+        const CoolPropDbl dB_delta3_ddelta = delta*delta*d3B_delta_ddelta3 + 3*delta*B_delta*d2B_delta_ddelta2 + 3*delta*POW2(dB_delta_ddelta)+3*B_delta*(B_delta-1)*dB_delta_ddelta;
+        const CoolPropDbl B_delta4 = delta*dB_delta3_ddelta + (B_delta -  3)*B_delta3;
+        const CoolPropDbl d3B_tau_dtau3 = tau*d4u_dtau4 + 3*d3u_dtau3;
+        const CoolPropDbl dB_tau3_dtau = tau*tau*d3B_tau_dtau3 + 3*tau*B_tau*d2B_tau_dtau2 + 3*tau*POW2(dB_tau_dtau)+3*B_tau*(B_tau-1)*dB_tau_dtau;
+        const CoolPropDbl B_tau4 = tau*dB_tau3_dtau + (B_tau -  3)*B_tau3;
         derivs.d4alphar_ddelta4 += ndteu*B_delta4;
         derivs.d4alphar_ddelta3_dtau += ndteu*B_delta3*B_tau;
         derivs.d4alphar_ddelta2_dtau2 += ndteu*B_delta2*B_tau2;
         derivs.d4alphar_ddelta_dtau3 += ndteu*B_delta*B_tau3;
         derivs.d4alphar_dtau4 += ndteu*B_tau4;
-
     }
     derivs.dalphar_ddelta         *= one_over_delta;
     derivs.dalphar_dtau           *= one_over_tau;
@@ -315,7 +616,7 @@ void ResidualHelmholtzNonAnalytic::to_json(rapidjson::Value &el, rapidjson::Docu
     el.AddMember("D",_D,doc.GetAllocator());
 }
 
-void ResidualHelmholtzNonAnalytic::all(const CoolPropDbl &tau_in, const CoolPropDbl &delta_in, HelmholtzDerivatives &derivs) throw()
+void ResidualHelmholtzNonAnalytic::all(const CoolPropDbl &tau_in, const CoolPropDbl &delta_in, HelmholtzDerivatives &derivs, const int max_order) throw()
 {
     if (N==0){return;}
     
@@ -335,68 +636,94 @@ void ResidualHelmholtzNonAnalytic::all(const CoolPropDbl &tau_in, const CoolProp
         const CoolPropDbl ni = el.n, ai = el.a, bi = el.b, betai = el.beta;
         const CoolPropDbl Ai = el.A, Bi = el.B, Ci = el.C, Di = el.D;
 
+        // Only the intermediate quantities that are needed for derivatives up to max_order are calculated
         // Derivatives of theta (all others are zero) (OK - checked)
         // Do not factor because then when delta = 1 you are dividing by 0
         const CoolPropDbl theta = (1.0-tau)+Ai*pow(POW2(delta-1.0), 1.0/(2.0*betai));
-        const CoolPropDbl dtheta_dTau = -1;
-        const CoolPropDbl dtheta_dDelta = Ai/(betai)*pow(POW2(delta-1), 1/(2*betai)-1)*(delta-1);
-        
-        const CoolPropDbl d2theta_dDelta2 = Ai/betai*(1/betai-1)*pow(POW2(delta-1), 1/(2*betai)-1);
-        const CoolPropDbl d3theta_dDelta3 = Ai/betai*(2-3/betai+1/POW2(betai))*pow(POW2(delta-1), 1/(2*betai))/POW3(delta-1);
-        const CoolPropDbl d4theta_dDelta4 = Ai/betai*(-6+11/betai-6/POW2(betai)+1/POW3(betai))*pow(POW2(delta-1), 1/(2*betai)-2);
 
         // Derivatives of PSI (OK - checked)
         const CoolPropDbl PSI = exp(-Ci*POW2(delta-1.0)-Di*POW2(tau-1.0));
+
+        // Derivatives of DELTA (OK - Checked)
+        const CoolPropDbl DELTA = POW2(theta)+Bi*pow(POW2(delta-1.0),ai);
+        const CoolPropDbl DELTA_bi = pow(DELTA, bi);
+
+        derivs.alphar += delta*ni*DELTA_bi*PSI;
+        if (max_order < 1){ continue; }
+
+        const CoolPropDbl dtheta_dTau = -1;
+        const CoolPropDbl dtheta_dDelta = Ai/(betai)*pow(POW2(delta-1), 1/(2*betai)-1)*(delta-1);
         const CoolPropDbl dPSI_dDelta_over_PSI = -2.0*Ci*(delta-1.0);
         const CoolPropDbl dPSI_dDelta = dPSI_dDelta_over_PSI*PSI;
         const CoolPropDbl dPSI_dTau_over_PSI = -2.0*Di*(tau-1.0);
         const CoolPropDbl dPSI_dTau = dPSI_dTau_over_PSI*PSI;
+        const CoolPropDbl dDELTA_dTau = 2*theta*dtheta_dTau;
+        const CoolPropDbl dDELTA_dDelta = 2*theta*dtheta_dDelta + 2*Bi*ai*pow(POW2(delta-1.0), ai-1.0)*(delta - 1);
+        const CoolPropDbl dDELTAbi_dDelta = bi*pow(DELTA,bi-1.0)*dDELTA_dDelta;
+        const CoolPropDbl dDELTAbi_dTau = -2.0*theta*bi*pow(DELTA,bi-1.0);
+
+        // First partials
+        derivs.dalphar_dtau += ni*delta*(DELTA_bi*dPSI_dTau + dDELTAbi_dTau*PSI);
+        derivs.dalphar_ddelta += ni*(DELTA_bi*(PSI+delta*dPSI_dDelta) + dDELTAbi_dDelta*delta*PSI);
+        if (max_order < 2){ continue; }
+
+        const CoolPropDbl d2theta_dDelta2 = Ai/betai*(1/betai-1)*pow(POW2(delta-1), 1/(2*betai)-1);
         const CoolPropDbl d2PSI_dDelta2_over_PSI = (2.0*Ci*POW2(delta-1.0)-1.0)*2.0*Ci;
         const CoolPropDbl d2PSI_dDelta2 = d2PSI_dDelta2_over_PSI*PSI;
-        const CoolPropDbl d3PSI_dDelta3 = 2*Ci*PSI*(-4*Ci*Ci*POW3(delta-1)+6*Ci*(delta-1));
-        const CoolPropDbl d4PSI_dDelta4 = 4*Ci*Ci*PSI*(4*Ci*Ci*POW4(delta-1) - 12*Ci*POW2(delta-1) + 3);
         const CoolPropDbl d2PSI_dTau2 = (2.0*Di*POW2(tau-1.0)-1.0)*2.0*Di*PSI;
-        const CoolPropDbl d3PSI_dTau3 = 2.0*Di*PSI*(-4*Di*Di*POW3(tau-1) + 6*Di*(tau-1));
-        const CoolPropDbl d4PSI_dTau4 = 4*Di*Di*PSI*(4*Di*Di*POW4(tau-1) - 12*Di*POW2(tau-1) + 3);
         const CoolPropDbl d2PSI_dDelta_dTau = dPSI_dDelta*dPSI_dTau_over_PSI;
-        const CoolPropDbl d3PSI_dDelta2_dTau = d2PSI_dDelta2*dPSI_dTau_over_PSI;
-        const CoolPropDbl d3PSI_dDelta_dTau2 = d2PSI_dTau2*dPSI_dDelta_over_PSI;
-        const CoolPropDbl d4PSI_dDelta_dTau3 = d3PSI_dTau3*dPSI_dDelta_over_PSI;
-        const CoolPropDbl d4PSI_dDelta2_dTau2 = d2PSI_dTau2*d2PSI_dDelta2_over_PSI;
-        const CoolPropDbl d4PSI_dDelta3_dTau = d3PSI_dDelta3*dPSI_dTau_over_PSI;
-        
-        
-
-        // Derivatives of DELTA (OK - Checked)
-        const CoolPropDbl DELTA = POW2(theta)+Bi*pow(POW2(delta-1.0),ai);
-        const CoolPropDbl dDELTA_dTau = 2*theta*dtheta_dTau;
-        const CoolPropDbl dDELTA_dDelta = 2*theta*dtheta_dDelta + 2*Bi*ai*pow(POW2(delta-1.0), ai-1.0)*(delta - 1);
         const CoolPropDbl d2DELTA_dTau2 = 2; // d2theta_dTau2 is zero and (dtheta_dtau)^2 = 1
         const CoolPropDbl d2DELTA_dDelta_dTau = 2*dtheta_dTau*dtheta_dDelta; // d2theta_dDelta2 is zero
         const CoolPropDbl d2DELTA_dDelta2 = 2*(theta*d2theta_dDelta2 + POW2(dtheta_dDelta) + Bi*(2*ai*ai-ai)*pow(POW2(delta-1.0), ai-1.0));
+        const CoolPropDbl d2DELTAbi_dDelta2 = bi*(pow(DELTA,bi-1)*d2DELTA_dDelta2+(bi-1.0)*pow(DELTA,bi-2.0)*pow(dDELTA_dDelta,2));
+        const CoolPropDbl d2DELTAbi_dDelta_dTau = -Ai*bi*2.0/betai*pow(DELTA,bi-1.0)*(delta-1.0)*pow(pow(delta-1.0,2),1.0/(2.0*betai)-1.0)-2.0*theta*bi*(bi-1.0)*pow(DELTA,bi-2.0)*dDELTA_dDelta;
+        const CoolPropDbl d2DELTAbi_dTau2 = 2.0*bi*pow(DELTA,bi-1.0)+4.0*pow(theta,2)*bi*(bi-1.0)*pow(DELTA,bi-2.0);
+
+        // Second partials
+        derivs.d2alphar_dtau2 += ni*delta*(d2DELTAbi_dTau2*PSI + 2*dDELTAbi_dTau*dPSI_dTau + DELTA_bi*d2PSI_dTau2);
+        derivs.d2alphar_ddelta_dtau += ni*(DELTA_bi*(dPSI_dTau+delta*d2PSI_dDelta_dTau)+delta*dDELTAbi_dDelta*dPSI_dTau+ dDELTAbi_dTau*(PSI+delta*dPSI_dDelta)+d2DELTAbi_dDelta_dTau*delta*PSI);
+        derivs.d2alphar_ddelta2 += ni*(DELTA_bi*(2.0*dPSI_dDelta + delta*d2PSI_dDelta2) + 2.0*dDELTAbi_dDelta*(PSI+delta*dPSI_dDelta) + d2DELTAbi_dDelta2*delta*PSI);
+        if (max_order < 3){ continue; }
+
+        const CoolPropDbl d3theta_dDelta3 = Ai/betai*(2-3/betai+1/POW2(betai))*pow(POW2(delta-1), 1/(2*betai))/POW3(delta-1);
+        const CoolPropDbl d3PSI_dDelta3 = 2*Ci*PSI*(-4*Ci*Ci*POW3(delta-1)+6*Ci*(delta-1));
+        const CoolPropDbl d3PSI_dTau3 = 2.0*Di*PSI*(-4*Di*Di*POW3(tau-1) + 6*Di*(tau-1));
+        const CoolPropDbl d3PSI_dDelta2_dTau = d2PSI_dDelta2*dPSI_dTau_over_PSI;
+        const CoolPropDbl d3PSI_dDelta_dTau2 = d2PSI_dTau2*dPSI_dDelta_over_PSI;
         const CoolPropDbl d3DELTA_dTau3 = 0;
         const CoolPropDbl d3DELTA_dDelta_dTau2 = 0;
         const CoolPropDbl d3DELTA_dDelta2_dTau = 2*dtheta_dTau*d2theta_dDelta2;
         const CoolPropDbl d3DELTA_dDelta3 = 2*(theta*d3theta_dDelta3 + 3*dtheta_dDelta*d2theta_dDelta2 + 2*Bi*ai*(2*ai*ai - 3*ai + 1)*pow(POW2(delta-1.0), ai-1.0)/(delta-1));
+        const CoolPropDbl d3DELTAbi_dDelta3 = bi*(pow(DELTA,bi-1)*d3DELTA_dDelta3+d2DELTA_dDelta2*(bi-1)*pow(DELTA,bi-2)*dDELTA_dDelta+(bi-1)*(pow(DELTA,bi-2)*2*dDELTA_dDelta*d2DELTA_dDelta2+pow(dDELTA_dDelta,2)*(bi-2)*pow(DELTA,bi-3)*dDELTA_dDelta));
+        const CoolPropDbl d3DELTAbi_dTau3 = -12.0*theta*bi*(bi-1.0)*pow(DELTA,bi-2)-8*pow(theta,3)*bi*(bi-1)*(bi-2)*pow(DELTA,bi-3);
+        const CoolPropDbl d3DELTAbi_dDelta_dTau2 = 2*bi*(bi-1)*pow(DELTA,bi-2)*dDELTA_dDelta+4*pow(theta,2)*bi*(bi-1)*(bi-2)*pow(DELTA,bi-3)*dDELTA_dDelta+8*theta*bi*(bi-1)*pow(DELTA,bi-2)*dtheta_dDelta;
+        const CoolPropDbl d3DELTAbi_dDelta2_dTau = bi*((bi-1)*pow(DELTA,bi-2)*dDELTA_dTau*d2DELTA_dDelta2 + pow(DELTA,bi-1)*d3DELTA_dDelta2_dTau+(bi-1)*((bi-2)*pow(DELTA,bi-3)*dDELTA_dTau*pow(dDELTA_dDelta,2)+pow(DELTA,bi-2)*2*dDELTA_dDelta*d2DELTA_dDelta_dTau));
+
+        // Third partials
+        derivs.d3alphar_dtau3 += ni*delta*(d3DELTAbi_dTau3*PSI + 3*d2DELTAbi_dTau2*dPSI_dTau + 3*dDELTAbi_dTau*d2PSI_dTau2 + DELTA_bi*d3PSI_dTau3);
+        derivs.d3alphar_ddelta_dtau2 += ni*delta*(d2DELTAbi_dTau2*dPSI_dDelta + d3DELTAbi_dDelta_dTau2*PSI + 2*dDELTAbi_dTau*d2PSI_dDelta_dTau + 
+                                                  2.0*d2DELTAbi_dDelta_dTau*dPSI_dTau + DELTA_bi*d3PSI_dDelta_dTau2+dDELTAbi_dDelta*d2PSI_dTau2) + 
+                                                  ni*(d2DELTAbi_dTau2*PSI + 2.0*dDELTAbi_dTau*dPSI_dTau + DELTA_bi*d2PSI_dTau2);
+        derivs.d3alphar_ddelta3 += ni*(DELTA_bi*(3*d2PSI_dDelta2 + delta*d3PSI_dDelta3)
+                                       + 3*dDELTAbi_dDelta*(2*dPSI_dDelta + delta*d2PSI_dDelta2)
+                                       + 3*d2DELTAbi_dDelta2*(PSI + delta*dPSI_dDelta) + d3DELTAbi_dDelta3*PSI*delta);
+        CoolPropDbl Line1 = DELTA_bi*(2*d2PSI_dDelta_dTau + delta*d3PSI_dDelta2_dTau) + dDELTAbi_dTau*(2*dPSI_dDelta+delta*d2PSI_dDelta2);
+        CoolPropDbl Line2 = 2*dDELTAbi_dDelta*(dPSI_dTau+delta*d2PSI_dDelta_dTau) + 2*d2DELTAbi_dDelta_dTau*(PSI+delta*dPSI_dDelta);
+        CoolPropDbl Line3 = d2DELTAbi_dDelta2*delta*dPSI_dTau + d3DELTAbi_dDelta2_dTau*delta*PSI;
+        derivs.d3alphar_ddelta2_dtau += ni*(Line1 + Line2 + Line3);
+        if (max_order < 4){ continue; }
 
+        const CoolPropDbl d4theta_dDelta4 = Ai/betai*(-6+11/betai-6/POW2(betai)+1/POW3(betai))*pow(POW2(delta-1), 1/(2*betai)-2);
+        const CoolPropDbl d4PSI_dDelta4 = 4*Ci*Ci*PSI*(4*Ci*Ci*POW4(delta-1) - 12*Ci*POW2(delta-1) + 3);
+        const CoolPropDbl d4PSI_dTau4 = 4*Di*Di*PSI*(4*Di*Di*POW4(tau-1) - 12*Di*POW2(tau-1) + 3);
+        const CoolPropDbl d4PSI_dDelta_dTau3 = d3PSI_dTau3*dPSI_dDelta_over_PSI;
+        const CoolPropDbl d4PSI_dDelta2_dTau2 = d2PSI_dTau2*d2PSI_dDelta2_over_PSI;
+        const CoolPropDbl d4PSI_dDelta3_dTau = d3PSI_dDelta3*dPSI_dTau_over_PSI;
         const CoolPropDbl d4DELTA_dTau4 = 0;
         const CoolPropDbl d4DELTA_dDelta_dTau3 = 0;
         const CoolPropDbl d4DELTA_dDelta2_dTau2 = 0;
         const CoolPropDbl d4DELTA_dDelta3_dTau = 2*dtheta_dTau*d3theta_dDelta3;
         const CoolPropDbl d4DELTA_dDelta4 = 2*(theta*d4theta_dDelta4 + 4*dtheta_dDelta*d3theta_dDelta3 + 3*POW2(d2theta_dDelta2) + 2*Bi*ai*(4*ai*ai*ai - 12*ai*ai + 11*ai-3)*pow(POW2(delta-1.0), ai-2.0));
- 
-        const CoolPropDbl dDELTAbi_dDelta = bi*pow(DELTA,bi-1.0)*dDELTA_dDelta;
-        const CoolPropDbl dDELTAbi_dTau = -2.0*theta*bi*pow(DELTA,bi-1.0);
-        const CoolPropDbl d2DELTAbi_dDelta2 = bi*(pow(DELTA,bi-1)*d2DELTA_dDelta2+(bi-1.0)*pow(DELTA,bi-2.0)*pow(dDELTA_dDelta,2));
-        const CoolPropDbl d3DELTAbi_dDelta3 = bi*(pow(DELTA,bi-1)*d3DELTA_dDelta3+d2DELTA_dDelta2*(bi-1)*pow(DELTA,bi-2)*dDELTA_dDelta+(bi-1)*(pow(DELTA,bi-2)*2*dDELTA_dDelta*d2DELTA_dDelta2+pow(dDELTA_dDelta,2)*(bi-2)*pow(DELTA,bi-3)*dDELTA_dDelta));
-        const CoolPropDbl d2DELTAbi_dDelta_dTau = -Ai*bi*2.0/betai*pow(DELTA,bi-1.0)*(delta-1.0)*pow(pow(delta-1.0,2),1.0/(2.0*betai)-1.0)-2.0*theta*bi*(bi-1.0)*pow(DELTA,bi-2.0)*dDELTA_dDelta;
-        const CoolPropDbl d2DELTAbi_dTau2 = 2.0*bi*pow(DELTA,bi-1.0)+4.0*pow(theta,2)*bi*(bi-1.0)*pow(DELTA,bi-2.0);
-        const CoolPropDbl d3DELTAbi_dTau3 = -12.0*theta*bi*(bi-1.0)*pow(DELTA,bi-2)-8*pow(theta,3)*bi*(bi-1)*(bi-2)*pow(DELTA,bi-3);
-        const CoolPropDbl d3DELTAbi_dDelta_dTau2 = 2*bi*(bi-1)*pow(DELTA,bi-2)*dDELTA_dDelta+4*pow(theta,2)*bi*(bi-1)*(bi-2)*pow(DELTA,bi-3)*dDELTA_dDelta+8*theta*bi*(bi-1)*pow(DELTA,bi-2)*dtheta_dDelta;
-        const CoolPropDbl d3DELTAbi_dDelta2_dTau = bi*((bi-1)*pow(DELTA,bi-2)*dDELTA_dTau*d2DELTA_dDelta2 + pow(DELTA,bi-1)*d3DELTA_dDelta2_dTau+(bi-1)*((bi-2)*pow(DELTA,bi-3)*dDELTA_dTau*pow(dDELTA_dDelta,2)+pow(DELTA,bi-2)*2*dDELTA_dDelta*d2DELTA_dDelta_dTau));
-
-        // Fourth partials
-        const CoolPropDbl DELTA_bi = pow(DELTA, bi);
         const CoolPropDbl d4DELTAbi_dTau4 = bi*DELTA_bi/DELTA*((POW3(bi) - 6*POW2(bi) + 11*bi - 6)*POW4(dDELTA_dTau)/POW3(DELTA)
                                                                + 6*(bi*bi - 3*bi + 2)*POW2(dDELTA_dTau/DELTA)*d2DELTA_dTau2
                                                                + 4*(bi - 1)*dDELTA_dTau/DELTA*d3DELTA_dTau3
@@ -425,38 +752,13 @@ void ResidualHelmholtzNonAnalytic::all(const CoolPropDbl &tau_in, const CoolProp
                                +2*(bi-1)*POW2(DELTA)*dDELTA_dDelta*d3DELTA_dDelta_dTau2 // Red sharp
                                +(bi-1)*POW2(DELTA)*d2DELTA_dDelta2*d2DELTA_dTau2 // black sharp
                                +POW3(DELTA)*d4DELTA_dDelta2_dTau2);
-        
-        derivs.alphar += delta*ni*DELTA_bi*PSI;
-        
-        // First partials
-        derivs.dalphar_dtau += ni*delta*(DELTA_bi*dPSI_dTau + dDELTAbi_dTau*PSI);
-        derivs.dalphar_ddelta += ni*(DELTA_bi*(PSI+delta*dPSI_dDelta) + dDELTAbi_dDelta*delta*PSI);
-        
-        // Second partials
-        derivs.d2alphar_dtau2 += ni*delta*(d2DELTAbi_dTau2*PSI + 2*dDELTAbi_dTau*dPSI_dTau + DELTA_bi*d2PSI_dTau2);
-        derivs.d2alphar_ddelta_dtau += ni*(DELTA_bi*(dPSI_dTau+delta*d2PSI_dDelta_dTau)+delta*dDELTAbi_dDelta*dPSI_dTau+ dDELTAbi_dTau*(PSI+delta*dPSI_dDelta)+d2DELTAbi_dDelta_dTau*delta*PSI);
-        derivs.d2alphar_ddelta2 += ni*(DELTA_bi*(2.0*dPSI_dDelta + delta*d2PSI_dDelta2) + 2.0*dDELTAbi_dDelta*(PSI+delta*dPSI_dDelta) + d2DELTAbi_dDelta2*delta*PSI);
-        
-        // Third partials
-        derivs.d3alphar_dtau3 += ni*delta*(d3DELTAbi_dTau3*PSI + 3*d2DELTAbi_dTau2*dPSI_dTau + 3*dDELTAbi_dTau*d2PSI_dTau2 + DELTA_bi*d3PSI_dTau3);
-        derivs.d3alphar_ddelta_dtau2 += ni*delta*(d2DELTAbi_dTau2*dPSI_dDelta + d3DELTAbi_dDelta_dTau2*PSI + 2*dDELTAbi_dTau*d2PSI_dDelta_dTau + 
-                                                  2.0*d2DELTAbi_dDelta_dTau*dPSI_dTau + DELTA_bi*d3PSI_dDelta_dTau2+dDELTAbi_dDelta*d2PSI_dTau2) + 
-                                                  ni*(d2DELTAbi_dTau2*PSI + 2.0*dDELTAbi_dTau*dPSI_dTau + DELTA_bi*d2PSI_dTau2);
-        derivs.d3alphar_ddelta3 += ni*(DELTA_bi*(3*d2PSI_dDelta2 + delta*d3PSI_dDelta3)
-                                       + 3*dDELTAbi_dDelta*(2*dPSI_dDelta + delta*d2PSI_dDelta2)
-                                       + 3*d2DELTAbi_dDelta2*(PSI + delta*dPSI_dDelta) + d3DELTAbi_dDelta3*PSI*delta);
-        CoolPropDbl Line1 = DELTA_bi*(2*d2PSI_dDelta_dTau + delta*d3PSI_dDelta2_dTau) + dDELTAbi_dTau*(2*dPSI_dDelta+delta*d2PSI_dDelta2);
-        CoolPropDbl Line2 = 2*dDELTAbi_dDelta*(dPSI_dTau+delta*d2PSI_dDelta_dTau) + 2*d2DELTAbi_dDelta_dTau*(PSI+delta*dPSI_dDelta);
-        CoolPropDbl Line3 = d2DELTAbi_dDelta2*delta*dPSI_dTau + d3DELTAbi_dDelta2_dTau*delta*PSI;
-        derivs.d3alphar_ddelta2_dtau += ni*(Line1 + Line2 + Line3);
-        
+
         // Fourth partials
         derivs.d4alphar_dtau4 += ni*delta*(DELTA_bi*d4PSI_dTau4 + 4*dDELTAbi_dTau*d3PSI_dTau3 + 6*d2DELTAbi_dTau2*d2PSI_dTau2 + 4*d3DELTAbi_dTau3*dPSI_dTau + PSI*d4DELTAbi_dTau4);
         derivs.d4alphar_ddelta4 += ni*(delta*DELTA_bi*d4PSI_dDelta4 + delta*PSI*d4DELTAbi_dDelta4 + 4*delta*dDELTAbi_dDelta*d3PSI_dDelta3
                                        + 4*delta*dPSI_dDelta*d3DELTAbi_dDelta3 + 6*delta*d2DELTAbi_dDelta2*d2PSI_dDelta2
                                        + 4*DELTA_bi*d3PSI_dDelta3 + 4*PSI*d3DELTAbi_dDelta3 + 12*dDELTAbi_dDelta*d2PSI_dDelta2
                                        + 12*dPSI_dDelta*d2DELTAbi_dDelta2);
-        
         derivs.d4alphar_ddelta_dtau3 += ni*(delta*DELTA_bi*d4PSI_dDelta_dTau3 + delta*PSI*d4DELTAbi_dDelta_dTau3 + delta*dDELTAbi_dDelta*d3PSI_dTau3
                                             + 3*delta*dDELTAbi_dTau*d3PSI_dDelta_dTau2 + delta*dPSI_dDelta*d3DELTAbi_dTau3 + 3*delta*dPSI_dTau*d3DELTAbi_dDelta_dTau2 
                                             + 3*delta*d2DELTAbi_dDelta_dTau*d2PSI_dTau2 + 3*delta*d2DELTAbi_dTau2*d2PSI_dDelta_dTau+DELTA_bi*d3PSI_dTau3
@@ -474,7 +776,7 @@ void ResidualHelmholtzNonAnalytic::all(const CoolPropDbl &tau_in, const CoolProp
     }
 }
 
-void ResidualHelmholtzSRK::all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw()
+void ResidualHelmholtzSRK::all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs, const int max_order) throw()
 {
     if (!enabled){ return; }
 
@@ -489,18 +791,22 @@ void ResidualHelmholtzSRK::all(const CoolPropDbl &tau, const CoolPropDbl &delta,
     CoolPropDbl d4amix_dTau4 = 3.0*a*kappa/8.0*(29.0*kappa/pow(tau, 5)-35/pow(tau, static_cast<CoolPropDbl>(9.0L/2.0))*kappa_times_Trbracket);
 
     derivs.alphar += -log(1-b*delta*rhor)-tau*amix/(R*Treducing*b)*log(b*delta*rhor + 1);
+    if (max_order < 1){ return; }
 
     derivs.dalphar_ddelta += 1/(R*Treducing*b)*(-R*Treducing*b/(delta-1/(b*rhor))-b*rhor*tau*amix/(b*delta*rhor+1));
     derivs.dalphar_dtau += -log(b*delta*rhor+1)/(R*Treducing*b)*(tau*damix_dTau + amix);
+    if (max_order < 2){ return; }
 
     derivs.d2alphar_ddelta2 += 1/(R*Treducing)*(R*Treducing/pow(delta-1/(b*rhor), 2)+b*tau*amix*pow(rhor/(b*delta*rhor+1), 2));
     derivs.d2alphar_ddelta_dtau += -1/(R*Treducing*b)*(b*rhor*tau*damix_dTau + b*rhor*amix)/(b*delta*rhor+1);
     derivs.d2alphar_dtau2 += -log(b*delta*rhor+1)/(R*Treducing*b)*(tau*d2amix_dTau2 + 2*damix_dTau);
+    if (max_order < 3){ return; }
 
     derivs.d3alphar_ddelta3 += -1/(R*Treducing)*(2*R*Treducing/pow(delta-1/(b*rhor), 3)+2*b*b*tau*amix*pow(rhor/(b*delta*rhor+1), 3));
     derivs.d3alphar_ddelta2_dtau += b*rhor*rhor*(tau*damix_dTau+amix)/(R*Treducing*pow(b*delta*rhor+1, 2));
     derivs.d3alphar_ddelta_dtau2 += -rhor*(tau*d2amix_dTau2+2*damix_dTau)/(R*Treducing*(b*delta*rhor+1));
     derivs.d3alphar_dtau3 += -log(b*delta*rhor+1)/(R*Treducing*b)*(tau*d3amix_dTau3 + 3*d2amix_dTau2);
+    if (max_order < 4){ return; }
 
     derivs.d4alphar_ddelta4 += 1/(R*Treducing)*(6*R*Treducing/pow(delta-1/(b*rhor), 4)+6*b*b*b*tau*amix*pow(rhor/(b*delta*rhor+1), 4));
     derivs.d4alphar_ddelta3_dtau += -2*b*b*rhor*rhor*rhor*(tau*damix_dTau+amix)/(R*Treducing*pow(b*delta*rhor+1,3));
@@ -545,16 +851,16 @@ ResidualHelmholtzXiangDeiters::ResidualHelmholtzXiangDeiters(
     enabled = true;
 };
 
-void ResidualHelmholtzXiangDeiters::all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs) throw()
+void ResidualHelmholtzXiangDeiters::all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &derivs, const int max_order) throw()
 {
     if (!enabled){ return; }
 
     HelmholtzDerivatives derivs0, derivs1, derivs2;
 
     // Calculate each of the derivative terms
-    phi0.all(tau, delta, derivs0);
-    phi1.all(tau, delta, derivs1);
-    phi2.all(tau, delta, derivs2);
+    phi0.all(tau, delta, derivs0, max_order);
+    phi1.all(tau, delta, derivs1, max_order);
+    phi2.all(tau, delta, derivs2, max_order);
 
     // Add up the contributions
     derivs = derivs + derivs0 + derivs1*acentric + derivs2*theta;
@@ -776,26 +1082,31 @@ CoolPropDbl ResidualHelmholtzSAFTAssociating::eta(const CoolPropDbl &delta) cons
     return this->vbarn*delta;
 }
 
-void ResidualHelmholtzSAFTAssociating::all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &deriv) const throw()
+void ResidualHelmholtzSAFTAssociating::all(const CoolPropDbl &tau, const CoolPropDbl &delta, HelmholtzDerivatives &deriv, const int max_order) const throw()
 {
     if (disabled){return;}
     CoolPropDbl X = this->X(delta, this->Deltabar(tau, delta));
+    deriv.alphar += this->m*this->a*((log(X)-X/2.0+0.5));
+    if (max_order < 1){ return; }
+    
     CoolPropDbl X_t = this->dX_dtau(tau, delta);
     CoolPropDbl X_d = this->dX_ddelta(tau, delta);
+    deriv.dalphar_ddelta += this->m*this->a*(1/X-0.5)*X_d;
+    deriv.dalphar_dtau += this->m*this->a*(1/X-0.5)*X_t;
+    if (max_order < 2){ return; }
+    
     CoolPropDbl X_tt = this->d2X_dtau2(tau, delta);
     CoolPropDbl X_dd = this->d2X_ddelta2(tau, delta);
     CoolPropDbl X_dt = this->d2X_ddeltadtau(tau, delta);
+    deriv.d2alphar_dtau2 += this->m*this->a*((1/X-0.5)*X_tt-pow(X_t/X, 2));
+    deriv.d2alphar_ddelta2 += this->m*this->a*((1/X-0.5)*X_dd-pow(X_d/X,2));
+    deriv.d2alphar_ddelta_dtau += this->m*this->a*((-X_t/X/X)*X_d + X_dt*(1/X-0.5));
+    if (max_order < 3){ return; }
+    
     CoolPropDbl X_ttt = this->d3X_dtau3(tau, delta);
     CoolPropDbl X_dtt = this->d3X_ddeltadtau2(tau, delta);
     CoolPropDbl X_ddt = this->d3X_ddelta2dtau(tau, delta);
     CoolPropDbl X_ddd = this->d3X_ddelta3(tau, delta);
-    
-    deriv.alphar += this->m*this->a*((log(X)-X/2.0+0.5));
-    deriv.dalphar_ddelta += this->m*this->a*(1/X-0.5)*this->dX_ddelta(tau, delta);
-    deriv.dalphar_dtau += this->m*this->a*(1/X-0.5)*this->dX_dtau(tau, delta);
-    deriv.d2alphar_dtau2 += this->m*this->a*((1/X-0.5)*X_tt-pow(X_t/X, 2));
-    deriv.d2alphar_ddelta2 += this->m*this->a*((1/X-0.5)*X_dd-pow(X_d/X,2));
-    deriv.d2alphar_ddelta_dtau += this->m*this->a*((-X_t/X/X)*X_d + X_dt*(1/X-0.5));
     deriv.d3alphar_dtau3 += this->m*this->a*((1/X-1.0/2.0)*X_ttt+(-X_t/pow(X,(int)2))*X_tt-2*(pow(X,(int)2)*(X_t*X_tt)-pow(X_t,(int)2)*(X*X_t))/pow(X,(int)4));
     deriv.d3alphar_ddelta_dtau2 += this->m*this->a*((1/X-1.0/2.0)*X_dtt-X_d/pow(X,(int)2)*X_tt-2*(pow(X,(int)2)*(X_t*X_dt)-pow(X_t,(int)2)*(X*X_d))/pow(X,(int)4));
     deriv.d3alphar_ddelta2_dtau += this->m*this->a*((1/X-1.0/2.0)*X_ddt-X_t/pow(X,(int)2)*X_dd-2*(pow(X,(int)2)*(X_d*X_dt)-pow(X_d,(int)2)*(X*X_t))/pow(X,(int)4));
@@ -967,6 +1278,7 @@ IdealHelmholtzEnthalpyEntropyOffset EnthalpyEntropyOffset;
 #include <math.h>
 #include "catch.hpp"
 #include "crossplatform_shared_ptr.h"
+#include "Backends/Helmholtz/Fluids/FluidLibrary.h"
 
 class HelmholtzConsistencyFixture
 {
@@ -1254,5 +1566,144 @@ TEST_CASE_METHOD(HelmholtzConsistencyFixture, "Helmholtz energy derivatives", "[
     }
 }
 
+TEST_CASE_METHOD(HelmholtzConsistencyFixture, "Helmholtz energy derivatives up to a given order", "[helmholtz]")
+{
+    shared_ptr<CoolProp::ResidualHelmholtzGeneralizedExponential> generalized[] = {Gaussian, Lemmon2005, Exponential, GERG2008, Power};
+    for (std::size_t i = 0; i < sizeof(generalized)/sizeof(generalized[0]); ++i)
+    {
+        CoolProp::HelmholtzDerivatives full;
+        generalized[i]->all(1.3, 0.9, full);
+        for (int max_order = 0; max_order < 4; ++max_order)
+        {
+            CoolProp::HelmholtzDerivatives partial;
+            generalized[i]->all(1.3, 0.9, partial, max_order);
+            CAPTURE(i);
+            CAPTURE(max_order);
+            CHECK(partial.alphar == full.alphar);
+            CHECK(partial.dalphar_ddelta == (max_order >= 1 ? full.dalphar_ddelta : 0));
+            CHECK(partial.dalphar_dtau == (max_order >= 1 ? full.dalphar_dtau : 0));
+            CHECK(partial.d2alphar_ddelta_dtau == (max_order >= 2 ? full.d2alphar_ddelta_dtau : 0));
+            CHECK(partial.d3alphar_ddelta2_dtau == (max_order >= 3 ? full.d3alphar_ddelta2_dtau : 0));
+            CHECK(partial.d4alphar_ddelta4 == 0);
+        }
+    }
+}
+
+TEST_CASE("Non-analytic and associating terms up to a given order", "[helmholtz]")
+{
+    // Water has the non-analytic terms and Methanol the associating (SAFT) term; near the critical point of water the
+    // non-analytic terms are not negligible
+    std::string fluids[] = {"Water", "Methanol"};
+    double taus[] = {647.096/650, 512.5/400}, deltas[] = {0.95, 2.3};
+    for (std::size_t i = 0; i < sizeof(fluids)/sizeof(fluids[0]); ++i)
+    {
+        CoolProp::ResidualHelmholtzContainer alphar = CoolProp::get_fluid(fluids[i]).EOS().alphar;
+        CoolProp::HelmholtzDerivatives full_term, full = alphar.all(taus[i], deltas[i]);
+        if (i == 0){ alphar.NonAnalytic.all(taus[i], deltas[i], full_term); }
+        else{ alphar.SAFT.all(taus[i], deltas[i], full_term); }
+        REQUIRE(full_term.alphar != 0);
+        for (int max_order = 0; max_order < 4; ++max_order)
+        {
+            CoolProp::HelmholtzDerivatives partial_term, partial = alphar.all(taus[i], deltas[i], max_order);
+            if (i == 0){ alphar.NonAnalytic.all(taus[i], deltas[i], partial_term, max_order); }
+            else{ alphar.SAFT.all(taus[i], deltas[i], partial_term, max_order); }
+            CAPTURE(fluids[i]);
+            CAPTURE(max_order);
+            // The derivatives up to max_order are those of the full evaluation, and the higher ones are not touched
+            #define CHECK_ORDER(name, order) CHECK(partial.name == (max_order >= order ? full.name : 0)); CHECK(partial_term.name == (max_order >= order ? full_term.name : 0));
+            CHECK_ORDER(alphar, 0)
+            CHECK_ORDER(dalphar_ddelta, 1)
+            CHECK_ORDER(dalphar_dtau, 1)
+            CHECK_ORDER(d2alphar_ddelta2, 2)
+            CHECK_ORDER(d2alphar_ddelta_dtau, 2)
+            CHECK_ORDER(d2alphar_dtau2, 2)
+            CHECK_ORDER(d3alphar_ddelta3, 3)
+            CHECK_ORDER(d3alphar_ddelta2_dtau, 3)
+            CHECK_ORDER(d3alphar_ddelta_dtau2, 3)
+            CHECK_ORDER(d3alphar_dtau3, 3)
+            CHECK_ORDER(d4alphar_ddelta4, 4)
+            CHECK_ORDER(d4alphar_ddelta2_dtau2, 4)
+            CHECK_ORDER(d4alphar_dtau4, 4)
+            #undef CHECK_ORDER
+        }
+    }
+}
+
+TEST_CASE_METHOD(HelmholtzConsistencyFixture, "Vectorized generalized exponential terms agree with the reference implementation", "[helmholtz]")
+{
+    std::vector<CoolProp::ResidualHelmholtzGeneralizedExponential> generalized;
+    generalized.push_back(*Gaussian); generalized.push_back(*Lemmon2005); generalized.push_back(*Exponential); generalized.push_back(*GERG2008); generalized.push_back(*Power);
+    std::vector<std::string> fluids = strsplit(CoolProp::get_fluid_list(), ',');
+    for (std::size_t i = 0; i < fluids.size(); ++i){
+        generalized.push_back(CoolProp::get_fluid(fluids[i]).EOS().alphar.GenExp);
+    }
+    const double taus[] = {0.3, 0.9, 1.0, 1.3, 3.5}, deltas[] = {0, 0.01, 0.1, 0.9, 1.0, 2.5};
+    for (std::size_t i = 0; i < generalized.size(); ++i){
+        for (std::size_t j = 0; j < sizeof(taus)/sizeof(taus[0]); ++j){
+            for (std::size_t k = 0; k < sizeof(deltas)/sizeof(deltas[0]); ++k){
+                CoolProp::HelmholtzDerivatives vectorized, reference;
+                generalized[i].all(taus[j], deltas[k], vectorized);
+                generalized[i].all_reference(taus[j], deltas[k], reference);
+                CAPTURE(i);
+                CAPTURE(taus[j]);
+                CAPTURE(deltas[k]);
+                #define CHECK_DERIVATIVE(name) CAPTURE(vectorized.name); CAPTURE(reference.name); CHECK(std::abs(vectorized.name - reference.name) <= 1e-9*std::abs(reference.name) + 1e-12);
+                CHECK_DERIVATIVE(alphar)
+                // At delta = 0 the derivatives are divided by delta, so only alphar is defined
+                if (deltas[k] == 0){ CHECK(ValidNumber(vectorized.alphar)); continue; }
+                CHECK_DERIVATIVE(dalphar_ddelta)
+                CHECK_DERIVATIVE(dalphar_dtau)
+                CHECK_DERIVATIVE(d2alphar_ddelta2)
+                CHECK_DERIVATIVE(d2alphar_ddelta_dtau)
+                CHECK_DERIVATIVE(d2alphar_dtau2)
+                CHECK_DERIVATIVE(d3alphar_ddelta3)
+                CHECK_DERIVATIVE(d3alphar_ddelta2_dtau)
+                CHECK_DERIVATIVE(d3alphar_ddelta_dtau2)
+                CHECK_DERIVATIVE(d3alphar_dtau3)
+                CHECK_DERIVATIVE(d4alphar_ddelta4)
+                CHECK_DERIVATIVE(d4alphar_ddelta3_dtau)
+                CHECK_DERIVATIVE(d4alphar_ddelta2_dtau2)
+                CHECK_DERIVATIVE(d4alphar_ddelta_dtau3)
+                CHECK_DERIVATIVE(d4alphar_dtau4)
+                #undef CHECK_DERIVATIVE
+            }
+        }
+    }
+}
+
+namespace {
+/// Stand-ins for generated kernels: one that evaluates the terms of water, and one that is wrong
+void water_kernel(const CoolPropDbl &tau, const CoolPropDbl &delta, CoolProp::HelmholtzDerivatives &derivs, const int max_order){
+    static CoolProp::ResidualHelmholtzGeneralizedExponential terms = CoolProp::get_fluid("Water").EOS().alphar.GenExp;
+    terms.all_reference(tau, delta, derivs, max_order);
+}
+void empty_kernel(const CoolPropDbl &tau, const CoolPropDbl &delta, CoolProp::HelmholtzDerivatives &derivs, const int max_order){}
+}
+
+TEST_CASE("Generated kernels are only used if they agree with the terms", "[helmholtz]")
+{
+    CoolProp::ResidualHelmholtzGeneralizedExponential water = CoolProp::get_fluid("Water").EOS().alphar.GenExp;
+    CHECK(!water.set_kernel(empty_kernel));
+    CHECK(water.kernel == NULL);
+    CHECK(water.set_kernel(water_kernel));
+    CHECK(water.kernel == water_kernel);
+    // Adding terms drops the kernel
+    water.add_Power(std::vector<CoolPropDbl>(1, 0.1), std::vector<CoolPropDbl>(1, 1), std::vector<CoolPropDbl>(1, 1), std::vector<CoolPropDbl>(1, 0));
+    CHECK(water.kernel == NULL);
+
+    #if defined(COOLPROP_GENERATED_KERNELS)
+    // Each of the kernels that were generated is used
+    std::vector<std::string> fluids = strsplit(CoolProp::get_fluid_list(), ',');
+    for (std::size_t i = 0; i < fluids.size(); ++i){
+        CAPTURE(fluids[i]);
+        CoolProp::GeneratedHelmholtzKernel kernel = CoolProp::get_generated_helmholtz_kernel(fluids[i]);
+        if (kernel != NULL){
+            CHECK(CoolProp::get_fluid(fluids[i]).EOS().alphar.GenExp.kernel == kernel);
+        }
+    }
+    #endif
+}
+
 #endif
 
+
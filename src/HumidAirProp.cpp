@@ -12,6 +12,7 @@
 #include "CoolProp.h"
 #include "crossplatform_shared_ptr.h"
 #include "Exceptions.h"
+#include "Configuration.h"
 
 #include <algorithm>    // std::next_permutation
 #include <stdlib.h>
@@ -22,6 +23,14 @@
 #include <iostream>
 #include <list>
 #include "IF97.h"
+#include "CPthreads.h"
+#if !defined(NO_TABULAR_BACKENDS)
+    #include "Backends/Tabular/HumidAirTables.h"
+#endif
+
+#if defined(_OPENMP)
+    #include <omp.h>
+#endif
 
 /// This is a stub overload to help with all the strcmp calls below and avoid needing to rewrite all of them
 std::size_t strcmp(const std::string &s, const std::string &e){
@@ -39,9 +48,6 @@ void strcpy(std::string &s, const std::string &e){
     s = e;
 }
 
-shared_ptr<CoolProp::HelmholtzEOSBackend> Water, Air;
-shared_ptr<CoolProp::AbstractState> WaterIF97;
-
 namespace HumidAir
 {
     enum givens{GIVEN_INVALID=0, GIVEN_TDP,GIVEN_PSIW, GIVEN_HUMRAT,GIVEN_VDA, GIVEN_VHA,GIVEN_TWB,GIVEN_RH,GIVEN_ENTHALPY,GIVEN_ENTHALPY_HA,GIVEN_ENTROPY,GIVEN_ENTROPY_HA, GIVEN_T,GIVEN_P,GIVEN_VISC,GIVEN_COND,GIVEN_CP,GIVEN_CPHA, GIVEN_COMPRESSIBILITY_FACTOR, GIVEN_PARTIAL_PRESSURE_WATER, GIVEN_CV, GIVEN_CVHA, GIVEN_INTERNAL_ENERGY, GIVEN_INTERNAL_ENERGY_HA, GIVEN_SPEED_OF_SOUND, GIVEN_ISENTROPIC_EXPONENT};
@@ -49,19 +55,53 @@ namespace HumidAir
     void _HAPropsSI_inputs(double p, const std::vector<givens> &input_keys, const std::vector<double> &input_vals, double &T, double &psi_w);
     double _HAPropsSI_outputs(givens OuputType, double p, double T, double psi_w);
 
-void check_fluid_instantiation()
+/// Serializes the construction of the contexts, since the fluid libraries are not thread-safe while they are loading
+static CoolProp::Mutex humid_air_state_construction_mutex;
+
+HumidAirState::HumidAirState()
 {
-    if (!Water.get()){
-        Water.reset(new CoolProp::HelmholtzEOSBackend("Water"));
-    }
-    if (!WaterIF97.get()){
-        WaterIF97.reset(CoolProp::AbstractState::factory("IF97","Water"));
-    }
-    if (!Air.get()){
-        Air.reset(new CoolProp::HelmholtzEOSBackend("Air"));
+    CoolProp::ScopedLock lock(humid_air_state_construction_mutex);
+    Water.reset(new CoolProp::HelmholtzEOSBackend("Water"));
+    WaterIF97.reset(CoolProp::AbstractState::factory("IF97","Water"));
+    Air.reset(new CoolProp::HelmholtzEOSBackend("Air"));
+}
+
+/// The humid air context in use on one thread
+struct ThreadHumidAirState{
+    HumidAirState *current; ///< The context that is in use, or NULL if the thread has not used one yet
+    shared_ptr<HumidAirState> own; ///< The context that the free functions use on this thread, created on first use
+    ThreadHumidAirState() : current(NULL) {};
+};
+static CoolProp::ThreadLocal<ThreadHumidAirState> thread_humid_air_states;
+
+/// Get the humid air context in use on this thread
+static HumidAirState & current_state()
+{
+    ThreadHumidAirState &thread_state = thread_humid_air_states.get();
+    if (thread_state.current == NULL){
+        if (!thread_state.own.get()){ thread_state.own.reset(new HumidAirState()); }
+        thread_state.current = thread_state.own.get();
     }
+    return *thread_state.current;
+}
+
+/// Makes a context the one in use on this thread for as long as it is in scope
+class CurrentStateGuard{
+private:
+    ThreadHumidAirState &thread_state;
+    HumidAirState *previous;
+    CurrentStateGuard(const CurrentStateGuard &);
+    CurrentStateGuard & operator=(const CurrentStateGuard &);
+public:
+    explicit CurrentStateGuard(HumidAirState &state) : thread_state(thread_humid_air_states.get()), previous(thread_state.current) { thread_state.current = &state; };
+    ~CurrentStateGuard(){ thread_state.current = previous; };
 };
 
+// The states of the context in use on this thread
+static CoolProp::HelmholtzEOSBackend & Water(){ return *(current_state().Water); }
+static CoolProp::HelmholtzEOSBackend & Air(){ return *(current_state().Air); }
+static CoolProp::AbstractState & WaterIF97(){ return *(current_state().WaterIF97); }
+
 static double epsilon=0.621945,R_bar=8.314472;
 static int FlagUseVirialCorrelations=0,FlagUseIsothermCompressCorrelation=0,FlagUseIdealGasEnthalpyCorrelations=0;
 double f_factor(double T, double p);
@@ -69,77 +109,67 @@ double f_factor(double T, double p);
 // A couple of convenience functions that are needed quite a lot
 static double MM_Air(void)
 {
-    check_fluid_instantiation();
-    return Air->keyed_output(CoolProp::imolar_mass);
+    return Air().keyed_output(CoolProp::imolar_mass);
 }
 static double MM_Water(void)
 {
-    check_fluid_instantiation();
-    return Water->keyed_output(CoolProp::imolar_mass);
+    return Water().keyed_output(CoolProp::imolar_mass);
 }
 static double B_Air(double T)
 {
-    check_fluid_instantiation();
-    Air->specify_phase(CoolProp::iphase_gas);
-    Air->update_DmolarT_direct(1e-12,T);
-    Air->unspecify_phase();
-    return Air->keyed_output(CoolProp::iBvirial);
+    Air().specify_phase(CoolProp::iphase_gas);
+    Air().update_DmolarT_direct(1e-12,T);
+    Air().unspecify_phase();
+    return Air().keyed_output(CoolProp::iBvirial);
 }
 static double dBdT_Air(double T)
 {
-    check_fluid_instantiation();
-    Air->specify_phase(CoolProp::iphase_gas);
-    Air->update_DmolarT_direct(1e-12,T);
-    Air->unspecify_phase();
-    return Air->keyed_output(CoolProp::idBvirial_dT);
+    Air().specify_phase(CoolProp::iphase_gas);
+    Air().update_DmolarT_direct(1e-12,T);
+    Air().unspecify_phase();
+    return Air().keyed_output(CoolProp::idBvirial_dT);
 }
 static double B_Water(double T)
 {
-    check_fluid_instantiation();
-    Water->specify_phase(CoolProp::iphase_gas);
-    Water->update_DmolarT_direct(1e-12,T);
-    Water->unspecify_phase();
-    return Water->keyed_output(CoolProp::iBvirial);
+    Water().specify_phase(CoolProp::iphase_gas);
+    Water().update_DmolarT_direct(1e-12,T);
+    Water().unspecify_phase();
+    return Water().keyed_output(CoolProp::iBvirial);
 }
 static double dBdT_Water(double T)
 {
-    check_fluid_instantiation();
-    Water->specify_phase(CoolProp::iphase_gas);
-    Water->update_DmolarT_direct(1e-12,T);
-    Water->unspecify_phase();
-    return Water->keyed_output(CoolProp::idBvirial_dT);
+    Water().specify_phase(CoolProp::iphase_gas);
+    Water().update_DmolarT_direct(1e-12,T);
+    Water().unspecify_phase();
+    return Water().keyed_output(CoolProp::idBvirial_dT);
 }
 static double C_Air(double T)
 {
-    check_fluid_instantiation();
-    Air->specify_phase(CoolProp::iphase_gas);
-    Air->update_DmolarT_direct(1e-12,T);
-    Air->unspecify_phase();
-    return Air->keyed_output(CoolProp::iCvirial);
+    Air().specify_phase(CoolProp::iphase_gas);
+    Air().update_DmolarT_direct(1e-12,T);
+    Air().unspecify_phase();
+    return Air().keyed_output(CoolProp::iCvirial);
 }
 static double dCdT_Air(double T)
 {
-    check_fluid_instantiation();
-    Air->specify_phase(CoolProp::iphase_gas);
-    Air->update_DmolarT_direct(1e-12,T);
-    Air->unspecify_phase();
-    return Air->keyed_output(CoolProp::idCvirial_dT);
+    Air().specify_phase(CoolProp::iphase_gas);
+    Air().update_DmolarT_direct(1e-12,T);
+    Air().unspecify_phase();
+    return Air().keyed_output(CoolProp::idCvirial_dT);
 }
 static double C_Water(double T)
 {
-    check_fluid_instantiation();
-    Water->specify_phase(CoolProp::iphase_gas);
-    Water->update_DmolarT_direct(1e-12,T);
-    Water->unspecify_phase();
-    return Water->keyed_output(CoolProp::iCvirial);
+    Water().specify_phase(CoolProp::iphase_gas);
+    Water().update_DmolarT_direct(1e-12,T);
+    Water().unspecify_phase();
+    return Water().keyed_output(CoolProp::iCvirial);
 }
 static double dCdT_Water(double T)
 {
-    check_fluid_instantiation();
-    Water->specify_phase(CoolProp::iphase_gas);
-    Water->update_DmolarT_direct(1e-12,T);
-    Water->unspecify_phase();
-    return Water->keyed_output(CoolProp::idCvirial_dT);
+    Water().specify_phase(CoolProp::iphase_gas);
+    Water().update_DmolarT_direct(1e-12,T);
+    Water().unspecify_phase();
+    return Water().keyed_output(CoolProp::idCvirial_dT);
 }
 void UseVirialCorrelations(int flag)
 {
@@ -411,7 +441,6 @@ static double Secant_HAProps_W( double p, double T, givens OutputType, double Ta
 // Mixed virial components
 static double _B_aw(double T)
 {
-    check_fluid_instantiation();
     // Returns value in m^3/mol
     double a[]={0,0.665687e2,-0.238834e3,-0.176755e3};
     double b[]={0,-0.237,-1.048,-3.183};
@@ -421,7 +450,6 @@ static double _B_aw(double T)
 
 static double _dB_aw_dT(double T)
 {
-    check_fluid_instantiation();
     // Returns value in m^3/mol
     double a[]={0,0.665687e2,-0.238834e3,-0.176755e3};
     double b[]={0,-0.237,-1.048,-3.183};
@@ -431,7 +459,6 @@ static double _dB_aw_dT(double T)
 
 static double _C_aaw(double T)
 {
-    check_fluid_instantiation();
     // Function return has units of m^6/mol^2
     double c[]={0,0.482737e3,0.105678e6,-0.656394e8,0.294442e11,-0.319317e13};
     double rhobarstar=1000,Tstar=1,summer=0; int i;
@@ -444,7 +471,6 @@ static double _C_aaw(double T)
 
 static double _dC_aaw_dT(double T)
 {
-    check_fluid_instantiation();
     // Function return in units of m^6/mol^2/K
     double c[]={0,0.482737e3,0.105678e6,-0.656394e8,0.294442e11,-0.319317e13};
     double rhobarstar=1000,Tstar=1,summer=0; int i;
@@ -457,7 +483,6 @@ static double _dC_aaw_dT(double T)
 
 static double _C_aww(double T)
 {
-    check_fluid_instantiation();
     // Function return has units of m^6/mol^2
     double d[]={0,-0.1072887e2,0.347804e4,-0.383383e6,0.334060e8};
     double rhobarstar=1,Tstar=1,summer=0; int i;
@@ -470,7 +495,6 @@ static double _C_aww(double T)
 
 static double _dC_aww_dT(double T)
 {
-    check_fluid_instantiation();
      // Function return in units of m^6/mol^2/K
     double d[]={0,-0.1072887e2,0.347804e4,-0.383383e6,0.334060e8};
     double rhobarstar=1,Tstar=1,summer1=0,summer2=0; int i;
@@ -602,9 +626,9 @@ double isothermal_compressibility(double T, double p)
         else
         {
             // Use IF97 to do the P,T call
-            WaterIF97->update(CoolProp::PT_INPUTS, p, T);
-            Water->update(CoolProp::DmassT_INPUTS, WaterIF97->rhomass(), T);
-            k_T = Water->keyed_output(CoolProp::iisothermal_compressibility);
+            WaterIF97().update(CoolProp::PT_INPUTS, p, T);
+            Water().update(CoolProp::DmassT_INPUTS, WaterIF97().rhomass(), T);
+            k_T = Water().keyed_output(CoolProp::iisothermal_compressibility);
         }
     }
     else
@@ -626,9 +650,9 @@ double f_factor(double T, double p)
     if (T>273.16)
     {
         // It is liquid water
-        Water->update(CoolProp::QT_INPUTS, 0, T);
-        p_ws = Water->p();
-        vbar_ws = 1.0/Water->keyed_output(CoolProp::iDmolar); //[m^3/mol]
+        Water().update(CoolProp::QT_INPUTS, 0, T);
+        p_ws = Water().p();
+        vbar_ws = 1.0/Water().keyed_output(CoolProp::iDmolar); //[m^3/mol]
         beta_H = HenryConstant(T); //[1/Pa]
     }
     else
@@ -749,11 +773,11 @@ double Viscosity(double T, double p, double psi_w)
     Mw=MM_Water();
     Ma=MM_Air();
     // Viscosity of dry air at dry-bulb temp and total pressure
-    Air->update(CoolProp::PT_INPUTS,p,T);
-    mu_a=Air->keyed_output(CoolProp::iviscosity);
+    Air().update(CoolProp::PT_INPUTS,p,T);
+    mu_a=Air().keyed_output(CoolProp::iviscosity);
     // Saturated water vapor of pure water at total pressure
-    Water->update(CoolProp::PQ_INPUTS, p, 1);
-    mu_w=Water->keyed_output(CoolProp::iviscosity);
+    Water().update(CoolProp::PQ_INPUTS, p, 1);
+    mu_w=Water().keyed_output(CoolProp::iviscosity);
     Phi_av=sqrt(2.0)/4.0*pow(1+Ma/Mw,-0.5)*pow(1+sqrt(mu_a/mu_w)*pow(Mw/Ma,0.25),2); //[-]
     Phi_va=sqrt(2.0)/4.0*pow(1+Mw/Ma,-0.5)*pow(1+sqrt(mu_w/mu_a)*pow(Ma/Mw,0.25),2); //[-]
     return (1-psi_w)*mu_a/((1-psi_w)+psi_w*Phi_av)+psi_w*mu_w/(psi_w+(1-psi_w)*Phi_va);
@@ -772,13 +796,13 @@ double Conductivity(double T, double p, double psi_w)
     Ma=MM_Air();
 
     // Viscosity of dry air at dry-bulb temp and total pressure
-    Air->update(CoolProp::PT_INPUTS,p,T);
-    mu_a=Air->keyed_output(CoolProp::iviscosity);
-    k_a=Air->keyed_output(CoolProp::iconductivity);
+    Air().update(CoolProp::PT_INPUTS,p,T);
+    mu_a=Air().keyed_output(CoolProp::iviscosity);
+    k_a=Air().keyed_output(CoolProp::iconductivity);
     // Conductivity of saturated pure water at total pressure
-    Water->update(CoolProp::PQ_INPUTS, p, 1);
-    mu_w=Water->keyed_output(CoolProp::iviscosity);
-    k_w=Water->keyed_output(CoolProp::iconductivity);
+    Water().update(CoolProp::PQ_INPUTS, p, 1);
+    mu_w=Water().keyed_output(CoolProp::iviscosity);
+    k_w=Water().keyed_output(CoolProp::iconductivity);
     Phi_av=sqrt(2.0)/4.0*pow(1+Ma/Mw,-0.5)*pow(1+sqrt(mu_a/mu_w)*pow(Mw/Ma,0.25),2); //[-]
     Phi_va=sqrt(2.0)/4.0*pow(1+Mw/Ma,-0.5)*pow(1+sqrt(mu_w/mu_a)*pow(Ma/Mw,0.25),2); //[-]
     return (1-psi_w)*k_a/((1-psi_w)+psi_w*Phi_av)+psi_w*k_w/(psi_w+(1-psi_w)*Phi_va);
@@ -835,17 +859,17 @@ double IdealGasMolarEnthalpy_Water(double T, double vmolar)
     
     // Calculate the offset in the water enthalpy from a given state with a known (desired) enthalpy
     double Tref = 473.15, vmolarref = 0.038837428192186184, href = 51885.582451893446;
-    Water->update(CoolProp::DmolarT_INPUTS,1/vmolarref,Tref);
-    double tauref = Water->keyed_output(CoolProp::iT_reducing)/Tref; //[no units]
-    double href_EOS = R_bar*Tref*(1+tauref*Water->keyed_output(CoolProp::idalpha0_dtau_constdelta));
+    Water().update(CoolProp::DmolarT_INPUTS,1/vmolarref,Tref);
+    double tauref = Water().keyed_output(CoolProp::iT_reducing)/Tref; //[no units]
+    double href_EOS = R_bar*Tref*(1+tauref*Water().keyed_output(CoolProp::idalpha0_dtau_constdelta));
     double hoffset = href - href_EOS;
     
-    tau = Water->keyed_output(CoolProp::iT_reducing)/T;
+    tau = Water().keyed_output(CoolProp::iT_reducing)/T;
     rhomolar = 1/vmolar; //[mol/m^3]
-    Water->specify_phase(CoolProp::iphase_gas);
-    Water->update_DmolarT_direct(rhomolar, T);
-    Water->unspecify_phase();
-    hbar_w = hbar_w_0 + hoffset + R_bar*T*(1+tau*Water->keyed_output(CoolProp::idalpha0_dtau_constdelta));
+    Water().specify_phase(CoolProp::iphase_gas);
+    Water().update_DmolarT_direct(rhomolar, T);
+    Water().unspecify_phase();
+    hbar_w = hbar_w_0 + hoffset + R_bar*T*(1+tau*Water().keyed_output(CoolProp::idalpha0_dtau_constdelta));
     return hbar_w;
 }
 double IdealGasMolarEntropy_Water(double T, double p)
@@ -855,16 +879,16 @@ double IdealGasMolarEntropy_Water(double T, double p)
     
     // Calculate the offset in the water entropy from a given state with a known (desired) entropy
     double Tref = 473.15, pref = 101325, sref = 141.18297895840303;
-    Water->update(CoolProp::DmolarT_INPUTS,pref/(R_bar*Tref),Tref);
-    double tauref = Water->keyed_output(CoolProp::iT_reducing)/Tref; //[no units]
-    double sref_EOS = R_bar*(tauref*Water->keyed_output(CoolProp::idalpha0_dtau_constdelta)-Water->keyed_output(CoolProp::ialpha0));
+    Water().update(CoolProp::DmolarT_INPUTS,pref/(R_bar*Tref),Tref);
+    double tauref = Water().keyed_output(CoolProp::iT_reducing)/Tref; //[no units]
+    double sref_EOS = R_bar*(tauref*Water().keyed_output(CoolProp::idalpha0_dtau_constdelta)-Water().keyed_output(CoolProp::ialpha0));
     double soffset = sref - sref_EOS;
     
-    tau = Water->keyed_output(CoolProp::iT_reducing)/T;
-    Water->specify_phase(CoolProp::iphase_gas);
-    Water->update(CoolProp::DmolarT_INPUTS,p/(R_bar*T),T);
-    Water->unspecify_phase();
-    sbar_w = soffset + R_bar*(tau*Water->keyed_output(CoolProp::idalpha0_dtau_constdelta)-Water->keyed_output(CoolProp::ialpha0)); //[kJ/kmol/K]
+    tau = Water().keyed_output(CoolProp::iT_reducing)/T;
+    Water().specify_phase(CoolProp::iphase_gas);
+    Water().update(CoolProp::DmolarT_INPUTS,p/(R_bar*T),T);
+    Water().unspecify_phase();
+    sbar_w = soffset + R_bar*(tau*Water().keyed_output(CoolProp::idalpha0_dtau_constdelta)-Water().keyed_output(CoolProp::ialpha0)); //[kJ/kmol/K]
     return sbar_w;
 }
 double IdealGasMolarEnthalpy_Air(double T, double vmolar)
@@ -876,19 +900,19 @@ double IdealGasMolarEnthalpy_Air(double T, double vmolar)
     R_bar_Lemmon = 8.314510; //[J/mol/K]
     // Calculate the offset in the air enthalpy from a given state with a known (desired) enthalpy
     double Tref = 473.15, vmolarref = 0.038837428192186184, href = 13782.240592933371;
-    Air->update(CoolProp::DmolarT_INPUTS, 1/vmolarref, Tref);
+    Air().update(CoolProp::DmolarT_INPUTS, 1/vmolarref, Tref);
     double tauref = 132.6312/Tref; //[no units]
-    double href_EOS = R_bar_Lemmon*Tref*(1+tauref*Air->keyed_output(CoolProp::idalpha0_dtau_constdelta)); 
+    double href_EOS = R_bar_Lemmon*Tref*(1+tauref*Air().keyed_output(CoolProp::idalpha0_dtau_constdelta)); 
     double hoffset = href - href_EOS;
     
     // Tj is given by 132.6312 K
     tau = 132.6312/T;
     rhomolar = 1/vmolar; //[mol/m^3]
     // Now calculate it based on the given inputs
-    Air->specify_phase(CoolProp::iphase_gas);
-    Air->update_DmolarT_direct(rhomolar, T);
-    Air->unspecify_phase();
-    hbar_a = hbar_a_0 + hoffset + R_bar_Lemmon*T*(1+tau*Air->keyed_output(CoolProp::idalpha0_dtau_constdelta)); //[J/mol]
+    Air().specify_phase(CoolProp::iphase_gas);
+    Air().update_DmolarT_direct(rhomolar, T);
+    Air().unspecify_phase();
+    hbar_a = hbar_a_0 + hoffset + R_bar_Lemmon*T*(1+tau*Air().keyed_output(CoolProp::idalpha0_dtau_constdelta)); //[J/mol]
     return hbar_a;
 }
 double IdealGasMolarEntropy_Air(double T, double vmolar_a)
@@ -902,18 +926,18 @@ double IdealGasMolarEntropy_Air(double T, double vmolar_a)
 
     // Calculate the offset in the air entropy from a given state with a known (desired) entropy
     double Tref = 473.15, vmolarref = 0.038837605637863169, sref = 212.22365283759311;
-    Air->update(CoolProp::DmolarT_INPUTS, 1/vmolar_a_0, Tref);
+    Air().update(CoolProp::DmolarT_INPUTS, 1/vmolar_a_0, Tref);
     double tauref = 132.6312/Tref; //[no units]
-    double sref_EOS = R_bar_Lemmon*(tauref*Air->keyed_output(CoolProp::idalpha0_dtau_constdelta)-Air->keyed_output(CoolProp::ialpha0))+R_bar_Lemmon*log(vmolarref/vmolar_a_0);
+    double sref_EOS = R_bar_Lemmon*(tauref*Air().keyed_output(CoolProp::idalpha0_dtau_constdelta)-Air().keyed_output(CoolProp::ialpha0))+R_bar_Lemmon*log(vmolarref/vmolar_a_0);
     double soffset = sref - sref_EOS;
     
     // Tj and rhoj are given by 132.6312 and 302.5507652 respectively
     tau = 132.6312/T; //[no units]
     
-    Air->specify_phase(CoolProp::iphase_gas);
-    Air->update_DmolarT_direct(1/vmolar_a_0,T);
-    Air->unspecify_phase();
-    sbar_a=sbar_0_Lem + soffset + R_bar_Lemmon*(tau*Air->keyed_output(CoolProp::idalpha0_dtau_constdelta)-Air->keyed_output(CoolProp::ialpha0))+R_bar_Lemmon*log(vmolar_a/vmolar_a_0); //[J/mol/K]
+    Air().specify_phase(CoolProp::iphase_gas);
+    Air().update_DmolarT_direct(1/vmolar_a_0,T);
+    Air().unspecify_phase();
+    sbar_a=sbar_0_Lem + soffset + R_bar_Lemmon*(tau*Air().keyed_output(CoolProp::idalpha0_dtau_constdelta)-Air().keyed_output(CoolProp::ialpha0))+R_bar_Lemmon*log(vmolar_a/vmolar_a_0); //[J/mol/K]
 
     return sbar_a; //[J/mol/K]
 }
@@ -1161,10 +1185,10 @@ public:
         if (Twb > 273.16)
         {
             // Use IF97 to do the flash
-            WaterIF97->update(CoolProp::PT_INPUTS, _p, Twb);
+            WaterIF97().update(CoolProp::PT_INPUTS, _p, Twb);
             // Enthalpy of water [J/kg_water]
-            Water->update(CoolProp::DmassT_INPUTS, WaterIF97->rhomass(), Twb);
-            h_w = Water->keyed_output(CoolProp::iHmass); //[J/kg_water]
+            Water().update(CoolProp::DmassT_INPUTS, WaterIF97().rhomass(), Twb);
+            h_w = Water().keyed_output(CoolProp::iHmass); //[J/kg_water]
         }
         else
         {
@@ -1736,59 +1760,140 @@ double _HAPropsSI_outputs(givens OutputType, double p, double T, double psi_w)
             return _HUGE;
     }
 }
+/// Pick the pressure out of the three inputs to HAPropsSI and load the other two inputs into input_keys and input_vals
+static void _HAPropsSI_sort_inputs(const givens InTypes[3], const double InVals[3], double &p, std::vector<givens> &input_keys, std::vector<double> &input_vals)
+{
+    input_keys.resize(2);
+    input_vals.resize(2);
+
+    // Check that pressure is provided; load input vectors
+    if (InTypes[0] == GIVEN_P){ 
+        p = InVals[0]; 
+        input_keys[0] = InTypes[1]; input_keys[1] = InTypes[2]; 
+        input_vals[0] = InVals[1]; input_vals[1] = InVals[2];
+    }
+    else if (InTypes[1] == GIVEN_P){ 
+        p = InVals[1]; 
+        input_keys[0] = InTypes[0]; input_keys[1] = InTypes[2]; 
+        input_vals[0] = InVals[0]; input_vals[1] = InVals[2];
+    }
+    else if (InTypes[2] == GIVEN_P){ 
+        p = InVals[2];
+        input_keys[0] = InTypes[0]; input_keys[1] = InTypes[1]; 
+        input_vals[0] = InVals[0]; input_vals[1] = InVals[1];
+    }
+    else{
+        throw CoolProp::ValueError("Pressure must be one of the inputs to HAPropsSI");
+    }
+    
+    if (input_keys[0] == input_keys[1]){
+        throw CoolProp::ValueError("Other two inputs to HAPropsSI aside from pressure cannot be the same");
+    }
+}
+#if !defined(NO_TABULAR_BACKENDS)
+static std::size_t _HAPropsSImulti_number_of_threads(configuration_keys key, std::size_t N);
+static void _HAPropsSImulti(const std::vector<std::string> &Outputs, const std::string &Input1Name, const std::vector<double> &Input1, const std::string &Input2Name, const std::vector<double> &Input2, const std::string &Input3Name, const std::vector<double> &Input3, std::size_t Nthreads, const HumidAirTables *tables, std::vector<std::vector<double> > &IO);
+
+/// The key of an output in the humid air tables is its givens value
+static int _HAPropsSI_table_key(const std::string &output)
+{
+    return static_cast<int>(Name2Type(output));
+}
+
+/// Calculate the tabulated outputs in full at the nodes of the humid air tables, spread over TABLE_BUILD_NUMBER_OF_THREADS threads
+static void _HAPropsSI_table_nodes(const std::vector<std::string> &outputs, double p, const std::vector<double> &T, const std::vector<double> &W, std::vector<std::vector<double> > &IO)
+{
+    _HAPropsSImulti(outputs, "T", T, "W", W, "P", std::vector<double>(T.size(), p), _HAPropsSImulti_number_of_threads(TABLE_BUILD_NUMBER_OF_THREADS, T.size()), NULL, IO);
+}
+
+/// Get the humid air tables if HAPROPSSI_TABULAR is set and the tables are available, otherwise NULL
+static const HumidAirTables * _HAPropsSI_tables()
+{
+    if (!CoolProp::get_config_bool(HAPROPSSI_TABULAR)){ return NULL; }
+    return get_humid_air_tables(_HAPropsSI_table_nodes, _HAPropsSI_table_key);
+}
+
+/// Find T and W from the inputs with the humid air tables; returns false if the tables cannot be used for these inputs
+/// One of the inputs must be T or W; the other one is then found by inverting the tabulated output that was given
+static bool _HAPropsSI_tabular_inputs(const HumidAirTables &tables, double p, const std::vector<givens> &input_keys, const std::vector<double> &input_vals, double &T, double &W)
+{
+    long iT = get_input_key(input_keys, GIVEN_T), iW = get_input_key(input_keys, GIVEN_HUMRAT);
+    if (iT >= 0 && iW >= 0){
+        T = input_vals[iT]; W = input_vals[iW];
+        return true;
+    }
+    else if (iT >= 0){
+        int m = tables.output_index(input_keys[1-iT]);
+        T = input_vals[iT];
+        return m >= 0 && tables.solve_W(m, input_vals[1-iT], p, T, W);
+    }
+    else if (iW >= 0){
+        int m = tables.output_index(input_keys[1-iW]);
+        W = input_vals[iW];
+        return m >= 0 && tables.solve_T(m, input_vals[1-iW], p, W, T);
+    }
+    return false;
+}
+
+/// Calculate an output with the humid air tables at (p, T, W); returns false if the tables cannot be used for it
+static bool _HAPropsSI_tabular_output(const HumidAirTables &tables, givens OutputType, double p, double T, double W, double &val)
+{
+    int m;
+    switch (OutputType){
+        case GIVEN_T:
+            val = T; return true;
+        case GIVEN_HUMRAT:
+            val = W; return true;
+        default:
+            m = tables.output_index(OutputType);
+            return m >= 0 && tables.interpolate(m, p, T, W, val);
+    }
+}
+#else
+class HumidAirTables;
+static const HumidAirTables * _HAPropsSI_tables(){ return NULL; }
+#endif
+
 double HAPropsSI(const std::string &OutputName, const std::string &Input1Name, double Input1, const std::string &Input2Name, double Input2, const std::string &Input3Name, double Input3)
 {
     try
     {
-        // Add a check to make sure that Air and Water fluid states have been properly instantiated
-        check_fluid_instantiation();
-        Water->clear();
-        Air->clear();
+        Water().clear();
+        Air().clear();
 
         if (CoolProp::get_debug_level() > 0){ std::cout << format("HAPropsSI(%s,%s,%g,%s,%g,%s,%g)\n", OutputName.c_str(), Input1Name.c_str(), Input1, Input2Name.c_str(), Input2, Input3Name.c_str(), Input3); }
         
         std::vector<givens> input_keys(2);
         std::vector<double> input_vals(2);
         
-        givens In1Type, In2Type, In3Type, OutputType;
+        givens InTypes[3], OutputType;
+        double InVals[3] = {Input1, Input2, Input3};
         double p, T = _HUGE, psi_w = _HUGE;
 
         // First figure out what kind of inputs you have, convert names to enum values
-        In1Type = Name2Type(Input1Name.c_str());
-        In2Type = Name2Type(Input2Name.c_str());
-        In3Type = Name2Type(Input3Name.c_str());
+        InTypes[0] = Name2Type(Input1Name.c_str());
+        InTypes[1] = Name2Type(Input2Name.c_str());
+        InTypes[2] = Name2Type(Input3Name.c_str());
         
         // Output type
         OutputType = Name2Type(OutputName.c_str());
         
         // Check for trivial inputs
-        if (OutputType == In1Type){return Input1;}
-        if (OutputType == In2Type){return Input2;}
-        if (OutputType == In3Type){return Input3;}
-        
-        // Check that pressure is provided; load input vectors
-        if (In1Type == GIVEN_P){ 
-            p = Input1; 
-            input_keys[0] = In2Type; input_keys[1] = In3Type; 
-            input_vals[0] = Input2; input_vals[1] = Input3;
-        }
-        else if (In2Type == GIVEN_P){ 
-            p = Input2; 
-            input_keys[0] = In1Type; input_keys[1] = In3Type; 
-            input_vals[0] = Input1; input_vals[1] = Input3;
-        }
-        else if (In3Type == GIVEN_P){ 
-            p = Input3;
-            input_keys[0] = In1Type; input_keys[1] = In2Type; 
-            input_vals[0] = Input1; input_vals[1] = Input2;
-        }
-        else{
-            throw CoolProp::ValueError("Pressure must be one of the inputs to HAPropsSI");
-        }
+        if (OutputType == InTypes[0]){return Input1;}
+        if (OutputType == InTypes[1]){return Input2;}
+        if (OutputType == InTypes[2]){return Input3;}
         
-        if (input_keys[0] == input_keys[1]){
-            throw CoolProp::ValueError("Other two inputs to HAPropsSI aside from pressure cannot be the same");
+        _HAPropsSI_sort_inputs(InTypes, InVals, p, input_keys, input_vals);
+
+        #if !defined(NO_TABULAR_BACKENDS)
+        // Interpolate in the humid air tables if they are enabled and cover this state point
+        const HumidAir::HumidAirTables *tables = HumidAir::_HAPropsSI_tables();
+        double T_table, W_table, val_table;
+        if (tables != NULL && _HAPropsSI_tabular_inputs(*tables, p, input_keys, input_vals, T_table, W_table)
+            && _HAPropsSI_tabular_output(*tables, OutputType, p, T_table, W_table, val_table)){
+            return val_table;
         }
+        #endif
         
         // Parse the inputs to get to set of p, T, psi_w
         _HAPropsSI_inputs(p, input_keys, input_vals, T, psi_w);
@@ -1812,12 +1917,135 @@ double HAPropsSI(const std::string &OutputName, const std::string &Input1Name, d
     }
 }
 
+/// Solve one state point for (T, psi_w) and evaluate all the outputs from the solved state
+/// An output that cannot be calculated is set to _HUGE; if the state cannot be solved, all the outputs are _HUGE
+/// The outputs are interpolated in the humid air tables, if they are given and cover the state point
+/// The first error is returned in error rather than set here, since this may run on a worker thread
+static void _HAPropsSImulti_point(const std::vector<givens> &OutputTypes, const givens InTypes[3], const double InVals[3], const HumidAirTables *tables, double *out, std::string &error)
+{
+    std::fill(out, out + OutputTypes.size(), _HUGE);
+    try
+    {
+        Water().clear();
+        Air().clear();
+
+        std::vector<givens> input_keys(2);
+        std::vector<double> input_vals(2);
+        double p, T = _HUGE, psi_w = _HUGE;
+        bool solved = false;
+        _HAPropsSI_sort_inputs(InTypes, InVals, p, input_keys, input_vals);
+
+        #if !defined(NO_TABULAR_BACKENDS)
+        double T_table = _HUGE, W_table = _HUGE;
+        bool tabulated = tables != NULL && _HAPropsSI_tabular_inputs(*tables, p, input_keys, input_vals, T_table, W_table);
+        #endif
+
+        for (std::size_t j = 0; j < OutputTypes.size(); ++j){
+            // Check for trivial inputs
+            if (OutputTypes[j] == InTypes[0]){ out[j] = InVals[0]; continue; }
+            if (OutputTypes[j] == InTypes[1]){ out[j] = InVals[1]; continue; }
+            if (OutputTypes[j] == InTypes[2]){ out[j] = InVals[2]; continue; }
+
+            #if !defined(NO_TABULAR_BACKENDS)
+            if (tabulated && _HAPropsSI_tabular_output(*tables, OutputTypes[j], p, T_table, W_table, out[j])){ continue; }
+            #endif
+
+            // Parse the inputs to get to set of p, T, psi_w; only done once for all the outputs
+            if (!solved){
+                _HAPropsSI_inputs(p, input_keys, input_vals, T, psi_w);
+                solved = true;
+            }
+            try{
+                out[j] = _HAPropsSI_outputs(OutputTypes[j], p, T, psi_w);
+            }
+            catch (std::exception &e){
+                if (error.empty()){ error = e.what(); }
+            }
+        }
+    }
+    catch (std::exception &e)
+    {
+        error = e.what();
+    }
+    catch (...)
+    {
+        error = "Undefined error";
+    }
+}
+
+/// Get the number of threads that the configuration key (HAPROPSSIMULTI_NUMBER_OF_THREADS, for instance) gives for evaluating N humid air state points
+static std::size_t _HAPropsSImulti_number_of_threads(configuration_keys key, std::size_t N)
+{
+    #if defined(_OPENMP)
+        int Nthreads = static_cast<int>(CoolProp::get_config_double(key));
+        if (Nthreads <= 0){ Nthreads = omp_get_max_threads(); }
+        return std::max(static_cast<std::size_t>(1), std::min(static_cast<std::size_t>(Nthreads), N));
+    #else
+        return 1;
+    #endif
+}
+
+/// Evaluate the state points; with more than one thread, each thread uses the humid air context that belongs to it
+static void _HAPropsSImulti(const std::vector<std::string> &Outputs, const std::string &Input1Name, const std::vector<double> &Input1, const std::string &Input2Name, const std::vector<double> &Input2, const std::string &Input3Name, const std::vector<double> &Input3, std::size_t Nthreads, const HumidAirTables *tables, std::vector<std::vector<double> > &IO)
+{
+    if (Input1.size() != Input2.size() || Input1.size() != Input3.size()){
+        throw CoolProp::ValueError(format("lengths of Input1 [%d], Input2 [%d] and Input3 [%d] are not the same", Input1.size(), Input2.size(), Input3.size()));
+    }
+    if (Outputs.empty()){ throw CoolProp::ValueError("At least one output must be provided to HAPropsSImulti"); }
+
+    givens InTypes[3];
+    InTypes[0] = Name2Type(Input1Name);
+    InTypes[1] = Name2Type(Input2Name);
+    InTypes[2] = Name2Type(Input3Name);
+    std::vector<givens> OutputTypes(Outputs.size());
+    for (std::size_t j = 0; j < Outputs.size(); ++j){
+        OutputTypes[j] = Name2Type(Outputs[j]);
+    }
+    // Check the input names once rather than failing at every state point
+    double p, dummy_vals[3] = {0, 0, 0};
+    std::vector<givens> input_keys;
+    std::vector<double> input_vals;
+    _HAPropsSI_sort_inputs(InTypes, dummy_vals, p, input_keys, input_vals);
+
+    long N = static_cast<long>(Input1.size());
+    IO.resize(N, std::vector<double>(Outputs.size(), _HUGE));
+    std::vector<std::string> errors(N);
+
+    #if defined(_OPENMP)
+    #pragma omp parallel for schedule(dynamic, 8) num_threads(static_cast<int>(Nthreads)) if (Nthreads > 1)
+    #endif
+    for (long i = 0; i < N; ++i){
+        double InVals[3] = {Input1[i], Input2[i], Input3[i]};
+        _HAPropsSImulti_point(OutputTypes, InTypes, InVals, tables, &(IO[i][0]), errors[i]);
+    }
+    // The error strings are per-thread, so the error of the first failed point is set here, on the calling thread
+    for (long i = 0; i < N; ++i){
+        if (!errors[i].empty()){ CoolProp::set_error_string(errors[i]); break; }
+    }
+}
+
+std::vector<std::vector<double> > HAPropsSImulti(const std::vector<std::string> &Outputs, const std::string &Input1Name, const std::vector<double> &Input1, const std::string &Input2Name, const std::vector<double> &Input2, const std::string &Input3Name, const std::vector<double> &Input3)
+{
+    std::vector<std::vector<double> > IO;
+    try
+    {
+        _HAPropsSImulti(Outputs, Input1Name, Input1, Input2Name, Input2, Input3Name, Input3, _HAPropsSImulti_number_of_threads(HAPROPSSIMULTI_NUMBER_OF_THREADS, Input1.size()), _HAPropsSI_tables(), IO);
+        return IO;
+    }
+    catch (std::exception &e)
+    {
+        CoolProp::set_error_string(e.what());
+    }
+    catch (...)
+    {
+    }
+    return std::vector<std::vector<double> >();
+}
+
 double HAProps_Aux(const char* Name,double T, double p, double W, char *units)
 {
     // This function provides some things that are not usually needed, but could be interesting for debug purposes.
     
-    // Add a check to make sure that Air and Water fluid states have been properly instantiated
-    check_fluid_instantiation();
 
     // Requires W since it is nice and fast and always defined.  Put a dummy value if you want something that doesn't use humidity
 
@@ -1920,9 +2148,9 @@ double HAProps_Aux(const char* Name,double T, double p, double W, char *units)
             if (T>273.16)
             {
                 // Use IF97 to do the flash
-                WaterIF97->update(CoolProp::PT_INPUTS, p, T);
-                Water->update(CoolProp::PT_INPUTS, WaterIF97->rhomass(), T);
-                return Water->keyed_output(CoolProp::iisothermal_compressibility);
+                WaterIF97().update(CoolProp::PT_INPUTS, p, T);
+                Water().update(CoolProp::PT_INPUTS, WaterIF97().rhomass(), T);
+                return Water().keyed_output(CoolProp::iisothermal_compressibility);
             }
             else
                 return IsothermCompress_Ice(T,p); //[1/Pa]
@@ -1941,8 +2169,8 @@ double HAProps_Aux(const char* Name,double T, double p, double W, char *units)
             strcpy(units,"m^3/mol");
             if (T>273.16)
             {
-                Water->update(CoolProp::QT_INPUTS, 0, T);
-                return 1.0/Water->keyed_output(CoolProp::iDmolar);
+                Water().update(CoolProp::QT_INPUTS, 0, T);
+                return 1.0/Water().keyed_output(CoolProp::iDmolar);
             }
             else
             {
@@ -2033,6 +2261,36 @@ double IceProps(const char* Name, double T, double p)
     }
 }
 
+double HumidAirState::HAPropsSI(const std::string &OutputName, const std::string &Input1Name, double Input1, const std::string &Input2Name, double Input2, const std::string &Input3Name, double Input3)
+{
+    CurrentStateGuard guard(*this);
+    return HumidAir::HAPropsSI(OutputName, Input1Name, Input1, Input2Name, Input2, Input3Name, Input3);
+}
+double HumidAirState::HAProps_Aux(const char* OutputName, double T, double p, double W, char *units)
+{
+    CurrentStateGuard guard(*this);
+    return HumidAir::HAProps_Aux(OutputName, T, p, W, units);
+}
+std::vector<std::vector<double> > HumidAirState::HAPropsSImulti(const std::vector<std::string> &Outputs, const std::string &Input1Name, const std::vector<double> &Input1, const std::string &Input2Name, const std::vector<double> &Input2, const std::string &Input3Name, const std::vector<double> &Input3)
+{
+    CurrentStateGuard guard(*this);
+    std::vector<std::vector<double> > IO;
+    try
+    {
+        // The states of this context can only be used from one thread
+        _HAPropsSImulti(Outputs, Input1Name, Input1, Input2Name, Input2, Input3Name, Input3, 1, _HAPropsSI_tables(), IO);
+        return IO;
+    }
+    catch (std::exception &e)
+    {
+        CoolProp::set_error_string(e.what());
+    }
+    catch (...)
+    {
+    }
+    return std::vector<std::vector<double> >();
+}
+
 } /* namespace HumidAir */
 
 #ifdef ENABLE_CATCH
@@ -2247,6 +2505,177 @@ TEST_CASE("Assorted tests","[HAPropsSI]")
     CHECK(ValidNumber(HumidAir::HAPropsSI("T", "B", 252.84, "W", 5.097e-4, "P", 101325)));
     CHECK(ValidNumber(HumidAir::HAPropsSI("T", "B",290, "R", 1, "P", 101325)));
 }
+
+#if !defined(__ISWINDOWS__)
+#include <pthread.h>
+
+/// The inputs and results of one thread of the humid air context test
+struct HumidAirThreadData{
+    HumidAir::HumidAirState *state; ///< The context to use, or NULL to use the free function
+    double T, h, h_calc;
+};
+static void * HumidAir_thread(void *arg)
+{
+    HumidAirThreadData &data = *static_cast<HumidAirThreadData *>(arg);
+    for (int i = 0; i < 20; ++i){
+        if (data.state != NULL){
+            data.h_calc = data.state->HAPropsSI("H", "T", data.T, "P", 101325, "Twb", data.T - 5);
+        }
+        else{
+            data.h_calc = HumidAir::HAPropsSI("H", "T", data.T, "P", 101325, "Twb", data.T - 5);
+        }
+        if (std::abs(data.h_calc - data.h) > 1e-8*std::abs(data.h)){ break; }
+    }
+    return NULL;
+}
+
+TEST_CASE("Humid air contexts can be used from several threads at once", "[HAPropsSI],[HumidAirState]")
+{
+    const int Nthreads = 4;
+    HumidAir::HumidAirState states[Nthreads];
+    std::vector<HumidAirThreadData> data(2*Nthreads);
+    for (int k = 0; k < 2*Nthreads; ++k){
+        // Half of the threads use a context of their own, the others the free function
+        data[k].state = (k < Nthreads) ? &states[k] : NULL;
+        data[k].T = 290 + 2*k;
+        data[k].h = HumidAir::HAPropsSI("H", "T", data[k].T, "P", 101325, "Twb", data[k].T - 5);
+        REQUIRE(ValidNumber(data[k].h));
+        CHECK(std::abs(states[k % Nthreads].HAPropsSI("H", "T", data[k].T, "P", 101325, "Twb", data[k].T - 5) - data[k].h) < 1e-8*std::abs(data[k].h));
+    }
+    std::vector<pthread_t> threads(2*Nthreads);
+    for (int k = 0; k < 2*Nthreads; ++k){
+        REQUIRE(pthread_create(&threads[k], NULL, HumidAir_thread, &data[k]) == 0);
+    }
+    for (int k = 0; k < 2*Nthreads; ++k){
+        pthread_join(threads[k], NULL);
+    }
+    for (int k = 0; k < 2*Nthreads; ++k){
+        CAPTURE(k);
+        CHECK(std::abs(data[k].h_calc - data[k].h) < 1e-8*std::abs(data[k].h));
+    }
+}
+#endif
+
+TEST_CASE("HAPropsSImulti agrees with HAPropsSI", "[HAPropsSI],[HAPropsSImulti]")
+{
+    std::vector<std::string> outputs;
+    outputs.push_back("H"); outputs.push_back("W"); outputs.push_back("Twb"); outputs.push_back("RH"); outputs.push_back("T");
+    std::vector<double> T, p, R;
+    for (std::size_t i = 0; i < 40; ++i){
+        T.push_back(275 + i); p.push_back(101325); R.push_back(0.1 + 0.02*i);
+    }
+    T[29] = 700; // Above the critical temperature of water, so the saturation pressure and this state point fail
+    double Nthreads = CoolProp::get_config_double(HAPROPSSIMULTI_NUMBER_OF_THREADS);
+    CoolProp::set_config_double(HAPROPSSIMULTI_NUMBER_OF_THREADS, 1);
+    std::vector<std::vector<double> > serial = HumidAir::HAPropsSImulti(outputs, "T", T, "P", p, "R", R);
+    CoolProp::get_global_param_string("errstring");
+    CoolProp::set_config_double(HAPROPSSIMULTI_NUMBER_OF_THREADS, 4);
+    std::vector<std::vector<double> > parallel = HumidAir::HAPropsSImulti(outputs, "T", T, "P", p, "R", R);
+    // The point fails on one of the other threads, but its error is seen here
+    CHECK(!CoolProp::get_global_param_string("errstring").empty());
+    CoolProp::set_config_double(HAPROPSSIMULTI_NUMBER_OF_THREADS, Nthreads);
+    REQUIRE(serial.size() == T.size());
+    REQUIRE(parallel.size() == T.size());
+    CHECK(parallel[29][0] == _HUGE);
+    for (std::size_t i = 0; i < T.size(); ++i){
+        CAPTURE(i);
+        CHECK(serial[i] == parallel[i]);
+        // HAPropsSI returns a trivial output (T here) even at the invalid point
+        if (i == 29){ continue; }
+        for (std::size_t j = 0; j < outputs.size(); ++j){
+            CAPTURE(outputs[j]);
+            double expected = HumidAir::HAPropsSI(outputs[j], "T", T[i], "P", p[i], "R", R[i]);
+            CHECK(std::abs(serial[i][j] - expected) <= 1e-10*std::abs(expected));
+        }
+    }
+    CHECK(HumidAir::HAPropsSImulti(outputs, "T", T, "H", p, "R", R).empty());
+}
+TEST_CASE("HAPropsSImulti with several threads reports the error of a failed point on the calling thread", "[HAPropsSImulti]")
+{
+    std::vector<std::string> outputs(1, "T");
+    std::vector<double> W(64, 0.01), p(64, 101325), H(64, 5e4);
+    H[50] = 1e8; // Out of reach for any temperature; this point is evaluated on one of the other threads
+    double Nthreads = CoolProp::get_config_double(HAPROPSSIMULTI_NUMBER_OF_THREADS);
+    CoolProp::get_global_param_string("errstring");
+    CoolProp::set_config_double(HAPROPSSIMULTI_NUMBER_OF_THREADS, 4);
+    std::vector<std::vector<double> > IO = HumidAir::HAPropsSImulti(outputs, "W", W, "P", p, "H", H);
+    std::string error = CoolProp::get_global_param_string("errstring");
+    CoolProp::set_config_double(HAPROPSSIMULTI_NUMBER_OF_THREADS, Nthreads);
+    REQUIRE(IO.size() == W.size());
+    CHECK(IO[50][0] == _HUGE);
+    CHECK(ValidNumber(IO[49][0]));
+    CHECK(!error.empty());
+}
+#if !defined(NO_TABULAR_BACKENDS)
+TEST_CASE("HAPropsSI with the humid air tables agrees with the full calculation", "[HAPropsSI],[HumidAirTables]")
+{
+    double Tmin = CoolProp::get_config_double(HUMID_AIR_TABLE_TMIN), Tmax = CoolProp::get_config_double(HUMID_AIR_TABLE_TMAX);
+    double Wmax = CoolProp::get_config_double(HUMID_AIR_TABLE_WMAX);
+    CoolProp::set_config_double(HUMID_AIR_TABLE_TMIN, 290);
+    CoolProp::set_config_double(HUMID_AIR_TABLE_TMAX, 310);
+    CoolProp::set_config_double(HUMID_AIR_TABLE_WMAX, 0.02);
+
+    // The error of a cell is only estimated at its centre, and is allowed to be as large as the tolerance there.  Away from
+    // the centre the error of the bicubic interpolation can be a few times larger, and when the second input is not W, the
+    // humidity ratio or temperature found by inverting the tables carries the error of that input into the outputs, so
+    // the outputs are allowed an error ten times the tolerance
+    const double safety_factor = 10;
+    double tolerance = CoolProp::get_config_double(HUMID_AIR_TABLE_TOLERANCE);
+    CoolProp::set_config_bool(HAPROPSSI_TABULAR, true);
+    const HumidAir::HumidAirTables *tables = HumidAir::_HAPropsSI_tables();
+    REQUIRE(tables != NULL);
+    REQUIRE(tables->Np == 1);
+    double dT = (tables->limits.Tmax - tables->limits.Tmin)/(tables->NT - 1), dW = tables->limits.Wmax/(tables->NW - 1);
+
+    // Points away from the centres of cells spread over the tables, away from dry air where the relative humidity is close to zero;
+    // the cells that are not accurate enough (those beyond saturation, for instance) are not used by the tables and are skipped
+    const std::size_t cells_T[] = {3, 30, 58, 86}, cells_W[] = {8, 20, 33, 47};
+    const double offsets[][2] = {{0.15, 0.8}, {0.9, 0.25}, {0.3, 0.05}, {0.7, 0.6}};
+    // Pairs of inputs with pressure, and the outputs to check for each of them
+    const char *input1[] = {"T", "T", "T", "T", "W"};
+    const char *input2[] = {"W", "R", "B", "H", "H"};
+    const char *outputs[] = {"H", "W", "R", "B", "V", "T"};
+    std::size_t Npoints = 0;
+    for (std::size_t a = 0; a < sizeof(cells_T)/sizeof(cells_T[0]); ++a){
+        for (std::size_t b = 0; b < sizeof(cells_W)/sizeof(cells_W[0]); ++b){
+            std::size_t i = cells_T[a], j = cells_W[b];
+            if (!(tables->errors[0][i][j] <= tolerance)){ continue; }
+            const double *offset = offsets[(a + b) % 4];
+            double T = tables->limits.Tmin + (i + offset[0])*dT, W = (j + offset[1])*dW;
+            CAPTURE(T); CAPTURE(W);
+            ++Npoints;
+            for (std::size_t k = 0; k < sizeof(input1)/sizeof(input1[0]); ++k){
+                CAPTURE(input1[k]); CAPTURE(input2[k]);
+                CoolProp::set_config_bool(HAPROPSSI_TABULAR, false);
+                double value1 = (std::string(input1[k]) == "T") ? T : W;
+                double value2 = HumidAir::HAPropsSI(input2[k], "T", T, "W", W, "P", 101325);
+                for (std::size_t m = 0; m < sizeof(outputs)/sizeof(outputs[0]); ++m){
+                    CAPTURE(outputs[m]);
+                    CoolProp::set_config_bool(HAPROPSSI_TABULAR, false);
+                    double exact = HumidAir::HAPropsSI(outputs[m], input1[k], value1, input2[k], value2, "P", 101325);
+                    CoolProp::set_config_bool(HAPROPSSI_TABULAR, true);
+                    double tabular = HumidAir::HAPropsSI(outputs[m], input1[k], value1, input2[k], value2, "P", 101325);
+                    CAPTURE(exact); CAPTURE(tabular);
+                    CHECK(std::abs(tabular - exact) <= safety_factor*tolerance*std::abs(exact));
+                }
+            }
+        }
+    }
+    // Most of the cells are below saturation, so most of the points are checked
+    CHECK(Npoints >= 10);
+    // Outside the tables the full calculation is used
+    CoolProp::set_config_bool(HAPROPSSI_TABULAR, false);
+    double exact = HumidAir::HAPropsSI("H", "T", 350, "R", 0.1, "P", 101325);
+    CoolProp::set_config_bool(HAPROPSSI_TABULAR, true);
+    CHECK(HumidAir::HAPropsSI("H", "T", 350, "R", 0.1, "P", 101325) == exact);
+
+    CoolProp::set_config_bool(HAPROPSSI_TABULAR, false);
+    CoolProp::set_config_double(HUMID_AIR_TABLE_TMIN, Tmin);
+    CoolProp::set_config_double(HUMID_AIR_TABLE_TMAX, Tmax);
+    CoolProp::set_config_double(HUMID_AIR_TABLE_WMAX, Wmax);
+}
+#endif
+
 // a predicate implemented as a function:
 bool is_not_a_pair (const std::set<std::size_t> &item) { return item.size() != 2; }
 
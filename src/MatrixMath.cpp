@@ -22,6 +22,8 @@ namespace CoolProp{
 #include <math.h>
 #include <iostream>
 #include "catch.hpp"
+#include "TestObjects.h"
+#include "Solvers.h"
 
 TEST_CASE("Internal consistency checks and example use cases for MatrixMath.h","[MatrixMath]")
 {
@@ -107,6 +109,110 @@ TEST_CASE("Internal consistency checks and example use cases for MatrixMath.h","
     }
 }
 
+template<class T> static void fill_linear_system(CoolProp::NewtonRaphsonWorkspace<T> &J, std::vector<std::vector<T> > &A, std::vector<T> &b, int seed)
+{
+    // A diagonally dominant matrix, so that the system is well conditioned
+    std::size_t N = J.size();
+    for (std::size_t i = 0; i < N; ++i){
+        for (std::size_t j = 0; j < N; ++j){
+            A[i][j] = (i == j) ? 10.0 + i : sin(static_cast<double>(seed + 3*i + 7*j));
+            J(i, j) = A[i][j];
+        }
+        b[i] = cos(static_cast<double>(seed + i));
+        J.rhs(i) = b[i];
+    }
+}
+
+TEST_CASE("Newton-Raphson workspace solves linear systems without allocating", "[MatrixMath],[NR_workspace]")
+{
+    // Small systems use the fixed-size storage, the larger ones the dynamic storage
+    std::size_t sizes[] = {2, 4, 6, 8, 12};
+    for (std::size_t k = 0; k < sizeof(sizes)/sizeof(sizes[0]); ++k)
+    {
+        std::size_t N = sizes[k];
+        CAPTURE(N);
+        CoolProp::NewtonRaphsonWorkspace<double> J;
+        J.resize(N);
+        std::vector<std::vector<double> > A(N, std::vector<double>(N, 0));
+        std::vector<double> b(N, 0);
+
+        // The first solve warms the workspace up
+        fill_linear_system(J, A, b, 0);
+        J.solve();
+
+        for (int seed = 1; seed < 4; ++seed)
+        {
+            fill_linear_system(J, A, b, seed);
+            std::size_t count_before = CoolPropTesting::heap_allocations();
+            J.solve();
+            CHECK(CoolPropTesting::heap_allocations() == count_before);
+
+            // The step agrees with the Gauss-Jordan solution
+            std::vector<double> v = CoolProp::linsolve(A, b);
+            for (std::size_t i = 0; i < N; ++i){
+                CAPTURE(i);
+                CHECK(std::abs(J.step(i) - v[i]) < 1e-12);
+            }
+        }
+    }
+}
+
+/// A nonlinear system x_i + 0.1*x_i^3 + 0.05*sum_j sin(x_j) = b_i that keeps count of the allocations made in its callbacks
+class AllocationCountingSystem : public CoolProp::FuncWrapperND{
+public:
+    std::size_t N, Ncalls, callback_allocations;
+    AllocationCountingSystem(std::size_t N) : N(N), Ncalls(0), callback_allocations(0) {};
+    std::vector<double> call(const std::vector<double> &x){
+        std::size_t count_before = CoolPropTesting::heap_allocations();
+        std::vector<double> r(N);
+        double sum_sin = 0;
+        for (std::size_t j = 0; j < N; ++j){ sum_sin += sin(x[j]); }
+        for (std::size_t i = 0; i < N; ++i){ r[i] = x[i] + 0.1*pow(x[i], 3) + 0.05*sum_sin - (1.0 + 0.1*i); }
+        ++Ncalls;
+        callback_allocations += CoolPropTesting::heap_allocations() - count_before;
+        return r;
+    };
+    std::vector<std::vector<double> > Jacobian(const std::vector<double> &x){
+        std::size_t count_before = CoolPropTesting::heap_allocations();
+        std::vector<std::vector<double> > J(N, std::vector<double>(N, 0));
+        for (std::size_t i = 0; i < N; ++i){
+            for (std::size_t j = 0; j < N; ++j){ J[i][j] = 0.05*cos(x[j]); }
+            J[i][i] += 1 + 0.3*x[i]*x[i];
+        }
+        callback_allocations += CoolPropTesting::heap_allocations() - count_before;
+        return J;
+    };
+};
+
+TEST_CASE("Newton-Raphson iterations with the workspace do not allocate", "[MatrixMath],[NR_workspace]")
+{
+    // The residual and Jacobian callbacks return std::vectors, so they allocate; everything else that the solver
+    // allocates is allocated before the first step, so it does not depend on the number of iterations
+    std::size_t sizes[] = {3, 10};
+    for (std::size_t k = 0; k < sizeof(sizes)/sizeof(sizes[0]); ++k)
+    {
+        std::size_t N = sizes[k];
+        CAPTURE(N);
+        std::size_t solver_allocations[2], iterations[2];
+        double guesses[2] = {1.0, 8.0};
+        for (int g = 0; g < 2; ++g){
+            AllocationCountingSystem system(N);
+            std::vector<double> x(N, guesses[g]);
+            std::string errstr;
+            std::size_t count_before = CoolPropTesting::heap_allocations();
+            x = CoolProp::NDNewtonRaphson_Jacobian(&system, x, 1e-12, 50, &errstr);
+            solver_allocations[g] = CoolPropTesting::heap_allocations() - count_before - system.callback_allocations;
+            iterations[g] = system.Ncalls;
+            CHECK(errstr.empty());
+            std::vector<double> r = system.call(x);
+            for (std::size_t i = 0; i < N; ++i){ CHECK(std::abs(r[i]) < 1e-10); }
+        }
+        CAPTURE(iterations[0]);
+        CAPTURE(iterations[1]);
+        REQUIRE(iterations[1] > iterations[0]);
+        CHECK(solver_allocations[1] == solver_allocations[0]);
+    }
+}
 
 #endif /* ENABLE_CATCH */
 
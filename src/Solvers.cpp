@@ -53,10 +53,11 @@ std::vector<double> NDNewtonRaphson_Jacobian(FuncWrapperND *f, std::vector<doubl
 {
     int iter=0;
     *errstring=std::string("");
-    std::vector<double> f0,v;
+    std::vector<double> f0;
     std::vector<std::vector<double> > JJ;
-    Eigen::VectorXd r(x0.size());
-    Eigen::Matrix2d J(x0.size(), x0.size());
+    // Allocated once; fixed-size storage is used for small systems
+    NewtonRaphsonWorkspace<double> J;
+    J.resize(x0.size());
     double error = 999;
     while (iter==0 || std::abs(error)>tol){
         f0 = f->call(x0);
@@ -64,17 +65,17 @@ std::vector<double> NDNewtonRaphson_Jacobian(FuncWrapperND *f, std::vector<doubl
         
         for (std::size_t i = 0; i < x0.size(); ++i)
         {
-            r(i) = f0[i];
+            J.rhs(i) = -f0[i];
             for (std::size_t j = 0; j < x0.size(); ++j)
             {
                 J(i,j) = JJ[i][j];
             }
         }
 
-        Eigen::Vector2d v = J.colPivHouseholderQr().solve(-r);
+        J.solve();
 
         // Update the guess
-        for (std::size_t i = 0; i<x0.size(); i++){ x0[i] += v(i);}
+        for (std::size_t i = 0; i<x0.size(); i++){ x0[i] += J.step(i);}
         error = root_sum_square(f0);
         if (iter>maxiter){
             *errstring=std::string("reached maximum number of iterations");
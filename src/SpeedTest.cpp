@@ -3,6 +3,7 @@
 #include "AbstractState.h"
 #include "DataStructures.h"
 #include "crossplatform_shared_ptr.h"
+#include "Backends/Helmholtz/Fluids/FluidLibrary.h"
 
 #include <time.h>
 
@@ -39,4 +40,38 @@ void compare_REFPROP_and_CoolProp(const std::string &fluid, CoolProp::input_pair
     printf("Elapsed time for REFPROP is %g us/call\n",elap);
 }
 
+void compare_generated_and_generic_kernels(const std::string &fluid, std::size_t N)
+{
+    time_t t1,t2;
+
+    ResidualHelmholtzGeneralizedExponential generated = get_library().get(fluid)->EOS().alphar.GenExp;
+    if (generated.kernel == NULL){
+        printf("There is no generated kernel for %s\n", fluid.c_str());
+        return;
+    }
+    ResidualHelmholtzGeneralizedExponential generic = generated;
+    generic.set_kernel(NULL);
+
+    // The result is summed and printed so that the evaluations cannot be optimized away
+    HelmholtzDerivatives derivs;
+    t1 = clock();
+    for (std::size_t ii = 0; ii < N; ++ii)
+    {
+        generated.all(0.5 + ii*1e-6, 1.0, derivs, 4);
+    }
+    t2 = clock();
+    double elap = ((double)(t2-t1))/CLOCKS_PER_SEC/((double)N)*1e6;
+    printf("Elapsed time for the generated kernel is %g us/call (%g)\n", elap, static_cast<double>(derivs.alphar));
+
+    derivs.reset(0.0);
+    t1 = clock();
+    for (std::size_t ii = 0; ii < N; ++ii)
+    {
+        generic.all(0.5 + ii*1e-6, 1.0, derivs, 4);
+    }
+    t2 = clock();
+    elap = ((double)(t2-t1))/CLOCKS_PER_SEC/((double)N)*1e6;
+    printf("Elapsed time for the generic evaluation is %g us/call (%g)\n", elap, static_cast<double>(derivs.alphar));
+}
+
 } /* namespace CoolProp */
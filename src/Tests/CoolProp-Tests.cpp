@@ -15,6 +15,10 @@
 #include "CoolPropTools.h"
 #include "CoolProp.h"
 
+#if !defined(__ISWINDOWS__)
+    #include <pthread.h>
+#endif
+
 using namespace CoolProp;
 
 namespace TransportValidation{
@@ -1312,7 +1316,7 @@ TEST_CASE("Triple point checks", "[triple_point]")
         {            
             REQUIRE_NOTHROW(HEOS->update(CoolProp::QT_INPUTS, 0, HEOS->Ttriple()););
             double p_EOS = HEOS->p();
-            double p_sat_min_liquid = HEOS->get_components()[0].EOS().sat_min_liquid.p;
+            double p_sat_min_liquid = HEOS->get_components()[0]->EOS().sat_min_liquid.p;
             double err_sat_min_liquid = std::abs(p_EOS-p_sat_min_liquid)/p_sat_min_liquid;
             CAPTURE(p_EOS);
             CAPTURE(p_sat_min_liquid);
@@ -1327,7 +1331,7 @@ TEST_CASE("Triple point checks", "[triple_point]")
             REQUIRE_NOTHROW(HEOS->update(CoolProp::QT_INPUTS, 1, HEOS->Ttriple()););
             
             double p_EOS = HEOS->p();
-            double p_sat_min_vapor = HEOS->get_components()[0].EOS().sat_min_vapor.p;
+            double p_sat_min_vapor = HEOS->get_components()[0]->EOS().sat_min_vapor.p;
             double err_sat_min_vapor = std::abs(p_EOS-p_sat_min_vapor)/p_sat_min_vapor;
             CAPTURE(p_EOS);
             CAPTURE(p_sat_min_vapor);
@@ -1786,6 +1790,273 @@ TEST_CASE("Check the phase flags", "[phase]")
     }
 }
 
+TEST_CASE("Fluid definitions are shared between states", "[shared_fluids]")
+{
+    shared_ptr<CoolProp::HelmholtzEOSBackend> HEOS1(new CoolProp::HelmholtzEOSBackend("R134a"));
+    shared_ptr<CoolProp::HelmholtzEOSBackend> HEOS2(new CoolProp::HelmholtzEOSBackend("R134a"));
+    SECTION("Two states point at the same fluid")
+    {
+        CHECK(HEOS1->get_components()[0].get() == HEOS2->get_components()[0].get());
+    }
+    SECTION("Interleaved updates give the same values as fresh states")
+    {
+        HEOS1->update(CoolProp::DmolarT_INPUTS, 40, 300);
+        HEOS2->update(CoolProp::DmolarT_INPUTS, 12000, 250);
+        double p1 = HEOS1->p(), p2 = HEOS2->p();
+        HEOS2->update(CoolProp::DmolarT_INPUTS, 40, 300);
+        HEOS1->update(CoolProp::DmolarT_INPUTS, 12000, 250);
+        CHECK(std::abs(HEOS2->p()/p1-1) < 1e-14);
+        CHECK(std::abs(HEOS1->p()/p2-1) < 1e-14);
+    }
+    SECTION("Changing the EOS of one state does not leak into the library")
+    {
+        CoolPropFluid *shared = HEOS1->get_components()[0].get();
+        double Tc = HEOS2->T_critical();
+        HEOS1->change_EOS(0, "SRK");
+        CHECK(HEOS1->get_components()[0].get() != shared);
+        CHECK(HEOS2->get_components()[0].get() == shared);
+        shared_ptr<CoolProp::HelmholtzEOSBackend> HEOS3(new CoolProp::HelmholtzEOSBackend("R134a"));
+        CHECK(HEOS3->get_components()[0].get() == shared);
+        CHECK(std::abs(HEOS3->T_critical() - Tc) < 1e-12);
+    }
+    SECTION("Changing the EOS after a saturation call gives the same values as a fresh state")
+    {
+        HEOS1->update(CoolProp::QT_INPUTS, 0, 280);
+        HEOS1->change_EOS(0, "SRK");
+        HEOS1->update(CoolProp::QT_INPUTS, 0, 280);
+        HEOS2->change_EOS(0, "SRK");
+        HEOS2->update(CoolProp::QT_INPUTS, 0, 280);
+        CHECK(std::abs(HEOS1->p()/HEOS2->p()-1) < 1e-12);
+        CHECK(std::abs(HEOS1->saturated_vapor_keyed_output(CoolProp::iDmolar)/HEOS2->saturated_vapor_keyed_output(CoolProp::iDmolar)-1) < 1e-12);
+    }
+}
+
+TEST_CASE("Every indexed fluid is parsed on first use and can be found by its name, CAS number and aliases", "[fluid_index]")
+{
+    std::vector<std::string> fluids = strsplit(CoolProp::get_fluid_list(), ',');
+    REQUIRE(fluids.size() > 100);
+    for (std::size_t i = 0; i < fluids.size(); ++i)
+    {
+        CAPTURE(fluids[i]);
+        shared_ptr<CoolPropFluid> fluid;
+        CHECK_NOTHROW(fluid = CoolProp::get_library().get(fluids[i]));
+        if (fluid.get() == NULL){ continue; }
+        CHECK(fluid->name == fluids[i]);
+        CHECK(CoolProp::get_library().get(fluid->CAS).get() == fluid.get());
+        for (std::size_t j = 0; j < fluid->aliases.size(); ++j){
+            CAPTURE(fluid->aliases[j]);
+            CHECK(CoolProp::get_library().get(fluid->aliases[j]).get() == fluid.get());
+        }
+    }
+}
+
+TEST_CASE("Residual Helmholtz derivatives at many points agree with those at one point at a time", "[alphar_multi]")
+{
+    std::string fluids[] = {"R134a", "Water", "R32&R125"};
+    for (std::size_t i = 0; i < sizeof(fluids)/sizeof(fluids[0]); ++i)
+    {
+        std::vector<std::string> names = strsplit(fluids[i], '&');
+        shared_ptr<CoolProp::HelmholtzEOSMixtureBackend> HEOS(new CoolProp::HelmholtzEOSMixtureBackend(names));
+        std::vector<CoolPropDbl> z(names.size(), 1.0/names.size());
+        HEOS->set_mole_fractions(z);
+        HEOS->specify_phase(CoolProp::iphase_gas);
+        // 13 points, so that the last block of points is only partly filled
+        std::vector<CoolPropDbl> T, rhomolar, tau, delta;
+        for (std::size_t k = 0; k < 13; ++k){
+            T.push_back(250 + 20*k);
+            rhomolar.push_back(10 + 900*k);
+            tau.push_back(HEOS->T_reducing()/T.back());
+            delta.push_back(rhomolar.back()/HEOS->rhomolar_reducing());
+        }
+        CoolProp::HelmholtzDerivativesArrays derivs;
+        HEOS->calc_all_alphar_deriv_multi(z, tau, delta, derivs);
+        REQUIRE(derivs.size() == T.size());
+        for (std::size_t k = 0; k < T.size(); ++k){
+            HEOS->update_DmolarT_direct(rhomolar[k], T[k]);
+            CAPTURE(fluids[i]);
+            CAPTURE(T[k]);
+            CAPTURE(rhomolar[k]);
+            CHECK(std::abs(derivs.alphar[k] - HEOS->alphar()) < 1e-10*std::abs(HEOS->alphar()) + 1e-14);
+            CHECK(std::abs(derivs.dalphar_dtau[k] - HEOS->dalphar_dTau()) < 1e-10*std::abs(HEOS->dalphar_dTau()) + 1e-14);
+            CHECK(std::abs(derivs.d2alphar_ddelta_dtau[k] - HEOS->d2alphar_dDelta_dTau()) < 1e-10*std::abs(HEOS->d2alphar_dDelta_dTau()) + 1e-14);
+            CHECK(std::abs(derivs.d3alphar_ddelta2_dtau[k] - HEOS->d3alphar_dDelta2_dTau()) < 1e-10*std::abs(HEOS->d3alphar_dDelta2_dTau()) + 1e-14);
+            CHECK(std::abs(derivs.d4alphar_ddelta4[k] - HEOS->d4alphar_dDelta4()) < 1e-10*std::abs(HEOS->d4alphar_dDelta4()) + 1e-14);
+        }
+    }
+}
+
+TEST_CASE("Residual Helmholtz derivatives cached at a lower order agree with those of a fresh state", "[alphar_order]")
+{
+    // Water has non-analytic terms, Methanol an associating term, and the mixture departure functions
+    std::string fluids[] = {"Water", "Methanol", "R32&R125"};
+    double T[] = {650, 400, 300}, rhomolar[] = {17000, 20000, 12000};
+    for (std::size_t i = 0; i < sizeof(fluids)/sizeof(fluids[0]); ++i)
+    {
+        std::vector<std::string> names = strsplit(fluids[i], '&');
+        std::vector<CoolPropDbl> z(names.size(), 1.0/names.size());
+        shared_ptr<CoolProp::HelmholtzEOSMixtureBackend> cached(new CoolProp::HelmholtzEOSMixtureBackend(names)), fresh(new CoolProp::HelmholtzEOSMixtureBackend(names));
+        cached->set_mole_fractions(z);
+        fresh->set_mole_fractions(z);
+        CAPTURE(fluids[i]);
+
+        // The fresh state calculates all the derivatives at once, as the fourth order one is asked for first
+        fresh->update_DmolarT_direct(rhomolar[i], T[i]);
+        CoolPropDbl d4 = fresh->d4alphar_dDelta4();
+
+        // alphar() caches the derivatives up to second order; the third and fourth order ones are calculated when asked for
+        cached->update_DmolarT_direct(rhomolar[i], T[i]);
+        #define CHECK_CACHED(name) CHECK(std::abs(cached->name() - fresh->name()) <= 1e-14*std::abs(fresh->name()));
+        CHECK_CACHED(alphar)
+        CHECK_CACHED(d3alphar_dDelta3)
+        CHECK(std::abs(cached->d4alphar_dDelta4() - d4) <= 1e-14*std::abs(d4));
+        CHECK_CACHED(dalphar_dDelta)
+        CHECK_CACHED(d2alphar_dDelta_dTau)
+        CHECK_CACHED(d3alphar_dDelta2_dTau)
+        CHECK_CACHED(d4alphar_dDelta2_dTau2)
+        CHECK_CACHED(d4alphar_dTau4)
+
+        // The density solver raises the minimum order while it runs; afterwards the derivatives of all orders are those of the solution
+        cached->update_TP_guessrho(T[i], fresh->p(), 1.01*rhomolar[i]);
+        fresh->update_DmolarT_direct(cached->rhomolar(), T[i]);
+        CHECK_CACHED(alphar)
+        CHECK_CACHED(dalphar_dDelta)
+        CHECK_CACHED(d2alphar_dDelta2)
+        CHECK_CACHED(d3alphar_dDelta3)
+        CHECK_CACHED(d3alphar_dDelta_dTau2)
+        CHECK_CACHED(d4alphar_dDelta4)
+        CHECK_CACHED(d4alphar_dDelta_dTau3)
+        #undef CHECK_CACHED
+    }
+}
+
+TEST_CASE("Transport properties from a reused state agree with those from fresh states", "[transport_reuse]")
+{
+    // R11 uses ECS for both viscosity and conductivity; the mixture uses the pure component states
+    std::string fluids[] = {"R11", "R32&R125"};
+    for (std::size_t i = 0; i < sizeof(fluids)/sizeof(fluids[0]); ++i)
+    {
+        std::vector<std::string> names = strsplit(fluids[i], '&');
+        std::vector<CoolPropDbl> z(names.size(), 1.0/names.size());
+        shared_ptr<CoolProp::HelmholtzEOSMixtureBackend> reused(new CoolProp::HelmholtzEOSMixtureBackend(names));
+        reused->set_mole_fractions(z);
+        // Jump between gas and liquid states so that the warm start is sometimes far from the solution
+        double T[] = {300, 320, 250, 400, 310}, rhomolar[] = {40, 45, 10000, 100, 9000};
+        for (std::size_t k = 0; k < sizeof(T)/sizeof(T[0]); ++k){
+            shared_ptr<CoolProp::HelmholtzEOSMixtureBackend> fresh(new CoolProp::HelmholtzEOSMixtureBackend(names));
+            fresh->set_mole_fractions(z);
+            reused->update(CoolProp::DmolarT_INPUTS, rhomolar[k], T[k]);
+            fresh->update(CoolProp::DmolarT_INPUTS, rhomolar[k], T[k]);
+            CAPTURE(fluids[i]);
+            CAPTURE(T[k]);
+            CAPTURE(rhomolar[k]);
+            double eta = fresh->viscosity(), lambda = fresh->conductivity();
+            CHECK(std::abs(reused->viscosity()/eta - 1) < 1e-8);
+            CHECK(std::abs(reused->conductivity()/lambda - 1) < 1e-8);
+        }
+    }
+}
+
+#if !defined(__ISWINDOWS__)
+
+/// The inputs and the results of one thread of the concurrent PropsSI test
+struct PropsSIThreadData{
+    int index, Ncalls;
+    double T_expected;
+    int Nwrong_value, Nwrong_error;
+};
+
+static void * PropsSI_thread(void *arg)
+{
+    PropsSIThreadData &data = *static_cast<PropsSIThreadData *>(arg);
+    // Each thread asks for a fluid of its own that does not exist, so its error message is recognizably its own
+    std::string bad_fluid = format("NotAFluid%d", data.index);
+    for (int i = 0; i < data.Ncalls; ++i){
+        double T = CoolProp::PropsSI("T", "P", 101325, "Q", 0, "Water");
+        if (std::abs(T - data.T_expected) > 1e-8){ data.Nwrong_value++; }
+        CoolProp::PropsSI("T", "P", 101325, "Q", 0, bad_fluid);
+        std::string err = CoolProp::get_global_param_string("errstring");
+        if (err.find(bad_fluid) == std::string::npos){ data.Nwrong_error++; }
+        // Reading the error string clears it
+        if (!CoolProp::get_global_param_string("errstring").empty()){ data.Nwrong_error++; }
+    }
+    return NULL;
+}
+
+TEST_CASE("Concurrent calls to PropsSI each see their own error string", "[thread_safety]")
+{
+    // Load the fluid library on this thread first; the threads then only read from it
+    double T_expected = CoolProp::PropsSI("T", "P", 101325, "Q", 0, "Water");
+    REQUIRE(ValidNumber(T_expected));
+
+    const int Nthreads = 8;
+    std::vector<PropsSIThreadData> data(Nthreads);
+    std::vector<pthread_t> threads(Nthreads);
+    for (int k = 0; k < Nthreads; ++k){
+        data[k].index = k; data[k].Ncalls = 50; data[k].T_expected = T_expected;
+        data[k].Nwrong_value = 0; data[k].Nwrong_error = 0;
+        REQUIRE(pthread_create(&threads[k], NULL, PropsSI_thread, &data[k]) == 0);
+    }
+    for (int k = 0; k < Nthreads; ++k){
+        pthread_join(threads[k], NULL);
+    }
+    for (int k = 0; k < Nthreads; ++k){
+        CAPTURE(k);
+        CHECK(data[k].Nwrong_value == 0);
+        CHECK(data[k].Nwrong_error == 0);
+    }
+    // The errors raised on the other threads are not visible on this one
+    CHECK(CoolProp::get_global_param_string("errstring").empty());
+}
+
+static int Once_calls = 0;
+static CoolProp::Once Once_under_test;
+
+static void Once_function()
+{
+    // Slow enough that the other threads arrive while it runs
+    int calls = Once_calls;
+    for (volatile int i = 0; i < 1000000; ++i){}
+    Once_calls = calls + 1;
+}
+
+static void * Once_thread(void *)
+{
+    Once_under_test.call(Once_function);
+    return NULL;
+}
+
+TEST_CASE("A Once runs its function exactly once when called from several threads at once", "[thread_safety]")
+{
+    const int Nthreads = 8;
+    std::vector<pthread_t> threads(Nthreads);
+    for (int k = 0; k < Nthreads; ++k){
+        REQUIRE(pthread_create(&threads[k], NULL, Once_thread, NULL) == 0);
+    }
+    for (int k = 0; k < Nthreads; ++k){
+        pthread_join(threads[k], NULL);
+    }
+    CHECK(Once_calls == 1);
+    Once_under_test.call(Once_function);
+    CHECK(Once_calls == 1);
+}
+
+#endif
+
+TEST_CASE("Fluids can be warmed up ahead of time", "[warm_up]")
+{
+    std::vector<std::string> fluids;
+    fluids.push_back("Water");
+    fluids.push_back("HEOS::R32[0.5]&R125[0.5]");
+    fluids.push_back("INCOMP::MEG-20%");
+    fluids.push_back("BICUBIC&HEOS::R32[0.5]&R125[0.5]");
+    CHECK_NOTHROW(CoolProp::warm_up(fluids));
+    // Warming up again does nothing more
+    CHECK_NOTHROW(CoolProp::warm_up(fluids));
+    CHECK_THROWS(CoolProp::warm_up(std::vector<std::string>(1, "NotAFluid")));
+    CHECK(ValidNumber(CoolProp::PropsSI("D", "T", 300, "P", 101325, "Water")));
+    CHECK(ValidNumber(CoolProp::PropsSI("D", "T", 300, "P", 101325, "BICUBIC&HEOS::R32[0.5]&R125[0.5]")));
+}
+
 /*
 TEST_CASE("Test that HS solver works for a few fluids", "[HS_solver]")
 {
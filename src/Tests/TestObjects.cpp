@@ -11,6 +11,39 @@
 #include "Eigen/Core"
 
 #if defined ENABLE_CATCH
+#include <cstdlib>
+#include <new>
+
+// The global operator new is replaced in the test runner to count the allocations.  The count is kept per thread,
+// so that the tests that check for allocations are not disturbed by other threads.
+#if __cplusplus >= 201103L
+    #define TEST_THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+    #define TEST_THREAD_LOCAL __declspec(thread)
+#else
+    #define TEST_THREAD_LOCAL __thread
+#endif
+static TEST_THREAD_LOCAL std::size_t heap_allocation_count = 0;
+
+#if __cplusplus >= 201103L
+void* operator new(std::size_t size)
+#else
+void* operator new(std::size_t size) throw(std::bad_alloc)
+#endif
+{
+    ++heap_allocation_count;
+    void *p = std::malloc(size == 0 ? 1 : size);
+    if (p == NULL){ throw std::bad_alloc(); }
+    return p;
+}
+void operator delete(void *p) throw()
+{
+    std::free(p);
+}
+
+std::size_t CoolPropTesting::heap_allocations(){
+    return heap_allocation_count;
+}
 
 Eigen::MatrixXd CoolPropTesting::makeMatrix(const std::vector<double> &coefficients){
     //IncompressibleClass::checkCoefficients(coefficients,18);
@@ -355,6 +355,15 @@ int main()
     }
 	#endif
     #if 0
+    {
+        // Needs a build with the kernels generated for these fluids (see COOLPROP_GENERATED_KERNELS in CMakeLists.txt)
+        std::cout << "Water generated kernel\n-----------------\n";
+        CoolProp::compare_generated_and_generic_kernels("Water", 1000000);
+        std::cout << "R134a generated kernel\n-----------------\n";
+        CoolProp::compare_generated_and_generic_kernels("R134a", 1000000);
+    }
+	#endif
+    #if 0
     {
         std::vector<std::string> ss = strsplit(get_global_param_string("FluidsList"),',');
 